@@ -0,0 +1,199 @@
+/**
+ * @file BenchmarkRunner.cpp
+ * @brief Calibración, medición y salida JSON de los microbenchmarks
+ */
+
+#include "BenchmarkRunner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <numeric>
+
+namespace CoralCode {
+
+    namespace {
+
+        std::string escapeJson(const std::string& text) {
+            std::string out;
+            out.reserve(text.size() + 2);
+            for (char ch : text) {
+                switch (ch) {
+                    case '"': out += "\\\""; break;
+                    case '\\': out += "\\\\"; break;
+                    case '\n': out += "\\n"; break;
+                    case '\r': out += "\\r"; break;
+                    case '\t': out += "\\t"; break;
+                    default:
+                        if (static_cast<unsigned char>(ch) < 0x20) {
+                            char escaped[8];
+                            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(ch));
+                            out += escaped;
+                        } else {
+                            out += ch;
+                        }
+                }
+            }
+            return out;
+        }
+
+        std::string formatNs(double ns) {
+            char text[32];
+            if (ns >= 1e6) {
+                std::snprintf(text, sizeof(text), "%.2f ms", ns / 1e6);
+            } else if (ns >= 1e3) {
+                std::snprintf(text, sizeof(text), "%.2f us", ns / 1e3);
+            } else {
+                std::snprintf(text, sizeof(text), "%.1f ns", ns);
+            }
+            return text;
+        }
+
+    } // namespace
+
+    // ========================================================================
+    // BenchmarkState
+    // ========================================================================
+
+    BenchmarkState::BenchmarkState(size_t iterations)
+        : iterations_(iterations), bytesPerIteration_(0), start_(Clock::now()),
+          elapsed_(Clock::duration::zero()), running_(false) {}
+
+    void BenchmarkState::pauseTiming() {
+        if (!running_) return;
+        elapsed_ += Clock::now() - start_;
+        running_ = false;
+    }
+
+    void BenchmarkState::resumeTiming() {
+        if (running_) return;
+        start_ = Clock::now();
+        running_ = true;
+    }
+
+    double BenchmarkState::getElapsedNs() const {
+        Clock::duration total = elapsed_;
+        if (running_) total += Clock::now() - start_;
+        return std::chrono::duration<double, std::nano>(total).count();
+    }
+
+    // ========================================================================
+    // BenchmarkRunner
+    // ========================================================================
+
+    BenchmarkRunner::BenchmarkRunner() : minTimeMs_(50.0), repetitions_(5) {}
+
+    void BenchmarkRunner::add(const std::string& name, Body body) {
+        cases_.push_back(Case{name, std::move(body)});
+    }
+
+    bool BenchmarkRunner::matches(const std::string& name) const {
+        return filter_.empty() || name.find(filter_) != std::string::npos;
+    }
+
+    std::vector<std::string> BenchmarkRunner::list() const {
+        std::vector<std::string> names;
+        for (const Case& benchmark : cases_) {
+            if (matches(benchmark.name)) names.push_back(benchmark.name);
+        }
+        return names;
+    }
+
+    std::vector<BenchmarkResult> BenchmarkRunner::run(std::ostream* progress) {
+        std::vector<BenchmarkResult> results;
+        for (Case& benchmark : cases_) {
+            if (!matches(benchmark.name)) continue;
+            results.push_back(measure(benchmark));
+            benchmark.body = nullptr;
+
+            if (progress) {
+                const BenchmarkResult& result = results.back();
+                *progress << std::left << std::setw(56) << result.name << std::right << std::setw(12)
+                          << formatNs(result.medianNs) << "  ±" << std::setw(5) << std::fixed
+                          << std::setprecision(1)
+                          << (result.medianNs > 0 ? 100.0 * result.stddevNs / result.medianNs : 0.0) << "%";
+                if (result.bytesPerSecond > 0) {
+                    *progress << "  " << std::setprecision(1) << result.bytesPerSecond / (1024.0 * 1024.0) << " MiB/s";
+                }
+                *progress << "  (" << result.iterations << " it)" << std::endl;
+            }
+        }
+        return results;
+    }
+
+    BenchmarkResult BenchmarkRunner::measure(Case& benchmark) {
+        // Calibrar: crecer hasta que una ejecución dure al menos minTime
+        const double minTimeNs = minTimeMs_ * 1e6;
+        size_t iterations = 1;
+        while (true) {
+            BenchmarkState state(iterations);
+            benchmark.body(state);
+            const double elapsed = state.getElapsedNs();
+            if (elapsed >= minTimeNs || iterations >= MAX_ITERATIONS) break;
+
+            double scale = elapsed > 0 ? minTimeNs * 1.2 / elapsed : 10.0;
+            scale = std::min(std::max(scale, 1.5), 10.0);
+            iterations = std::min(MAX_ITERATIONS, static_cast<size_t>(std::ceil(static_cast<double>(iterations) * scale)));
+        }
+
+        std::vector<double> perIteration;
+        uint64_t bytes = 0;
+        for (size_t repetition = 0; repetition < repetitions_; ++repetition) {
+            BenchmarkState state(iterations);
+            benchmark.body(state);
+            perIteration.push_back(state.getElapsedNs() / static_cast<double>(iterations));
+            bytes = state.getBytesPerIteration();
+        }
+
+        BenchmarkResult result;
+        result.name = benchmark.name;
+        result.iterations = iterations;
+        result.repetitions = perIteration.size();
+
+        std::vector<double> sorted = perIteration;
+        std::sort(sorted.begin(), sorted.end());
+        const size_t middle = sorted.size() / 2;
+        result.medianNs = sorted.size() % 2 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2.0;
+        result.minNs = sorted.front();
+        result.maxNs = sorted.back();
+        result.meanNs = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size());
+        double variance = 0.0;
+        for (double value : sorted) {
+            variance += (value - result.meanNs) * (value - result.meanNs);
+        }
+        result.stddevNs = sorted.size() > 1 ? std::sqrt(variance / static_cast<double>(sorted.size() - 1)) : 0.0;
+        if (bytes > 0 && result.medianNs > 0) {
+            result.bytesPerSecond = static_cast<double>(bytes) * 1e9 / result.medianNs;
+        }
+        return result;
+    }
+
+    void BenchmarkRunner::writeJson(std::ostream& out, const std::map<std::string, std::string>& context,
+                                    const std::vector<BenchmarkResult>& results) {
+        out << "{\n  \"context\": {";
+        bool first = true;
+        for (const auto& entry : context) {
+            out << (first ? "\n" : ",\n") << "    \"" << escapeJson(entry.first) << "\": \""
+                << escapeJson(entry.second) << "\"";
+            first = false;
+        }
+        out << "\n  },\n  \"benchmarks\": [";
+
+        out << std::setprecision(17);
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchmarkResult& result = results[i];
+            out << (i == 0 ? "\n" : ",\n")
+                << "    {\"name\": \"" << escapeJson(result.name) << "\""
+                << ", \"iterations\": " << result.iterations
+                << ", \"repetitions\": " << result.repetitions
+                << ", \"median_ns\": " << result.medianNs
+                << ", \"mean_ns\": " << result.meanNs
+                << ", \"min_ns\": " << result.minNs
+                << ", \"max_ns\": " << result.maxNs
+                << ", \"stddev_ns\": " << result.stddevNs
+                << ", \"bytes_per_second\": " << result.bytesPerSecond << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+} // namespace CoralCode
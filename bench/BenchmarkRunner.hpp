@@ -0,0 +1,120 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Estado de una ejecución: cuántas iteraciones hacer y cronómetro
+     *
+     * El cuerpo del benchmark prepara su entrada, llama a resumeTiming(),
+     * repite la operación iterations() veces y llama a pauseTiming(). El
+     * cronómetro empieza parado: la preparación nunca entra en la medida.
+     */
+    class BenchmarkState {
+    public:
+        explicit BenchmarkState(size_t iterations);
+
+        size_t iterations() const { return iterations_; }
+        void pauseTiming();
+        void resumeTiming();
+
+        // Bytes tratados por iteración (para informar el rendimiento)
+        void setBytesPerIteration(uint64_t bytes) { bytesPerIteration_ = bytes; }
+        uint64_t getBytesPerIteration() const { return bytesPerIteration_; }
+
+        double getElapsedNs() const;
+
+        // Evita que el compilador elimine un resultado no usado
+        template <typename T>
+        static void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+            asm volatile("" : : "r,m"(value) : "memory");
+#else
+            const volatile char* sink = reinterpret_cast<const volatile char*>(&value);
+            static_cast<void>(*sink);
+#endif
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        size_t iterations_;
+        uint64_t bytesPerIteration_;
+        Clock::time_point start_;
+        Clock::duration elapsed_;
+        bool running_;
+    };
+
+    /**
+     * @brief Resultado de un benchmark (tiempos por iteración)
+     */
+    struct BenchmarkResult {
+        std::string name;
+        size_t iterations = 0;
+        size_t repetitions = 0;
+        double medianNs = 0.0;
+        double meanNs = 0.0;
+        double minNs = 0.0;
+        double maxNs = 0.0;
+        double stddevNs = 0.0;
+        double bytesPerSecond = 0.0;
+    };
+
+    /**
+     * @brief Registro y ejecución de microbenchmarks sin dependencias
+     *
+     * Responsable de:
+     * - Calibrar las iteraciones hasta que una ejecución dure minTime
+     * - Repetir la medición y resumir mediana, media, extremos y desviación
+     * - Filtrar por subcadena del nombre ("textbuffer/", "search/regex")
+     * - Escribir los resultados en JSON para comparar versiones
+     *
+     * Cada cuerpo se libera al terminar su benchmark, así el estado que
+     * capture (documentos grandes) no se acumula durante la ejecución.
+     */
+    class BenchmarkRunner {
+    public:
+        using Body = std::function<void(BenchmarkState&)>;
+
+        BenchmarkRunner();
+
+        void add(const std::string& name, Body body);
+
+        // Configuración
+        void setFilter(const std::string& filter) { filter_ = filter; }
+        void setMinTime(double milliseconds) { minTimeMs_ = milliseconds; }
+        void setRepetitions(size_t repetitions) { repetitions_ = repetitions > 0 ? repetitions : 1; }
+
+        std::vector<std::string> list() const;
+        std::vector<BenchmarkResult> run(std::ostream* progress = nullptr);
+
+        // Salida: contexto (versión, compilador, corpus...) y resultados
+        static void writeJson(std::ostream& out, const std::map<std::string, std::string>& context,
+                              const std::vector<BenchmarkResult>& results);
+
+        static constexpr size_t MAX_ITERATIONS = 1000000000;
+
+    private:
+        struct Case {
+            std::string name;
+            Body body;
+        };
+
+        std::vector<Case> cases_;
+        std::string filter_;
+        double minTimeMs_;
+        size_t repetitions_;
+
+        bool matches(const std::string& name) const;
+        BenchmarkResult measure(Case& benchmark);
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,549 @@
+/**
+ * @file CoreBenchmarks.cpp
+ * @brief Microbenchmarks del núcleo: buffer, sintaxis, undo, búsqueda,
+ *        pegado, coordenadas del viewport y ajuste de línea
+ *
+ * Los nombres siguen "subsistema/operación/variante/documento" para poder
+ * filtrar por prefijo y comparar la misma entrada entre versiones. Cada
+ * operación que modifica el buffer deshace su efecto dentro de la misma
+ * iteración, así el documento no crece con las iteraciones.
+ */
+
+#include "CoreBenchmarks.hpp"
+#include "CursorSet.hpp"
+#include "IncrementalParser.hpp"
+#include "RegexEngine.hpp"
+#include "SearchEngine.hpp"
+#include "SyntaxHighlighter.hpp"
+#include "TextBuffer.hpp"
+#include "UndoRedoManager.hpp"
+#include "Viewport.hpp"
+#include "WrapIndex.hpp"
+#include <algorithm>
+#include <memory>
+#include <string>
+
+namespace CoralCode {
+
+    namespace {
+
+        using DocumentPtr = std::shared_ptr<const BenchDocument>;
+
+        // Muestra de líneas para tokenizar (el documento entero no hace falta)
+        constexpr size_t TOKENIZE_SAMPLE_LINES = 1024;
+        constexpr size_t PASTE_BLOCK_LINES = 100;
+
+        struct Position {
+            const char* name;
+            double fraction;
+        };
+
+        const Position POSITIONS[] = {{"start", 0.0}, {"middle", 0.5}, {"end", 1.0}};
+
+        size_t lineAt(const BenchDocument& document, double fraction) {
+            if (document.lines.empty()) return 0;
+            return std::min(document.lines.size() - 1,
+                            static_cast<size_t>(fraction * static_cast<double>(document.lines.size() - 1)));
+        }
+
+        // Primera línea no vacía a partir de la indicada (o la propia)
+        size_t nonEmptyLineFrom(const BenchDocument& document, size_t line) {
+            for (size_t i = line; i < document.lines.size(); ++i) {
+                if (!document.lines[i].empty()) return i;
+            }
+            return line;
+        }
+
+        std::string pasteBlock(const BenchDocument& document) {
+            std::string block;
+            const size_t count = std::min(PASTE_BLOCK_LINES, document.lines.size());
+            for (size_t i = 0; i < count; ++i) {
+                block += document.lines[i];
+                if (i + 1 < count) block += '\n';
+            }
+            return block;
+        }
+
+        size_t sampleBytes(const BenchDocument& document, size_t count) {
+            size_t bytes = 0;
+            for (size_t i = 0; i < count && i < document.lines.size(); ++i) {
+                bytes += document.lines[i].size();
+            }
+            return bytes;
+        }
+
+        std::string caseName(const std::string& base, const BenchDocument& document) {
+            return base + "/" + document.name;
+        }
+
+        // ====================================================================
+        // TextBuffer
+        // ====================================================================
+
+        void registerTextBuffer(BenchmarkRunner& runner, const DocumentPtr& document) {
+            for (const Position& position : POSITIONS) {
+                const std::string suffix = std::string(position.name) + "/" + document->name;
+
+                runner.add("textbuffer/insert_delete_char/" + suffix, [document, position](BenchmarkState& state) {
+                    TextBuffer buffer(document->lines);
+                    const size_t line = lineAt(*document, position.fraction);
+                    const size_t col = buffer.getLineLength(line) / 2;
+                    state.resumeTiming();
+                    for (size_t i = 0; i < state.iterations(); ++i) {
+                        buffer.insertChar(line, col, 'x');
+                        buffer.deleteChar(line, col);
+                    }
+                    state.pauseTiming();
+                    BenchmarkState::doNotOptimize(buffer.getLineLength(line));
+                });
+
+                runner.add("textbuffer/split_merge_line/" + suffix, [document, position](BenchmarkState& state) {
+                    TextBuffer buffer(document->lines);
+                    const size_t line = lineAt(*document, position.fraction);
+                    const size_t col = buffer.getLineLength(line) / 2;
+                    state.resumeTiming();
+                    for (size_t i = 0; i < state.iterations(); ++i) {
+                        buffer.splitLine(line, col);
+                        buffer.mergeLine(line);
+                    }
+                    state.pauseTiming();
+                    BenchmarkState::doNotOptimize(buffer.getLineCount());
+                });
+
+                runner.add("textbuffer/insert_delete_line/" + suffix, [document, position](BenchmarkState& state) {
+                    TextBuffer buffer(document->lines);
+                    const size_t line = lineAt(*document, position.fraction);
+                    state.resumeTiming();
+                    for (size_t i = 0; i < state.iterations(); ++i) {
+                        buffer.insertLine(line, "    int inserted = 0;");
+                        buffer.deleteLine(line);
+                    }
+                    state.pauseTiming();
+                    BenchmarkState::doNotOptimize(buffer.getLineCount());
+                });
+
+                runner.add("textbuffer/insert_remove_word/" + suffix, [document, position](BenchmarkState& state) {
+                    TextBuffer buffer(document->lines);
+                    const size_t line = lineAt(*document, position.fraction);
+                    const size_t col = buffer.getLineLength(line) / 2;
+                    const std::string word = "identifier";
+                    state.resumeTiming();
+                    for (size_t i = 0; i < state.iterations(); ++i) {
+                        buffer.insertText(line, col, word);
+                        buffer.replaceRange(line, col, line, col + word.size(), "");
+                    }
+                    state.pauseTiming();
+                    BenchmarkState::doNotOptimize(buffer.getLineLength(line));
+                });
+            }
+
+            runner.add(caseName("textbuffer/to_string", *document), [document](BenchmarkState& state) {
+                TextBuffer buffer(document->lines);
+                state.setBytesPerIteration(document->bytes);
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    std::string text = buffer.toString();
+                    BenchmarkState::doNotOptimize(text.size());
+                }
+                state.pauseTiming();
+            });
+        }
+
+        // ====================================================================
+        // Sintaxis
+        // ====================================================================
+
+        void registerSyntax(BenchmarkRunner& runner, const DocumentPtr& document) {
+            const size_t sample = std::min(TOKENIZE_SAMPLE_LINES, document->lines.size());
+            const size_t bytes = sampleBytes(*document, sample);
+
+            runner.add(caseName("syntax/tokenize_lines", *document), [document, sample, bytes](BenchmarkState& state) {
+                SyntaxHighlighter highlighter;
+                highlighter.setLanguage("C++");
+                state.setBytesPerIteration(bytes);
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    SyntaxHighlighter::MultiLineState lexState;
+                    for (size_t line = 0; line < sample; ++line) {
+                        BenchmarkState::doNotOptimize(
+                            highlighter.tokenizeLineWithState(document->lines[line], lexState).size());
+                    }
+                }
+                state.pauseTiming();
+            });
+
+            runner.add(caseName("syntax/highlight_lines", *document), [document, sample, bytes](BenchmarkState& state) {
+                SyntaxHighlighter highlighter;
+                highlighter.setLanguage("C++");
+                state.setBytesPerIteration(bytes);
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    SyntaxHighlighter::MultiLineState lexState;
+                    for (size_t line = 0; line < sample; ++line) {
+                        BenchmarkState::doNotOptimize(
+                            highlighter.highlightLineWithState(document->lines[line], lexState).size());
+                    }
+                }
+                state.pauseTiming();
+            });
+
+            runner.add(caseName("syntax/incremental_edit_reparse/middle", *document), [document](BenchmarkState& state) {
+                SyntaxHighlighter highlighter;
+                highlighter.setLanguage("C++");
+                TextBuffer buffer(document->lines);
+                IncrementalParser parser(highlighter);
+                parser.attach(buffer);
+                parser.reparse();
+
+                const size_t line = lineAt(*document, 0.5);
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    buffer.insertChar(line, 0, '/');
+                    buffer.insertChar(line, 0, '*');
+                    BenchmarkState::doNotOptimize(parser.reparse());
+                    buffer.deleteChar(line, 0);
+                    buffer.deleteChar(line, 0);
+                    BenchmarkState::doNotOptimize(parser.reparse());
+                }
+                state.pauseTiming();
+            });
+
+            runner.add(caseName("syntax/full_reparse", *document), [document](BenchmarkState& state) {
+                SyntaxHighlighter highlighter;
+                highlighter.setLanguage("C++");
+                TextBuffer buffer(document->lines);
+                IncrementalParser parser(highlighter);
+                parser.attach(buffer);
+                state.setBytesPerIteration(document->bytes);
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    parser.invalidate();
+                    BenchmarkState::doNotOptimize(parser.reparse());
+                }
+                state.pauseTiming();
+            });
+        }
+
+        // ====================================================================
+        // Undo/redo
+        // ====================================================================
+
+        void registerUndo(BenchmarkRunner& runner, const DocumentPtr& document) {
+            // Historial por instantánea: copia el documento en cada saveState
+            runner.add(caseName("undo/snapshot_edit_undo_redo", *document), [document](BenchmarkState& state) {
+                TextBuffer buffer(document->lines);
+                UndoRedoManager history;
+                CursorPosition cursor;
+                const size_t line = lineAt(*document, 0.5);
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    history.saveState(buffer, cursor, OperationType::Insert, "Insertar");
+                    buffer.insertChar(line, 0, 'x');
+                    history.undo(buffer, cursor);
+                    history.redo(buffer, cursor);
+                    buffer.deleteChar(line, 0);
+                }
+                state.pauseTiming();
+                BenchmarkState::doNotOptimize(history.getUndoCount());
+            });
+
+            // Historial compacto: solo las ediciones inversas
+            runner.add(caseName("undo/delta_edit_undo_redo", *document), [document](BenchmarkState& state) {
+                TextBuffer buffer(document->lines);
+                UndoRedoManager history;
+                CursorPosition cursor;
+                const size_t line = lineAt(*document, 0.5);
+                const std::vector<TextEdit> insert = {TextEdit{line, 0, line, 0, "x"}};
+                const std::vector<TextEdit> remove = {TextEdit{line, 0, line, 1, ""}};
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    history.recordEdits(buffer.applyEdits(insert), cursor, OperationType::Insert, "Insertar");
+                    history.undo(buffer, cursor);
+                    history.redo(buffer, cursor);
+                    buffer.applyEdits(remove);
+                }
+                state.pauseTiming();
+                BenchmarkState::doNotOptimize(history.getUndoCount());
+            });
+        }
+
+        // ====================================================================
+        // Búsqueda
+        // ====================================================================
+
+        void addFindAll(BenchmarkRunner& runner, const DocumentPtr& document, const std::string& variant,
+                        const std::string& pattern, bool caseSensitive, bool wholeWord) {
+            runner.add(caseName("search/find_all/" + variant, *document),
+                       [document, pattern, caseSensitive, wholeWord](BenchmarkState& state) {
+                TextBuffer buffer(document->lines);
+                SearchEngine engine(pattern, caseSensitive, wholeWord);
+                state.setBytesPerIteration(document->bytes);
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    BenchmarkState::doNotOptimize(engine.findAll(buffer).size());
+                }
+                state.pauseTiming();
+            });
+        }
+
+        void registerSearch(BenchmarkRunner& runner, const DocumentPtr& document) {
+            addFindAll(runner, document, "common_literal", "buffer", true, false);
+            addFindAll(runner, document, "rare_literal", "zzz_not_present", true, false);
+            addFindAll(runner, document, "case_insensitive", "CURSOR", false, false);
+            addFindAll(runner, document, "whole_word", "line", true, true);
+
+            runner.add(caseName("search/find_forward/from_middle", *document), [document](BenchmarkState& state) {
+                TextBuffer buffer(document->lines);
+                SearchEngine engine("viewport");
+                const size_t line = lineAt(*document, 0.5);
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    SearchMatch match{};
+                    BenchmarkState::doNotOptimize(engine.findForward(buffer, line, 0, match));
+                }
+                state.pauseTiming();
+            });
+
+            runner.add(caseName("search/regex/identifier_call", *document), [document](BenchmarkState& state) {
+                TextBuffer buffer(document->lines);
+                RegexEngine regex;
+                regex.compile("[a-z]+\\.[a-z]+\\([0-9]+\\)");
+                state.setBytesPerIteration(document->bytes);
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    size_t matches = 0;
+                    regex.search(buffer, 0, 0, [&matches](const RegexMatch&) noexcept {
+                        ++matches;
+                        return true;
+                    });
+                    BenchmarkState::doNotOptimize(matches);
+                }
+                state.pauseTiming();
+            });
+        }
+
+        // ====================================================================
+        // Pegado
+        // ====================================================================
+
+        void registerPaste(BenchmarkRunner& runner, const DocumentPtr& document) {
+            runner.add(caseName("paste/single_line/middle", *document), [document](BenchmarkState& state) {
+                TextBuffer buffer(document->lines);
+                const size_t line = nonEmptyLineFrom(*document, lineAt(*document, 0.5));
+                const std::string text = "std::vector<std::string> pasted = collect(buffer, line);";
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    buffer.replaceRange(line, 0, line, 0, text);
+                    buffer.replaceRange(line, 0, line, text.size(), "");
+                }
+                state.pauseTiming();
+                BenchmarkState::doNotOptimize(buffer.getLineCount());
+            });
+
+            const std::string block = pasteBlock(*document);
+            runner.add(caseName("paste/block_100_lines/middle", *document), [document, block](BenchmarkState& state) {
+                TextBuffer buffer(document->lines);
+                const size_t line = lineAt(*document, 0.5);
+                const size_t lastBlockLine = std::min(PASTE_BLOCK_LINES, document->lines.size()) - 1;
+                const size_t lastBlockLength = document->lines[lastBlockLine].size();
+                state.setBytesPerIteration(block.size());
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    buffer.insertText(line, 0, block);
+                    buffer.replaceRange(line, 0, line + lastBlockLine, lastBlockLength, "");
+                }
+                state.pauseTiming();
+                BenchmarkState::doNotOptimize(buffer.getLineCount());
+            });
+
+            runner.add(caseName("paste/multi_cursor_100/middle", *document), [document](BenchmarkState& state) {
+                TextBuffer buffer(document->lines);
+                CursorSet cursors;
+                const size_t first = lineAt(*document, 0.5);
+                const size_t last = std::min(first + PASTE_BLOCK_LINES, buffer.getLineCount()) - 1;
+                const std::vector<std::string> texts(last - first + 1, "pasted");
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    cursors.setColumnSelection(buffer, CursorPosition(first, 0), CursorPosition(last, 0));
+                    std::vector<TextEdit> inverse = cursors.insertTexts(buffer, texts);
+                    buffer.applyEdits(inverse);
+                }
+                state.pauseTiming();
+                BenchmarkState::doNotOptimize(buffer.getLineCount());
+            });
+        }
+
+        // ====================================================================
+        // Viewport
+        // ====================================================================
+
+        Viewport makeViewport() {
+            Viewport viewport(1280, 720);
+            viewport.setCharacterMetrics(9.0f, 18.0f);
+            viewport.setUIMetrics(60.0f, 25.0f, 15.0f);
+            return viewport;
+        }
+
+        void registerViewport(BenchmarkRunner& runner, const DocumentPtr& document) {
+            const size_t totalLines = document->lines.size();
+
+            runner.add(caseName("viewport/screen_to_text", *document), [totalLines](BenchmarkState& state) {
+                Viewport viewport = makeViewport();
+                viewport.scrollToLine(totalLines / 2);
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    const float x = 60.0f + static_cast<float>(i % 1000);
+                    const float y = static_cast<float>(i % 600);
+                    BenchmarkState::doNotOptimize(viewport.screenToTextPosition(x, y));
+                }
+                state.pauseTiming();
+            });
+
+            runner.add(caseName("viewport/text_to_screen", *document), [totalLines](BenchmarkState& state) {
+                Viewport viewport = makeViewport();
+                viewport.scrollToLine(totalLines / 2);
+                const size_t first = viewport.getFirstVisibleLine();
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    BenchmarkState::doNotOptimize(viewport.textToScreenPosition(first + i % 40, i % 120));
+                }
+                state.pauseTiming();
+            });
+
+            runner.add(caseName("viewport/screen_to_text/layout", *document), [document, totalLines](BenchmarkState& state) {
+                TextBuffer buffer(document->lines);
+                Viewport viewport = makeViewport();
+                viewport.scrollToLine(totalLines / 2);
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    const float x = 60.0f + static_cast<float>(i % 1000);
+                    const float y = static_cast<float>(i % 600);
+                    BenchmarkState::doNotOptimize(viewport.screenToTextPosition(x, y, buffer));
+                }
+                state.pauseTiming();
+            });
+
+            runner.add(caseName("viewport/ensure_cursor_visible", *document), [totalLines](BenchmarkState& state) {
+                Viewport viewport = makeViewport();
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    // Saltos por todo el documento: cada llamada desplaza
+                    viewport.ensureCursorVisible((i * 7919) % totalLines, i % 200, totalLines);
+                }
+                state.pauseTiming();
+                BenchmarkState::doNotOptimize(viewport.getScrollLine());
+            });
+
+            runner.add(caseName("viewport/page_down", *document), [totalLines](BenchmarkState& state) {
+                Viewport viewport = makeViewport();
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    viewport.pageDown(totalLines);
+                    if (!viewport.canScrollDown(totalLines)) viewport.scrollToTop();
+                }
+                state.pauseTiming();
+                BenchmarkState::doNotOptimize(viewport.getScrollLine());
+            });
+        }
+
+        // ====================================================================
+        // Ajuste de línea
+        // ====================================================================
+
+        // Columnas estrechas para que haya líneas con varias filas
+        constexpr float WRAP_WIDTH = 400.0f;
+
+        void registerWrap(BenchmarkRunner& runner, const DocumentPtr& document) {
+            runner.add(caseName("wrap/measure", *document), [document](BenchmarkState& state) {
+                TextBuffer buffer(document->lines);
+                TextLayout layout;
+                WrapIndex index;
+                index.attach(buffer, layout);
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    // Cambio de ancho: medida completa (en paralelo si compensa)
+                    index.setWrapWidth(WRAP_WIDTH + static_cast<float>(i % 2));
+                    BenchmarkState::doNotOptimize(index.getVisualLineCount());
+                }
+                state.pauseTiming();
+            });
+
+            runner.add(caseName("wrap/row_to_line", *document), [document](BenchmarkState& state) {
+                TextBuffer buffer(document->lines);
+                TextLayout layout;
+                WrapIndex index;
+                index.attach(buffer, layout);
+                index.setWrapWidth(WRAP_WIDTH);
+                const size_t rows = index.getVisualLineCount();
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    // Scroll a una fila y posición del thumb
+                    const VisualPosition position = index.lineAtVisualRow((i * 7919) % rows);
+                    BenchmarkState::doNotOptimize(index.visualRowOfLine(position.line));
+                }
+                state.pauseTiming();
+            });
+
+            runner.add(caseName("wrap/insert_delete_char", *document), [document](BenchmarkState& state) {
+                TextBuffer buffer(document->lines);
+                TextLayout layout;
+                WrapIndex index;
+                index.attach(buffer, layout);
+                index.setWrapWidth(WRAP_WIDTH);
+                BenchmarkState::doNotOptimize(index.getVisualLineCount());
+                const size_t line = lineAt(*document, 0.5);
+                const size_t col = buffer.getLineLength(line) / 2;
+                state.resumeTiming();
+                for (size_t i = 0; i < state.iterations(); ++i) {
+                    buffer.insertChar(line, col, 'x');
+                    buffer.deleteChar(line, col);
+                    BenchmarkState::doNotOptimize(index.getVisualLineCount());
+                }
+                state.pauseTiming();
+            });
+        }
+
+    } // namespace
+
+    void registerCoreBenchmarks(BenchmarkRunner& runner, const std::vector<BenchDocument>& documents) {
+        // No depende del documento
+        runner.add("search/regex/compile", [](BenchmarkState& state) {
+            state.resumeTiming();
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                RegexEngine regex;
+                BenchmarkState::doNotOptimize(regex.compile("(foo|bar)[0-9]{2,4}\\s*=\\s*\"[^\"]*\""));
+            }
+            state.pauseTiming();
+        });
+
+        // Una línea de 1 MB con tabulaciones: el clic busca en el layout
+        // cacheado en vez de recorrer la línea
+        runner.add("viewport/screen_to_text/long_line", [](BenchmarkState& state) {
+            std::string line;
+            while (line.size() < 1024 * 1024) line += "\tvalue = compute(a, b);";
+            TextBuffer buffer(std::vector<std::string>{line});
+            Viewport viewport = makeViewport();
+            viewport.setTabSize(4);
+            viewport.screenToTextPosition(60.0f, 0.0f, buffer);
+            state.resumeTiming();
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                viewport.scrollToColumn((i * 7919) % line.size());
+                BenchmarkState::doNotOptimize(viewport.screenToTextPosition(60.0f + static_cast<float>(i % 1000), 0.0f, buffer));
+            }
+            state.pauseTiming();
+        });
+
+        for (const BenchDocument& source : documents) {
+            if (source.lines.empty()) continue;
+            DocumentPtr document = std::make_shared<const BenchDocument>(source);
+            registerTextBuffer(runner, document);
+            registerSyntax(runner, document);
+            registerUndo(runner, document);
+            registerSearch(runner, document);
+            registerPaste(runner, document);
+            registerViewport(runner, document);
+            registerWrap(runner, document);
+        }
+    }
+
+} // namespace CoralCode
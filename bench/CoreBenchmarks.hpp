@@ -0,0 +1,12 @@
+#pragma once
+
+#include "BenchmarkRunner.hpp"
+#include "Corpus.hpp"
+#include <vector>
+
+namespace CoralCode {
+
+    // Registra los benchmarks del núcleo para cada documento de entrada
+    void registerCoreBenchmarks(BenchmarkRunner& runner, const std::vector<BenchDocument>& documents);
+
+} // namespace CoralCode
@@ -0,0 +1,172 @@
+/**
+ * @file Corpus.cpp
+ * @brief Documentos sintéticos y corpus reales para los benchmarks
+ */
+
+#include "Corpus.hpp"
+#include "FileHandler.hpp"
+#include "WorkspaceWalker.hpp"
+#include <algorithm>
+#include <future>
+#include <mutex>
+
+namespace CoralCode {
+
+    namespace {
+
+        // Generador lineal congruente: reproducible en cualquier plataforma
+        class Random {
+        public:
+            explicit Random(uint32_t seed) : state_(seed) {}
+
+            uint32_t next() {
+                state_ = state_ * 1664525u + 1013904223u;
+                return state_ >> 8;
+            }
+
+            size_t below(size_t limit) { return limit > 0 ? next() % limit : 0; }
+
+        private:
+            uint32_t state_;
+        };
+
+        const char* const IDENTIFIERS[] = {
+            "buffer", "line", "column", "cursor", "viewport", "token", "result", "index",
+            "count", "offset", "length", "value", "state", "match", "range", "document",
+        };
+        const char* const TYPES[] = {"size_t", "int", "bool", "std::string", "auto", "float"};
+        const char* const COMMENTS[] = {
+            "// Ajustar el desplazamiento tras la edición",
+            "// TODO: revisar el caso de la última línea",
+            "/* comentario de bloque",
+            "   que ocupa varias líneas */",
+        };
+
+        template <size_t N>
+        const char* pick(Random& random, const char* const (&items)[N]) {
+            return items[random.below(N)];
+        }
+
+        bool looksBinary(const std::string& content) {
+            const size_t probe = std::min<size_t>(content.size(), 8192);
+            return content.find('\0') < probe;
+        }
+
+    } // namespace
+
+    // ========================================================================
+    // Documentos sintéticos
+    // ========================================================================
+
+    BenchDocument Corpus::synthetic(const std::string& name, size_t lineCount, uint32_t seed) {
+        Random random(seed);
+        BenchDocument document;
+        document.name = name;
+        document.lines.reserve(lineCount);
+
+        size_t depth = 0;
+        while (document.lines.size() < lineCount) {
+            std::string indent(depth * 4, ' ');
+            const size_t kind = random.below(20);
+            std::string line;
+
+            if (kind == 0 && depth < 3) {
+                line = indent + "for (" + pick(random, TYPES) + " " + pick(random, IDENTIFIERS) + " = 0; i < " +
+                       pick(random, IDENTIFIERS) + ".size(); ++i) {";
+                ++depth;
+            } else if (kind == 1 && depth > 0) {
+                --depth;
+                line = std::string(depth * 4, ' ') + "}";
+            } else if (kind == 2) {
+                line = indent + pick(random, COMMENTS);
+            } else if (kind == 3) {
+                line = indent + "const char* " + pick(random, IDENTIFIERS) + " = \"texto con \\\"comillas\\\" y " +
+                       std::to_string(random.below(100000)) + "\";";
+            } else if (kind == 4) {
+                // Línea larga (tablas, datos generados)
+                line = indent + "static const int table[] = {";
+                const size_t values = 20 + random.below(200);
+                for (size_t i = 0; i < values; ++i) {
+                    line += std::to_string(random.below(65536)) + ", ";
+                }
+                line += "};";
+            } else if (kind == 5) {
+                line.clear();
+            } else {
+                line = indent + pick(random, TYPES) + " " + pick(random, IDENTIFIERS) + " = " +
+                       pick(random, IDENTIFIERS) + "." + pick(random, IDENTIFIERS) + "(" +
+                       std::to_string(random.below(1000)) + ") + 0x" + std::to_string(random.below(256)) + ";";
+            }
+
+            document.bytes += line.size() + 1;
+            document.lines.push_back(std::move(line));
+        }
+        return document;
+    }
+
+    // ========================================================================
+    // Corpus real
+    // ========================================================================
+
+    std::vector<std::string> Corpus::splitLines(const std::string& content) {
+        std::vector<std::string> lines;
+        size_t start = 0;
+        while (start <= content.size()) {
+            size_t end = content.find('\n', start);
+            if (end == std::string::npos) end = content.size();
+            size_t lineEnd = end;
+            if (lineEnd > start && content[lineEnd - 1] == '\r') --lineEnd;
+            lines.emplace_back(content, start, lineEnd - start);
+            start = end + 1;
+        }
+        return lines;
+    }
+
+    bool Corpus::load(const std::string& path, BenchDocument& document, std::string& error, size_t maxBytes) {
+        FileHandler files;
+
+        // Un archivo suelto
+        std::string content;
+        if (files.readFile(path, content)) {
+            if (content.size() > maxBytes) content.resize(maxBytes);
+            document.name = "corpus";
+            document.lines = splitLines(content);
+            document.bytes = content.size();
+            return true;
+        }
+
+        // Un directorio: todos los archivos, en orden estable
+        std::vector<std::string> paths;
+        std::mutex pathsMutex;
+        WorkspaceWalker walker;
+        if (!walker.walk(path, [&](const WorkspaceFile& file, size_t) {
+                if (file.isDirectory) return;
+                std::lock_guard<std::mutex> lock(pathsMutex);
+                paths.push_back(file.path);
+            })) {
+            error = walker.getLastError().empty() ? files.getLastError() : walker.getLastError();
+            return false;
+        }
+        std::sort(paths.begin(), paths.end());
+
+        std::string all;
+        std::vector<std::future<FileReadResult>> reads = files.readAll(paths);
+        for (std::future<FileReadResult>& read : reads) {
+            FileReadResult result = read.get();
+            if (!result.success || looksBinary(result.content) || all.size() >= maxBytes) continue;
+            all += result.content;
+            if (!all.empty() && all.back() != '\n') all += '\n';
+        }
+        if (all.size() > maxBytes) all.resize(maxBytes);
+        if (all.empty()) {
+            error = "No se encontraron archivos de texto en " + path;
+            return false;
+        }
+
+        document.name = "corpus";
+        document.lines = splitLines(all);
+        document.bytes = all.size();
+        return true;
+    }
+
+} // namespace CoralCode
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Documento de entrada de los benchmarks
+     */
+    struct BenchDocument {
+        std::string name;               // "1k", "100k", "corpus"...
+        std::vector<std::string> lines;
+        size_t bytes = 0;
+    };
+
+    /**
+     * @brief Generación y carga de documentos para los benchmarks
+     *
+     * Responsable de:
+     * - Generar código C++ sintético y determinista (misma semilla, mismo
+     *   texto) con comentarios de bloque, cadenas, números y líneas largas
+     * - Cargar un corpus real (archivo o directorio, respetando .gitignore)
+     *   para medir sobre el código que se edita de verdad
+     */
+    class Corpus {
+    public:
+        static BenchDocument synthetic(const std::string& name, size_t lineCount, uint32_t seed = 0xC0FFEEu);
+
+        // Concatena los archivos de texto encontrados hasta maxBytes
+        static bool load(const std::string& path, BenchDocument& document, std::string& error,
+                         size_t maxBytes = DEFAULT_MAX_CORPUS_BYTES);
+
+        static std::vector<std::string> splitLines(const std::string& content);
+
+        static constexpr size_t DEFAULT_MAX_CORPUS_BYTES = 64u << 20;
+    };
+
+} // namespace CoralCode
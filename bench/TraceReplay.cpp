@@ -0,0 +1,552 @@
+/**
+ * @file TraceReplay.cpp
+ * @brief Reproducción determinista de trazas de edición y sus latencias
+ */
+
+#include "TraceReplay.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+namespace CoralCode {
+
+    namespace {
+
+        bool isContinuationByte(char ch) {
+            return (static_cast<unsigned char>(ch) & 0xC0) == 0x80;
+        }
+
+        uint64_t countCodepoints(const std::string& text) {
+            uint64_t count = 0;
+            for (char ch : text) {
+                if (!isContinuationByte(ch)) ++count;
+            }
+            return count;
+        }
+
+        // Byte en el que empieza el codepoint número index (o el final)
+        size_t byteColumn(const std::string& text, uint64_t index) {
+            size_t byte = 0;
+            while (byte < text.size()) {
+                if (!isContinuationByte(text[byte])) {
+                    if (index == 0) return byte;
+                    --index;
+                }
+                ++byte;
+            }
+            return text.size();
+        }
+
+        std::string encodeUtf8(uint32_t codepoint) {
+            std::string out;
+            if (codepoint < 0x80) {
+                out += static_cast<char>(codepoint);
+            } else if (codepoint < 0x800) {
+                out += static_cast<char>(0xC0 | (codepoint >> 6));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            } else if (codepoint < 0x10000) {
+                out += static_cast<char>(0xE0 | (codepoint >> 12));
+                out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (codepoint >> 18));
+                out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            }
+            return out;
+        }
+
+        double percentile(const std::vector<double>& sorted, double fraction) {
+            if (sorted.empty()) return 0.0;
+            const size_t index = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size()))) - 1;
+            return sorted[std::min(index, sorted.size() - 1)];
+        }
+
+        ReplayOperationStats summarize(const std::string& name, std::vector<double>& samples) {
+            ReplayOperationStats stats;
+            stats.name = name;
+            stats.count = samples.size();
+            if (samples.empty()) return stats;
+
+            std::sort(samples.begin(), samples.end());
+            stats.p50Ns = percentile(samples, 0.50);
+            stats.p99Ns = percentile(samples, 0.99);
+            stats.maxNs = samples.back();
+            double total = 0.0;
+            for (double sample : samples) total += sample;
+            stats.meanNs = total / static_cast<double>(samples.size());
+            return stats;
+        }
+
+        bool isBefore(const CursorPosition& a, const CursorPosition& b) {
+            return a.line < b.line || (a.line == b.line && a.column < b.column);
+        }
+
+        uint64_t hashText(const TextBuffer& buffer) {
+            uint64_t hash = 1469598103934665603ull;
+            for (size_t line = 0; line < buffer.getLineCount(); ++line) {
+                if (line > 0) hash = (hash ^ '\n') * 1099511628211ull;
+                for (char ch : buffer.getLine(line)) {
+                    hash = (hash ^ static_cast<unsigned char>(ch)) * 1099511628211ull;
+                }
+            }
+            return hash;
+        }
+
+    } // namespace
+
+    // ========================================================================
+    // Construcción
+    // ========================================================================
+
+    TraceReplayer::TraceReplayer(const EditTrace& trace, bool incrementalParsing)
+        : trace_(trace), history_(100), parser_(highlighter_), viewport_(trace.windowWidth, trace.windowHeight),
+          incrementalParsing_(incrementalParsing), selecting_(false), mouseDown_(false),
+          spliceLine_(0), spliceLineStart_(0) {
+        buffer_.fromString(trace.initialText);
+        highlighter_.setLanguage("C++");
+        viewport_.setCharacterMetrics(CHAR_WIDTH, LINE_HEIGHT);
+        viewport_.setUIMetrics(LINE_NUMBER_WIDTH, STATUS_BAR_HEIGHT, SCROLL_BAR_WIDTH);
+        if (incrementalParsing_) {
+            parser_.attach(buffer_);
+            parser_.reparse();
+        }
+    }
+
+    TraceReplayer::~TraceReplayer() {
+        parser_.detach();
+    }
+
+    // ========================================================================
+    // Reproducción
+    // ========================================================================
+
+    ReplayReport TraceReplayer::run() {
+        using Clock = std::chrono::steady_clock;
+
+        std::vector<double> samples[static_cast<size_t>(Operation::Count)];
+        std::vector<double> all;
+        all.reserve(trace_.events.size());
+
+        const Clock::time_point start = Clock::now();
+        for (const TraceEvent& event : trace_.events) {
+            const Clock::time_point before = Clock::now();
+
+            const Operation operation = apply(event);
+            // Lo que el frame siguiente necesita antes de dibujar
+            if (incrementalParsing_ && parser_.needsReparse()) parser_.reparse();
+            viewport_.ensureCursorVisible(cursor_.line, cursor_.column, buffer_.getLineCount());
+
+            const double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - before).count();
+            samples[static_cast<size_t>(operation)].push_back(elapsed);
+            all.push_back(elapsed);
+        }
+        const double totalNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+        ReplayReport report;
+        report.events = trace_.events.size();
+        report.totalMs = totalNs / 1e6;
+        report.eventsPerSecond = totalNs > 0 ? static_cast<double>(report.events) * 1e9 / totalNs : 0.0;
+        report.operations.push_back(summarize("all", all));
+        for (size_t i = 0; i < static_cast<size_t>(Operation::Count); ++i) {
+            if (samples[i].empty()) continue;
+            report.operations.push_back(summarize(operationName(static_cast<Operation>(i)), samples[i]));
+        }
+
+        report.finalLines = buffer_.getLineCount();
+        report.finalBytes = buffer_.getTotalCharacters() + (report.finalLines > 0 ? report.finalLines - 1 : 0);
+        report.finalHash = hashText(buffer_);
+        if (trace_.hasExpectedText) {
+            report.checkedExpected = true;
+            report.matchedExpected = buffer_.toString() == trace_.expectedText;
+        }
+        return report;
+    }
+
+    TraceReplayer::Operation TraceReplayer::apply(const TraceEvent& event) {
+        // Cualquier otro evento puede editar: la línea cacheada ya no vale
+        if (event.type != TraceEventType::Splice) {
+            spliceLine_ = 0;
+            spliceLineStart_ = 0;
+        }
+
+        switch (event.type) {
+            case TraceEventType::Key:
+                return applyKey(event);
+
+            case TraceEventType::Text: {
+                // Los caracteres de control llegan también como Key
+                if (event.codepoint < 32 || event.codepoint == 127) return Operation::Ignored;
+                deleteSelection();
+                edit(cursor_.line, cursor_.column, cursor_.line, cursor_.column, encodeUtf8(event.codepoint),
+                     OperationType::Insert);
+                return Operation::Type;
+            }
+
+            case TraceEventType::Paste:
+                if (event.text.empty()) return Operation::Ignored;
+                deleteSelection();
+                edit(cursor_.line, cursor_.column, cursor_.line, cursor_.column, event.text, OperationType::Insert);
+                return Operation::Paste;
+
+            case TraceEventType::MousePress: {
+                if (event.button != 0) return Operation::Ignored;
+                auto position = viewport_.screenToTextPosition(event.x, event.y, buffer_);
+                cursor_ = CursorPosition(position.first, position.second);
+                clampCursor();
+                anchor_ = cursor_;
+                selecting_ = false;
+                mouseDown_ = true;
+                return Operation::Mouse;
+            }
+
+            case TraceEventType::MouseMove: {
+                if (!mouseDown_) return Operation::Ignored;
+                auto position = viewport_.screenToTextPosition(event.x, event.y, buffer_);
+                cursor_ = CursorPosition(position.first, position.second);
+                clampCursor();
+                selecting_ = cursor_ != anchor_;
+                return Operation::Select;
+            }
+
+            case TraceEventType::MouseRelease:
+                mouseDown_ = false;
+                return Operation::Mouse;
+
+            case TraceEventType::Scroll: {
+                const int lines = static_cast<int>(std::lround(-event.delta * SCROLL_LINES_PER_NOTCH));
+                if (event.horizontal) {
+                    viewport_.scrollHorizontal(lines);
+                } else {
+                    viewport_.scrollVertical(lines);
+                }
+                return Operation::Scroll;
+            }
+
+            case TraceEventType::Resize:
+                viewport_.setWindowSize(event.width, event.height);
+                return Operation::Resize;
+
+            case TraceEventType::Splice:
+            default:
+                return applySplice(event);
+        }
+    }
+
+    TraceReplayer::Operation TraceReplayer::applyKey(const TraceEvent& event) {
+        const bool command = event.hasModifier(TRACE_CTRL) || event.hasModifier(TRACE_SYSTEM);
+        const bool shift = event.hasModifier(TRACE_SHIFT);
+
+        // Flechas con Shift extienden la selección
+        auto beginMove = [this, shift]() {
+            if (shift && !selecting_) {
+                anchor_ = cursor_;
+                selecting_ = true;
+            } else if (!shift) {
+                selecting_ = false;
+            }
+        };
+
+        switch (event.key) {
+            case TraceKey::Enter:
+                deleteSelection();
+                edit(cursor_.line, cursor_.column, cursor_.line, cursor_.column, "\n", OperationType::Insert);
+                return Operation::Newline;
+
+            case TraceKey::Tab:
+                deleteSelection();
+                edit(cursor_.line, cursor_.column, cursor_.line, cursor_.column, "    ", OperationType::Insert);
+                return Operation::Type;
+
+            case TraceKey::Backspace:
+                if (deleteSelection()) return Operation::Delete;
+                if (cursor_.column > 0) {
+                    edit(cursor_.line, cursor_.column - 1, cursor_.line, cursor_.column, "", OperationType::Delete);
+                } else if (cursor_.line > 0) {
+                    const size_t previous = cursor_.line - 1;
+                    edit(previous, buffer_.getLineLength(previous), cursor_.line, 0, "", OperationType::Delete);
+                }
+                return Operation::Delete;
+
+            case TraceKey::Delete:
+                if (deleteSelection()) return Operation::Delete;
+                if (cursor_.column < buffer_.getLineLength(cursor_.line)) {
+                    edit(cursor_.line, cursor_.column, cursor_.line, cursor_.column + 1, "", OperationType::Delete);
+                } else if (cursor_.line + 1 < buffer_.getLineCount()) {
+                    edit(cursor_.line, cursor_.column, cursor_.line + 1, 0, "", OperationType::Delete);
+                }
+                return Operation::Delete;
+
+            case TraceKey::Left:
+                beginMove();
+                if (command) cursor_.column = 0;
+                else if (cursor_.column > 0) --cursor_.column;
+                return shift ? Operation::Select : Operation::Navigate;
+
+            case TraceKey::Right:
+                beginMove();
+                if (command) cursor_.column = buffer_.getLineLength(cursor_.line);
+                else if (cursor_.column < buffer_.getLineLength(cursor_.line)) ++cursor_.column;
+                return shift ? Operation::Select : Operation::Navigate;
+
+            case TraceKey::Up:
+                beginMove();
+                if (cursor_.line > 0) --cursor_.line;
+                clampCursor();
+                return shift ? Operation::Select : Operation::Navigate;
+
+            case TraceKey::Down:
+                beginMove();
+                if (cursor_.line + 1 < buffer_.getLineCount()) ++cursor_.line;
+                clampCursor();
+                return shift ? Operation::Select : Operation::Navigate;
+
+            case TraceKey::Home:
+                beginMove();
+                cursor_.column = 0;
+                return Operation::Navigate;
+
+            case TraceKey::End:
+                beginMove();
+                cursor_.column = buffer_.getLineLength(cursor_.line);
+                return Operation::Navigate;
+
+            case TraceKey::PageUp:
+                selecting_ = false;
+                viewport_.pageUp();
+                cursor_ = CursorPosition(viewport_.getFirstVisibleLine(), 0);
+                clampCursor();
+                return Operation::Navigate;
+
+            case TraceKey::PageDown:
+                selecting_ = false;
+                viewport_.pageDown(buffer_.getLineCount());
+                cursor_ = CursorPosition(viewport_.getLastVisibleLine(buffer_.getLineCount()), 0);
+                clampCursor();
+                return Operation::Navigate;
+
+            case TraceKey::A:
+                if (!command) return Operation::Ignored;
+                anchor_ = CursorPosition(0, 0);
+                cursor_ = CursorPosition(buffer_.getLineCount() - 1,
+                                         buffer_.getLineLength(buffer_.getLineCount() - 1));
+                selecting_ = true;
+                return Operation::Select;
+
+            case TraceKey::C:
+                if (!command || !selecting_) return Operation::Ignored;
+                clipboard_ = selectedText();
+                return Operation::Copy;
+
+            case TraceKey::X:
+                if (!command || !selecting_) return Operation::Ignored;
+                clipboard_ = selectedText();
+                deleteSelection();
+                return Operation::Cut;
+
+            case TraceKey::Z:
+                if (!command) return Operation::Ignored;
+                selecting_ = false;
+                if (shift) {
+                    history_.redo(buffer_, cursor_);
+                    clampCursor();
+                    return Operation::Redo;
+                }
+                history_.undo(buffer_, cursor_);
+                clampCursor();
+                return Operation::Undo;
+
+            case TraceKey::Y:
+                if (!command) return Operation::Ignored;
+                selecting_ = false;
+                history_.redo(buffer_, cursor_);
+                clampCursor();
+                return Operation::Redo;
+
+            case TraceKey::Escape:
+                selecting_ = false;
+                return Operation::Navigate;
+
+            case TraceKey::D:
+            case TraceKey::F:
+            case TraceKey::S:
+            case TraceKey::V:   // El pegado llega como Paste, con su texto
+            case TraceKey::Unknown:
+            default:
+                return Operation::Ignored;
+        }
+    }
+
+    TraceReplayer::Operation TraceReplayer::applySplice(const TraceEvent& event) {
+        const CursorPosition start = locate(event.position);
+        const CursorPosition end = event.deleteCount > 0 ? advance(start, event.deleteCount) : start;
+
+        selecting_ = false;
+        const TextEdit change{start.line, start.column, end.line, end.column, event.text};
+        const CursorPosition before = cursor_;
+        history_.recordEdits(buffer_.applyEdits({change}), before, OperationType::Replace, "Splice");
+        cursor_ = advance(start, countCodepoints(event.text));
+        return Operation::Splice;
+    }
+
+    // ========================================================================
+    // Edición
+    // ========================================================================
+
+    void TraceReplayer::edit(size_t line, size_t col, size_t endLine, size_t endCol, const std::string& text,
+                             OperationType operation) {
+        const CursorPosition before = cursor_;
+        const TextEdit change{line, col, endLine, endCol, text};
+        history_.recordEdits(buffer_.applyEdits({change}), before, operation,
+                             operation == OperationType::Delete ? "Borrar" : "Escribir");
+
+        // Cursor al final del texto insertado
+        const size_t newline = text.rfind('\n');
+        if (newline == std::string::npos) {
+            cursor_ = CursorPosition(line, col + text.size());
+        } else {
+            size_t lines = 0;
+            for (char ch : text) {
+                if (ch == '\n') ++lines;
+            }
+            cursor_ = CursorPosition(line + lines, text.size() - newline - 1);
+        }
+    }
+
+    bool TraceReplayer::deleteSelection() {
+        if (!selecting_ || cursor_ == anchor_) {
+            selecting_ = false;
+            return false;
+        }
+        CursorPosition start = anchor_;
+        CursorPosition end = cursor_;
+        if (isBefore(end, start)) std::swap(start, end);
+        cursor_ = start;
+        selecting_ = false;
+        edit(start.line, start.column, end.line, end.column, "", OperationType::Delete);
+        return true;
+    }
+
+    std::string TraceReplayer::selectedText() const {
+        CursorPosition start = anchor_;
+        CursorPosition end = cursor_;
+        if (isBefore(end, start)) std::swap(start, end);
+        return buffer_.getText(start.line, start.column, end.line, end.column);
+    }
+
+    void TraceReplayer::clampCursor() {
+        auto clamped = buffer_.clampPosition(cursor_.line, cursor_.column);
+        cursor_ = CursorPosition(clamped.first, clamped.second);
+    }
+
+    // ========================================================================
+    // Posiciones absolutas (en codepoints, como las trazas publicadas)
+    // ========================================================================
+
+    CursorPosition TraceReplayer::locate(uint64_t offset) {
+        // Las ediciones de una traza son locales: se parte de la última línea
+        // resuelta. Sigue siendo válida tras una edición que empieza en ella.
+        const size_t lineCount = buffer_.getLineCount();
+        if (spliceLine_ >= lineCount) {
+            spliceLine_ = 0;
+            spliceLineStart_ = 0;
+        }
+        while (spliceLine_ > 0 && offset < spliceLineStart_) {
+            --spliceLine_;
+            spliceLineStart_ -= countCodepoints(buffer_.getLine(spliceLine_)) + 1;
+        }
+        while (true) {
+            const uint64_t length = countCodepoints(buffer_.getLine(spliceLine_));
+            if (offset <= spliceLineStart_ + length || spliceLine_ + 1 >= lineCount) break;
+            spliceLineStart_ += length + 1;
+            ++spliceLine_;
+        }
+        const std::string& line = buffer_.getLine(spliceLine_);
+        return CursorPosition(spliceLine_, byteColumn(line, offset - spliceLineStart_));
+    }
+
+    CursorPosition TraceReplayer::advance(CursorPosition from, uint64_t codepoints) const {
+        const size_t lineCount = buffer_.getLineCount();
+        while (true) {
+            const std::string& line = buffer_.getLine(from.line);
+            size_t byte = from.column;
+            while (byte < line.size()) {
+                if (!isContinuationByte(line[byte])) {
+                    if (codepoints == 0) return CursorPosition(from.line, byte);
+                    --codepoints;
+                }
+                ++byte;
+            }
+            if (codepoints == 0 || from.line + 1 >= lineCount) return CursorPosition(from.line, line.size());
+            --codepoints;   // El salto de línea cuenta uno
+            from = CursorPosition(from.line + 1, 0);
+        }
+    }
+
+    const char* TraceReplayer::operationName(Operation operation) {
+        switch (operation) {
+            case Operation::Type: return "type";
+            case Operation::Newline: return "newline";
+            case Operation::Delete: return "delete";
+            case Operation::Navigate: return "navigate";
+            case Operation::Select: return "select";
+            case Operation::Copy: return "copy";
+            case Operation::Cut: return "cut";
+            case Operation::Paste: return "paste";
+            case Operation::Undo: return "undo";
+            case Operation::Redo: return "redo";
+            case Operation::Mouse: return "mouse";
+            case Operation::Scroll: return "scroll";
+            case Operation::Resize: return "resize";
+            case Operation::Splice: return "splice";
+            case Operation::Ignored:
+            case Operation::Count:
+            default: return "ignored";
+        }
+    }
+
+    // ========================================================================
+    // Informe
+    // ========================================================================
+
+    void ReplayReport::print(std::ostream& out) const {
+        out << "Eventos: " << events << "  Total: " << std::fixed << std::setprecision(2) << totalMs << " ms  ("
+            << std::setprecision(0) << eventsPerSecond << " eventos/s)\n";
+        out << std::left << std::setw(12) << "operación" << std::right << std::setw(10) << "n" << std::setw(12)
+            << "p50 us" << std::setw(12) << "p99 us" << std::setw(12) << "max us" << "\n";
+        for (const ReplayOperationStats& stats : operations) {
+            out << std::left << std::setw(12) << stats.name << std::right << std::setw(10) << stats.count
+                << std::setprecision(2) << std::setw(12) << stats.p50Ns / 1e3 << std::setw(12) << stats.p99Ns / 1e3
+                << std::setw(12) << stats.maxNs / 1e3 << "\n";
+        }
+        out << "Resultado: " << finalLines << " líneas, " << finalBytes << " bytes, hash " << std::hex << finalHash
+            << std::dec;
+        if (checkedExpected) out << (matchedExpected ? "  (coincide con endContent)" : "  (NO coincide con endContent)");
+        out << std::endl;
+    }
+
+    void ReplayReport::writeJson(std::ostream& out, const std::string& traceName) const {
+        std::string name;
+        for (char ch : traceName) {
+            if (ch == '"' || ch == '\\') name += '\\';
+            name += ch;
+        }
+
+        out << std::setprecision(17) << "{\n  \"trace\": \"" << name << "\",\n  \"events\": " << events
+            << ",\n  \"total_ms\": " << totalMs << ",\n  \"events_per_second\": " << eventsPerSecond
+            << ",\n  \"final_lines\": " << finalLines << ",\n  \"final_bytes\": " << finalBytes
+            << ",\n  \"final_hash\": \"" << std::hex << finalHash << std::dec << "\""
+            << ",\n  \"matched_expected\": " << (checkedExpected ? (matchedExpected ? "true" : "false") : "null")
+            << ",\n  \"operations\": [";
+        for (size_t i = 0; i < operations.size(); ++i) {
+            const ReplayOperationStats& stats = operations[i];
+            out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << stats.name << "\", \"count\": " << stats.count
+                << ", \"p50_ns\": " << stats.p50Ns << ", \"p99_ns\": " << stats.p99Ns << ", \"max_ns\": "
+                << stats.maxNs << ", \"mean_ns\": " << stats.meanNs << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+} // namespace CoralCode
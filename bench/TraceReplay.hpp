@@ -0,0 +1,120 @@
+#pragma once
+
+#include "EditTrace.hpp"
+#include "Editor.hpp"
+#include "IncrementalParser.hpp"
+#include "SyntaxHighlighter.hpp"
+#include "TextBuffer.hpp"
+#include "UndoRedoManager.hpp"
+#include "Viewport.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Latencias de un tipo de operación durante la reproducción
+     */
+    struct ReplayOperationStats {
+        std::string name;       // "type", "delete", "paste", "undo", "splice"...
+        size_t count = 0;
+        double p50Ns = 0.0;
+        double p99Ns = 0.0;
+        double maxNs = 0.0;
+        double meanNs = 0.0;
+    };
+
+    /**
+     * @brief Resultado de reproducir una traza completa
+     */
+    struct ReplayReport {
+        size_t events = 0;
+        double totalMs = 0.0;
+        double eventsPerSecond = 0.0;
+        std::vector<ReplayOperationStats> operations;   // "all" primero
+        size_t finalLines = 0;
+        size_t finalBytes = 0;
+        uint64_t finalHash = 0;     // FNV-1a del texto final
+        bool checkedExpected = false;
+        bool matchedExpected = false;
+
+        void print(std::ostream& out) const;
+        void writeJson(std::ostream& out, const std::string& traceName) const;
+    };
+
+    /**
+     * @brief Reproduce una traza contra el núcleo del editor, sin ventana
+     *
+     * Responsable de:
+     * - Aplicar cada evento con la misma semántica que la ventana (teclas,
+     *   selección, portapapeles, ratón y scroll) sobre TextBuffer,
+     *   UndoRedoManager, IncrementalParser y Viewport
+     * - Ignorar los tiempos grabados: los eventos se aplican seguidos
+     * - Medir cada evento, incluido el re-análisis y el ajuste de scroll
+     *   que el frame siguiente necesitaría
+     * - Comprobar el texto final si la traza lo incluye
+     */
+    class TraceReplayer {
+    public:
+        explicit TraceReplayer(const EditTrace& trace, bool incrementalParsing = true);
+        ~TraceReplayer();
+
+        TraceReplayer(const TraceReplayer&) = delete;
+        TraceReplayer& operator=(const TraceReplayer&) = delete;
+
+        ReplayReport run();
+
+        const TextBuffer& getBuffer() const { return buffer_; }
+
+        // Métricas de la ventana grabada (las de coralcode.cpp)
+        static constexpr float CHAR_WIDTH = 9.6f;
+        static constexpr float LINE_HEIGHT = 24.0f;
+        static constexpr float LINE_NUMBER_WIDTH = 60.0f;
+        static constexpr float STATUS_BAR_HEIGHT = 25.0f;
+        static constexpr float SCROLL_BAR_WIDTH = 15.0f;
+        static constexpr int SCROLL_LINES_PER_NOTCH = 3;
+
+    private:
+        enum class Operation {
+            Type, Newline, Delete, Navigate, Select, Copy, Cut, Paste,
+            Undo, Redo, Mouse, Scroll, Resize, Splice, Ignored, Count
+        };
+
+        const EditTrace& trace_;
+        TextBuffer buffer_;
+        UndoRedoManager history_;
+        SyntaxHighlighter highlighter_;
+        IncrementalParser parser_;
+        Viewport viewport_;
+        bool incrementalParsing_;
+
+        // Estado de edición
+        CursorPosition cursor_;
+        CursorPosition anchor_;
+        bool selecting_;
+        bool mouseDown_;
+        std::string clipboard_;
+
+        // Conversión de posiciones absolutas (Splice): última línea resuelta
+        size_t spliceLine_;
+        uint64_t spliceLineStart_;
+
+        Operation apply(const TraceEvent& event);
+        Operation applyKey(const TraceEvent& event);
+        Operation applySplice(const TraceEvent& event);
+
+        void edit(size_t line, size_t col, size_t endLine, size_t endCol, const std::string& text,
+                  OperationType operation);
+        bool deleteSelection();
+        std::string selectedText() const;
+        void clampCursor();
+        CursorPosition locate(uint64_t codepointOffset);
+        CursorPosition advance(CursorPosition from, uint64_t codepoints) const;
+
+        static const char* operationName(Operation operation);
+    };
+
+} // namespace CoralCode
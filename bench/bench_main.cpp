@@ -0,0 +1,243 @@
+/**
+ * @file bench_main.cpp
+ * @brief Punto de entrada de coralcode_bench (sin ventana ni SFML)
+ *
+ * Uso:
+ *   coralcode_bench [--filter texto] [--corpus ruta] [--out resultados.json]
+ *                   [--min-time ms] [--repetitions n] [--list]
+ *   coralcode_bench --check-io
+ */
+
+#include "AsyncFileIO.hpp"
+#include "BenchmarkRunner.hpp"
+#include "CoreBenchmarks.hpp"
+#include "Corpus.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifndef CORALCODE_VERSION
+#define CORALCODE_VERSION "desconocida"
+#endif
+
+#ifndef CORALCODE_BUILD_TYPE
+#define CORALCODE_BUILD_TYPE "desconocido"
+#endif
+
+namespace {
+
+    struct BenchOptions {
+        std::string filter;
+        std::string corpusPath;
+        std::string outputPath;
+        double minTimeMs = 50.0;
+        size_t repetitions = 5;
+        bool listOnly = false;
+        bool checkIo = false;
+    };
+
+    void printUsage() {
+        std::cout << "Uso: coralcode_bench [opciones]\n"
+                  << "  --filter <texto>     Solo benchmarks cuyo nombre contenga el texto\n"
+                  << "  --corpus <ruta>      Añade un archivo o directorio real como documento\n"
+                  << "  --out <archivo>      Escribe los resultados en JSON\n"
+                  << "  --min-time <ms>      Duración mínima de cada medición (50)\n"
+                  << "  --repetitions <n>    Mediciones por benchmark (5)\n"
+                  << "  --list               Lista los benchmarks sin ejecutarlos\n"
+                  << "  --check-io           Comprueba guardados simultáneos de un mismo archivo\n";
+    }
+
+    bool parseArguments(int argc, char* argv[], BenchOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if (argument == "--filter" && hasValue) {
+                options.filter = argv[++i];
+            } else if (argument == "--corpus" && hasValue) {
+                options.corpusPath = argv[++i];
+            } else if (argument == "--out" && hasValue) {
+                options.outputPath = argv[++i];
+            } else if (argument == "--min-time" && hasValue) {
+                options.minTimeMs = std::atof(argv[++i]);
+            } else if (argument == "--repetitions" && hasValue) {
+                options.repetitions = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (argument == "--list") {
+                options.listOnly = true;
+            } else if (argument == "--check-io") {
+                options.checkIo = true;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string compilerName() {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc " + std::to_string(_MSC_VER);
+#else
+        return "desconocido";
+#endif
+    }
+
+    std::string utcTimestamp() {
+        std::time_t now = std::time(nullptr);
+        std::tm utc{};
+#ifdef _WIN32
+        gmtime_s(&utc, &now);
+#else
+        gmtime_r(&now, &utc);
+#endif
+        char text[32];
+        std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &utc);
+        return text;
+    }
+
+    // ========================================================================
+    // Guardados simultáneos (--check-io)
+    // ========================================================================
+    //
+    // Varias escrituras en vuelo sobre la misma ruta, con y sin io_uring.
+    // Cada una tiene su propio temporal: todas deben terminar bien, el
+    // archivo debe quedar entero con el contenido de una de ellas y no debe
+    // quedar ningún temporal en el directorio.
+
+    constexpr size_t CHECK_IO_ROUNDS = 100;
+    constexpr size_t CHECK_IO_WRITERS = 4;
+
+    bool checkConcurrentWrites(CoralCode::AsyncFileIO& io, const std::filesystem::path& directory) {
+        const std::string path = (directory / "same-path.txt").string();
+        std::vector<std::string> contents;
+        for (size_t writer = 0; writer < CHECK_IO_WRITERS; ++writer) {
+            contents.emplace_back(100000 + writer * 25000, static_cast<char>('a' + writer));
+        }
+
+        size_t failures = 0;
+        bool reported = false;
+        for (size_t round = 0; round < CHECK_IO_ROUNDS; ++round) {
+            std::vector<std::future<CoralCode::FileWriteResult>> writes;
+            for (const std::string& content : contents) {
+                writes.push_back(io.write(path, content));
+            }
+            bool success = true;
+            for (auto& write : writes) {
+                CoralCode::FileWriteResult result = write.get();
+                if (!result.success) {
+                    if (!reported) std::cerr << "  " << result.error << "\n";
+                    reported = true;
+                    success = false;
+                }
+            }
+
+            std::ifstream in(path, std::ios::binary);
+            std::ostringstream saved;
+            saved << in.rdbuf();
+            if (std::find(contents.begin(), contents.end(), saved.str()) == contents.end()) success = false;
+            if (!success) ++failures;
+        }
+
+        size_t leftovers = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            if (entry.path().filename() != "same-path.txt") ++leftovers;
+        }
+
+        std::cout << io.getBackendName() << ": " << CHECK_IO_ROUNDS - failures << "/" << CHECK_IO_ROUNDS
+                  << " rondas correctas, " << leftovers << " temporales sobrantes\n";
+        return failures == 0 && leftovers == 0;
+    }
+
+    int runWriteCheck() {
+        std::error_code code;
+        const std::filesystem::path directory = std::filesystem::temp_directory_path(code) / "coralcode_check_io";
+        std::filesystem::remove_all(directory, code);
+        if (!std::filesystem::create_directories(directory, code)) {
+            std::cerr << "No se pudo crear " << directory.string() << std::endl;
+            return 1;
+        }
+
+        bool passed = true;
+        for (bool allowIoUring : {true, false}) {
+            CoralCode::AsyncFileIO io(allowIoUring);
+            passed = checkConcurrentWrites(io, directory) && passed;
+        }
+        std::filesystem::remove_all(directory, code);
+        return passed ? 0 : 1;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace CoralCode;
+
+    BenchOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+    if (options.checkIo) {
+        return runWriteCheck();
+    }
+
+    // Documentos: tamaños sintéticos fijos y, opcionalmente, un corpus real
+    std::vector<BenchDocument> documents;
+    documents.push_back(Corpus::synthetic("1k", 1000));
+    documents.push_back(Corpus::synthetic("100k", 100000));
+    if (!options.corpusPath.empty()) {
+        BenchDocument corpus;
+        std::string error;
+        if (!Corpus::load(options.corpusPath, corpus, error)) {
+            std::cerr << "Error cargando el corpus: " << error << std::endl;
+            return 1;
+        }
+        documents.push_back(std::move(corpus));
+    }
+
+    BenchmarkRunner runner;
+    runner.setFilter(options.filter);
+    runner.setMinTime(options.minTimeMs);
+    runner.setRepetitions(options.repetitions);
+    registerCoreBenchmarks(runner, documents);
+
+    if (options.listOnly) {
+        for (const std::string& name : runner.list()) {
+            std::cout << name << "\n";
+        }
+        return 0;
+    }
+
+    std::map<std::string, std::string> context;
+    context["version"] = CORALCODE_VERSION;
+    context["build_type"] = CORALCODE_BUILD_TYPE;
+    context["compiler"] = compilerName();
+    context["timestamp"] = utcTimestamp();
+    context["cpus"] = std::to_string(std::thread::hardware_concurrency());
+    context["corpus"] = options.corpusPath;
+    for (const BenchDocument& document : documents) {
+        context["document_" + document.name] =
+            std::to_string(document.lines.size()) + " lines, " + std::to_string(document.bytes) + " bytes";
+    }
+    documents.clear();
+
+    std::vector<BenchmarkResult> results = runner.run(&std::cout);
+
+    if (!options.outputPath.empty()) {
+        std::ofstream out(options.outputPath);
+        if (!out) {
+            std::cerr << "No se pudo escribir " << options.outputPath << std::endl;
+            return 1;
+        }
+        BenchmarkRunner::writeJson(out, context, results);
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file replay_main.cpp
+ * @brief Punto de entrada de coralcode_replay (sin ventana ni SFML)
+ *
+ * Uso:
+ *   coralcode_replay <traza.cctrace | traza.json> [--repeat n] [--no-parser]
+ *                    [--out informe.json] [--convert salida.cctrace]
+ *
+ * Las trazas .json son las publicadas para comparar editores ({"startContent",
+ * "endContent", "txns"}); deben estar descomprimidas.
+ */
+
+#include "EditTrace.hpp"
+#include "FileHandler.hpp"
+#include "TraceReplay.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+    struct ReplayOptions {
+        std::string tracePath;
+        std::string outputPath;
+        std::string convertPath;
+        size_t repeat = 1;
+        bool incrementalParsing = true;
+    };
+
+    void printUsage() {
+        std::cout << "Uso: coralcode_replay <traza> [opciones]\n"
+                  << "  --repeat <n>          Reproduce la traza n veces (se informa la última)\n"
+                  << "  --no-parser           Sin análisis incremental tras cada evento\n"
+                  << "  --out <archivo>       Escribe el informe en JSON\n"
+                  << "  --convert <archivo>   Guarda la traza en formato .cctrace y termina\n";
+    }
+
+    bool parseArguments(int argc, char* argv[], ReplayOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if (argument == "--repeat" && hasValue) {
+                options.repeat = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+            } else if (argument == "--no-parser") {
+                options.incrementalParsing = false;
+            } else if (argument == "--out" && hasValue) {
+                options.outputPath = argv[++i];
+            } else if (argument == "--convert" && hasValue) {
+                options.convertPath = argv[++i];
+            } else if (options.tracePath.empty() && argument.rfind("--", 0) != 0) {
+                options.tracePath = argument;
+            } else {
+                return false;
+            }
+        }
+        return !options.tracePath.empty();
+    }
+
+    bool loadTrace(const std::string& path, CoralCode::EditTrace& trace, std::string& error) {
+        CoralCode::FileHandler files;
+        std::string data;
+        if (!files.readFile(path, data)) {
+            error = files.getLastError();
+            return false;
+        }
+        const size_t first = data.find_first_not_of(" \t\r\n");
+        if (first != std::string::npos && data[first] == '{') {
+            return trace.parseEditingTrace(data, error);
+        }
+        return trace.deserialize(data, error);
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace CoralCode;
+
+    ReplayOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    EditTrace trace;
+    std::string error;
+    if (!loadTrace(options.tracePath, trace, error)) {
+        std::cerr << "Error cargando la traza: " << error << std::endl;
+        return 1;
+    }
+
+    if (!options.convertPath.empty()) {
+        if (!trace.save(options.convertPath, error)) {
+            std::cerr << "Error guardando la traza: " << error << std::endl;
+            return 1;
+        }
+        std::cout << trace.events.size() << " eventos guardados en " << options.convertPath << std::endl;
+        return 0;
+    }
+
+    // Cada repetición parte del documento inicial; la primera calienta cachés
+    ReplayReport report;
+    for (size_t run = 0; run < options.repeat; ++run) {
+        TraceReplayer replayer(trace, options.incrementalParsing);
+        report = replayer.run();
+    }
+    report.print(std::cout);
+
+    if (!options.outputPath.empty()) {
+        std::ofstream out(options.outputPath);
+        if (!out) {
+            std::cerr << "No se pudo escribir " << options.outputPath << std::endl;
+            return 1;
+        }
+        report.writeJson(out, options.tracePath);
+    }
+    return report.checkedExpected && !report.matchedExpected ? 3 : 0;
+}
@@ -3,11 +3,26 @@
 #include <string>
 #include <vector>
 #include <set>
-#include <sstream>
 #include <algorithm>
 #include <iomanip>
 #include <cstring>
-#include <deque>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cctype>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <array>
+#include "FrameProfiler.hpp"
+#include "LatencyTracer.hpp"
+#include "MemoryUsage.hpp"
+#include "AllocationTracker.hpp"
+#include "TextLayout.hpp"
+#include "Renderer.hpp"
+#include "SfmlRenderer.hpp"
 
 // Función para verificar si una palabra es reservada
 bool isKeyword(const std::string& word) {
@@ -39,82 +54,128 @@ sf::Color getWordColor(const std::string& word) {
     return sf::Color(255, 255, 255); // Blanco para texto normal
 }
 
-// Función para procesar una línea y obtener palabras con colores
-std::vector<std::pair<std::string, sf::Color>> processLine(const std::string& line) {
-    std::vector<std::pair<std::string, sf::Color>> result;
-    std::string currentWord;
-    
-    for (size_t i = 0; i < line.length(); ++i) {
-        char c = line[i];
-        
-        // Verificar si es un comentario
-        if (c == '/' && i + 1 < line.length() && line[i + 1] == '/') {
-            // Si tenemos una palabra pendiente, agregarla
-            if (!currentWord.empty()) {
-                result.push_back({currentWord, getWordColor(currentWord)});
-                currentWord.clear();
-            }
-            // Agregar el resto de la línea como comentario
-            std::string comment = line.substr(i);
-            result.push_back({comment, sf::Color(100, 200, 100)}); // Verde para comentarios
-            break;
+// Token coloreado de una línea visible
+using ColoredToken = std::pair<std::string, sf::Color>;
+
+// Estado del lexer en una posición de la línea. Un token que empieza antes
+// (palabra, string o comentario) sigue abierto desde tokenStart
+enum class LexMode : uint8_t { Normal, Word, String, Comment };
+
+struct LexState {
+    LexMode mode = LexMode::Normal;
+    size_t tokenStart = 0;
+};
+
+// Las palabras más largas no pueden ser reservadas: no se copian para mirarlas
+const size_t MAX_KEYWORD_LENGTH = 16;
+
+bool isWordByte(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Avanza el lexer por [begin, end) llamando a emit(inicio, fin, modo) con
+// cada token que termina dentro; al volver, state es el estado en end. Un
+// comentario llega hasta el final de la línea: no hace falta recorrerlo
+template <typename Emit>
+void lexRange(const std::string& line, size_t begin, size_t end, LexState& state, Emit&& emit) {
+    for (size_t i = begin; i < end; ++i) {
+        const char c = line[i];
+        if (state.mode == LexMode::Comment) {
+            return;
         }
-        
-        // Verificar si es un string
-        if (c == '"') {
-            // Si tenemos una palabra pendiente, agregarla
-            if (!currentWord.empty()) {
-                result.push_back({currentWord, getWordColor(currentWord)});
-                currentWord.clear();
-            }
-            
-            // Buscar el final del string
-            std::string stringLiteral = "\"";
-            bool foundClosing = false;
-            size_t j;
-            for (j = i + 1; j < line.length(); ++j) {
-                stringLiteral += line[j];
-                if (line[j] == '"' && (j == 0 || line[j-1] != '\\')) {
-                    foundClosing = true;
-                    i = j;
-                    break;
-                }
-            }
-            
-            // Si no encontramos comilla de cierre, solo tomar el resto de la línea
-            if (!foundClosing) {
-                stringLiteral = line.substr(i); // Tomar desde la comilla hasta el final
-                i = line.length() - 1; // Mover el índice al final
+        if (state.mode == LexMode::String) {
+            // Cierra la primera comilla no escapada (si no hay, hasta el final de la línea)
+            if (c == '"' && i > state.tokenStart && line[i - 1] != '\\') {
+                emit(state.tokenStart, i + 1, LexMode::String);
+                state.mode = LexMode::Normal;
             }
-            
-            result.push_back({stringLiteral, sf::Color(255, 200, 100)}); // Naranja para strings
             continue;
         }
+        if (state.mode == LexMode::Word) {
+            if (isWordByte(c)) continue;
+            emit(state.tokenStart, i, LexMode::Word);
+            state.mode = LexMode::Normal;
+        }
         
-        // Si es letra, número o underscore, es parte de una palabra
-        if (std::isalnum(c) || c == '_') {
-            currentWord += c;
+        if (c == '/' && i + 1 < line.length() && line[i + 1] == '/') {
+            state = LexState{LexMode::Comment, i};
+            return;
+        }
+        if (c == '"') {
+            state = LexState{LexMode::String, i};
+        } else if (isWordByte(c)) {
+            state = LexState{LexMode::Word, i};
         } else {
-            // Si tenemos una palabra, procesarla
-            if (!currentWord.empty()) {
-                result.push_back({currentWord, getWordColor(currentWord)});
-                currentWord.clear();
-            }
-            // Agregar el carácter especial
-            if (c != ' ' && c != '\t') {
-                result.push_back({std::string(1, c), sf::Color(255, 255, 255)});
-            } else {
-                result.push_back({std::string(1, c), sf::Color(255, 255, 255)});
-            }
+            // Carácter especial (espacios incluidos)
+            emit(i, i + 1, LexMode::Normal);
         }
     }
+}
+
+// Estado del lexer en offset recorriendo desde state, tomado en start
+LexState lexStateAt(const std::string& line, size_t start, size_t offset, LexState state) {
+    lexRange(line, start, offset, state, [](size_t, size_t, LexMode) {});
+    return state;
+}
+
+// Colorea los bytes [from, to) de line partiendo del estado del lexer en
+// from y deja los tokens en result, reusando sus strings: con capacidad
+// suficiente no asigna memoria. Los tokens que cruzan from o to se
+// recortan (una palabra reservada se reconoce entera). Devuelve cuántos
+// tokens escribió (result no se encoge para conservar esa capacidad).
+size_t processLine(const std::string& line, size_t from, size_t to, LexState state,
+                   std::vector<ColoredToken>& result) {
+    size_t count = 0;
+    auto emit = [&](size_t begin, size_t end, LexMode mode) {
+        if (count == result.size()) {
+            result.emplace_back();
+        }
+        ColoredToken& token = result[count++];
+        
+        const size_t visibleBegin = std::max(begin, from);
+        const size_t visibleEnd = std::min(end, to);
+        token.first.assign(line, visibleBegin, visibleEnd - visibleBegin);
+        switch (mode) {
+            case LexMode::Word:
+                if (end - begin > MAX_KEYWORD_LENGTH) {
+                    token.second = sf::Color(255, 255, 255);
+                } else if (visibleBegin == begin && visibleEnd == end) {
+                    token.second = getWordColor(token.first);
+                } else {
+                    // Palabra recortada: se colorea entera
+                    token.first.assign(line, begin, end - begin);
+                    token.second = getWordColor(token.first);
+                    token.first.assign(line, visibleBegin, visibleEnd - visibleBegin);
+                }
+                break;
+            case LexMode::String:
+                token.second = sf::Color(255, 200, 100); // Naranja para strings
+                break;
+            case LexMode::Comment:
+                token.second = sf::Color(100, 200, 100); // Verde para comentarios
+                break;
+            default:
+                token.second = sf::Color(255, 255, 255);
+                break;
+        }
+    };
     
-    // Agregar última palabra si existe
-    if (!currentWord.empty()) {
-        result.push_back({currentWord, getWordColor(currentWord)});
-    }
+    lexRange(line, from, to, state, emit);
     
-    return result;
+    // Token abierto en to: se emite recortado
+    if (from == to) {
+        return count;
+    }
+    if (state.mode == LexMode::Word) {
+        size_t end = to;
+        while (end < line.length() && end - state.tokenStart <= MAX_KEYWORD_LENGTH && isWordByte(line[end])) {
+            ++end;
+        }
+        emit(state.tokenStart, end, LexMode::Word);
+    } else if (state.mode != LexMode::Normal) {
+        emit(state.tokenStart, to, state.mode);
+    }
+    return count;
 }
 
 // Funciones de clipboard real para macOS
@@ -180,12 +241,43 @@ void getSelectionBounds(size_t selStartLine, size_t selStartCol, size_t selEndLi
     }
 }
 
+// Tamaño de la fuente del texto: Ctrl/Cmd+rueda lo cambia (zoom) y el
+// resto de la métrica del área de texto escala con él
+const unsigned BASE_FONT_SIZE = 16;
+const unsigned MIN_FONT_SIZE = 8;
+const unsigned MAX_FONT_SIZE = 72;
+
+// Métrica del área de texto a un tamaño de fuente, compartida por el
+// modelo (clicks, scroll) y el render
+struct TextMetrics {
+    unsigned fontSize = BASE_FONT_SIZE;
+    unsigned lineNumberSize = 14;
+    float lineHeight = 24.0f;
+    float rowHeight = 20.0f;            // Alto del cursor y de la selección
+    float lineNumberWidth = 50.0f;
+    float textStartX = 60.0f;           // Tras los números de línea
+    float columnWidth = 9.6f;           // Columna media (barra horizontal)
+};
+
+TextMetrics textMetrics(unsigned fontSize) {
+    const float scale = static_cast<float>(fontSize) / static_cast<float>(BASE_FONT_SIZE);
+    TextMetrics metrics;
+    metrics.fontSize = fontSize;
+    metrics.lineNumberSize = std::max(1u, static_cast<unsigned>(std::lround(14.0f * scale)));
+    metrics.lineHeight = 24.0f * scale;
+    metrics.rowHeight = 20.0f * scale;
+    metrics.lineNumberWidth = 50.0f * scale;
+    metrics.textStartX = 60.0f * scale;
+    metrics.columnWidth = 9.6f * scale;
+    return metrics;
+}
+
 // Función helper para calcular líneas visibles de manera consistente
-size_t calculateVisibleLines(const sf::Vector2u& windowSize) {
+size_t calculateVisibleLines(const sf::Vector2u& windowSize, float lineHeight) {
     float statusBarHeight = 25.0f;
     float scrollBarHeight = 15.0f;
     float textAreaHeight = std::max(0.0f, static_cast<float>(windowSize.y) - statusBarHeight - scrollBarHeight);
-    return textAreaHeight > 24.0f ? static_cast<size_t>(textAreaHeight / 24.0f) : 0;
+    return textAreaHeight > lineHeight ? static_cast<size_t>(textAreaHeight / lineHeight) : 0;
 }
 
 // Estructura para el historial de undo/redo
@@ -199,17 +291,35 @@ struct EditorState {
         : lines(l), cursorLine(cl), cursorCol(cc), description(desc) {}
 };
 
-// Variables globales para undo/redo
-std::deque<EditorState> undoHistory;
-std::deque<EditorState> redoHistory;
+// Variables globales para undo/redo (vectores: el historial lleno rota sin asignar)
+std::vector<EditorState> undoHistory;
+std::vector<EditorState> redoHistory;
 const size_t MAX_HISTORY = 100;
 
+// Bytes vivos de ambos historiales (se actualiza en cada push/pop)
+size_t historyBytes = 0;
+
+// Estados guardados: cada edición guarda uno antes de tocar el texto
+uint64_t savedStateCount = 0;
+
+size_t stateBytes(const EditorState& state) {
+    size_t bytes = sizeof(EditorState) + state.lines.capacity() * sizeof(std::string) +
+                   CoralCode::MemoryUsage::stringBytes(state.description);
+    for (const auto& line : state.lines) {
+        bytes += CoralCode::MemoryUsage::stringBytes(line);
+    }
+    return bytes;
+}
+
 // Función para guardar estado actual
 void saveState(const std::vector<std::string>& lines, size_t cursorLine, size_t cursorCol, const std::string& description) {
     // Validar que el estado sea válido antes de guardarlo
     if (lines.empty()) return;
     
     // Limpiar redo history cuando se hace un nuevo cambio
+    for (const auto& state : redoHistory) {
+        historyBytes -= stateBytes(state);
+    }
     redoHistory.clear();
     
     // Asegurar que cursor está en límites válidos antes de guardar
@@ -223,13 +333,24 @@ void saveState(const std::vector<std::string>& lines, size_t cursorLine, size_t
         validCursorCol = lines[validCursorLine].length();
     }
     
-    // Agregar estado actual al historial de undo con cursor válido
-    undoHistory.push_back(EditorState(lines, validCursorLine, validCursorCol, description));
+    CoralCode::AllocationTracker::Scope allocationSite(CoralCode::AllocationSite::UndoHistory);
+    ++savedStateCount;
     
-    // Mantener límite de historial
-    if (undoHistory.size() > MAX_HISTORY) {
-        undoHistory.pop_front();
+    // Agregar estado actual al historial de undo con cursor válido. Con el
+    // historial lleno se recicla el más antiguo: sus strings ya tienen
+    // capacidad y copiar el texto encima no asigna memoria
+    if (undoHistory.size() >= MAX_HISTORY) {
+        historyBytes -= stateBytes(undoHistory.front());
+        std::rotate(undoHistory.begin(), undoHistory.begin() + 1, undoHistory.end());
+        EditorState& recycled = undoHistory.back();
+        recycled.lines = lines;
+        recycled.cursorLine = validCursorLine;
+        recycled.cursorCol = validCursorCol;
+        recycled.description = description;
+    } else {
+        undoHistory.push_back(EditorState(lines, validCursorLine, validCursorCol, description));
     }
+    historyBytes += stateBytes(undoHistory.back());
 }
 
 // Función para deshacer (undo)
@@ -241,9 +362,11 @@ bool undo(std::vector<std::string>& lines, size_t& cursorLine, size_t& cursorCol
     
     // Guardar estado actual en redo
     redoHistory.push_back(EditorState(lines, cursorLine, cursorCol, "Redo"));
+    historyBytes += stateBytes(redoHistory.back());
     
     // Restaurar estado anterior
     const EditorState& previousState = undoHistory.back();
+    const std::string description = previousState.description;
     lines = previousState.lines;
     cursorLine = previousState.cursorLine;
     cursorCol = previousState.cursorCol;
@@ -256,9 +379,10 @@ bool undo(std::vector<std::string>& lines, size_t& cursorLine, size_t& cursorCol
         cursorCol = lines[cursorLine].length();
     }
     
+    historyBytes -= stateBytes(undoHistory.back());
     undoHistory.pop_back();
     
-    std::cout << "↶ Undo: " << previousState.description << std::endl;
+    std::cout << "↶ Undo: " << description << std::endl;
     return true;
 }
 
@@ -271,9 +395,11 @@ bool redo(std::vector<std::string>& lines, size_t& cursorLine, size_t& cursorCol
     
     // Guardar estado actual en undo
     undoHistory.push_back(EditorState(lines, cursorLine, cursorCol, "Undo"));
+    historyBytes += stateBytes(undoHistory.back());
     
     // Restaurar estado siguiente
     const EditorState& nextState = redoHistory.back();
+    const std::string description = nextState.description;
     lines = nextState.lines;
     cursorLine = nextState.cursorLine;
     cursorCol = nextState.cursorCol;
@@ -286,30 +412,206 @@ bool redo(std::vector<std::string>& lines, size_t& cursorLine, size_t& cursorCol
         cursorCol = lines[cursorLine].length();
     }
     
+    historyBytes -= stateBytes(redoHistory.back());
     redoHistory.pop_back();
     
-    std::cout << "↷ Redo: " << nextState.description << std::endl;
+    std::cout << "↷ Redo: " << description << std::endl;
     return true;
 }
 
-int main() {
-    // Crear ventana redimensionable
-    sf::RenderWindow window(sf::VideoMode(sf::Vector2u(1000, 700)), "CoralCode - Editor con Syntax Highlighting", sf::Style::Default);
-    window.setFramerateLimit(60);
+// ============================================================================
+// Hilo del modelo y snapshots de frame
+// ============================================================================
+//
+// El hilo principal solo recoge eventos de la ventana y dibuja el último
+// snapshot publicado. El hilo del modelo aplica los eventos al texto, colorea
+// las líneas visibles y publica un snapshot inmutable. La cola de entrada y el
+// puntero al snapshot se bloquean solo durante un push o un intercambio: la
+// entrada nunca espera a un frame y un frame nunca espera a una edición.
+
+// Evento de ventana con los modificadores capturados al recibirlo
+struct InputEvent {
+    sf::Event event;
+    bool ctrl;
+    bool system;
+    bool shift;
+    bool leftButton;
     
-    // Configurar vista inicial para mapeo 1:1 de pixels
-    sf::View initialView;
-    initialView.setSize(sf::Vector2f(1000.0f, 700.0f));
-    initialView.setCenter(sf::Vector2f(500.0f, 350.0f));
-    window.setView(initialView);
+    // Traza de latencia (0 si está desactivada)
+    uint64_t traceId = 0;
+    uint64_t deliveredNs = 0;
+    const char* traceName = "";
+};
+
+// Evento ya aplicado, pendiente de llegar a pantalla
+struct TracedInput {
+    uint64_t id;
+    uint64_t deliveredNs;
+    const char* name;
+};
+
+// Línea visible ya coloreada (tokens desde la columna de scroll)
+struct SnapshotLine {
+    size_t number = 0;
+    size_t length = 0;
+    std::vector<ColoredToken> tokens;   // Solo los tokenCount primeros son de esta línea
+    std::vector<float> tokenX;          // x de cada token desde textStartX (avances de la fuente)
+    size_t tokenCount = 0;
     
-    // Variables del editor - método que funciona perfecto
-    std::vector<std::string> lines = {""};
+    // Parte seleccionada de la línea, ya recortada al scroll (ancho 0: ninguna)
+    float selectionX = 0.0f;
+    float selectionWidth = 0.0f;
+};
+
+// Todo lo que el render necesita para dibujar un frame. Los snapshots se
+// reciclan: los vectores no se encogen y solo valen los primeros *Count
+struct FrameSnapshot {
+    std::vector<SnapshotLine> visibleLines;
+    size_t visibleLineCount = 0;
+    size_t totalLines = 1;
+    size_t maxLineLength = 0;
+    size_t scrollLine = 0;
+    size_t scrollCol = 0;
     size_t currentLine = 0;
     size_t currentCol = 0;
+    float cursorX = 0.0f;               // Desde textStartX
+    TextMetrics metrics;                // Con la que el modelo midió las x
+    
+    // Selección ya ordenada
+    bool isSelecting = false;
+    size_t selectionFirstLine = 0;
+    size_t selectionLastLine = 0;
+    size_t selectionStartCol = 0;
+    size_t selectionEndCol = 0;
+    
+    std::string status;
+    bool closeRequested = false;
+    
+    // Perfilado: número de snapshot y lo que tardó en el hilo del modelo
+    uint64_t sequence = 0;
+    uint64_t editNs = 0;
+    uint64_t highlightNs = 0;
+    
+    // Memoria del modelo (el atlas de glifos lo suma el render)
+    CoralCode::MemoryUsage memory;
+};
+
+// Estado del lexer cada LEXER_CHECKPOINT_INTERVAL bytes de una línea larga
+// (states[k] vale en k * intervalo). Se extiende solo hasta donde se mira
+struct LexerCheckpoints {
+    size_t line = SIZE_MAX;             // SIZE_MAX: entrada libre
+    std::vector<LexState> states;
+    uint64_t lastUsed = 0;
+};
+
+// Minimapa: el documento entero reducido a una imagen de densidad de color,
+// una fila de píxeles por cada linesPerRow líneas y un píxel por cada
+// MINIMAP_COLUMNS_PER_PIXEL columnas. El modelo reescribe las filas de las
+// líneas editadas; el render sube a la textura solo las filas cambiadas
+const size_t MINIMAP_WIDTH = 80;                // Píxeles (= minimapWidth)
+const size_t MINIMAP_COLUMNS_PER_PIXEL = 2;
+const size_t MINIMAP_MAX_ROWS = 2048;           // Alto de la textura
+const size_t MINIMAP_LINES_PER_STEP = 32768;    // Reconstrucción por tramos entre eventos
+
+// Píxeles RGBA del minimapa, compartidos entre el hilo del modelo (escribe)
+// y el de render (sube a la textura). La capacidad se reserva entera al
+// crearla: mover o reescribir filas no asigna memoria
+class MinimapImage {
+public:
+    static const size_t ROW_BYTES = MINIMAP_WIDTH * 4;
+    
+    MinimapImage() {
+        pixels_.reserve(MINIMAP_MAX_ROWS * ROW_BYTES);
+    }
+    
+    // Nueva forma: todo transparente hasta que se escriban las filas
+    void reshape(size_t rows, size_t linesPerRow) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pixels_.assign(rows * ROW_BYTES, 0);
+        rows_ = rows;
+        linesPerRow_ = linesPerRow;
+        markDirty(0, rows);
+    }
+    
+    // Las filas [from, rows_) pasan a empezar en to y el alto a rows
+    void moveRows(size_t from, size_t to, size_t rows) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t moved = rows_ - from;
+        if (rows > rows_) pixels_.resize(rows * ROW_BYTES);
+        std::memmove(pixels_.data() + to * ROW_BYTES, pixels_.data() + from * ROW_BYTES, moved * ROW_BYTES);
+        if (rows < rows_) pixels_.resize(rows * ROW_BYTES);
+        rows_ = rows;
+        markDirty(std::min(from, to), rows);
+    }
+    
+    void writeRow(size_t row, const uint8_t* pixels) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::memcpy(pixels_.data() + row * ROW_BYTES, pixels, ROW_BYTES);
+        markDirty(row, row + 1);
+    }
+    
+    // Render: upload(píxeles, primera fila, filas) recibe solo las filas
+    // cambiadas desde la última llamada. Devuelve el alto y las líneas por fila
+    template <typename Upload>
+    std::pair<size_t, size_t> upload(Upload&& write) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (dirtyFirst_ < dirtyEnd_) {
+            write(pixels_.data() + dirtyFirst_ * ROW_BYTES, dirtyFirst_, dirtyEnd_ - dirtyFirst_);
+            dirtyFirst_ = dirtyEnd_ = 0;
+        }
+        return {rows_, linesPerRow_};
+    }
+    
+    size_t getMemoryUsage() const {
+        return pixels_.capacity();
+    }
+    
+private:
+    std::mutex mutex_;
+    std::vector<uint8_t> pixels_;
+    size_t rows_ = 0;
+    size_t linesPerRow_ = 1;
+    size_t dirtyFirst_ = 0;
+    size_t dirtyEnd_ = 0;
     
-    // Guardar estado inicial
-    saveState(lines, currentLine, currentCol, "Estado inicial");
+    void markDirty(size_t first, size_t end) {
+        if (first >= end) return;
+        if (dirtyFirst_ >= dirtyEnd_) {
+            dirtyFirst_ = first;
+            dirtyEnd_ = end;
+        } else {
+            dirtyFirst_ = std::min(dirtyFirst_, first);
+            dirtyEnd_ = std::max(dirtyEnd_, end);
+        }
+        dirtyEnd_ = std::min(dirtyEnd_, rows_);
+    }
+};
+
+// Lado del modelo del minimapa: líneas pendientes de redibujar y memoria
+// de trabajo para construir una fila sin asignar
+struct MinimapState {
+    std::shared_ptr<MinimapImage> image = std::make_shared<MinimapImage>();
+    size_t rows = 0;
+    size_t linesPerRow = 0;             // 0: sin forma todavía
+    size_t pendingFirst = 0;            // Líneas [pendingFirst, pendingEnd) por redibujar
+    size_t pendingEnd = 0;
+    
+    // Con varias líneas por fila, insertar o borrar líneas no redibuja las
+    // que solo se desplazan hasta que el desplazamiento acumulado llega a
+    // una fila
+    size_t shiftedLines = 0;
+    size_t shiftFirst = SIZE_MAX;
+    
+    std::vector<ColoredToken> tokens;
+    std::array<uint32_t, MINIMAP_WIDTH * 4> sums{};     // r, g, b y bytes visibles por píxel
+    std::array<uint8_t, MinimapImage::ROW_BYTES> row{};
+};
+
+// Estado del editor: solo lo modifica el hilo del modelo
+struct EditorModel {
+    std::vector<std::string> lines = {""};
+    size_t currentLine = 0;
+    size_t currentCol = 0;
     
     // Variables para selección
     bool isSelecting = false;
@@ -319,930 +621,1915 @@ int main() {
     size_t selectionEndCol = 0;
     
     // Variables para scroll y tamaño dinámico
-    size_t scrollLine = 0;  // Primera línea visible
-    size_t scrollCol = 0;   // Primera columna visible (scroll horizontal)
-    sf::Vector2u windowSize = window.getSize();
+    size_t scrollLine = 0;
+    size_t scrollCol = 0;
+    sf::Vector2u windowSize;
+    
+    // Tamaño de fuente (zoom) y métrica derivada
+    TextMetrics metrics;
     
     // Variables para barra de scroll
-    bool isScrolling = false;  // Si el usuario está arrastrando la barra vertical
-    bool isScrollingHorizontal = false;  // Si el usuario está arrastrando la barra horizontal
-    float scrollBarWidth = 15.0f;  // Ancho de la barra de scroll vertical
-    float scrollBarHeight = 15.0f;  // Alto de la barra de scroll horizontal
-    
-    // Colores
-    sf::Color backgroundColor(25, 25, 25);  // Más oscuro
-    sf::Color cursorColor(255, 255, 0);     // Amarillo
-    sf::Color lineIndicatorColor(255, 50, 50); // Rojo
-    sf::Color lineNumberColor(100, 100, 100); // Gris para números de línea
-    sf::Color selectionColor(70, 130, 180, 100); // Azul translúcido para selección
-    sf::Color statusBarColor(40, 40, 40);   // Gris oscuro para barra de estado
-    sf::Color scrollBarColor(60, 60, 60);   // Gris para barra de scroll
-    sf::Color scrollThumbColor(120, 120, 120); // Gris claro para el thumb
+    bool isScrolling = false;
+    bool isScrollingHorizontal = false;
     
-    // Cargar fuente del sistema
-    sf::Font font;
-    bool fontLoaded = false;
+    bool closeRequested = false;
     
-    std::vector<std::string> fontPaths = {
-        "/System/Library/Fonts/Monaco.ttf",
-        "/System/Library/Fonts/Menlo.ttc", 
-        "/System/Library/Fonts/Courier New.ttf",
-        "/System/Library/Fonts/Helvetica.ttc"
-    };
+    // Longitud máxima (barra horizontal): se recalcula solo tras editar
+    size_t maxLineLength = 0;
+    bool linesChanged = true;
     
-    for (const auto& path : fontPaths) {
-        if (font.openFromFile(path)) {
-            fontLoaded = true;
-            std::cout << "✅ Fuente cargada: " << path << std::endl;
+    // Posiciones horizontales con los avances reales y las tabulaciones. La
+    // versión del texto invalida los layouts cacheados de cada línea
+    CoralCode::TextLayout layout;
+    CoralCode::LineLayoutCache layoutCache;
+    uint64_t textVersion = 0;
+    
+    // Modo línea larga: checkpoints del lexer de las líneas largas vistas
+    // hace poco y layout de la ventana visible de cada una
+    std::vector<LexerCheckpoints> lexerCheckpoints;
+    CoralCode::LineLayout windowLayout;
+    
+    MinimapState minimap;
+    
+    // Memoria del texto: se recalcula en la misma pasada que maxLineLength
+    size_t bufferBytes = 0;
+    size_t lineIndexBytes = 0;
+    
+    uint64_t snapshotCount = 0;
+    
+    // Snapshots reciclables (uno publicado, uno en el render, uno libre)
+    std::vector<std::shared_ptr<FrameSnapshot>> snapshotPool;
+};
+
+const size_t SNAPSHOT_POOL_SIZE = 3;
+
+// Modo línea larga: por encima del umbral solo se lexa y mide la ventana
+// visible desde la columna de scroll, partiendo del checkpoint anterior
+const size_t LONG_LINE_THRESHOLD = 4096;
+const size_t LONG_LINE_WINDOW = 2048;           // Más bytes de los que caben en pantalla
+const size_t LEXER_CHECKPOINT_INTERVAL = 4096;
+const size_t MAX_CHECKPOINTED_LINES = 16;
+
+// Layout compartido por el modelo (clicks, scroll) y el render
+const float scrollBarWidth = 15.0f;
+const float scrollBarHeight = 15.0f;
+const float minimapWidth = static_cast<float>(MINIMAP_WIDTH);
+
+// Borde derecho del área de texto: a su derecha, minimapa y barra vertical
+float textAreaRight(const sf::Vector2u& windowSize) {
+    return static_cast<float>(windowSize.x) - scrollBarWidth - minimapWidth;
+}
+
+// Alto en pantalla de cada fila del minimapa (como mucho 2 px)
+float minimapRowHeight(const sf::Vector2u& windowSize, size_t rows) {
+    const float height = std::max(0.0f, static_cast<float>(windowSize.y) - 25.0f - scrollBarHeight);
+    return rows > 0 ? std::min(2.0f, height / static_cast<float>(rows)) : 0.0f;
+}
+
+// Longitud máxima y memoria del texto: una pasada solo tras editar
+void updateLineStats(EditorModel& model) {
+    if (!model.linesChanged) return;
+    model.maxLineLength = 0;
+    model.bufferBytes = 0;
+    for (const auto& line : model.lines) {
+        model.maxLineLength = std::max(model.maxLineLength, line.length());
+        model.bufferBytes += CoralCode::MemoryUsage::stringBytes(line);
+    }
+    model.lineIndexBytes = model.lines.capacity() * sizeof(std::string);
+    model.linesChanged = false;
+}
+
+bool isLongLine(const std::string& line) {
+    return line.length() > LONG_LINE_THRESHOLD;
+}
+
+// Layout de la parte de line que puede verse. Las líneas normales se miden
+// enteras (cacheadas por versión del texto); las largas, solo la ventana
+// desde el scroll, con x y tabulaciones relativas a su inicio (base)
+const CoralCode::LineLayout& visibleLayout(EditorModel& model, size_t line, size_t& base) {
+    const std::string& text = model.lines[line];
+    if (!isLongLine(text)) {
+        base = 0;
+        return model.layoutCache.get(model.layout, line, text, model.textVersion);
+    }
+    base = std::min(model.scrollCol, text.length());
+    const size_t length = std::min(text.length() - base, LONG_LINE_WINDOW);
+    model.layout.layoutLine(text.data() + base, length, model.windowLayout);
+    return model.windowLayout;
+}
+
+// Columna (byte) de line más cercana a la x de pantalla: O(log longitud)
+size_t columnAtX(EditorModel& model, size_t line, float x) {
+    size_t base = 0;
+    const CoralCode::LineLayout& layout = visibleLayout(model, line, base);
+    const size_t scrollCol = std::max(model.scrollCol, base) - base;
+    return base + layout.hitTest(layout.offsetOf(scrollCol) + std::max(0.0f, x - model.metrics.textStartX));
+}
+
+// Cambia el tamaño de la fuente (zoom). Las x cacheadas caducan con la
+// escala del layout: solo se vuelven a medir las líneas que se dibujan
+void setFontSize(EditorModel& model, unsigned fontSize) {
+    fontSize = std::clamp(fontSize, MIN_FONT_SIZE, MAX_FONT_SIZE);
+    if (fontSize == model.metrics.fontSize) return;
+    const size_t visibleBefore = calculateVisibleLines(model.windowSize, model.metrics.lineHeight);
+    const bool cursorVisible = model.currentLine >= model.scrollLine &&
+                               model.currentLine < model.scrollLine + visibleBefore;
+    
+    model.metrics = textMetrics(fontSize);
+    model.layout.setScale(static_cast<float>(fontSize) / static_cast<float>(BASE_FONT_SIZE));
+    
+    // Si caben menos líneas, el cursor que se veía sigue a la vista
+    const size_t visibleLines = calculateVisibleLines(model.windowSize, model.metrics.lineHeight);
+    if (cursorVisible && visibleLines > 0 && model.currentLine >= model.scrollLine + visibleLines) {
+        model.scrollLine = model.currentLine - visibleLines + 1;
+    }
+}
+
+// Checkpoints de una línea larga; sin entrada, se recicla la menos usada
+LexerCheckpoints& checkpointsFor(EditorModel& model, size_t line) {
+    LexerCheckpoints* entry = nullptr;
+    for (auto& candidate : model.lexerCheckpoints) {
+        if (candidate.line == line) {
+            entry = &candidate;
             break;
         }
+        if (!entry || candidate.lastUsed < entry->lastUsed) {
+            entry = &candidate;
+        }
     }
-    
-    if (!fontLoaded) {
-        std::cout << "❌ No se pudo cargar fuente. Texto puede no ser visible." << std::endl;
+    if (!entry || (entry->line != line && model.lexerCheckpoints.size() < MAX_CHECKPOINTED_LINES)) {
+        model.lexerCheckpoints.emplace_back();
+        entry = &model.lexerCheckpoints.back();
+    }
+    if (entry->line != line) {
+        entry->line = line;
+        entry->states.assign(1, LexState{});
+    }
+    entry->lastUsed = model.snapshotCount;
+    return *entry;
+}
+
+// Estado del lexer en offset: desde el inicio en líneas normales, desde el
+// checkpoint anterior (a lo sumo un intervalo) en las largas
+LexState lexStateFor(EditorModel& model, size_t line, size_t offset) {
+    const std::string& text = model.lines[line];
+    if (!isLongLine(text)) {
+        return lexStateAt(text, 0, offset, LexState{});
     }
     
-    // Elementos visuales
-    sf::RectangleShape cursor(sf::Vector2f(2.0f, 20.0f));
-    cursor.setFillColor(cursorColor);
-    
-    // Indicador de línea actual (más delgado y a la izquierda)
-    sf::RectangleShape lineIndicator(sf::Vector2f(2.0f, 20.0f));
-    lineIndicator.setFillColor(lineIndicatorColor);
+    LexerCheckpoints& checkpoints = checkpointsFor(model, line);
+    const size_t index = offset / LEXER_CHECKPOINT_INTERVAL;
+    while (checkpoints.states.size() <= index) {
+        const size_t start = (checkpoints.states.size() - 1) * LEXER_CHECKPOINT_INTERVAL;
+        checkpoints.states.push_back(
+            lexStateAt(text, start, start + LEXER_CHECKPOINT_INTERVAL, checkpoints.states.back()));
+    }
+    const size_t start = index * LEXER_CHECKPOINT_INTERVAL;
+    return lexStateAt(text, start, offset, checkpoints.states[index]);
+}
+
+// Una edición cambió line desde col: los checkpoints anteriores siguen
+// valiendo y los de las líneas siguientes (que pueden haberse desplazado) no
+void invalidateCheckpoints(EditorModel& model, size_t line, size_t col) {
+    for (auto& checkpoints : model.lexerCheckpoints) {
+        if (checkpoints.line == SIZE_MAX || checkpoints.line < line) continue;
+        if (checkpoints.line > line) {
+            checkpoints.line = SIZE_MAX;
+            continue;
+        }
+        // El estado en k depende de los bytes [0, k]: vale si k < col
+        const size_t keep = std::max<size_t>(1, (col + LEXER_CHECKPOINT_INTERVAL - 1) / LEXER_CHECKPOINT_INTERVAL);
+        if (checkpoints.states.size() > keep) {
+            checkpoints.states.resize(keep);
+        }
+    }
+}
+
+// ============================================================================
+// Minimapa
+// ============================================================================
+
+void markMinimapLines(EditorModel& model, size_t first, size_t end) {
+    MinimapState& minimap = model.minimap;
+    if (first >= end) return;
+    if (minimap.pendingFirst >= minimap.pendingEnd) {
+        minimap.pendingFirst = first;
+        minimap.pendingEnd = end;
+    } else {
+        minimap.pendingFirst = std::min(minimap.pendingFirst, first);
+        minimap.pendingEnd = std::max(minimap.pendingEnd, end);
+    }
+}
+
+// Una edición cambió las líneas desde editLine hasta el cursor. Con una
+// línea por fila, las que solo se desplazan se mueven dentro de la imagen;
+// agrupadas, se redibujan cuando el desplazamiento acumulado llega a una fila
+void noteMinimapEdit(EditorModel& model, size_t editLine, size_t linesBefore) {
+    MinimapState& minimap = model.minimap;
+    const size_t lineCount = model.lines.size();
+    const size_t first = std::min(editLine, model.currentLine);
+    const size_t last = std::max(editLine, model.currentLine) + 1;
+    if (lineCount == linesBefore) {
+        markMinimapLines(model, first, last);
+        return;
+    }
     
-    // Barra de estado (dinámico)
-    sf::RectangleShape statusBar;
-    statusBar.setFillColor(statusBarColor);
+    if (minimap.linesPerRow == 1 && minimap.rows == linesBefore && lineCount <= MINIMAP_MAX_ROWS &&
+        last <= lineCount) {
+        // Las líneas desde last venían de last + linesBefore - lineCount
+        minimap.image->moveRows(last + linesBefore - lineCount, last, lineCount);
+        minimap.rows = lineCount;
+        if (minimap.pendingFirst < minimap.pendingEnd && lineCount > linesBefore) {
+            minimap.pendingEnd += lineCount - linesBefore;
+        }
+        markMinimapLines(model, first, last);
+        return;
+    }
     
-    // Área de números de línea (dinámico)
-    sf::RectangleShape lineNumberArea;
-    lineNumberArea.setFillColor(sf::Color(35, 35, 35));
+    minimap.shiftedLines += lineCount > linesBefore ? lineCount - linesBefore : linesBefore - lineCount;
+    minimap.shiftFirst = std::min(minimap.shiftFirst, first);
+    if (minimap.shiftedLines >= minimap.linesPerRow) {
+        markMinimapLines(model, minimap.shiftFirst, lineCount);
+        minimap.shiftedLines = 0;
+        minimap.shiftFirst = SIZE_MAX;
+    } else {
+        markMinimapLines(model, first, last);
+    }
+}
+
+// Color medio de los bytes visibles (ni blancos ni continuación UTF-8) de
+// cada píxel de la fila, con la opacidad según la parte ocupada. Parte de
+// los tokens cacheados en la memoria de trabajo: no asigna en estado estable
+void buildMinimapRow(EditorModel& model, size_t row) {
+    MinimapState& minimap = model.minimap;
+    const size_t first = row * minimap.linesPerRow;
+    const size_t end = std::min(first + minimap.linesPerRow, model.lines.size());
+    const size_t span = MINIMAP_WIDTH * MINIMAP_COLUMNS_PER_PIXEL;
+    const size_t tabSize = model.layout.getTabSize();
     
-    // Barra de scroll
-    sf::RectangleShape scrollBar;
-    scrollBar.setFillColor(scrollBarColor);
+    minimap.sums.fill(0);
+    for (size_t i = first; i < end; ++i) {
+        const std::string& line = model.lines[i];
+        const size_t count = processLine(line, 0, std::min(line.length(), span), LexState{}, minimap.tokens);
+        size_t column = 0;
+        for (size_t t = 0; t < count && column < span; ++t) {
+            const ColoredToken& token = minimap.tokens[t];
+            for (char c : token.first) {
+                if (column >= span) break;
+                if (c == '\t') {
+                    column = (column / tabSize + 1) * tabSize;
+                    continue;
+                }
+                if ((static_cast<unsigned char>(c) & 0xC0) == 0x80) continue;
+                if (c != ' ') {
+                    uint32_t* sum = &minimap.sums[column / MINIMAP_COLUMNS_PER_PIXEL * 4];
+                    sum[0] += token.second.r;
+                    sum[1] += token.second.g;
+                    sum[2] += token.second.b;
+                    sum[3] += 1;
+                }
+                ++column;
+            }
+        }
+    }
     
-    // Thumb de la barra de scroll vertical
-    sf::RectangleShape scrollThumb;
-    scrollThumb.setFillColor(scrollThumbColor);
+    const uint32_t capacity = static_cast<uint32_t>((end - first) * MINIMAP_COLUMNS_PER_PIXEL);
+    for (size_t x = 0; x < MINIMAP_WIDTH; ++x) {
+        const uint32_t* sum = &minimap.sums[x * 4];
+        uint8_t* pixel = &minimap.row[x * 4];
+        if (sum[3] == 0) {
+            std::fill(pixel, pixel + 4, uint8_t(0));
+            continue;
+        }
+        pixel[0] = static_cast<uint8_t>(sum[0] / sum[3]);
+        pixel[1] = static_cast<uint8_t>(sum[1] / sum[3]);
+        pixel[2] = static_cast<uint8_t>(sum[2] / sum[3]);
+        pixel[3] = static_cast<uint8_t>(64 + 191 * sum[3] / capacity);
+    }
+}
+
+// Redibuja hasta MINIMAP_LINES_PER_STEP líneas pendientes; un cambio de
+// forma (otro número de filas) lo deja todo pendiente. Devuelve si queda
+// trabajo, que el hilo del modelo sigue entre eventos
+bool updateMinimap(EditorModel& model) {
+    CoralCode::AllocationTracker::Scope allocationSite(CoralCode::AllocationSite::Highlight);
+    MinimapState& minimap = model.minimap;
+    const size_t lineCount = model.lines.size();
+    if (lineCount == 0) return false;
     
-    // Barra de scroll horizontal
-    sf::RectangleShape horizontalScrollBar;
-    horizontalScrollBar.setFillColor(scrollBarColor);
+    const size_t linesPerRow = (lineCount + MINIMAP_MAX_ROWS - 1) / MINIMAP_MAX_ROWS;
+    const size_t rows = (lineCount + linesPerRow - 1) / linesPerRow;
+    if (linesPerRow != minimap.linesPerRow || rows != minimap.rows) {
+        minimap.image->reshape(rows, linesPerRow);
+        minimap.rows = rows;
+        minimap.linesPerRow = linesPerRow;
+        minimap.shiftedLines = 0;
+        minimap.shiftFirst = SIZE_MAX;
+        minimap.pendingFirst = 0;
+        minimap.pendingEnd = lineCount;
+    }
     
-    // Thumb de la barra de scroll horizontal
-    sf::RectangleShape horizontalScrollThumb;
-    horizontalScrollThumb.setFillColor(scrollThumbColor);
+    const size_t end = std::min(minimap.pendingEnd, lineCount);
+    size_t row = minimap.pendingFirst / linesPerRow;
+    for (size_t budget = 0; row * linesPerRow < end && budget < MINIMAP_LINES_PER_STEP; ++row) {
+        buildMinimapRow(model, row);
+        minimap.image->writeRow(row, minimap.row.data());
+        budget += linesPerRow;
+    }
+    minimap.pendingFirst = row * linesPerRow;
+    if (minimap.pendingFirst >= end) {
+        minimap.pendingFirst = 0;
+        minimap.pendingEnd = 0;
+        return false;
+    }
+    return true;
+}
+
+// Aplica un evento de entrada al modelo
+void handleEvent(EditorModel& model, const InputEvent& input) {
+    CoralCode::AllocationTracker::Scope allocationSite(CoralCode::AllocationSite::Edit);
+    std::vector<std::string>& lines = model.lines;
+    size_t& currentLine = model.currentLine;
+    size_t& currentCol = model.currentCol;
+    bool& isSelecting = model.isSelecting;
+    size_t& selectionStartLine = model.selectionStartLine;
+    size_t& selectionStartCol = model.selectionStartCol;
+    size_t& selectionEndLine = model.selectionEndLine;
+    size_t& selectionEndCol = model.selectionEndCol;
+    size_t& scrollLine = model.scrollLine;
+    size_t& scrollCol = model.scrollCol;
+    sf::Vector2u& windowSize = model.windowSize;
+    bool& isScrolling = model.isScrolling;
+    bool& isScrollingHorizontal = model.isScrollingHorizontal;
+    bool& closeRequested = model.closeRequested;
+    const float textStartX = model.metrics.textStartX;
+    const sf::Event* event = &input.event;
     
-    // Variables de layout
-    const float lineNumberWidth = 50.0f;
-    const float textStartX = lineNumberWidth + 10.0f;
+    if (event->is<sf::Event::KeyPressed>() || event->is<sf::Event::TextEntered>()) {
+        model.linesChanged = true;
+        ++model.textVersion;
+    }
     
-    std::cout << "🚀 CoralCode - Editor Profesional Iniciado" << std::endl;
-    std::cout << "📝 Escribe código en C++, C, Java, JavaScript, Python, C#" << std::endl;
-    std::cout << "🎨 Syntax highlighting: azul=keywords, verde=comentarios, naranja=strings" << std::endl;
-    std::cout << "🔢 Números de línea automáticos" << std::endl;
-    std::cout << "📊 Barra de estado con información detallada" << std::endl;
-    std::cout << "🖱️  Click y arrastra para seleccionar texto" << std::endl;
-    std::cout << "📋 Cmd+C para copiar, Cmd+V para pegar (clipboard del sistema)" << std::endl;
-    std::cout << "↶ Cmd+Z para deshacer, Cmd+Shift+Z para rehacer (límite: 100 cambios)" << std::endl;
-    std::cout << "🔄 Scroll: Rueda vertical (up/down), Shift+Rueda horizontal, Trackpad horizontal" << std::endl;
-    std::cout << "⚡ Ctrl/Cmd+Flechas: ↑↓ scroll 10 líneas, ←→ inicio/fin de línea" << std::endl;
-    std::cout << "⌨️  ESC para salir" << std::endl;
+    // Primer byte que puede cambiar si el evento edita: el cursor o el
+    // inicio de la selección, uno antes por Backspace
+    const uint64_t statesBefore = savedStateCount;
+    const size_t linesBefore = lines.size();
+    const size_t cursorLineBefore = currentLine;
+    size_t editLine = currentLine;
+    size_t editCol = currentCol;
+    if (isSelecting) {
+        size_t lastLine, lastCol;
+        getSelectionBounds(selectionStartLine, selectionStartCol, selectionEndLine, selectionEndCol,
+                           editLine, lastLine, editCol, lastCol);
+    }
+    editCol = editCol > 0 ? editCol - 1 : 0;
     
-    while (window.isOpen()) {
-        // Verificar posición del mouse y ajustar cursor (solo cuando cambie)
-        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-        float mouseX = static_cast<float>(mousePos.x);
-        float mouseY = static_cast<float>(mousePos.y);
-        float scrollBarX = static_cast<float>(windowSize.x) - scrollBarWidth;
-        
-        // Determinar qué tipo de cursor usar
-        float horizontalScrollY = static_cast<float>(windowSize.y) - 25 - scrollBarHeight;
-        
-        sf::Cursor::Type newCursorType;
-        if (mouseX > textStartX && mouseX < scrollBarX && 
-            mouseY > 0 && mouseY < horizontalScrollY) {
-            // En área de texto - cursor de texto
-            newCursorType = sf::Cursor::Type::Text;
-        } else if (mouseX > scrollBarX || 
-                  (mouseY > horizontalScrollY && mouseY < windowSize.y - 25)) {
-            // En barras de scroll - cursor de mano
-            newCursorType = sf::Cursor::Type::Hand;
-        } else {
-            // En otras áreas - cursor normal
-            newCursorType = sf::Cursor::Type::Arrow;
+    if (auto* keyEvent = event->getIf<sf::Event::KeyPressed>()) {
+        if (keyEvent->code == sf::Keyboard::Key::Escape) {
+            closeRequested = true;
         }
-        
-        // Cambiar cursor solo si es diferente al actual
-        static sf::Cursor::Type currentCursorType = sf::Cursor::Type::Arrow;
-        if (newCursorType != currentCursorType) {
-            auto cursor = sf::Cursor::createFromSystem(newCursorType);
-            if (cursor) {
-                window.setMouseCursor(cursor.value());
-                currentCursorType = newCursorType;
+        else if (keyEvent->code == sf::Keyboard::Key::Enter) {
+            // Guardar estado antes de modificar
+            saveState(lines, currentLine, currentCol, "Nueva línea");
+            
+            // Nueva línea - método que funciona
+            std::string currentText = lines[currentLine];
+            std::string remainingText = currentText.substr(currentCol);
+            lines[currentLine] = currentText.substr(0, currentCol);
+            lines.insert(lines.begin() + currentLine + 1, remainingText);
+            currentLine++;
+            currentCol = 0;
+            
+            // Auto-scroll si la nueva línea no es visible
+            size_t visibleLines = calculateVisibleLines(windowSize, model.metrics.lineHeight);
+            if (visibleLines > 0 && currentLine >= scrollLine + visibleLines) {
+                scrollLine = currentLine - visibleLines + 1;
             }
         }
-        
-        // Manejar eventos - LÓGICA QUE FUNCIONA PERFECTO
-        while (auto event = window.pollEvent()) {
-            if (auto* closeEvent = event->getIf<sf::Event::Closed>()) {
-                window.close();
-            }
-            else if (auto* keyEvent = event->getIf<sf::Event::KeyPressed>()) {
-                if (keyEvent->code == sf::Keyboard::Key::Escape) {
-                    window.close();
+        else if (keyEvent->code == sf::Keyboard::Key::Backspace) {
+            // Guardar estado antes de modificar
+            saveState(lines, currentLine, currentCol, "Borrar");
+            
+            // Si hay selección, borrar todo lo seleccionado
+            if (isSelecting) {
+                // Borrar texto seleccionado
+                size_t startLine, endLine, startCol, endCol;
+                getSelectionBounds(selectionStartLine, selectionStartCol, selectionEndLine, selectionEndCol,
+                                 startLine, endLine, startCol, endCol);
+                
+                if (startLine == endLine) {
+                    // Selección en una sola línea
+                    lines[startLine].erase(startCol, endCol - startCol);
+                } else {
+                    // Selección multi-línea
+                    std::string remainingText = lines[endLine].substr(endCol);
+                    lines[startLine] = lines[startLine].substr(0, startCol) + remainingText;
+                    lines.erase(lines.begin() + startLine + 1, lines.begin() + endLine + 1);
                 }
-                else if (keyEvent->code == sf::Keyboard::Key::Enter) {
-                    // Guardar estado antes de modificar
-                    saveState(lines, currentLine, currentCol, "Nueva línea");
-                    
-                    // Nueva línea - método que funciona
-                    std::string currentText = lines[currentLine];
-                    std::string remainingText = currentText.substr(currentCol);
-                    lines[currentLine] = currentText.substr(0, currentCol);
-                    lines.insert(lines.begin() + currentLine + 1, remainingText);
-                    currentLine++;
-                    currentCol = 0;
-                    
-                    // Auto-scroll si la nueva línea no es visible
-                    size_t visibleLines = calculateVisibleLines(windowSize);
-                    if (visibleLines > 0 && currentLine >= scrollLine + visibleLines) {
-                        scrollLine = currentLine - visibleLines + 1;
-                    }
+                
+                // Posicionar cursor al inicio de la selección
+                currentLine = startLine;
+                currentCol = startCol;
+                isSelecting = false;
+            } else {
+                // Borrar carácter normal
+                if (currentCol > 0) {
+                    lines[currentLine].erase(currentCol - 1, 1);
+                    currentCol--;
+                } else if (currentLine > 0) {
+                    currentCol = lines[currentLine - 1].length();
+                    lines[currentLine - 1] += lines[currentLine];
+                    lines.erase(lines.begin() + currentLine);
+                    currentLine--;
                 }
-                else if (keyEvent->code == sf::Keyboard::Key::Backspace) {
-                    // Guardar estado antes de modificar
-                    saveState(lines, currentLine, currentCol, "Borrar");
-                    
-                    // Si hay selección, borrar todo lo seleccionado
-                    if (isSelecting) {
-                        // Borrar texto seleccionado
-                        size_t startLine, endLine, startCol, endCol;
-                        getSelectionBounds(selectionStartLine, selectionStartCol, selectionEndLine, selectionEndCol,
-                                         startLine, endLine, startCol, endCol);
-                        
-                        if (startLine == endLine) {
-                            // Selección en una sola línea
-                            lines[startLine].erase(startCol, endCol - startCol);
-                        } else {
-                            // Selección multi-línea
-                            std::string remainingText = lines[endLine].substr(endCol);
-                            lines[startLine] = lines[startLine].substr(0, startCol) + remainingText;
-                            lines.erase(lines.begin() + startLine + 1, lines.begin() + endLine + 1);
-                        }
-                        
-                        // Posicionar cursor al inicio de la selección
-                        currentLine = startLine;
-                        currentCol = startCol;
-                        isSelecting = false;
-                    } else {
-                        // Borrar carácter normal
-                        if (currentCol > 0) {
-                            lines[currentLine].erase(currentCol - 1, 1);
-                            currentCol--;
-                        } else if (currentLine > 0) {
-                            currentCol = lines[currentLine - 1].length();
-                            lines[currentLine - 1] += lines[currentLine];
-                            lines.erase(lines.begin() + currentLine);
-                            currentLine--;
-                        }
-                    }
-                }
-                else if (keyEvent->code == sf::Keyboard::Key::Left) {
-                    // Detectar si se presiona Ctrl (Windows/Linux) o Cmd (Mac)
-                    bool isCtrlCmd = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LControl) || 
-                                     sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RControl) ||
-                                     sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LSystem) || 
-                                     sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RSystem);
-                    
-                    if (isCtrlCmd) {
-                        // Ir al inicio de la línea
-                        currentCol = 0;
-                        scrollCol = 0; // Resetear scroll horizontal
-                    } else if (currentCol > 0) {
-                        // Navegación normal
-                        currentCol--;
-                        
-                        // Auto-scroll horizontal hacia la izquierda si es necesario
-                        if (currentCol < scrollCol) {
-                            scrollCol = currentCol;
-                        }
-                    }
-                }
-                else if (keyEvent->code == sf::Keyboard::Key::Right) {
-                    // Detectar si se presiona Ctrl (Windows/Linux) o Cmd (Mac)
-                    bool isCtrlCmd = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LControl) || 
-                                     sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RControl) ||
-                                     sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LSystem) || 
-                                     sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RSystem);
-                    
-                    if (isCtrlCmd) {
-                        // Ir al final de la línea
-                        currentCol = lines[currentLine].length();
-                        
-                        // Auto-scroll horizontal hacia la derecha si es necesario
-                        float textStartX = 55.0f; // Después del área de números de línea
-                        size_t visibleCols = static_cast<size_t>((windowSize.x - textStartX - scrollBarWidth) / 9.6f);
-                        if (currentCol >= scrollCol + visibleCols) {
-                            scrollCol = currentCol >= visibleCols ? currentCol - visibleCols + 1 : 0;
-                        }
-                    } else if (currentCol < lines[currentLine].length()) {
-                        // Navegación normal
-                        currentCol++;
-                        
-                        // Auto-scroll horizontal hacia la derecha si es necesario
-                        float textStartX = 55.0f; // Después del área de números de línea
-                        size_t visibleCols = static_cast<size_t>((windowSize.x - textStartX - scrollBarWidth) / 9.6f);
-                        if (currentCol >= scrollCol + visibleCols) {
-                            scrollCol = currentCol - visibleCols + 1;
-                        }
-                    }
+            }
+        }
+        else if (keyEvent->code == sf::Keyboard::Key::Left) {
+            // Detectar si se presiona Ctrl (Windows/Linux) o Cmd (Mac)
+            bool isCtrlCmd = input.ctrl || input.system;
+            
+            if (isCtrlCmd) {
+                // Ir al inicio de la línea
+                currentCol = 0;
+                scrollCol = 0; // Resetear scroll horizontal
+            } else if (currentCol > 0) {
+                // Navegación normal
+                currentCol--;
+                
+                // Auto-scroll horizontal hacia la izquierda si es necesario
+                if (currentCol < scrollCol) {
+                    scrollCol = currentCol;
                 }
-                else if (keyEvent->code == sf::Keyboard::Key::Up) {
-                    // Detectar si se presiona Ctrl (Windows/Linux) o Cmd (Mac)
-                    bool isCtrlCmd = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LControl) || 
-                                     sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RControl) ||
-                                     sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LSystem) || 
-                                     sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RSystem);
-                    
-                    if (isCtrlCmd) {
-                        // Scroll rápido de 10 líneas hacia arriba
-                        if (scrollLine >= 10) {
-                            scrollLine -= 10;
-                        } else {
-                            scrollLine = 0;
-                        }
-                        // Mover cursor al inicio del scroll visible
-                        currentLine = scrollLine;
-                        currentCol = std::min(currentCol, lines[currentLine].length());
-                    } else if (currentLine > 0) {
-                        // Navegación normal
-                        currentLine--;
-                        currentCol = std::min(currentCol, lines[currentLine].length());
-                        
-                        // Auto-scroll hacia arriba si es necesario
-                        if (currentLine < scrollLine) {
-                            scrollLine = currentLine;
-                        }
-                    }
+            }
+        }
+        else if (keyEvent->code == sf::Keyboard::Key::Right) {
+            // Detectar si se presiona Ctrl (Windows/Linux) o Cmd (Mac)
+            bool isCtrlCmd = input.ctrl || input.system;
+            
+            if (isCtrlCmd) {
+                // Ir al final de la línea
+                currentCol = lines[currentLine].length();
+                
+                // Auto-scroll horizontal hacia la derecha si es necesario
+                size_t visibleCols = static_cast<size_t>((textAreaRight(windowSize) - model.metrics.textStartX) /
+                                                         model.metrics.columnWidth);
+                if (currentCol >= scrollCol + visibleCols) {
+                    scrollCol = currentCol >= visibleCols ? currentCol - visibleCols + 1 : 0;
                 }
-                else if (keyEvent->code == sf::Keyboard::Key::Down) {
-                    // Detectar si se presiona Ctrl (Windows/Linux) o Cmd (Mac)
-                    bool isCtrlCmd = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LControl) || 
-                                     sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RControl) ||
-                                     sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LSystem) || 
-                                     sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RSystem);
-                    
-                    if (isCtrlCmd) {
-                        // Scroll rápido de 10 líneas hacia abajo
-                        size_t visibleLines = calculateVisibleLines(windowSize);
-                        if (visibleLines > 0) {
-                            scrollLine += 10;
-                            if (scrollLine + visibleLines > lines.size()) {
-                                scrollLine = lines.size() > visibleLines ? lines.size() - visibleLines : 0;
-                            }
-                            // Mover cursor al inicio del scroll visible
-                            currentLine = scrollLine;
-                            currentCol = std::min(currentCol, lines[currentLine].length());
-                        }
-                    } else if (currentLine < lines.size() - 1) {
-                        // Navegación normal
-                        currentLine++;
-                        currentCol = std::min(currentCol, lines[currentLine].length());
-                        
-                        // Auto-scroll hacia abajo si es necesario
-                        size_t visibleLines = calculateVisibleLines(windowSize);
-                        if (visibleLines > 0 && currentLine >= scrollLine + visibleLines) {
-                            scrollLine = currentLine - visibleLines + 1;
-                        }
-                    }
+            } else if (currentCol < lines[currentLine].length()) {
+                // Navegación normal
+                currentCol++;
+                
+                // Auto-scroll horizontal hacia la derecha si es necesario
+                size_t visibleCols = static_cast<size_t>((textAreaRight(windowSize) - model.metrics.textStartX) /
+                                                         model.metrics.columnWidth);
+                if (currentCol >= scrollCol + visibleCols) {
+                    scrollCol = currentCol - visibleCols + 1;
                 }
-                else if (keyEvent->code == sf::Keyboard::Key::PageUp) {
-                    // Scroll rápido hacia arriba
-                    size_t visibleLines = calculateVisibleLines(windowSize);
-                    if (visibleLines > 0) {
-                        if (scrollLine >= visibleLines) {
-                            scrollLine -= visibleLines;
-                        } else {
-                            scrollLine = 0;
-                        }
-                        currentLine = scrollLine;
-                        currentCol = 0;
-                    }
+            }
+        }
+        else if (keyEvent->code == sf::Keyboard::Key::Up) {
+            // Detectar si se presiona Ctrl (Windows/Linux) o Cmd (Mac)
+            bool isCtrlCmd = input.ctrl || input.system;
+            
+            if (isCtrlCmd) {
+                // Scroll rápido de 10 líneas hacia arriba
+                if (scrollLine >= 10) {
+                    scrollLine -= 10;
+                } else {
+                    scrollLine = 0;
                 }
-                else if (keyEvent->code == sf::Keyboard::Key::PageDown) {
-                    // Scroll rápido hacia abajo
-                    size_t visibleLines = calculateVisibleLines(windowSize);
-                    if (visibleLines > 0) {
-                        scrollLine += visibleLines;
-                        if (scrollLine >= lines.size()) {
-                            scrollLine = lines.size() > visibleLines ? lines.size() - visibleLines : 0;
-                        }
-                        currentLine = std::min(scrollLine + visibleLines - 1, lines.size() - 1);
-                        currentCol = 0;
-                    }
+                // Mover cursor al inicio del scroll visible
+                currentLine = scrollLine;
+                currentCol = std::min(currentCol, lines[currentLine].length());
+            } else if (currentLine > 0) {
+                // Navegación normal
+                currentLine--;
+                currentCol = std::min(currentCol, lines[currentLine].length());
+                
+                // Auto-scroll hacia arriba si es necesario
+                if (currentLine < scrollLine) {
+                    scrollLine = currentLine;
                 }
-                // Scroll horizontal con Shift+Flecha
-                else if (keyEvent->code == sf::Keyboard::Key::Left && 
-                        (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LShift) || 
-                         sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RShift))) {
-                    // Scroll horizontal hacia la izquierda
-                    if (scrollCol > 0) {
-                        scrollCol = scrollCol > 10 ? scrollCol - 10 : 0;
+            }
+        }
+        else if (keyEvent->code == sf::Keyboard::Key::Down) {
+            // Detectar si se presiona Ctrl (Windows/Linux) o Cmd (Mac)
+            bool isCtrlCmd = input.ctrl || input.system;
+            
+            if (isCtrlCmd) {
+                // Scroll rápido de 10 líneas hacia abajo
+                size_t visibleLines = calculateVisibleLines(windowSize, model.metrics.lineHeight);
+                if (visibleLines > 0) {
+                    scrollLine += 10;
+                    if (scrollLine + visibleLines > lines.size()) {
+                        scrollLine = lines.size() > visibleLines ? lines.size() - visibleLines : 0;
                     }
+                    // Mover cursor al inicio del scroll visible
+                    currentLine = scrollLine;
+                    currentCol = std::min(currentCol, lines[currentLine].length());
                 }
-                else if (keyEvent->code == sf::Keyboard::Key::Right && 
-                        (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LShift) || 
-                         sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RShift))) {
-                    // Scroll horizontal hacia la derecha
-                    scrollCol += 10;
+            } else if (currentLine < lines.size() - 1) {
+                // Navegación normal
+                currentLine++;
+                currentCol = std::min(currentCol, lines[currentLine].length());
+                
+                // Auto-scroll hacia abajo si es necesario
+                size_t visibleLines = calculateVisibleLines(windowSize, model.metrics.lineHeight);
+                if (visibleLines > 0 && currentLine >= scrollLine + visibleLines) {
+                    scrollLine = currentLine - visibleLines + 1;
                 }
-                else if (keyEvent->code == sf::Keyboard::Key::Delete) {
-                    // Guardar estado antes de modificar
-                    saveState(lines, currentLine, currentCol, "Borrar");
-                    
-                    // Si hay selección, borrar todo lo seleccionado (igual que Backspace)
-                    if (isSelecting) {
-                        // Borrar texto seleccionado
-                        size_t startLine, endLine, startCol, endCol;
-                        getSelectionBounds(selectionStartLine, selectionStartCol, selectionEndLine, selectionEndCol,
-                                         startLine, endLine, startCol, endCol);
-                        
-                        if (startLine == endLine) {
-                            // Selección en una sola línea
-                            lines[startLine].erase(startCol, endCol - startCol);
-                        } else {
-                            // Selección multi-línea
-                            std::string remainingText = lines[endLine].substr(endCol);
-                            lines[startLine] = lines[startLine].substr(0, startCol) + remainingText;
-                            lines.erase(lines.begin() + startLine + 1, lines.begin() + endLine + 1);
-                        }
-                        
-                        // Posicionar cursor al inicio de la selección
-                        currentLine = startLine;
-                        currentCol = startCol;
-                        isSelecting = false;
-                    } else {
-                        // Borrar carácter siguiente
-                        if (currentCol < lines[currentLine].length()) {
-                            lines[currentLine].erase(currentCol, 1);
-                        } else if (currentLine < lines.size() - 1) {
-                            // Fusionar con línea siguiente
-                            lines[currentLine] += lines[currentLine + 1];
-                            lines.erase(lines.begin() + currentLine + 1);
-                        }
-                    }
+            }
+        }
+        else if (keyEvent->code == sf::Keyboard::Key::PageUp) {
+            // Scroll rápido hacia arriba
+            size_t visibleLines = calculateVisibleLines(windowSize, model.metrics.lineHeight);
+            if (visibleLines > 0) {
+                if (scrollLine >= visibleLines) {
+                    scrollLine -= visibleLines;
+                } else {
+                    scrollLine = 0;
                 }
-                // Cmd+C para copiar (Mac)
-                else if (keyEvent->code == sf::Keyboard::Key::C && 
-                        (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LSystem) || 
-                         sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RSystem))) {
-                    if (isSelecting) {
-                        // Copiar texto seleccionado
-                        std::string selectedText = "";
-                        size_t startLine, endLine, startCol, endCol;
-                        getSelectionBounds(selectionStartLine, selectionStartCol, selectionEndLine, selectionEndCol,
-                                         startLine, endLine, startCol, endCol);
-                        
-                        if (startLine == endLine) {
-                            selectedText = lines[startLine].substr(startCol, endCol - startCol);
-                        } else {
-                            selectedText = lines[startLine].substr(startCol) + "\n";
-                            for (size_t i = startLine + 1; i < endLine; ++i) {
-                                selectedText += lines[i] + "\n";
-                            }
-                            selectedText += lines[endLine].substr(0, endCol);
-                        }
-                        setClipboard(selectedText);
-                    }
+                currentLine = scrollLine;
+                currentCol = 0;
+            }
+        }
+        else if (keyEvent->code == sf::Keyboard::Key::PageDown) {
+            // Scroll rápido hacia abajo
+            size_t visibleLines = calculateVisibleLines(windowSize, model.metrics.lineHeight);
+            if (visibleLines > 0) {
+                scrollLine += visibleLines;
+                if (scrollLine >= lines.size()) {
+                    scrollLine = lines.size() > visibleLines ? lines.size() - visibleLines : 0;
                 }
-                // Cmd+Z para undo (Mac) o Ctrl+Z para undo (Windows)
-                else if (keyEvent->code == sf::Keyboard::Key::Z && 
-                        (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LSystem) || 
-                         sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RSystem) ||
-                         sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LControl) || 
-                         sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RControl))) {
-                    undo(lines, currentLine, currentCol);
+                currentLine = std::min(scrollLine + visibleLines - 1, lines.size() - 1);
+                currentCol = 0;
+            }
+        }
+        // Scroll horizontal con Shift+Flecha
+        else if (keyEvent->code == sf::Keyboard::Key::Left &&
+                input.shift) {
+            // Scroll horizontal hacia la izquierda
+            if (scrollCol > 0) {
+                scrollCol = scrollCol > 10 ? scrollCol - 10 : 0;
+            }
+        }
+        else if (keyEvent->code == sf::Keyboard::Key::Right &&
+                input.shift) {
+            // Scroll horizontal hacia la derecha
+            scrollCol += 10;
+        }
+        else if (keyEvent->code == sf::Keyboard::Key::Delete) {
+            // Guardar estado antes de modificar
+            saveState(lines, currentLine, currentCol, "Borrar");
+            
+            // Si hay selección, borrar todo lo seleccionado (igual que Backspace)
+            if (isSelecting) {
+                // Borrar texto seleccionado
+                size_t startLine, endLine, startCol, endCol;
+                getSelectionBounds(selectionStartLine, selectionStartCol, selectionEndLine, selectionEndCol,
+                                 startLine, endLine, startCol, endCol);
+                
+                if (startLine == endLine) {
+                    // Selección en una sola línea
+                    lines[startLine].erase(startCol, endCol - startCol);
+                } else {
+                    // Selección multi-línea
+                    std::string remainingText = lines[endLine].substr(endCol);
+                    lines[startLine] = lines[startLine].substr(0, startCol) + remainingText;
+                    lines.erase(lines.begin() + startLine + 1, lines.begin() + endLine + 1);
                 }
-                // Cmd+Shift+Z para redo (Mac) o Ctrl+Y para redo (Windows)
-                else if ((keyEvent->code == sf::Keyboard::Key::Z && 
-                         (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LSystem) || 
-                          sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RSystem)) &&
-                         (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LShift) || 
-                          sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RShift))) ||
-                        (keyEvent->code == sf::Keyboard::Key::Y && 
-                         (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LControl) || 
-                          sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RControl)))) {
-                    redo(lines, currentLine, currentCol);
+                
+                // Posicionar cursor al inicio de la selección
+                currentLine = startLine;
+                currentCol = startCol;
+                isSelecting = false;
+            } else {
+                // Borrar carácter siguiente
+                if (currentCol < lines[currentLine].length()) {
+                    lines[currentLine].erase(currentCol, 1);
+                } else if (currentLine < lines.size() - 1) {
+                    // Fusionar con línea siguiente
+                    lines[currentLine] += lines[currentLine + 1];
+                    lines.erase(lines.begin() + currentLine + 1);
                 }
-                // Cmd+V para pegar (Mac)
-                else if (keyEvent->code == sf::Keyboard::Key::V && 
-                        (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LSystem) || 
-                         sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RSystem))) {
-                    std::string clipboardText = getClipboard();
-                    if (!clipboardText.empty()) {
-                        // Guardar estado antes de pegar
-                        saveState(lines, currentLine, currentCol, "Pegar");
-                        
-                        // Insertar texto del clipboard
-                        for (char c : clipboardText) {
-                            if (c == '\n') {
-                                // Nueva línea
-                                std::string currentText = lines[currentLine];
-                                std::string remainingText = currentText.substr(currentCol);
-                                lines[currentLine] = currentText.substr(0, currentCol);
-                                lines.insert(lines.begin() + currentLine + 1, remainingText);
-                                currentLine++;
-                                currentCol = 0;
-                            } else if (c >= 32 && c < 127) {
-                                lines[currentLine].insert(currentCol, 1, c);
-                                currentCol++;
-                            }
-                        }
+            }
+        }
+        // Cmd+C para copiar (Mac)
+        else if (keyEvent->code == sf::Keyboard::Key::C &&
+                input.system) {
+            if (isSelecting) {
+                // Copiar texto seleccionado
+                std::string selectedText = "";
+                size_t startLine, endLine, startCol, endCol;
+                getSelectionBounds(selectionStartLine, selectionStartCol, selectionEndLine, selectionEndCol,
+                                 startLine, endLine, startCol, endCol);
+                
+                if (startLine == endLine) {
+                    selectedText = lines[startLine].substr(startCol, endCol - startCol);
+                } else {
+                    selectedText = lines[startLine].substr(startCol) + "\n";
+                    for (size_t i = startLine + 1; i < endLine; ++i) {
+                        selectedText += lines[i] + "\n";
                     }
+                    selectedText += lines[endLine].substr(0, endCol);
                 }
+                setClipboard(selectedText);
             }
-            else if (auto* textEvent = event->getIf<sf::Event::TextEntered>()) {
-                // Agregar carácter - método que funciona perfecto
-                uint32_t unicode = textEvent->unicode;
-                if (unicode >= 32 && unicode < 127) {
-                    char c = static_cast<char>(unicode);
-                    
-                    // Guardar estado antes de modificar
-                    saveState(lines, currentLine, currentCol, "Escribir");
-                    
-                    // Si hay selección, reemplazarla con el nuevo carácter
-                    if (isSelecting) {
-                        // Borrar texto seleccionado primero
-                        size_t startLine, endLine, startCol, endCol;
-                        getSelectionBounds(selectionStartLine, selectionStartCol, selectionEndLine, selectionEndCol,
-                                         startLine, endLine, startCol, endCol);
-                        
-                        if (startLine == endLine) {
-                            // Selección en una sola línea
-                            lines[startLine].erase(startCol, endCol - startCol);
-                        } else {
-                            // Selección multi-línea
-                            std::string remainingText = lines[endLine].substr(endCol);
-                            lines[startLine] = lines[startLine].substr(0, startCol) + remainingText;
-                            lines.erase(lines.begin() + startLine + 1, lines.begin() + endLine + 1);
-                        }
-                        
-                        // Posicionar cursor al inicio de la selección
-                        currentLine = startLine;
-                        currentCol = startCol;
-                        isSelecting = false;
+        }
+        // Cmd+Z para undo (Mac) o Ctrl+Z para undo (Windows)
+        else if (keyEvent->code == sf::Keyboard::Key::Z && 
+                (input.system ||
+                 input.ctrl)) {
+            if (undo(lines, currentLine, currentCol)) {
+                invalidateCheckpoints(model, 0, 0);
+                markMinimapLines(model, 0, SIZE_MAX);
+            }
+        }
+        // Cmd+Shift+Z para redo (Mac) o Ctrl+Y para redo (Windows)
+        else if ((keyEvent->code == sf::Keyboard::Key::Z &&
+                 input.system &&
+                 input.shift) ||
+                (keyEvent->code == sf::Keyboard::Key::Y &&
+                 input.ctrl)) {
+            if (redo(lines, currentLine, currentCol)) {
+                invalidateCheckpoints(model, 0, 0);
+                markMinimapLines(model, 0, SIZE_MAX);
+            }
+        }
+        // Cmd+V para pegar (Mac)
+        else if (keyEvent->code == sf::Keyboard::Key::V &&
+                input.system) {
+            std::string clipboardText = getClipboard();
+            if (!clipboardText.empty()) {
+                // Guardar estado antes de pegar
+                saveState(lines, currentLine, currentCol, "Pegar");
+                
+                // Insertar texto del clipboard
+                for (char c : clipboardText) {
+                    if (c == '\n') {
+                        // Nueva línea
+                        std::string currentText = lines[currentLine];
+                        std::string remainingText = currentText.substr(currentCol);
+                        lines[currentLine] = currentText.substr(0, currentCol);
+                        lines.insert(lines.begin() + currentLine + 1, remainingText);
+                        currentLine++;
+                        currentCol = 0;
+                    } else if (c >= 32 && c < 127) {
+                        lines[currentLine].insert(currentCol, 1, c);
+                        currentCol++;
                     }
-                    
-                    // Insertar el nuevo carácter
-                    lines[currentLine].insert(currentCol, 1, c);
-                    currentCol++;
                 }
             }
-            else if (auto* mouseEvent = event->getIf<sf::Event::MouseButtonPressed>()) {
-                if (mouseEvent->button == sf::Mouse::Button::Left) {
-                    // Calcular posición del cursor basada en click del mouse
-                    float mouseX = static_cast<float>(mouseEvent->position.x);
-                    float mouseY = static_cast<float>(mouseEvent->position.y);
-                    
-                    // Verificar si click en barra de scroll vertical
-                    float scrollBarX = static_cast<float>(windowSize.x) - scrollBarWidth;
-                    float horizontalScrollY = static_cast<float>(windowSize.y) - 25 - scrollBarHeight;
-                    
-                    if (mouseX > scrollBarX && mouseY < windowSize.y - 25 - scrollBarHeight) {
-                        // Click en barra de scroll vertical
-                        isScrolling = true;
-                        
-                        // Calcular nueva posición de scroll basada en click
-                        float scrollAreaHeight = windowSize.y - 50 - scrollBarHeight; // Sin barra de estado ni scroll horizontal
-                        float clickRatio = mouseY / scrollAreaHeight;
-                        size_t maxScroll = lines.size() > (windowSize.y - 50 - scrollBarHeight) / 24 ? 
-                                         lines.size() - (windowSize.y - 50 - scrollBarHeight) / 24 : 0;
-                        scrollLine = static_cast<size_t>(clickRatio * maxScroll);
-                        
-                        // Asegurar límites
-                        if (scrollLine > maxScroll) scrollLine = maxScroll;
-                    }
-                    else if (mouseY > horizontalScrollY && mouseY < windowSize.y - 25 && 
-                             mouseX > textStartX && mouseX < scrollBarX) {
-                        // Click en barra de scroll horizontal
-                        isScrollingHorizontal = true;
-                        
-                        // Calcular nueva posición de scroll horizontal basada en click
-                        float scrollAreaWidth = scrollBarX - textStartX;
-                        float clickRatio = (mouseX - textStartX) / scrollAreaWidth;
-                        
-                        // Encontrar la línea más larga para calcular el máximo scroll
-                        size_t maxLineLength = 0;
-                        for (const auto& line : lines) {
-                            maxLineLength = std::max(maxLineLength, line.length());
-                        }
-                        
-                        size_t visibleCols = static_cast<size_t>(scrollAreaWidth / 9.6f);
-                        size_t maxScrollCol = maxLineLength > visibleCols ? maxLineLength - visibleCols : 0;
-                        scrollCol = static_cast<size_t>(clickRatio * maxScrollCol);
-                        
-                        // Asegurar límites
-                        if (scrollCol > maxScrollCol) scrollCol = maxScrollCol;
-                    }
-                    else if (mouseX > textStartX && mouseX < scrollBarX && mouseY < windowSize.y - 25 - scrollBarHeight) {
-                        // Dentro del área de texto
-                        size_t clickedLine = scrollLine + static_cast<size_t>((mouseY - 20.0f) / 24.0f);
-                        size_t clickedCol = scrollCol + static_cast<size_t>((mouseX - textStartX) / 9.6f);
-                        
-                        if (clickedLine < lines.size()) {
-                            currentLine = clickedLine;
-                            currentCol = std::min(clickedCol, lines[currentLine].length());
-                            
-                            // Iniciar selección
-                            isSelecting = true;
-                            selectionStartLine = currentLine;
-                            selectionStartCol = currentCol;
-                            selectionEndLine = currentLine;
-                            selectionEndCol = currentCol;
-                        }
-                    }
+        }
+    }
+    else if (auto* textEvent = event->getIf<sf::Event::TextEntered>()) {
+        // Agregar carácter - método que funciona perfecto
+        uint32_t unicode = textEvent->unicode;
+        if (unicode >= 32 && unicode < 127) {
+            char c = static_cast<char>(unicode);
+            
+            // Guardar estado antes de modificar
+            saveState(lines, currentLine, currentCol, "Escribir");
+            
+            // Si hay selección, reemplazarla con el nuevo carácter
+            if (isSelecting) {
+                // Borrar texto seleccionado primero
+                size_t startLine, endLine, startCol, endCol;
+                getSelectionBounds(selectionStartLine, selectionStartCol, selectionEndLine, selectionEndCol,
+                                 startLine, endLine, startCol, endCol);
+                
+                if (startLine == endLine) {
+                    // Selección en una sola línea
+                    lines[startLine].erase(startCol, endCol - startCol);
+                } else {
+                    // Selección multi-línea
+                    std::string remainingText = lines[endLine].substr(endCol);
+                    lines[startLine] = lines[startLine].substr(0, startCol) + remainingText;
+                    lines.erase(lines.begin() + startLine + 1, lines.begin() + endLine + 1);
                 }
+                
+                // Posicionar cursor al inicio de la selección
+                currentLine = startLine;
+                currentCol = startCol;
+                isSelecting = false;
             }
-            else if (auto* mouseEvent = event->getIf<sf::Event::MouseButtonReleased>()) {
-                if (mouseEvent->button == sf::Mouse::Button::Left) {
-                    if (isScrolling) {
-                        isScrolling = false;
-                    }
-                    else if (isScrollingHorizontal) {
-                        isScrollingHorizontal = false;
-                    }
-                    else if (isSelecting) {
-                        // Finalizar selección si no hay texto seleccionado
-                        if (selectionStartLine == selectionEndLine && selectionStartCol == selectionEndCol) {
-                            isSelecting = false;
-                        }
-                    }
+            
+            // Insertar el nuevo carácter
+            lines[currentLine].insert(currentCol, 1, c);
+            currentCol++;
+        }
+    }
+    else if (auto* mouseEvent = event->getIf<sf::Event::MouseButtonPressed>()) {
+        if (mouseEvent->button == sf::Mouse::Button::Left) {
+            // Calcular posición del cursor basada en click del mouse
+            float mouseX = static_cast<float>(mouseEvent->position.x);
+            float mouseY = static_cast<float>(mouseEvent->position.y);
+            
+            // Verificar si click en barra de scroll vertical
+            float scrollBarX = static_cast<float>(windowSize.x) - scrollBarWidth;
+            float textRight = textAreaRight(windowSize);
+            float horizontalScrollY = static_cast<float>(windowSize.y) - 25 - scrollBarHeight;
+            
+            if (mouseX > scrollBarX && mouseY < windowSize.y - 25 - scrollBarHeight) {
+                // Click en barra de scroll vertical
+                isScrolling = true;
+                
+                // Calcular nueva posición de scroll basada en click
+                float scrollAreaHeight = windowSize.y - 50 - scrollBarHeight; // Sin barra de estado ni scroll horizontal
+                float clickRatio = mouseY / scrollAreaHeight;
+                size_t maxScroll = lines.size() > (windowSize.y - 50 - scrollBarHeight) / model.metrics.lineHeight ? 
+                                 lines.size() - (windowSize.y - 50 - scrollBarHeight) / model.metrics.lineHeight : 0;
+                scrollLine = static_cast<size_t>(clickRatio * maxScroll);
+                
+                // Asegurar límites
+                if (scrollLine > maxScroll) scrollLine = maxScroll;
+            }
+            else if (mouseY > horizontalScrollY && mouseY < windowSize.y - 25 && 
+                     mouseX > textStartX && mouseX < textRight) {
+                // Click en barra de scroll horizontal
+                isScrollingHorizontal = true;
+                
+                // Calcular nueva posición de scroll horizontal basada en click
+                float scrollAreaWidth = textRight - textStartX;
+                float clickRatio = (mouseX - textStartX) / scrollAreaWidth;
+                
+                // Línea más larga para el máximo scroll (cacheada hasta la próxima edición)
+                updateLineStats(model);
+                const size_t maxLineLength = model.maxLineLength;
+                
+                size_t visibleCols = static_cast<size_t>(scrollAreaWidth / model.metrics.columnWidth);
+                size_t maxScrollCol = maxLineLength > visibleCols ? maxLineLength - visibleCols : 0;
+                scrollCol = static_cast<size_t>(clickRatio * maxScrollCol);
+                
+                // Asegurar límites
+                if (scrollCol > maxScrollCol) scrollCol = maxScrollCol;
+            }
+            else if (mouseX >= textRight && mouseX < scrollBarX && mouseY < horizontalScrollY) {
+                // Click en el minimapa: la línea pulsada queda en el centro
+                const float rowHeight = minimapRowHeight(windowSize, model.minimap.rows);
+                if (rowHeight > 0.0f) {
+                    size_t clickedLine = static_cast<size_t>(mouseY / rowHeight) * model.minimap.linesPerRow;
+                    size_t visibleLines = calculateVisibleLines(windowSize, model.metrics.lineHeight);
+                    size_t maxScroll = lines.size() > visibleLines ? lines.size() - visibleLines : 0;
+                    scrollLine = std::min(clickedLine > visibleLines / 2 ? clickedLine - visibleLines / 2 : 0, maxScroll);
                 }
             }
-            else if (auto* mouseEvent = event->getIf<sf::Event::MouseMoved>()) {
-                if (isScrolling && sf::Mouse::isButtonPressed(sf::Mouse::Button::Left)) {
-                    // Arrastrar barra de scroll vertical
-                    float mouseY = static_cast<float>(mouseEvent->position.y);
-                    float scrollAreaHeight = windowSize.y - 50 - scrollBarHeight;
-                    float dragRatio = mouseY / scrollAreaHeight;
-                    size_t maxScroll = lines.size() > (windowSize.y - 50 - scrollBarHeight) / 24 ? 
-                                     lines.size() - (windowSize.y - 50 - scrollBarHeight) / 24 : 0;
-                    scrollLine = static_cast<size_t>(dragRatio * maxScroll);
+            else if (mouseX > textStartX && mouseX < textRight && mouseY < windowSize.y - 25 - scrollBarHeight) {
+                // Dentro del área de texto
+                size_t clickedLine = scrollLine + static_cast<size_t>((mouseY - 20.0f) / model.metrics.lineHeight);
+                
+                if (clickedLine < lines.size()) {
+                    currentLine = clickedLine;
+                    currentCol = columnAtX(model, clickedLine, mouseX);
                     
-                    // Asegurar límites
-                    if (scrollLine > maxScroll) scrollLine = maxScroll;
+                    // Iniciar selección
+                    isSelecting = true;
+                    selectionStartLine = currentLine;
+                    selectionStartCol = currentCol;
+                    selectionEndLine = currentLine;
+                    selectionEndCol = currentCol;
                 }
-                else if (isScrollingHorizontal && sf::Mouse::isButtonPressed(sf::Mouse::Button::Left)) {
-                    // Arrastrar barra de scroll horizontal
-                    float mouseX = static_cast<float>(mouseEvent->position.x);
-                    float scrollBarX = static_cast<float>(windowSize.x) - scrollBarWidth;
-                    float scrollAreaWidth = scrollBarX - textStartX;
-                    float dragRatio = (mouseX - textStartX) / scrollAreaWidth;
-                    
-                    // Encontrar la línea más larga para calcular el máximo scroll
-                    size_t maxLineLength = 0;
-                    for (const auto& line : lines) {
-                        maxLineLength = std::max(maxLineLength, line.length());
-                    }
-                    
-                    size_t visibleCols = static_cast<size_t>(scrollAreaWidth / 9.6f);
-                    size_t maxScrollCol = maxLineLength > visibleCols ? maxLineLength - visibleCols : 0;
-                    scrollCol = static_cast<size_t>(dragRatio * maxScrollCol);
-                    
-                    // Asegurar límites
-                    if (scrollCol > maxScrollCol) scrollCol = maxScrollCol;
+            }
+        }
+    }
+    else if (auto* mouseEvent = event->getIf<sf::Event::MouseButtonReleased>()) {
+        if (mouseEvent->button == sf::Mouse::Button::Left) {
+            if (isScrolling) {
+                isScrolling = false;
+            }
+            else if (isScrollingHorizontal) {
+                isScrollingHorizontal = false;
+            }
+            else if (isSelecting) {
+                // Finalizar selección si no hay texto seleccionado
+                if (selectionStartLine == selectionEndLine && selectionStartCol == selectionEndCol) {
+                    isSelecting = false;
                 }
-                else if (isSelecting && sf::Mouse::isButtonPressed(sf::Mouse::Button::Left)) {
-                    // Actualizar selección mientras se arrastra
-                    float mouseX = static_cast<float>(mouseEvent->position.x);
-                    float mouseY = static_cast<float>(mouseEvent->position.y);
-                    float scrollBarX = static_cast<float>(windowSize.x) - scrollBarWidth;
-                    
-                    if (mouseX > textStartX && mouseX < scrollBarX && mouseY < windowSize.y - 25 - scrollBarHeight) {
-                        size_t dragLine = scrollLine + static_cast<size_t>((mouseY - 20.0f) / 24.0f);
-                        size_t dragCol = scrollCol + static_cast<size_t>((mouseX - textStartX) / 9.6f);
-                        
-                        if (dragLine < lines.size()) {
-                            selectionEndLine = dragLine;
-                            selectionEndCol = std::min(dragCol, lines[dragLine].length());
-                        }
-                    }
+            }
+        }
+    }
+    else if (auto* mouseEvent = event->getIf<sf::Event::MouseMoved>()) {
+        if (isScrolling && input.leftButton) {
+            // Arrastrar barra de scroll vertical
+            float mouseY = static_cast<float>(mouseEvent->position.y);
+            float scrollAreaHeight = windowSize.y - 50 - scrollBarHeight;
+            float dragRatio = mouseY / scrollAreaHeight;
+            size_t maxScroll = lines.size() > (windowSize.y - 50 - scrollBarHeight) / model.metrics.lineHeight ? 
+                             lines.size() - (windowSize.y - 50 - scrollBarHeight) / model.metrics.lineHeight : 0;
+            scrollLine = static_cast<size_t>(dragRatio * maxScroll);
+            
+            // Asegurar límites
+            if (scrollLine > maxScroll) scrollLine = maxScroll;
+        }
+        else if (isScrollingHorizontal && input.leftButton) {
+            // Arrastrar barra de scroll horizontal
+            float mouseX = static_cast<float>(mouseEvent->position.x);
+            float scrollAreaWidth = textAreaRight(windowSize) - textStartX;
+            float dragRatio = (mouseX - textStartX) / scrollAreaWidth;
+            
+            // Línea más larga para el máximo scroll (cacheada hasta la próxima edición)
+            updateLineStats(model);
+            const size_t maxLineLength = model.maxLineLength;
+            
+            size_t visibleCols = static_cast<size_t>(scrollAreaWidth / model.metrics.columnWidth);
+            size_t maxScrollCol = maxLineLength > visibleCols ? maxLineLength - visibleCols : 0;
+            scrollCol = static_cast<size_t>(dragRatio * maxScrollCol);
+            
+            // Asegurar límites
+            if (scrollCol > maxScrollCol) scrollCol = maxScrollCol;
+        }
+        else if (isSelecting && input.leftButton) {
+            // Actualizar selección mientras se arrastra
+            float mouseX = static_cast<float>(mouseEvent->position.x);
+            float mouseY = static_cast<float>(mouseEvent->position.y);
+            
+            if (mouseX > textStartX && mouseX < textAreaRight(windowSize) && mouseY < windowSize.y - 25 - scrollBarHeight) {
+                size_t dragLine = scrollLine + static_cast<size_t>((mouseY - 20.0f) / model.metrics.lineHeight);
+                
+                if (dragLine < lines.size()) {
+                    selectionEndLine = dragLine;
+                    selectionEndCol = columnAtX(model, dragLine, mouseX);
                 }
             }
-            else if (auto* scrollEvent = event->getIf<sf::Event::MouseWheelScrolled>()) {
-                if (scrollEvent->wheel == sf::Mouse::Wheel::Vertical) {
-                    // Verificar si se mantiene presionado Shift para scroll horizontal
-                    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LShift) || 
-                        sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RShift)) {
-                        // Scroll horizontal con Shift + rueda del mouse (lógica de Mac)
-                        if (scrollEvent->delta > 0) {
-                            // Rueda hacia arriba = scroll hacia la izquierda (Mac)
-                            if (scrollCol > 0) {
-                                scrollCol = scrollCol > 3 ? scrollCol - 3 : 0;
-                            }
-                        } else {
-                            // Rueda hacia abajo = scroll hacia la derecha (Mac)
-                            scrollCol += 3;
-                        }
-                    } else {
-                        // Scroll vertical normal (lógica de Mac invertida)
-                        if (scrollEvent->delta > 0) {
-                            // Rueda hacia arriba = scroll hacia arriba (Mac)
-                            if (scrollLine > 0) {
-                                scrollLine--;
-                            }
-                        } else {
-                            // Rueda hacia abajo = scroll hacia abajo (Mac)
-                            size_t visibleLines = calculateVisibleLines(windowSize);
-                            if (visibleLines > 0 && scrollLine + visibleLines < lines.size()) {
-                                scrollLine++;
-                            }
-                        }
+        }
+    }
+    else if (auto* scrollEvent = event->getIf<sf::Event::MouseWheelScrolled>()) {
+        if (scrollEvent->wheel == sf::Mouse::Wheel::Vertical) {
+            if (input.ctrl || input.system) {
+                // Zoom con Ctrl/Cmd + rueda: un punto de fuente por paso
+                const unsigned fontSize = model.metrics.fontSize;
+                setFontSize(model, scrollEvent->delta > 0 ? fontSize + 1 : fontSize - 1);
+            }
+            // Verificar si se mantiene presionado Shift para scroll horizontal
+            else if (input.shift) {
+                // Scroll horizontal con Shift + rueda del mouse (lógica de Mac)
+                if (scrollEvent->delta > 0) {
+                    // Rueda hacia arriba = scroll hacia la izquierda (Mac)
+                    if (scrollCol > 0) {
+                        scrollCol = scrollCol > 3 ? scrollCol - 3 : 0;
                     }
+                } else {
+                    // Rueda hacia abajo = scroll hacia la derecha (Mac)
+                    scrollCol += 3;
                 }
-                else if (scrollEvent->wheel == sf::Mouse::Wheel::Horizontal) {
-                    // Scroll horizontal nativo del mouse (trackpad Mac)
-                    if (scrollEvent->delta > 0) {
-                        // Scroll hacia la derecha
-                        scrollCol += 3;
-                    } else {
-                        // Scroll hacia la izquierda
-                        if (scrollCol > 0) {
-                            scrollCol = scrollCol > 3 ? scrollCol - 3 : 0;
-                        }
+            } else {
+                // Scroll vertical normal (lógica de Mac invertida)
+                if (scrollEvent->delta > 0) {
+                    // Rueda hacia arriba = scroll hacia arriba (Mac)
+                    if (scrollLine > 0) {
+                        scrollLine--;
+                    }
+                } else {
+                    // Rueda hacia abajo = scroll hacia abajo (Mac)
+                    size_t visibleLines = calculateVisibleLines(windowSize, model.metrics.lineHeight);
+                    if (visibleLines > 0 && scrollLine + visibleLines < lines.size()) {
+                        scrollLine++;
                     }
                 }
             }
-            else if (auto* resizeEvent = event->getIf<sf::Event::Resized>()) {
-                // Actualizar tamaño de ventana
-                windowSize = sf::Vector2u(resizeEvent->size.x, resizeEvent->size.y);
-                
-                // Crear una vista que mapee 1:1 con los pixels de la ventana
-                sf::View view;
-                view.setSize(sf::Vector2f(static_cast<float>(windowSize.x), static_cast<float>(windowSize.y)));
-                view.setCenter(sf::Vector2f(static_cast<float>(windowSize.x) / 2.0f, static_cast<float>(windowSize.y) / 2.0f));
-                window.setView(view);
+        }
+        else if (scrollEvent->wheel == sf::Mouse::Wheel::Horizontal) {
+            // Scroll horizontal nativo del mouse (trackpad Mac)
+            if (scrollEvent->delta > 0) {
+                // Scroll hacia la derecha
+                scrollCol += 3;
+            } else {
+                // Scroll hacia la izquierda
+                if (scrollCol > 0) {
+                    scrollCol = scrollCol > 3 ? scrollCol - 3 : 0;
+                }
+            }
+        }
+    }
+    else if (auto* resizeEvent = event->getIf<sf::Event::Resized>()) {
+        // La vista la ajusta el hilo de render; aquí solo cambia el layout
+        windowSize = sf::Vector2u(resizeEvent->size.x, resizeEvent->size.y);
+    }
+    
+    // Si el evento editó, los checkpoints del lexer anteriores al cambio siguen valiendo
+    if (savedStateCount != statesBefore) {
+        invalidateCheckpoints(model, editLine, editCol);
+    }
+    
+    validateEditorState(lines, currentLine, currentCol);
+    
+    // El minimapa solo redibuja las líneas tocadas (desde la primera que
+    // pudo cambiar hasta el cursor)
+    if (savedStateCount != statesBefore) {
+        noteMinimapEdit(model, std::min(editLine, cursorLineBefore), linesBefore);
+    }
+}
+
+// Snapshot del pool que ya nadie referencia (ni el render ni el publicado)
+std::shared_ptr<FrameSnapshot> acquireSnapshot(EditorModel& model) {
+    for (const auto& candidate : model.snapshotPool) {
+        if (candidate.use_count() == 1) {
+            // Lo último que hizo el render con él ocurre antes de reescribirlo
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return candidate;
+        }
+    }
+    auto frame = std::make_shared<FrameSnapshot>();
+    if (model.snapshotPool.size() < SNAPSHOT_POOL_SIZE) {
+        model.snapshotPool.push_back(frame);
+    }
+    return frame;
+}
+
+// Construye el snapshot inmutable del estado actual. En estado estable
+// (mismo documento, mismo número de líneas visibles) no asigna memoria
+std::shared_ptr<const FrameSnapshot> buildSnapshot(EditorModel& model, uint64_t editNs = 0) {
+    CoralCode::AllocationTracker::Scope allocationSite(CoralCode::AllocationSite::Snapshot);
+    const uint64_t start = CoralCode::FrameProfiler::now();
+    std::shared_ptr<FrameSnapshot> frame = acquireSnapshot(model);
+    frame->sequence = ++model.snapshotCount;
+    frame->editNs = editNs;
+    const std::vector<std::string>& lines = model.lines;
+    
+    updateLineStats(model);
+    
+    frame->totalLines = lines.size();
+    frame->maxLineLength = model.maxLineLength;
+    frame->scrollLine = model.scrollLine;
+    frame->scrollCol = model.scrollCol;
+    frame->currentLine = model.currentLine;
+    frame->currentCol = model.currentCol;
+    frame->metrics = model.metrics;
+    frame->closeRequested = model.closeRequested;
+    
+    // Selección ordenada (también la usa la barra de estado)
+    size_t selStart = 0, selEnd = 0, startCol = 0, endCol = 0;
+    if (model.isSelecting) {
+        getSelectionBounds(model.selectionStartLine, model.selectionStartCol, model.selectionEndLine, model.selectionEndCol,
+                         selStart, selEnd, startCol, endCol);
+    }
+    
+    // Highlighting solo de las líneas visibles (desde la columna de scroll)
+    {
+        CoralCode::AllocationTracker::Scope highlightSite(CoralCode::AllocationSite::Highlight);
+        size_t visibleLines = calculateVisibleLines(model.windowSize, model.metrics.lineHeight);
+        size_t lastLine = std::min(lines.size(), model.scrollLine + visibleLines);
+        size_t count = 0;
+        for (size_t i = model.scrollLine; i < lastLine; ++i, ++count) {
+            if (count == frame->visibleLines.size()) {
+                frame->visibleLines.emplace_back();
+            }
+            SnapshotLine& line = frame->visibleLines[count];
+            line.number = i;
+            line.length = lines[i].length();
+            
+            // Solo la parte visible: en líneas largas, una ventana desde el
+            // scroll lexada desde el checkpoint anterior
+            const size_t from = std::min(model.scrollCol, line.length);
+            const size_t to = isLongLine(lines[i]) ? std::min(line.length, from + LONG_LINE_WINDOW) : line.length;
+            line.tokenCount = processLine(lines[i], from, to, lexStateFor(model, i, from), line.tokens);
+            
+            // x de cada token y de la selección con los avances de la fuente
+            size_t base = 0;
+            const CoralCode::LineLayout& layout = visibleLayout(model, i, base);
+            const float scrollX = layout.offsetOf(from - base);
+            auto xOf = [&layout, base, scrollX](size_t col) {
+                return layout.offsetOf(col > base ? col - base : 0) - scrollX;
+            };
+            if (line.tokenX.size() < line.tokenCount) {
+                line.tokenX.resize(line.tokenCount);
+            }
+            size_t column = from;
+            for (size_t t = 0; t < line.tokenCount; ++t) {
+                line.tokenX[t] = xOf(column);
+                column += line.tokens[t].first.length();
+            }
+            
+            line.selectionX = 0.0f;
+            line.selectionWidth = 0.0f;
+            if (model.isSelecting && i >= selStart && i <= selEnd) {
+                const float left = xOf(i == selStart ? startCol : 0);
+                const float right = xOf(i == selEnd ? endCol : line.length);
+                line.selectionX = std::max(0.0f, left);
+                line.selectionWidth = std::max(0.0f, right - line.selectionX);
+            }
+            
+            if (i == model.currentLine) {
+                frame->cursorX = xOf(model.currentCol);
             }
         }
+        frame->visibleLineCount = count;
+    }
+    
+    size_t tokenBytes = frame->visibleLines.capacity() * sizeof(SnapshotLine);
+    for (const auto& line : frame->visibleLines) {
+        tokenBytes += line.tokens.capacity() * sizeof(ColoredToken);
+        for (const auto& token : line.tokens) {
+            tokenBytes += CoralCode::MemoryUsage::stringBytes(token.first);
+        }
+    }
+    for (const auto& checkpoints : model.lexerCheckpoints) {
+        tokenBytes += checkpoints.states.capacity() * sizeof(LexState);
+    }
+    frame->memory[CoralCode::MemorySubsystem::Buffer] = model.bufferBytes;
+    frame->memory[CoralCode::MemorySubsystem::LineIndex] = model.lineIndexBytes;
+    frame->memory[CoralCode::MemorySubsystem::UndoHistory] = historyBytes;
+    frame->memory[CoralCode::MemorySubsystem::TokenCache] = tokenBytes;
+    frame->memory[CoralCode::MemorySubsystem::Minimap] = model.minimap.image->getMemoryUsage() +
+        model.minimap.tokens.capacity() * sizeof(ColoredToken);
+    
+    CoralCode::AllocationTracker::Scope statusSite(CoralCode::AllocationSite::StatusBar);
+    char statusInfo[512];
+    int length = std::snprintf(statusInfo, sizeof(statusInfo),
+                               "Línea: %zu  Columna: %zu  Total líneas: %zu  Caracteres: %zu",
+                               model.currentLine + 1, model.currentCol + 1, lines.size(),
+                               lines[model.currentLine].length());
+    
+    frame->isSelecting = model.isSelecting;
+    if (model.isSelecting) {
+        frame->selectionFirstLine = selStart;
+        frame->selectionLastLine = selEnd;
+        frame->selectionStartCol = startCol;
+        frame->selectionEndCol = endCol;
         
-        // Renderizar
-        window.clear(backgroundColor);
+        size_t selectedLines = selEnd - selStart + 1;
+        size_t selectedChars = 0;
         
-        // Obtener tamaño actual de ventana
-        sf::Vector2u currentWindowSize = window.getSize();
+        if (selStart == selEnd) {
+            selectedChars = endCol - startCol;
+        } else {
+            selectedChars += lines[selStart].length() - startCol + 1; // +1 for newline
+            for (size_t i = selStart + 1; i < selEnd; ++i) {
+                selectedChars += lines[i].length() + 1; // +1 for newline
+            }
+            selectedChars += endCol;
+        }
         
-        // Solo actualizar windowSize si realmente cambió
-        if (currentWindowSize.x != windowSize.x || currentWindowSize.y != windowSize.y) {
-            windowSize = currentWindowSize;
+        length += std::snprintf(statusInfo + length, sizeof(statusInfo) - static_cast<size_t>(length),
+                                "  |  SELECCIÓN - Líneas: %zu  Caracteres: %zu", selectedLines, selectedChars);
+    }
+    
+    length += std::snprintf(statusInfo + length, sizeof(statusInfo) - static_cast<size_t>(length),
+                            "  |  Scroll H: %zu  |  Fuente: %u px  |  Cmd+C: Copiar  Cmd+V: Pegar  Cmd+Z: Undo  Cmd+Shift+Z: Redo  ⚡: Ctrl+Flechas  🔄: Rueda/Trackpad",
+                            model.scrollCol, model.metrics.fontSize);
+    frame->status.assign(statusInfo, std::min(static_cast<size_t>(length), sizeof(statusInfo) - 1));
+    frame->highlightNs = CoralCode::FrameProfiler::now() - start;
+    return frame;
+}
+
+// Hilo dueño del modelo: aplica la cola de eventos y publica snapshots
+class ModelThread {
+public:
+    ModelThread(const sf::Vector2u& windowSize, CoralCode::TextLayout::GlyphAdvanceFunction glyphAdvances) {
+        model_.windowSize = windowSize;
+        if (glyphAdvances) {
+            model_.layout.setGlyphAdvanceProvider(std::move(glyphAdvances));
         }
         
-        // Calcular posiciones una vez por frame
-        float statusBarHeight = 25.0f;
-        float statusBarY = static_cast<float>(windowSize.y) - statusBarHeight;
-        float lineNumberWidth = 50.0f;
+        // Guardar estado inicial
+        saveState(model_.lines, model_.currentLine, model_.currentCol, "Estado inicial");
+        snapshot_ = buildSnapshot(model_);
+        thread_ = std::thread(&ModelThread::run, this);
+    }
+    
+    ~ModelThread() {
+        stop();
+    }
+    
+    // Llamado por el hilo de render: nunca espera a que se procese
+    void push(const InputEvent& input) {
+        {
+            std::lock_guard<std::mutex> lock(inputMutex_);
+            input_.push_back(input);
+        }
+        inputReady_.notify_one();
+    }
+    
+    // applied recibe los eventos trazados que ya incluye el snapshot
+    std::shared_ptr<const FrameSnapshot> latest(std::vector<TracedInput>* applied = nullptr) {
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        if (applied) {
+            applied->swap(appliedInputs_);
+            appliedInputs_.clear();
+        }
+        return snapshot_;
+    }
+    
+    // Procesa lo pendiente y detiene el hilo; después model() es seguro
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(inputMutex_);
+            stopping_ = true;
+        }
+        inputReady_.notify_one();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+    
+    const EditorModel& model() const { return model_; }
+    
+    // Píxeles del minimapa: el modelo los reescribe y el render los sube
+    std::shared_ptr<MinimapImage> minimapImage() const { return model_.minimap.image; }
+    
+private:
+    EditorModel model_;
+    std::thread thread_;
+    
+    std::mutex inputMutex_;
+    std::condition_variable inputReady_;
+    std::vector<InputEvent> input_;
+    bool stopping_ = false;
+    
+    mutable std::mutex snapshotMutex_;
+    std::shared_ptr<const FrameSnapshot> snapshot_;
+    std::vector<TracedInput> appliedInputs_;
+    
+    void run() {
+        CoralCode::LatencyTracer& tracer = CoralCode::LatencyTracer::shared();
+        CoralCode::LatencyTracer::setThreadName("Modelo");
+        std::vector<InputEvent> batch;
+        std::vector<TracedInput> traced;
+        bool minimapPending = updateMinimap(model_);
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(inputMutex_);
+                inputReady_.wait(lock, [this, minimapPending] { return stopping_ || !input_.empty() || minimapPending; });
+                if (stopping_ && input_.empty()) return;
+                batch.swap(input_);
+            }
+            
+            // Sin eventos: otro tramo del minimapa (los eventos van antes)
+            if (batch.empty()) {
+                minimapPending = updateMinimap(model_);
+                continue;
+            }
+            
+            // Todos los eventos pendientes producen un único snapshot
+            const uint64_t editStart = CoralCode::FrameProfiler::now();
+            for (const InputEvent& input : batch) {
+                handleEvent(model_, input);
+                if (input.traceId != 0) {
+                    tracer.flow(CoralCode::TraceFlow::Step, input.traceId, editStart);
+                    traced.push_back(TracedInput{input.traceId, input.deliveredNs, input.traceName});
+                }
+            }
+            batch.clear();
+            const uint64_t editEnd = CoralCode::FrameProfiler::now();
+            
+            std::shared_ptr<const FrameSnapshot> frame = buildSnapshot(model_, editEnd - editStart);
+            tracer.span("model", "edit", editStart, editEnd, traced.empty() ? 0 : traced.front().id);
+            tracer.span("model", "highlight", editEnd, editEnd + frame->highlightNs);
+            
+            {
+                std::lock_guard<std::mutex> lock(snapshotMutex_);
+                snapshot_ = std::move(frame);
+                appliedInputs_.insert(appliedInputs_.end(), traced.begin(), traced.end());
+                traced.clear();
+            }
+            
+            // Filas del minimapa de las líneas editadas, ya con el frame publicado
+            minimapPending = updateMinimap(model_);
+        }
+    }
+};
+
+// Nombre del evento en la traza de latencia
+const char* traceInputName(const sf::Event& event) {
+    if (event.is<sf::Event::KeyPressed>()) return "KeyPressed";
+    if (event.is<sf::Event::TextEntered>()) return "TextEntered";
+    if (event.is<sf::Event::MouseButtonPressed>()) return "MouseButtonPressed";
+    if (event.is<sf::Event::MouseButtonReleased>()) return "MouseButtonReleased";
+    if (event.is<sf::Event::MouseMoved>()) return "MouseMoved";
+    if (event.is<sf::Event::MouseWheelScrolled>()) return "MouseWheelScrolled";
+    if (event.is<sf::Event::Resized>()) return "Resized";
+    return "Evento";
+}
+
+// Captura el evento con el estado de teclado y ratón del momento
+InputEvent captureInput(const sf::Event& event) {
+    InputEvent input{event, false, false, false, false};
+    input.ctrl = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LControl) || 
+                 sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RControl);
+    input.system = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LSystem) || 
+                   sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RSystem);
+    input.shift = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LShift) || 
+                  sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RShift);
+    input.leftButton = sf::Mouse::isButtonPressed(sf::Mouse::Button::Left);
+    return input;
+}
+
+// ============================================================================
+// Layout del frame
+// ============================================================================
+//
+// Todo el dibujo pasa por CoralCode::Renderer: en la ventana con el backend
+// SFML y, sin pantalla, con el nulo (--measure-render, --check-allocations).
+
+const CoralCode::RenderColor backgroundColor(25, 25, 25);         // Más oscuro
+const CoralCode::RenderColor cursorColor(255, 255, 0);            // Amarillo
+const CoralCode::RenderColor lineIndicatorColor(255, 50, 50);     // Rojo
+const CoralCode::RenderColor lineNumberColor(100, 100, 100);      // Gris para números de línea
+const CoralCode::RenderColor selectionColor(70, 130, 180, 100);   // Azul translúcido para selección
+const CoralCode::RenderColor statusBarColor(40, 40, 40);          // Gris oscuro para barra de estado
+const CoralCode::RenderColor statusTextColor(200, 200, 200);
+const CoralCode::RenderColor lineNumberAreaColor(35, 35, 35);
+const CoralCode::RenderColor scrollBarColor(60, 60, 60);          // Gris para barra de scroll
+const CoralCode::RenderColor scrollThumbColor(120, 120, 120);     // Gris claro para el thumb
+const CoralCode::RenderColor minimapColor(25, 25, 25);
+const CoralCode::RenderColor minimapViewportColor(255, 255, 255, 30);
+
+CoralCode::RenderColor toRenderColor(const sf::Color& color) {
+    return CoralCode::RenderColor(color.r, color.g, color.b, color.a);
+}
+
+// Panel del perfilador (F12): arriba a la derecha, sobre el texto
+void drawProfilerOverlay(CoralCode::Renderer& renderer, const std::string& text, const sf::Vector2u& windowSize) {
+    const CoralCode::RenderRect bounds = renderer.measureText(text, 12);
+    float width = bounds.width + 20.0f;
+    float height = bounds.height + 20.0f;
+    float x = std::max(0.0f, textAreaRight(windowSize) - width - 10.0f);
+    
+    renderer.fillRect(CoralCode::RenderRect{x, 10.0f, width, height}, CoralCode::RenderColor(0, 0, 0, 200));
+    renderer.drawText(text, x + 10.0f, 15.0f, 12, CoralCode::RenderColor(180, 255, 180));
+}
+
+// Dibuja el snapshot: fondo, barras, minimapa (sube antes sus filas
+// cambiadas), texto coloreado, cursor y barra de estado. profilerText es
+// opcional
+void renderFrame(CoralCode::Renderer& renderer, const FrameSnapshot& frame, const sf::Vector2u& windowSize,
+                 MinimapImage& minimapImage, CoralCode::ImageId minimapTexture, const std::string& statusLine,
+                 const std::string* profilerText) {
+    const size_t scrollLine = frame.scrollLine;
+    const size_t scrollCol = frame.scrollCol;
+    const size_t currentLine = frame.currentLine;
+    const size_t currentCol = frame.currentCol;
+    const TextMetrics& metrics = frame.metrics;
+    const float lineNumberWidth = metrics.lineNumberWidth;
+    const float textStartX = metrics.textStartX;
+    
+    renderer.beginFrame(windowSize.x, windowSize.y, backgroundColor);
+    
+    // Calcular posiciones una vez por frame
+    float statusBarHeight = 25.0f;
+    float statusBarY = static_cast<float>(windowSize.y) - statusBarHeight;
+    
+    // Dibujar área de números de línea
+    renderer.fillRect(CoralCode::RenderRect{0.0f, 0.0f, lineNumberWidth, statusBarY}, lineNumberAreaColor);
+    
+    // Dibujar barra de estado
+    renderer.fillRect(CoralCode::RenderRect{0.0f, statusBarY, static_cast<float>(windowSize.x), statusBarHeight},
+                      statusBarColor);
+    
+    // Calcular áreas de trabajo con validaciones para ventanas pequeñas
+    float textAreaHeight = std::max(0.0f, statusBarY - scrollBarHeight);
+    float textAreaWidth = std::max(0.0f, textAreaRight(windowSize) - lineNumberWidth);
+    size_t visibleLines = calculateVisibleLines(windowSize, metrics.lineHeight);
+    
+    // Dibujar barra de scroll vertical (solo si es necesario)
+    if (frame.totalLines > visibleLines && visibleLines > 0) {
+        float scrollBarX = static_cast<float>(windowSize.x) - scrollBarWidth;
+        renderer.fillRect(CoralCode::RenderRect{scrollBarX, 0.0f, scrollBarWidth, textAreaHeight}, scrollBarColor);
         
-        // Configurar elementos con posiciones estables
-        lineNumberArea.setSize(sf::Vector2f(lineNumberWidth, statusBarY));
-        lineNumberArea.setPosition(sf::Vector2f(0.0f, 0.0f));
+        // Calcular y dibujar el thumb vertical
+        float maxScroll = static_cast<float>(frame.totalLines - visibleLines);
+        float scrollRatio = maxScroll > 0 ? static_cast<float>(scrollLine) / maxScroll : 0.0f;
+        float thumbHeight = (textAreaHeight * visibleLines) / frame.totalLines;
+        float thumbY = scrollRatio * (textAreaHeight - thumbHeight);
+        renderer.fillRect(CoralCode::RenderRect{scrollBarX + 1.0f, thumbY, scrollBarWidth - 2.0f, thumbHeight},
+                          scrollThumbColor);
+    }
+    
+    // Minimapa entre el texto y la barra vertical
+    {
+        const std::pair<size_t, size_t> minimap = minimapImage.upload(
+            [&renderer, minimapTexture](const uint8_t* pixels, size_t firstRow, size_t rowCount) {
+                renderer.updateImage(minimapTexture, pixels, static_cast<unsigned>(firstRow),
+                                     static_cast<unsigned>(rowCount));
+            });
+        const size_t minimapRows = minimap.first;
+        const size_t linesPerRow = minimap.second;
+        const float minimapX = textAreaRight(windowSize);
+        const float rowHeight = minimapRowHeight(windowSize, minimapRows);
         
-        statusBar.setSize(sf::Vector2f(static_cast<float>(windowSize.x), statusBarHeight));
-        statusBar.setPosition(sf::Vector2f(0.0f, statusBarY));
+        renderer.fillRect(CoralCode::RenderRect{minimapX, 0.0f, minimapWidth, textAreaHeight}, minimapColor);
+        if (minimapRows > 0 && rowHeight > 0.0f) {
+            renderer.drawImage(minimapTexture, static_cast<unsigned>(minimapRows),
+                               CoralCode::RenderRect{minimapX, 0.0f, minimapWidth,
+                                                     rowHeight * static_cast<float>(minimapRows)});
+            
+            const float viewportY = static_cast<float>(scrollLine / linesPerRow) * rowHeight;
+            const float viewportHeight = static_cast<float>(visibleLines) / static_cast<float>(linesPerRow) * rowHeight;
+            renderer.fillRect(CoralCode::RenderRect{minimapX, viewportY, minimapWidth, std::max(2.0f, viewportHeight)},
+                              minimapViewportColor);
+        }
+    }
+    
+    // Calcular si necesitamos barra de scroll horizontal
+    size_t maxLineLength = frame.maxLineLength;
+    
+    size_t visibleCols = textAreaWidth > metrics.columnWidth ? static_cast<size_t>(textAreaWidth / metrics.columnWidth) : 0;
+    if (maxLineLength > visibleCols && visibleCols > 0) {
+        float horizontalScrollY = statusBarY - scrollBarHeight;
+        renderer.fillRect(CoralCode::RenderRect{lineNumberWidth, horizontalScrollY, textAreaWidth, scrollBarHeight},
+                          scrollBarColor);
         
-        // Dibujar área de números de línea
-        window.draw(lineNumberArea);
+        // Calcular y dibujar el thumb horizontal
+        size_t maxScrollCol = maxLineLength - visibleCols;
+        float scrollColRatio = maxScrollCol > 0 ? static_cast<float>(scrollCol) / static_cast<float>(maxScrollCol) : 0.0f;
+        float thumbWidth = (textAreaWidth * visibleCols) / maxLineLength;
+        float thumbX = lineNumberWidth + scrollColRatio * (textAreaWidth - thumbWidth);
+        renderer.fillRect(CoralCode::RenderRect{thumbX, horizontalScrollY + 1.0f, thumbWidth, scrollBarHeight - 2.0f},
+                          scrollThumbColor);
+    }
+    
+    // Mostrar texto con syntax highlighting (ya coloreado por el modelo)
+    float yPos = 20.0f;
+    size_t linesToShow = std::min(frame.visibleLineCount, visibleLines);
+    
+    // Limitar el ancho del texto para no superponerse con el minimapa
+    float maxTextWidth = textAreaRight(windowSize) - textStartX - 10.0f;
+    
+    for (size_t i = 0; i < linesToShow; ++i) {
+        const SnapshotLine& line = frame.visibleLines[i];
         
-        // Dibujar barra de estado
-        window.draw(statusBar);
+        // Dibujar número de línea
+        char lineNumber[24];
+        int length = std::snprintf(lineNumber, sizeof(lineNumber), "%zu", line.number + 1);
+        renderer.drawText(lineNumber, static_cast<size_t>(length), 5.0f, yPos, metrics.lineNumberSize, lineNumberColor);
         
-        // Calcular áreas de trabajo con validaciones para ventanas pequeñas
-        float textAreaHeight = std::max(0.0f, statusBarY - scrollBarHeight);
-        float textAreaWidth = std::max(0.0f, static_cast<float>(windowSize.x) - lineNumberWidth - scrollBarWidth);
-        size_t visibleLines = textAreaHeight > 24.0f ? static_cast<size_t>(textAreaHeight / 24.0f) : 0;
+        // Dibujar selección si existe (el modelo ya la recortó al scroll)
+        if (line.selectionWidth > 0) {
+            renderer.fillRect(CoralCode::RenderRect{textStartX + line.selectionX, yPos, line.selectionWidth, metrics.rowHeight},
+                              selectionColor);
+        }
         
-        // Dibujar barra de scroll vertical (solo si es necesario)
-        if (lines.size() > visibleLines && visibleLines > 0) {
-            float scrollBarX = static_cast<float>(windowSize.x) - scrollBarWidth;
-            
-            scrollBar.setSize(sf::Vector2f(scrollBarWidth, textAreaHeight));
-            scrollBar.setPosition(sf::Vector2f(scrollBarX, 0.0f));
-            window.draw(scrollBar);
+        for (size_t t = 0; t < line.tokenCount; ++t) {
+            const ColoredToken& wordPair = line.tokens[t];
             
-            // Calcular y dibujar el thumb vertical
-            if (lines.size() > visibleLines) {
-                float maxScroll = static_cast<float>(lines.size() - visibleLines);
-                float scrollRatio = maxScroll > 0 ? static_cast<float>(scrollLine) / maxScroll : 0.0f;
-                float thumbHeight = (textAreaHeight * visibleLines) / lines.size();
-                float thumbY = scrollRatio * (textAreaHeight - thumbHeight);
-                
-                scrollThumb.setSize(sf::Vector2f(scrollBarWidth - 2.0f, thumbHeight));
-                scrollThumb.setPosition(sf::Vector2f(scrollBarX + 1.0f, thumbY));
-                window.draw(scrollThumb);
+            // x calculada por el modelo con los avances de la fuente;
+            // si ya salimos del área visible, parar de renderizar
+            float xPos = textStartX + line.tokenX[t];
+            if (xPos >= maxTextWidth) {
+                break;
             }
+            renderer.drawText(wordPair.first, xPos, yPos, metrics.fontSize, toRenderColor(wordPair.second));
         }
         
-        // Calcular si necesitamos barra de scroll horizontal
-        size_t maxLineLength = 0;
-        for (const auto& line : lines) {
-            maxLineLength = std::max(maxLineLength, line.length());
-        }
+        yPos += metrics.lineHeight;
+    }
+    
+    // Indicador de línea actual (en el borde izquierdo) y cursor, solo si están visibles
+    if (currentLine >= scrollLine && currentLine < scrollLine + (windowSize.y - 50) / metrics.lineHeight) {
+        float lineY = 20.0f + (currentLine - scrollLine) * metrics.lineHeight;
+        renderer.fillRect(CoralCode::RenderRect{1.0f, lineY, 2.0f, metrics.rowHeight}, lineIndicatorColor);
         
-        size_t visibleCols = textAreaWidth > 9.6f ? static_cast<size_t>(textAreaWidth / 9.6f) : 0;
-        if (maxLineLength > visibleCols && visibleCols > 0) {
-            float horizontalScrollY = statusBarY - scrollBarHeight;
-            
-            horizontalScrollBar.setSize(sf::Vector2f(textAreaWidth, scrollBarHeight));
-            horizontalScrollBar.setPosition(sf::Vector2f(lineNumberWidth, horizontalScrollY));
-            window.draw(horizontalScrollBar);
-            
-            // Calcular y dibujar el thumb horizontal
-            if (maxLineLength > visibleCols) {
-                size_t maxScrollCol = maxLineLength - visibleCols;
-                float scrollColRatio = maxScrollCol > 0 ? static_cast<float>(scrollCol) / static_cast<float>(maxScrollCol) : 0.0f;
-                float thumbWidth = (textAreaWidth * visibleCols) / maxLineLength;
-                float thumbX = lineNumberWidth + scrollColRatio * (textAreaWidth - thumbWidth);
-                
-                horizontalScrollThumb.setSize(sf::Vector2f(thumbWidth, scrollBarHeight - 2.0f));
-                horizontalScrollThumb.setPosition(sf::Vector2f(thumbX, horizontalScrollY + 1.0f));
-                window.draw(horizontalScrollThumb);
-            }
+        // Solo mostrar cursor si está dentro del área visible
+        float cursorX = textStartX + frame.cursorX;
+        if (currentCol >= scrollCol && cursorX < maxTextWidth) {
+            renderer.fillRect(CoralCode::RenderRect{cursorX, lineY, 2.0f, metrics.rowHeight}, cursorColor);
+        }
+    }
+    
+    // Barra de estado (texto preparado por el modelo), 5px desde su borde superior
+    renderer.drawText(statusLine, 10.0f, statusBarY + 5.0f, 12, statusTextColor);
+    
+    if (profilerText) {
+        drawProfilerOverlay(renderer, *profilerText, windowSize);
+    }
+    renderer.endFrame();
+}
+
+// ============================================================================
+// Comprobación de asignaciones en estado estable (--check-allocations)
+// ============================================================================
+//
+// Sin ventana: aplica al modelo dos veces la misma secuencia de click,
+// escritura y scroll sobre un documento que no cambia de tamaño y dibuja
+// cada snapshot con el backend nulo. La primera pasada llena el historial de
+// undo, el pool de snapshots, los layouts de línea, la capacidad de los
+// tokens y la de los comandos grabados; en la segunda, nada debe asignar memoria.
+
+// Documento de prueba: código con palabras clave, strings y comentarios
+void fillSampleDocument(std::vector<std::string>& lines, size_t count) {
+    static const char* const SAMPLE[] = {
+        "int main(int argc, char* argv[]) {",
+        "    const std::string name = \"CoralCode\"; // nombre del editor",
+        "    for (size_t i = 0; i < lines.size(); ++i) {",
+        "        if (lines[i].empty()) continue;",
+        "        total += lines[i].length(); // \"sin\" asignar",
+        "    }",
+        "    return 0;",
+        "}",
+        "",
+    };
+    const size_t sampleLines = sizeof(SAMPLE) / sizeof(SAMPLE[0]);
+    lines.clear();
+    for (size_t i = 0; i < count; ++i) {
+        lines.push_back(SAMPLE[i % sampleLines]);
+    }
+}
+
+int runAllocationCheck() {
+    EditorModel model;
+    model.windowSize = sf::Vector2u(1000, 700);
+    fillSampleDocument(model.lines, 2000);
+    model.currentLine = 1000;
+    model.currentCol = 10;
+    model.scrollLine = 990;
+    
+    sf::Event::KeyPressed backspace{};
+    backspace.code = sf::Keyboard::Key::Backspace;
+    sf::Event::MouseWheelScrolled wheelDown{};
+    wheelDown.wheel = sf::Mouse::Wheel::Vertical;
+    wheelDown.delta = -1.0f;
+    sf::Event::MouseWheelScrolled wheelUp = wheelDown;
+    wheelUp.delta = 1.0f;
+    sf::Event::MouseButtonPressed press{};
+    press.button = sf::Mouse::Button::Left;
+    press.position = sf::Vector2i(300, 200);
+    sf::Event::MouseButtonReleased release{};
+    release.button = sf::Mouse::Button::Left;
+    release.position = press.position;
+    
+    const InputEvent typeChar{sf::Event(sf::Event::TextEntered{U'x'}), false, false, false, false};
+    const InputEvent deleteChar{sf::Event(backspace), false, false, false, false};
+    const InputEvent scrollDown{sf::Event(wheelDown), false, false, false, false};
+    const InputEvent scrollUp{sf::Event(wheelUp), false, false, false, false};
+    const InputEvent scrollRight{sf::Event(wheelDown), false, false, true, false};
+    const InputEvent scrollLeft{sf::Event(wheelUp), false, false, true, false};
+    const InputEvent clickDown{sf::Event(press), false, false, false, true};
+    const InputEvent clickUp{sf::Event(release), false, false, false, false};
+    
+    CoralCode::NullRenderer renderer;
+    renderer.setRecording(true);
+    const CoralCode::ImageId minimapTexture = renderer.createImage(static_cast<unsigned>(MINIMAP_WIDTH),
+                                                                   static_cast<unsigned>(MINIMAP_MAX_ROWS), true);
+    
+    // Como el render, se conserva el snapshot anterior mientras se construye
+    // el siguiente
+    std::shared_ptr<const FrameSnapshot> presented;
+    auto apply = [&](const InputEvent& input, size_t times) {
+        for (size_t i = 0; i < times; ++i) {
+            handleEvent(model, input);
+            presented = buildSnapshot(model);
+            while (updateMinimap(model)) {}
+            renderFrame(renderer, *presented, model.windowSize, *model.minimap.image, minimapTexture,
+                        presented->status, nullptr);
         }
+    };
+    // Número par de snapshots: cada pasada reparte el pool igual
+    auto steadyPass = [&]() {
+        apply(clickDown, 1);
+        apply(clickUp, 1);
+        for (size_t i = 0; i < 2 * MAX_HISTORY; ++i) {
+            apply(typeChar, 1);
+            apply(deleteChar, 1);
+        }
+        apply(scrollDown, 200);
+        apply(scrollUp, 200);
+        apply(scrollRight, 10);
+        apply(scrollLeft, 10);
+    };
+    
+    CoralCode::AllocationTracker::retain();
+    steadyPass();
+    const CoralCode::AllocationCounts before = CoralCode::AllocationTracker::snapshot();
+    steadyPass();
+    const CoralCode::AllocationCounts allocated = CoralCode::AllocationTracker::snapshot() - before;
+    CoralCode::AllocationTracker::release();
+    
+    if (allocated.total() != 0) {
+        std::cout << "❌ Escribir y hacer scroll en estado estable asigna memoria:\n"
+                  << allocated.formatReport() << std::flush;
+        return 1;
+    }
+    std::cout << "✅ Escribir y hacer scroll en estado estable no asigna memoria" << std::endl;
+    return 0;
+}
+
+// ============================================================================
+// Medida del render sin ventana (--measure-render [frames])
+// ============================================================================
+//
+// Dibuja con el backend nulo frames de escritura y scroll sobre el documento
+// de prueba y resume el trabajo medio por frame (draw calls, quads, cambios
+// de estado, bytes subidos) y lo que tarda el layout, sin pantalla ni GPU.
+// Después mide el zoom con Ctrl+rueda de un extremo a otro y de vuelta: lo
+// que tardan el modelo (volver a medir las líneas visibles) y el layout.
+
+int runRenderMeasurement(size_t frames, bool singleFontAtlas) {
+    EditorModel model;
+    model.windowSize = sf::Vector2u(1000, 700);
+    fillSampleDocument(model.lines, 2000);
+    model.currentLine = 10;
+    model.currentCol = 10;
+    
+    sf::Event::KeyPressed backspace{};
+    backspace.code = sf::Keyboard::Key::Backspace;
+    sf::Event::MouseWheelScrolled wheelDown{};
+    wheelDown.wheel = sf::Mouse::Wheel::Vertical;
+    wheelDown.delta = -1.0f;
+    
+    // Escribir, borrar y bajar una línea por frame
+    const InputEvent inputs[] = {
+        {sf::Event(sf::Event::TextEntered{U'x'}), false, false, false, false},
+        {sf::Event(wheelDown), false, false, false, false},
+        {sf::Event(backspace), false, false, false, false},
+        {sf::Event(wheelDown), false, false, false, false},
+    };
+    const size_t inputCount = sizeof(inputs) / sizeof(inputs[0]);
+    
+    // Como el backend SFML con campos de distancia (un atlas para todos los
+    // tamaños) o con bitmaps (--bitmap-fonts)
+    CoralCode::NullRenderer renderer;
+    renderer.setSingleFontAtlas(singleFontAtlas);
+    const CoralCode::ImageId minimapTexture = renderer.createImage(static_cast<unsigned>(MINIMAP_WIDTH),
+                                                                   static_cast<unsigned>(MINIMAP_MAX_ROWS), true);
+    uint64_t layoutNs = 0;
+    size_t maxQuads = 0;
+    for (size_t i = 0; i < frames; ++i) {
+        handleEvent(model, inputs[i % inputCount]);
+        std::shared_ptr<const FrameSnapshot> frame = buildSnapshot(model);
+        while (updateMinimap(model)) {}
         
-        // Mostrar texto con syntax highlighting
-        if (fontLoaded) {
-            float yPos = 20.0f;
-            size_t linesToShow = std::min(lines.size() - scrollLine, visibleLines);
-            
-            for (size_t i = 0; i < linesToShow; ++i) {
-                size_t actualLineNum = scrollLine + i;
-                
-                // Validar que la línea existe
-                if (actualLineNum >= lines.size()) {
-                    break;
-                }
-                
-                // Dibujar número de línea
-                sf::Text lineNumber(font, std::to_string(actualLineNum + 1), 14);
-                lineNumber.setPosition(sf::Vector2f(5.0f, yPos));
-                lineNumber.setFillColor(lineNumberColor);
-                window.draw(lineNumber);
-                
-                // Dibujar selección si existe
-                if (isSelecting) {
-                    size_t selStart, selEnd, startCol, endCol;
-                    getSelectionBounds(selectionStartLine, selectionStartCol, selectionEndLine, selectionEndCol,
-                                     selStart, selEnd, startCol, endCol);
-                    
-                    if (actualLineNum >= selStart && actualLineNum <= selEnd) {
-                        float selectionX = textStartX;
-                        float selectionWidth = 0;
-                        
-                        if (actualLineNum == selStart && actualLineNum == selEnd) {
-                            // Selección en una sola línea - ajustar por scroll horizontal
-                            if (startCol >= scrollCol) {
-                                selectionX += (startCol - scrollCol) * 9.6f;
-                                size_t visibleStart = startCol - scrollCol;
-                                size_t visibleEnd = endCol > scrollCol ? endCol - scrollCol : 0;
-                                selectionWidth = (visibleEnd > visibleStart ? visibleEnd - visibleStart : 0) * 9.6f;
-                            }
-                        } else if (actualLineNum == selStart) {
-                            // Primera línea de selección múltiple
-                            if (startCol >= scrollCol) {
-                                selectionX += (startCol - scrollCol) * 9.6f;
-                                size_t visibleStart = startCol - scrollCol;
-                                size_t lineLength = lines[actualLineNum].length();
-                                size_t visibleLength = lineLength > scrollCol ? lineLength - scrollCol : 0;
-                                selectionWidth = (visibleLength > visibleStart ? visibleLength - visibleStart : 0) * 9.6f;
-                            }
-                        } else if (actualLineNum == selEnd) {
-                            // Última línea de selección múltiple
-                            size_t visibleEnd = endCol > scrollCol ? endCol - scrollCol : 0;
-                            selectionWidth = visibleEnd * 9.6f;
-                        } else {
-                            // Línea completa seleccionada
-                            size_t lineLength = lines[actualLineNum].length();
-                            selectionWidth = (lineLength > scrollCol ? lineLength - scrollCol : 0) * 9.6f;
-                        }
-                        
-                        if (selectionWidth > 0) {
-                            sf::RectangleShape selection(sf::Vector2f(selectionWidth, 20.0f));
-                            selection.setPosition(sf::Vector2f(selectionX, yPos));
-                            selection.setFillColor(selectionColor);
-                            window.draw(selection);
-                        }
-                    }
-                }
-                
-                float xPos = textStartX;
-                
-                // Limitar el ancho del texto para no superponerse con la barra de scroll
-                float maxTextWidth = static_cast<float>(windowSize.x) - scrollBarWidth - textStartX - 10.0f;
-                
-                // Procesar línea para syntax highlighting con scroll horizontal
-                const std::string& lineContent = lines[actualLineNum];
-                
-                // Aplicar scroll horizontal: extraer la parte visible de la línea
-                std::string visibleContent;
-                if (lineContent.length() > scrollCol) {
-                    visibleContent = lineContent.substr(scrollCol);
-                } else {
-                    visibleContent = ""; // Línea más corta que el scroll
-                }
-                
-                auto coloredWords = processLine(visibleContent);
-                
-                for (const auto& wordPair : coloredWords) {
-                    sf::Text text(font, wordPair.first, 16);
-                    text.setPosition(sf::Vector2f(xPos, yPos));
-                    text.setFillColor(wordPair.second);
-                    
-                    // Solo dibujar si el texto está dentro del área visible
-                    if (xPos < maxTextWidth) {
-                        window.draw(text);
-                    }
-                    
-                    // Calcular ancho aproximado del texto
-                    xPos += wordPair.first.length() * 9.6f; // Ancho promedio por carácter
-                    
-                    // Si ya salimos del área visible, parar de renderizar
-                    if (xPos > maxTextWidth) {
-                        break;
-                    }
-                }
-                
-                yPos += 24.0f;
+        const uint64_t start = CoralCode::FrameProfiler::now();
+        renderFrame(renderer, *frame, model.windowSize, *model.minimap.image, minimapTexture, frame->status, nullptr);
+        layoutNs += CoralCode::FrameProfiler::now() - start;
+        maxQuads = std::max(maxQuads, renderer.getFrameStats().quads);
+    }
+    
+    const CoralCode::RenderStats& total = renderer.getTotalStats();
+    const double count = static_cast<double>(std::max<size_t>(1, frames));
+    char report[512];
+    std::snprintf(report, sizeof(report),
+                  "🖼️  Render sin ventana (backend %s): %zu frames, %zu líneas\n"
+                  "   Por frame: %.1f draw calls, %.1f quads (máx. %zu), %.1f glifos en %.1f textos, "
+                  "%.1f imágenes, %.1f cambios de estado, %.0f B subidos\n"
+                  "   Layout: %.2f µs por frame\n",
+                  renderer.getName(), frames, model.lines.size(),
+                  static_cast<double>(total.drawCalls) / count, static_cast<double>(total.quads) / count, maxQuads,
+                  static_cast<double>(total.glyphs) / count, static_cast<double>(total.textRuns) / count,
+                  static_cast<double>(total.images) / count, static_cast<double>(total.stateChanges) / count,
+                  static_cast<double>(total.uploadedBytes) / count,
+                  static_cast<double>(layoutNs) / count / 1000.0);
+    std::cout << report << std::flush;
+    
+    // Zoom: de MIN_FONT_SIZE a MAX_FONT_SIZE y de vuelta, un punto por frame
+    sf::Event::MouseWheelScrolled zoomIn{};
+    zoomIn.wheel = sf::Mouse::Wheel::Vertical;
+    zoomIn.delta = 1.0f;
+    sf::Event::MouseWheelScrolled zoomOut = zoomIn;
+    zoomOut.delta = -1.0f;
+    const InputEvent zoomInput[] = {
+        {sf::Event(zoomIn), true, false, false, false},
+        {sf::Event(zoomOut), true, false, false, false},
+    };
+    setFontSize(model, MIN_FONT_SIZE);
+    
+    const size_t zoomFrames = 2 * (MAX_FONT_SIZE - MIN_FONT_SIZE);
+    const CoralCode::RenderStats before = renderer.getTotalStats();
+    uint64_t zoomModelNs = 0;
+    uint64_t zoomLayoutNs = 0;
+    uint64_t worstZoomNs = 0;
+    for (size_t i = 0; i < zoomFrames; ++i) {
+        const uint64_t start = CoralCode::FrameProfiler::now();
+        handleEvent(model, zoomInput[i < zoomFrames / 2 ? 0 : 1]);
+        std::shared_ptr<const FrameSnapshot> frame = buildSnapshot(model);
+        const uint64_t built = CoralCode::FrameProfiler::now();
+        renderFrame(renderer, *frame, model.windowSize, *model.minimap.image, minimapTexture, frame->status, nullptr);
+        const uint64_t end = CoralCode::FrameProfiler::now();
+        zoomModelNs += built - start;
+        zoomLayoutNs += end - built;
+        worstZoomNs = std::max(worstZoomNs, end - start);
+    }
+    
+    const CoralCode::RenderStats& after = renderer.getTotalStats();
+    const double zoomCount = static_cast<double>(zoomFrames);
+    std::snprintf(report, sizeof(report),
+                  "🔍 Zoom con Ctrl+rueda (%u-%u px, %zu frames): %.2f µs de modelo y %.2f µs de layout por frame "
+                  "(peor: %.2f µs), %.1f cambios de estado por frame\n",
+                  MIN_FONT_SIZE, MAX_FONT_SIZE, zoomFrames,
+                  static_cast<double>(zoomModelNs) / zoomCount / 1000.0,
+                  static_cast<double>(zoomLayoutNs) / zoomCount / 1000.0,
+                  static_cast<double>(worstZoomNs) / 1000.0,
+                  static_cast<double>(after.stateChanges - before.stateChanges) / zoomCount);
+    std::cout << report << std::flush;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // --profile: perfilador activo desde el inicio y resumen al salir
+    // --trace <archivo>: latencia de cada evento hasta display(), en JSON de Chrome
+    // --check-allocations: sin ventana; falla si escribir o hacer scroll asigna memoria
+    // --measure-render [frames]: sin ventana; trabajo y tiempo de layout por frame
+    // --bitmap-fonts: texto con los bitmaps de cada tamaño aunque haya shaders
+    bool profileRequested = false;
+    bool bitmapFonts = false;
+    size_t measureFrames = 0;
+    std::string tracePath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--profile") {
+            profileRequested = true;
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (arg == "--check-allocations") {
+            return runAllocationCheck();
+        } else if (arg == "--measure-render") {
+            measureFrames = 1000;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                measureFrames = std::strtoull(argv[++i], nullptr, 10);
             }
+        } else if (arg == "--bitmap-fonts") {
+            bitmapFonts = true;
         }
+    }
+    if (measureFrames > 0) {
+        return runRenderMeasurement(measureFrames, !bitmapFonts);
+    }
+    CoralCode::LatencyTracer& tracer = CoralCode::LatencyTracer::shared();
+    CoralCode::LatencyTracer::setThreadName("Ventana");
+    tracer.setEnabled(!tracePath.empty());
+    
+
+    // Crear ventana redimensionable
+    sf::RenderWindow window(sf::VideoMode(sf::Vector2u(1000, 700)), "CoralCode - Editor con Syntax Highlighting", sf::Style::Default);
+    window.setFramerateLimit(60);
+    
+    // Configurar vista inicial para mapeo 1:1 de pixels
+    sf::View initialView;
+    initialView.setSize(sf::Vector2f(1000.0f, 700.0f));
+    initialView.setCenter(sf::Vector2f(500.0f, 350.0f));
+    window.setView(initialView);
+    
+    // Tamaño de ventana visto por el render (el modelo lleva el suyo)
+    sf::Vector2u windowSize = window.getSize();
+    
+    // Cargar fuente del sistema
+    sf::Font font;
+    bool fontLoaded = false;
+    
+    std::vector<std::string> fontPaths = {
+        "/System/Library/Fonts/Monaco.ttf",
+        "/System/Library/Fonts/Menlo.ttc", 
+        "/System/Library/Fonts/Courier New.ttf",
+        "/System/Library/Fonts/Helvetica.ttc"
+    };
+    
+    for (const auto& path : fontPaths) {
+        if (font.openFromFile(path)) {
+            fontLoaded = true;
+            std::cout << "✅ Fuente cargada: " << path << std::endl;
+            break;
+        }
+    }
+    
+    if (!fontLoaded) {
+        std::cout << "❌ No se pudo cargar fuente. Texto puede no ser visible." << std::endl;
+    }
+    
+    std::cout << "🚀 CoralCode - Editor Profesional Iniciado" << std::endl;
+    std::cout << "📝 Escribe código en C++, C, Java, JavaScript, Python, C#" << std::endl;
+    std::cout << "🎨 Syntax highlighting: azul=keywords, verde=comentarios, naranja=strings" << std::endl;
+    std::cout << "🔢 Números de línea automáticos" << std::endl;
+    std::cout << "📊 Barra de estado con información detallada" << std::endl;
+    std::cout << "🖱️  Click y arrastra para seleccionar texto" << std::endl;
+    std::cout << "📋 Cmd+C para copiar, Cmd+V para pegar (clipboard del sistema)" << std::endl;
+    std::cout << "↶ Cmd+Z para deshacer, Cmd+Shift+Z para rehacer (límite: 100 cambios)" << std::endl;
+    std::cout << "🔄 Scroll: Rueda vertical (up/down), Shift+Rueda horizontal, Trackpad horizontal" << std::endl;
+    std::cout << "⚡ Ctrl/Cmd+Flechas: ↑↓ scroll 10 líneas, ←→ inicio/fin de línea" << std::endl;
+    std::cout << "🔍 Ctrl/Cmd+Rueda: zoom del texto (" << MIN_FONT_SIZE << "-" << MAX_FONT_SIZE << " px)" << std::endl;
+    std::cout << "⏱️  F12 para el perfilador de frames (o --profile)" << std::endl;
+    std::cout << "🧮 F10 para volcar la memoria por subsistema" << std::endl;
+    std::cout << "⌨️  ESC para salir" << std::endl;
+    
+    // Perfilador de frames: fases del bucle, draw calls y asignaciones
+    CoralCode::FrameProfiler profiler;
+    profiler.setEnabled(profileRequested);
+    bool showProfiler = profileRequested;
+    
+    // Todo el dibujo pasa por el renderer (que atribuye cada draw al
+    // perfilador). Con shaders, el texto de cualquier tamaño sale de un
+    // único atlas de campos de distancia generado aquí
+    CoralCode::SfmlRenderer renderer(window, fontLoaded ? &font : nullptr, &profiler, !bitmapFonts);
+    if (fontLoaded) {
+        std::cout << (renderer.usesDistanceField()
+                          ? "🔤 Texto con campos de distancia: el zoom no vuelve a rasterizar"
+                          : "🔤 Texto con bitmaps de SFML por tamaño")
+                  << std::endl;
+    }
+    
+    // Avances de la fuente para el layout del modelo, los mismos con los
+    // que dibuja el renderer. sf::Font no se puede consultar desde otro hilo
+    // mientras se dibuja: se copian antes de arrancarlo (Latin-1; el resto
+    // de caracteres mide el avance medio). El zoom los escala en el layout
+    CoralCode::TextLayout::GlyphAdvanceFunction glyphAdvances;
+    if (fontLoaded) {
+        std::vector<float> advances(256);
+        float printableSum = 0.0f;
+        for (char32_t codepoint = 0; codepoint < advances.size(); ++codepoint) {
+            advances[codepoint] = renderer.getGlyphAdvance(codepoint, BASE_FONT_SIZE);
+            if (codepoint >= 32 && codepoint < 127) printableSum += advances[codepoint];
+        }
+        const float averageAdvance = printableSum / 95.0f;
+        glyphAdvances = [advances, averageAdvance](char32_t codepoint) {
+            return codepoint < advances.size() ? advances[codepoint] : averageAdvance;
+        };
+    }
+    
+    // Hilo del modelo: aplica las ediciones y publica snapshots
+    ModelThread modelThread(windowSize, std::move(glyphAdvances));
+    
+    std::string profilerText;
+    uint64_t lastSnapshot = 0;
+    std::vector<TracedInput> presentedInputs;
+    
+    // Memoria por subsistema: la barra solo se reformatea si cambia el total
+    CoralCode::MemoryUsage memory;
+    size_t memoryTotal = SIZE_MAX;
+    std::string memoryStatus;
+    std::string statusLine;
+    bool dumpMemory = false;
+    
+    // Métrica del último snapshot (cursor del ratón sobre el texto)
+    TextMetrics metrics;
+    
+    // La textura del minimapa se crea una vez
+    std::shared_ptr<MinimapImage> minimapImage = modelThread.minimapImage();
+    const CoralCode::ImageId minimapTexture = renderer.createImage(static_cast<unsigned>(MINIMAP_WIDTH),
+                                                                   static_cast<unsigned>(MINIMAP_MAX_ROWS), true);
+    
+    while (window.isOpen()) {
+        profiler.beginFrame();
         
-        // Mostrar indicador de línea actual (en el borde izquierdo) - solo si está visible
-        if (currentLine >= scrollLine && currentLine < scrollLine + (windowSize.y - 50) / 24) {
-            float indicatorY = 20.0f + (currentLine - scrollLine) * 24.0f;
-            lineIndicator.setPosition(sf::Vector2f(1.0f, indicatorY));
-            window.draw(lineIndicator);
+
+        // Verificar posición del mouse y ajustar cursor (solo cuando cambie)
+        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+        float mouseX = static_cast<float>(mousePos.x);
+        float mouseY = static_cast<float>(mousePos.y);
+        float textRight = textAreaRight(windowSize);
+        
+        // Determinar qué tipo de cursor usar
+        float horizontalScrollY = static_cast<float>(windowSize.y) - 25 - scrollBarHeight;
+        
+        sf::Cursor::Type newCursorType;
+        if (mouseX > metrics.textStartX && mouseX < textRight && 
+            mouseY > 0 && mouseY < horizontalScrollY) {
+            // En área de texto - cursor de texto
+            newCursorType = sf::Cursor::Type::Text;
+        } else if (mouseX >= textRight || 
+                  (mouseY > horizontalScrollY && mouseY < windowSize.y - 25)) {
+            // En barras de scroll o minimapa - cursor de mano
+            newCursorType = sf::Cursor::Type::Hand;
+        } else {
+            // En otras áreas - cursor normal
+            newCursorType = sf::Cursor::Type::Arrow;
         }
         
-        // Mostrar cursor - solo si está visible en pantalla
-        if (currentLine >= scrollLine && currentLine < scrollLine + (windowSize.y - 50) / 24) {
-            // Verificar que el cursor esté visible horizontalmente también
-            if (currentCol >= scrollCol) {
-                float cursorX = textStartX + (currentCol - scrollCol) * 9.6f;
-                float cursorY = 20.0f + (currentLine - scrollLine) * 24.0f;
-                
-                // Solo mostrar cursor si está dentro del área visible
-                float maxTextWidth = static_cast<float>(windowSize.x) - scrollBarWidth - textStartX - 10.0f;
-                if (cursorX < maxTextWidth) {
-                    cursor.setPosition(sf::Vector2f(cursorX, cursorY));
-                    window.draw(cursor);
-                }
+        // Cambiar cursor solo si es diferente al actual
+        static sf::Cursor::Type currentCursorType = sf::Cursor::Type::Arrow;
+        if (newCursorType != currentCursorType) {
+            auto cursor = sf::Cursor::createFromSystem(newCursorType);
+            if (cursor) {
+                window.setMouseCursor(cursor.value());
+                currentCursorType = newCursorType;
             }
         }
         
-        // Crear información de la barra de estado
-        if (fontLoaded) {
-            std::stringstream statusInfo;
-            statusInfo << "Línea: " << (currentLine + 1) 
-                      << "  Columna: " << (currentCol + 1)
-                      << "  Total líneas: " << lines.size()
-                      << "  Caracteres: " << lines[currentLine].length();
-            
-            if (isSelecting) {
-                // Calcular información de selección
-                size_t selStart, selEnd, startCol, endCol;
-                getSelectionBounds(selectionStartLine, selectionStartCol, selectionEndLine, selectionEndCol,
-                                 selStart, selEnd, startCol, endCol);
-                
-                size_t selectedLines = selEnd - selStart + 1;
-                size_t selectedChars = 0;
-                
-                if (selStart == selEnd) {
-                    selectedChars = endCol - startCol;
-                } else {
-                    selectedChars += lines[selStart].length() - startCol + 1; // +1 for newline
-                    for (size_t i = selStart + 1; i < selEnd; ++i) {
-                        selectedChars += lines[i].length() + 1; // +1 for newline
-                    }
-                    selectedChars += endCol;
+        // Manejar eventos: la ventana se atiende aquí, el resto va al modelo
+        profiler.beginPhase(CoralCode::FramePhase::Events);
+        CoralCode::AllocationTracker::setSite(CoralCode::AllocationSite::Input);
+        const uint64_t pollStart = CoralCode::LatencyTracer::now();
+        while (auto event = window.pollEvent()) {
+            if (event->is<sf::Event::Closed>()) {
+                window.close();
+                continue;
+            }
+            if (auto* keyEvent = event->getIf<sf::Event::KeyPressed>()) {
+                if (keyEvent->code == sf::Keyboard::Key::F12) {
+                    // El overlay es de la ventana: no llega al modelo
+                    showProfiler = !showProfiler;
+                    profiler.setEnabled(showProfiler || profileRequested);
+                    profilerText.clear();
+                    continue;
+                }
+                if (keyEvent->code == sf::Keyboard::Key::F10) {
+                    dumpMemory = true;
+                    continue;
                 }
+            }
+            if (auto* resizeEvent = event->getIf<sf::Event::Resized>()) {
+                // Actualizar tamaño de ventana
+                windowSize = sf::Vector2u(resizeEvent->size.x, resizeEvent->size.y);
                 
-                statusInfo << "  |  SELECCIÓN - Líneas: " << selectedLines 
-                          << "  Caracteres: " << selectedChars;
+                // Crear una vista que mapee 1:1 con los pixels de la ventana
+                sf::View view;
+                view.setSize(sf::Vector2f(static_cast<float>(windowSize.x), static_cast<float>(windowSize.y)));
+                view.setCenter(sf::Vector2f(static_cast<float>(windowSize.x) / 2.0f, static_cast<float>(windowSize.y) / 2.0f));
+                window.setView(view);
             }
+            InputEvent input = captureInput(*event);
+            if (tracer.isEnabled()) {
+                // El reloj de latencia arranca al entregarlo SFML
+                input.traceId = tracer.newId();
+                input.deliveredNs = CoralCode::LatencyTracer::now();
+                input.traceName = traceInputName(*event);
+                tracer.flow(CoralCode::TraceFlow::Start, input.traceId, input.deliveredNs);
+            }
+            modelThread.push(input);
+        }
+        tracer.span("render", "events", pollStart, CoralCode::LatencyTracer::now());
+        profiler.endPhase(CoralCode::FramePhase::Events);
+        CoralCode::AllocationTracker::setSite(CoralCode::AllocationSite::Layout);
+        if (!window.isOpen()) {
+            break;
+        }
+        
+        // Último snapshot publicado (no espera a ediciones en curso)
+        std::shared_ptr<const FrameSnapshot> frame =
+            modelThread.latest(tracer.isEnabled() ? &presentedInputs : nullptr);
+        metrics = frame->metrics;
+        if (frame->sequence != lastSnapshot) {
+            // Tiempo del modelo atribuido al primer frame que lo muestra
+            profiler.addPhaseTime(CoralCode::FramePhase::Edits, frame->editNs);
+            profiler.addPhaseTime(CoralCode::FramePhase::Highlight, frame->highlightNs);
+            lastSnapshot = frame->sequence;
             
-            statusInfo << "  |  Scroll H: " << scrollCol 
-                      << "  |  Cmd+C: Copiar  Cmd+V: Pegar  Cmd+Z: Undo  Cmd+Shift+Z: Redo  ⚡: Ctrl+Flechas  🔄: Rueda/Trackpad";
-            
-            sf::Text statusText(font, statusInfo.str(), 12);
-            // Posicionar texto dinámicamente en la barra de estado
-            float statusTextY = static_cast<float>(windowSize.y - 25) + 5.0f; // 5px desde el borde superior de la barra
-            statusText.setPosition(sf::Vector2f(10.0f, statusTextY));
-            statusText.setFillColor(sf::Color(200, 200, 200));
-            window.draw(statusText);
+            memory = frame->memory;
+            memory[CoralCode::MemorySubsystem::GlyphAtlas] = renderer.getGlyphAtlasMemory();
+            memory[CoralCode::MemorySubsystem::Minimap] += renderer.getImageMemory();
+            if (memory.total() != memoryTotal) {
+                memoryTotal = memory.total();
+                memoryStatus = memory.formatStatus();
+            }
+            statusLine.assign(frame->status);
+            statusLine += "  |  ";
+            statusLine += memoryStatus;
         }
+        if (dumpMemory) {
+            std::cout << memory.formatReport() << std::flush;
+            dumpMemory = false;
+        }
+        if (frame->closeRequested) {
+            window.close();
+            break;
+        }
+        // Renderizar
+        profiler.beginPhase(CoralCode::FramePhase::Layout);
+        const uint64_t renderStart = CoralCode::LatencyTracer::now();
         
+        // Obtener tamaño actual de ventana
+        sf::Vector2u currentWindowSize = window.getSize();
+        
+        // Solo actualizar windowSize si realmente cambió
+        if (currentWindowSize.x != windowSize.x || currentWindowSize.y != windowSize.y) {
+            windowSize = currentWindowSize;
+        }
+        
+        // Overlay del perfilador (el texto se recalcula cada pocos frames)
+        const bool overlay = showProfiler && fontLoaded;
+        if (overlay && (profilerText.empty() || profiler.getFrameCount() % 15 == 0)) {
+            profilerText = CoralCode::FrameProfiler::formatOverlay(profiler.computeStats());
+        }
+        renderFrame(renderer, *frame, windowSize, *minimapImage, minimapTexture, statusLine,
+                    overlay ? &profilerText : nullptr);
+        profiler.endPhase(CoralCode::FramePhase::Layout);
+        const uint64_t displayStart = CoralCode::LatencyTracer::now();
+        tracer.span("render", "render", renderStart, displayStart);
+        
+        profiler.beginPhase(CoralCode::FramePhase::Present);
+        CoralCode::AllocationTracker::setSite(CoralCode::AllocationSite::Present);
         window.display();
+        CoralCode::AllocationTracker::setSite(CoralCode::AllocationSite::Layout);
+        profiler.endPhase(CoralCode::FramePhase::Present);
+        profiler.endFrame();
+        
+        // Cada evento incluido en este frame se cierra cuando display() devuelve
+        if (tracer.isEnabled()) {
+            const uint64_t presented = CoralCode::LatencyTracer::now();
+            tracer.span("render", "display", displayStart, presented);
+            for (const TracedInput& input : presentedInputs) {
+                tracer.flow(CoralCode::TraceFlow::End, input.id, displayStart);
+                tracer.asyncSpan("latency", input.name, input.id, input.deliveredNs, presented);
+            }
+            presentedInputs.clear();
+        }
+    }
+    
+    if (!tracePath.empty()) {
+        std::string error;
+        if (tracer.exportChromeTrace(tracePath, error)) {
+            std::cout << "\n🧵 Traza de latencia guardada en " << tracePath << " (abrir en ui.perfetto.dev)" << std::endl;
+        } else {
+            std::cerr << "❌ " << error << std::endl;
+        }
     }
     
+    if (profileRequested) {
+        std::cout << "\n⏱️  Perfil: " << CoralCode::FrameProfiler::formatSummary(profiler.computeStats()) << std::endl;
+    }
+    
+    // Procesar los eventos pendientes y detener el hilo del modelo
+    modelThread.stop();
+    const std::vector<std::string>& lines = modelThread.model().lines;
+    
     // Mostrar contenido final
     std::cout << "\n📄 Contenido final del editor:" << std::endl;
     for (size_t i = 0; i < lines.size(); ++i) {
@@ -1250,4 +2537,4 @@ int main() {
     }
     
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace CoralCode {
+
+    /**
+     * @brief Parte del editor a la que se cargan las asignaciones del hilo
+     */
+    enum class AllocationSite : uint8_t {
+        Unattributed,
+        Input,          // Recoger y encolar eventos
+        Edit,           // Aplicar un evento al texto
+        UndoHistory,
+        Highlight,      // Tokens de las líneas visibles
+        StatusBar,
+        Snapshot,       // Resto del snapshot del frame
+        Layout,         // Render fuera de las llamadas a draw
+        Draw,
+        Present,        // display()
+        Count
+    };
+
+    /**
+     * @brief Asignaciones acumuladas por sitio (recuento y bytes pedidos)
+     */
+    struct AllocationCounts {
+        static constexpr size_t SITE_COUNT = static_cast<size_t>(AllocationSite::Count);
+
+        std::array<uint64_t, SITE_COUNT> count{};
+        std::array<uint64_t, SITE_COUNT> bytes{};
+
+        uint64_t operator[](AllocationSite site) const { return count[static_cast<size_t>(site)]; }
+
+        uint64_t total() const;
+        uint64_t totalBytes() const;
+
+        // Diferencia entre dos lecturas (la de la izquierda es la posterior)
+        AllocationCounts operator-(const AllocationCounts& earlier) const;
+
+        // Una fila por sitio con asignaciones, de mayor a menor
+        std::string formatReport() const;
+    };
+
+    /**
+     * @brief Recuento opcional de asignaciones por sitio
+     *
+     * Responsable de:
+     * - Sustituir el operator new global y contar cada asignación en el
+     *   sitio activo del hilo que la hace
+     * - Activarse solo mientras alguien lo pida (perfilador de frames,
+     *   comprobación de estado estable); inactivo cuesta una lectura atómica
+     *
+     * El sitio es por hilo: el hilo del modelo y el de render se atribuyen
+     * por separado aunque asignen a la vez.
+     */
+    class AllocationTracker {
+    public:
+        static constexpr size_t SITE_COUNT = AllocationCounts::SITE_COUNT;
+
+        // Cada retain() necesita su release(); cuenta mientras haya alguno
+        static void retain();
+        static void release();
+        static bool isActive();
+
+        // Lectura de los contadores globales (no asigna memoria)
+        static AllocationCounts snapshot();
+        static uint64_t totalCount();
+
+        // Sitio del hilo actual
+        static AllocationSite currentSite();
+        static void setSite(AllocationSite site);
+
+        static const char* siteName(AllocationSite site);
+
+        // Cambia el sitio del hilo en un ámbito
+        class Scope {
+        public:
+            explicit Scope(AllocationSite site) : previous_(currentSite()) { setSite(site); }
+            ~Scope() { setSite(previous_); }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            AllocationSite previous_;
+        };
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+
+namespace CoralCode {
+
+    /**
+     * @brief Resultado de una lectura asíncrona
+     */
+    struct FileReadResult {
+        bool success = false;
+        std::string content;
+        std::string error;
+    };
+
+    /**
+     * @brief Resultado de una escritura asíncrona
+     */
+    struct FileWriteResult {
+        bool success = false;
+        std::string error;
+    };
+
+    /**
+     * @brief Capa de E/S de archivos asíncrona
+     *
+     * Responsable de:
+     * - En Linux, encadenar open/statx/read/write/fsync/close/rename en un
+     *   io_uring atendido por un hilo propio: cientos de archivos quedan en
+     *   vuelo a la vez con una llamada al sistema por lote
+     * - Si io_uring no está disponible (kernel antiguo, seccomp, otras
+     *   plataformas), repartir las mismas operaciones bloqueantes en un
+     *   pequeño grupo de hilos de E/S
+     * - Guardar de forma atómica: un temporal propio de cada escritura
+     *   (creado con O_EXCL), fsync y rename, conservando los permisos
+     *   del original
+     *
+     * Las llamadas solo encolan y devuelven un futuro; nunca bloquean.
+     */
+    class AsyncFileIO {
+    public:
+        explicit AsyncFileIO(bool allowIoUring = true, size_t fallbackThreads = 0);
+        ~AsyncFileIO();
+
+        AsyncFileIO(const AsyncFileIO&) = delete;
+        AsyncFileIO& operator=(const AsyncFileIO&) = delete;
+
+        // Instancia de todo el proceso
+        static AsyncFileIO& shared();
+
+        std::future<FileReadResult> read(const std::string& path, uint64_t maxSize = DEFAULT_MAX_FILE_SIZE);
+        std::future<FileWriteResult> write(const std::string& path, std::string content);
+
+        bool isUsingIoUring() const;
+        const char* getBackendName() const;
+
+        static constexpr uint64_t DEFAULT_MAX_FILE_SIZE = 1ull << 30;
+
+        // Operaciones simultáneas en el anillo y bytes por lectura/escritura
+        static constexpr unsigned QUEUE_DEPTH = 256;
+        static constexpr size_t IO_CHUNK = 1u << 20;
+
+        // Hilos del respaldo sin io_uring (E/S, no CPU: no depende de los núcleos)
+        static constexpr size_t FALLBACK_THREADS = 4;
+
+        class Backend;
+        struct Request;
+
+    private:
+        std::unique_ptr<Backend> backend_;
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "RegexEngine.hpp"
+#include "SearchEngine.hpp"
+#include "TextBuffer.hpp"
+#include "UndoRedoManager.hpp"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Órdenes de un script de edición por lotes
+     */
+    enum class BatchCommandType {
+        Replace,                // replace "viejo" "nuevo" [-i] [-w]
+        ReplaceRegex,           // replace-regex "patrón" "nuevo $1" [-i]
+        DeleteLines,            // delete-lines "patrón"
+        InsertLine,             // insert-line <n|end> "texto"
+        TrimTrailingWhitespace, // trim-trailing-whitespace
+        ExpandTabs,             // expand-tabs [ancho]
+        EnsureFinalNewline,     // ensure-final-newline
+        Require,                // require "texto": si falta, el archivo no se toca
+        RequireRegex            // require-regex "patrón"
+    };
+
+    /**
+     * @brief Una orden ya validada (y con su búsqueda compilada)
+     */
+    struct BatchCommand {
+        BatchCommandType type = BatchCommandType::Replace;
+        std::string pattern;
+        std::string text;
+        bool caseSensitive = true;
+        bool wholeWord = false;
+        size_t number = 0;          // insert-line (0 = al final), expand-tabs
+        size_t sourceLine = 0;
+
+        // Compiladas una vez y compartidas entre hilos (búsqueda const)
+        std::shared_ptr<const SearchEngine> search;
+        std::shared_ptr<const RegexEngine> regex;
+    };
+
+    /**
+     * @brief Script de edición por lotes
+     *
+     * Una orden por línea, argumentos separados por espacios o entre
+     * comillas dobles (con \" \\ \n \t), y comentarios con '#'.
+     */
+    class BatchScript {
+    public:
+        bool parse(const std::string& text, std::string& error);
+        bool load(const std::string& path, std::string& error);
+
+        const std::vector<BatchCommand>& getCommands() const { return commands_; }
+        bool isEmpty() const { return commands_.empty(); }
+
+    private:
+        std::vector<BatchCommand> commands_;
+    };
+
+    /**
+     * @brief Opciones de ejecución por lotes
+     */
+    struct BatchOptions {
+        size_t jobs = 0;            // 0: planificador compartido
+        bool dryRun = false;        // Informar sin escribir
+    };
+
+    /**
+     * @brief Resultado de un archivo
+     */
+    struct BatchFileResult {
+        std::string path;
+        bool success = false;
+        bool changed = false;
+        bool skipped = false;       // Un require no se cumplió
+        size_t edits = 0;
+        std::string error;
+    };
+
+    /**
+     * @brief Resumen de una ejecución
+     */
+    struct BatchSummary {
+        size_t files = 0;
+        size_t changed = 0;
+        size_t skipped = 0;
+        size_t failed = 0;
+        size_t edits = 0;
+        double elapsedMs = 0.0;
+    };
+
+    /**
+     * @brief Una invocación completa desde la línea de comandos
+     */
+    struct BatchRequest {
+        std::string scriptPath;
+        std::vector<std::string> inputs;    // Archivos o directorios
+        std::vector<std::string> include;   // Globs sobre la ruta relativa
+        BatchOptions options;
+        bool verbose = false;
+    };
+
+    /**
+     * @brief Edición por lotes sin ventana
+     *
+     * Responsable de:
+     * - Aplicar un BatchScript con los mismos motores que el editor:
+     *   TextBuffer::applyEdits, SearchEngine/RegexEngine y un paso de
+     *   UndoRedoManager por orden (un require fallido deshace lo anterior)
+     * - Leer por bloques con FileHandler (E/S asíncrona), editar en
+     *   paralelo con el TaskScheduler y guardar de forma atómica solo los
+     *   archivos que cambian, conservando los finales de línea CRLF
+     *
+     * La memoria está acotada a BATCH_CHUNK archivos a la vez.
+     */
+    class BatchEditor {
+    public:
+        using FileCallback = std::function<void(const BatchFileResult&)>;
+
+        explicit BatchEditor(const BatchScript& script, const BatchOptions& options = BatchOptions());
+
+        // Un buffer en memoria; devuelve las ediciones aplicadas
+        bool apply(TextBuffer& buffer, UndoRedoManager& history, BatchFileResult& result) const;
+
+        // Archivos en disco; onFile se llama desde el hilo que llama a run()
+        BatchSummary run(const std::vector<std::string>& paths, const FileCallback& onFile = nullptr) const;
+
+        // Archivos y directorios (recorridos respetando .gitignore); include
+        // filtra por patrones glob sobre la ruta relativa
+        static bool expandPaths(const std::vector<std::string>& inputs, const std::vector<std::string>& include,
+                                std::vector<std::string>& paths, std::string& error);
+
+        // Carga el script, expande las rutas, ejecuta e informa por consola;
+        // devuelve 0 si todo fue bien, 1 si falló algún archivo y 2 si el
+        // script o las rutas no son válidos
+        static int runRequest(const BatchRequest& request);
+
+        static constexpr size_t BATCH_CHUNK = 256;
+        static constexpr size_t DEFAULT_TAB_WIDTH = 4;
+
+    private:
+        const BatchScript& script_;
+        BatchOptions options_;
+
+        void processFile(const std::string& path, std::string content, BatchFileResult& result,
+                         std::string& output) const;
+    };
+
+} // namespace CoralCode
@@ -38,6 +38,7 @@ namespace CoralCode {
         std::vector<std::string> getHistory() const;
         std::string getHistoryItem(size_t index) const;
         void clearHistory();
+        size_t getMemoryUsage() const;
         
         // Detección de formato
         enum class TextFormat {
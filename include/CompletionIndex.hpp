@@ -0,0 +1,97 @@
+#pragma once
+
+#include "TextBuffer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Índice de identificadores del buffer para autocompletado
+     *
+     * Responsable de:
+     * - Recorrer el documento por tramos (indexStep) sin bloquear la UI
+     * - Mantenerse al día con los eventos de cambio del TextBuffer: solo
+     *   se re-escanean las líneas editadas
+     * - Contar apariciones de cada identificador para ordenar sugerencias
+     * - Responder prefijos (sin distinguir mayúsculas) con búsqueda binaria
+     *   sobre un arreglo ordenado más una lista corta de altas recientes
+     * - Informar de la memoria ocupada
+     *
+     * Cada palabra se guarda una vez; las líneas guardan solo los
+     * identificadores numéricos de sus palabras para poder descontarlas.
+     */
+    class CompletionIndex {
+    public:
+        CompletionIndex();
+        ~CompletionIndex();
+
+        CompletionIndex(const CompletionIndex&) = delete;
+        CompletionIndex& operator=(const CompletionIndex&) = delete;
+
+        // Conexión con el buffer
+        void attach(TextBuffer& buffer);
+        void detach();
+        bool isAttached() const { return buffer_ != nullptr; }
+
+        // Escaneo por tramos
+        size_t indexStep(size_t maxLines);
+        bool isComplete() const;
+
+        // Consultas: palabras que empiezan por prefix, más frecuentes primero
+        std::vector<std::string> complete(const std::string& prefix, size_t limit = 20,
+                                          bool excludeSingleExact = true);
+        size_t getWordCount() const { return liveWords_; }
+        size_t getMemoryUsage() const;
+
+        // Actualización incremental
+        void applyChange(const TextChange& change);
+
+        static bool isWordByte(char ch);
+
+        static constexpr size_t MIN_WORD_LENGTH = 2;
+        static constexpr size_t MAX_WORD_LENGTH = 128;
+
+        // Regiones editadas más grandes se re-escanean con indexStep()
+        static constexpr size_t MAX_SYNC_RESCAN_LINES = 2048;
+
+        // Altas recientes que se recorren linealmente antes de ordenarlas
+        static constexpr size_t MAX_PENDING_WORDS = 256;
+
+    private:
+        struct Word {
+            std::string text;
+            uint32_t count;
+        };
+
+        TextBuffer* buffer_;
+        size_t listenerId_;
+
+        // Palabras (deque: las claves de ids_ apuntan a su texto)
+        std::deque<Word> words_;
+        std::unordered_map<std::string_view, uint32_t> ids_;
+        size_t liveWords_;
+
+        // Identificadores ordenados por texto + altas sin ordenar
+        std::vector<uint32_t> sorted_;
+        std::vector<uint32_t> pending_;
+
+        // Palabras de cada línea indexada; cubre [0, lineWords_.size())
+        std::vector<std::vector<uint32_t>> lineWords_;
+
+        void restart();
+        void scanLine(size_t line, std::vector<uint32_t>& out);
+        void releaseLine(std::vector<uint32_t>& ids);
+        void truncate(size_t firstLine);
+        uint32_t intern(std::string_view text);
+        void mergePending();
+        void compact();
+        bool wordLess(uint32_t a, uint32_t b) const;
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "TextBuffer.hpp"
+#include "TextEdit.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Un cursor con su selección (anchor = extremo fijo, head = cursor)
+     */
+    struct CursorRange {
+        CursorPosition anchor;
+        CursorPosition head;
+
+        CursorRange() = default;
+        explicit CursorRange(const CursorPosition& position) : anchor(position), head(position) {}
+        CursorRange(const CursorPosition& a, const CursorPosition& h) : anchor(a), head(h) {}
+
+        bool isEmpty() const { return anchor == head; }
+        const CursorPosition& start() const;
+        const CursorPosition& end() const;
+    };
+
+    /**
+     * @brief Conjunto de cursores para edición simultánea
+     *
+     * Responsable de:
+     * - Mantener los cursores ordenados y sin solapes (los que se tocan
+     *   o coinciden se fusionan)
+     * - Selección rectangular: un rango por línea entre dos columnas
+     * - Traducir una pulsación en un único lote de TextEdit aplicado con
+     *   TextBuffer::applyEdits; devuelve las ediciones inversas para
+     *   registrar un solo paso de undo
+     * - Recolocar cada cursor al final de su propia edición
+     *
+     * Las columnas son bytes; borrar retrocede un carácter UTF-8 completo.
+     */
+    class CursorSet {
+    public:
+        CursorSet();
+
+        // Gestión de cursores
+        void reset(const CursorPosition& position);
+        void reset(const CursorPosition& anchor, const CursorPosition& head);
+        void add(const CursorPosition& anchor, const CursorPosition& head);
+        void add(const CursorPosition& position) { add(position, position); }
+        bool addAbove(const TextBuffer& buffer);
+        bool addBelow(const TextBuffer& buffer);
+        void setColumnSelection(const TextBuffer& buffer, const CursorPosition& anchor, const CursorPosition& head);
+        void collapseToPrimary();
+
+        size_t size() const { return ranges_.size(); }
+        bool isMulti() const { return ranges_.size() > 1; }
+        const std::vector<CursorRange>& getRanges() const { return ranges_; }
+        const CursorRange& getPrimary() const { return ranges_[primary_]; }
+        std::vector<std::string> getSelectedTexts(const TextBuffer& buffer) const;
+
+        // Edición en lote (devuelven las ediciones inversas)
+        std::vector<TextEdit> insertText(TextBuffer& buffer, const std::string& text);
+        std::vector<TextEdit> insertTexts(TextBuffer& buffer, const std::vector<std::string>& texts);
+        std::vector<TextEdit> deleteBackward(TextBuffer& buffer);
+        std::vector<TextEdit> deleteForward(TextBuffer& buffer);
+
+        // Movimiento de todos los cursores (extend conserva el anchor)
+        void move(const TextBuffer& buffer, int deltaLine, int deltaCol, bool extend);
+        void moveToLineStart(bool extend);
+        void moveToLineEnd(const TextBuffer& buffer, bool extend);
+
+        // Tras cambios externos (undo, recarga) los cursores pueden quedar fuera
+        void clamp(const TextBuffer& buffer);
+
+    private:
+        std::vector<CursorRange> ranges_;
+        size_t primary_;
+
+        void normalize();
+        std::vector<TextEdit> apply(TextBuffer& buffer, std::vector<TextEdit> edits);
+
+        static CursorPosition clampPosition(const TextBuffer& buffer, const CursorPosition& position);
+        static CursorPosition stepBackward(const TextBuffer& buffer, const CursorPosition& position);
+        static CursorPosition stepForward(const TextBuffer& buffer, const CursorPosition& position);
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Atlas de glifos como campos de distancia con signo (SDF)
+     *
+     * Responsable de:
+     * - Convertir la cobertura de cada glifo, rasterizada una sola vez a
+     *   BASE_SIZE, en la distancia al borde (transformada exacta de
+     *   Felzenszwalb y Huttenlocher, dentro y fuera)
+     * - Empaquetar los campos en estantes de una imagen de un canal que
+     *   crece en alto cuando se llena
+     * - Guardar la métrica de cada glifo a BASE_SIZE para escalarla a
+     *   cualquier tamaño
+     *
+     * Cada píxel vale 128 en el borde, más dentro del glifo y menos fuera,
+     * hasta SPREAD píxeles (de BASE_SIZE) a cada lado. Con filtrado lineal
+     * y un umbral en 0.5, el mismo atlas dibuja el texto nítido a cualquier
+     * tamaño sin volver a rasterizar. No depende de la biblioteca gráfica:
+     * la cobertura la aporta el backend.
+     */
+    class DistanceFieldAtlas {
+    public:
+        // Métrica de un glifo a BASE_SIZE (ancho 0: no se dibuja, p. ej. el espacio)
+        struct Glyph {
+            float advance = 0.0f;
+            float left = 0.0f;              // Esquina del campo (con margen) desde la pluma
+            float top = 0.0f;               // y desde la línea base (negativo: encima)
+            unsigned x = 0;                 // Posición y tamaño en el atlas
+            unsigned y = 0;
+            unsigned width = 0;
+            unsigned height = 0;
+        };
+
+        static constexpr unsigned BASE_SIZE = 32;
+        static constexpr unsigned SPREAD = 4;
+        static constexpr unsigned WIDTH = 512;
+        static constexpr unsigned MAX_HEIGHT = 4096;
+
+        DistanceFieldAtlas();
+
+        /**
+         * @brief Añade un glifo a partir de su cobertura a BASE_SIZE
+         * @param coverage Cobertura de 8 bits fila a fila (stride bytes por fila)
+         * @param left Desplazamiento del bitmap desde la pluma
+         * @param top Desplazamiento del bitmap desde la línea base
+         * @return false si el atlas ya no admite más alto
+         */
+        bool addGlyph(char32_t codepoint, const uint8_t* coverage, unsigned width, unsigned height, size_t stride,
+                      float left, float top, float advance);
+
+        const Glyph* find(char32_t codepoint) const;
+
+        // Distancia entre líneas de la fuente a BASE_SIZE
+        void setLineSpacing(float lineSpacing) { lineSpacing_ = lineSpacing; }
+        float getLineSpacing() const { return lineSpacing_; }
+
+        // Un byte por píxel, WIDTH por fila
+        const std::vector<uint8_t>& getPixels() const { return pixels_; }
+        unsigned getWidth() const { return WIDTH; }
+        unsigned getHeight() const { return height_; }
+        size_t getGlyphCount() const { return glyphs_.size(); }
+
+        // Filas escritas desde la última llamada; false si no hay ninguna
+        bool takeDirtyRows(unsigned& firstRow, unsigned& rowCount);
+
+        size_t getMemoryUsage() const;
+
+    private:
+        std::vector<Glyph> glyphs_;
+        std::array<int32_t, 256> latin1_;                   // Índice en glyphs_ (-1: ninguno)
+        std::unordered_map<char32_t, size_t> others_;
+        float lineSpacing_ = 0.0f;
+
+        std::vector<uint8_t> pixels_;
+        unsigned height_ = 0;
+        unsigned shelfX_ = 0;
+        unsigned shelfY_ = 0;
+        unsigned shelfHeight_ = 0;
+        unsigned dirtyFirst_ = 0;
+        unsigned dirtyEnd_ = 0;
+
+        // Buffers de la transformada, reutilizados entre glifos
+        std::vector<float> inside_;
+        std::vector<float> outside_;
+        std::vector<float> line_;
+        std::vector<float> lineOut_;
+        std::vector<size_t> hull_;
+        std::vector<float> bounds_;
+
+        bool reserve(unsigned width, unsigned height, unsigned& x, unsigned& y);
+        void transform(std::vector<float>& grid, unsigned width, unsigned height);
+    };
+
+} // namespace CoralCode
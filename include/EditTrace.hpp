@@ -0,0 +1,151 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Teclas que el editor interpreta (independientes de SFML)
+     *
+     * Las trazas guardan estos valores y no los de sf::Keyboard::Key, que
+     * cambian entre versiones de SFML; así una traza se reproduce sin
+     * ventana y con cualquier versión.
+     */
+    enum class TraceKey : uint8_t {
+        Unknown = 0,
+        Left, Right, Up, Down,
+        Home, End, PageUp, PageDown,
+        Backspace, Delete, Enter, Tab, Escape,
+        A, C, D, F, S, V, X, Y, Z
+    };
+
+    /**
+     * @brief Tipos de evento de una traza
+     *
+     * Key, Text, ratón, Scroll y Resize son lo que EventHandler recibe
+     * (KeyInfo, MouseInfo). Paste guarda el texto del portapapeles en el
+     * momento de pegar, para que la reproducción sea determinista. Splice
+     * es una edición posicional (trazas publicadas de edición de texto).
+     */
+    enum class TraceEventType : uint8_t {
+        Key = 1,
+        Text = 2,
+        MousePress = 3,
+        MouseRelease = 4,
+        MouseMove = 5,
+        Scroll = 6,
+        Resize = 7,
+        Paste = 8,
+        Splice = 9
+    };
+
+    // Modificadores de Key (máscara de bits)
+    enum TraceModifier : uint8_t {
+        TRACE_CTRL = 1,
+        TRACE_SHIFT = 2,
+        TRACE_ALT = 4,
+        TRACE_SYSTEM = 8
+    };
+
+    /**
+     * @brief Un evento de la traza
+     *
+     * Solo se usan los campos de su tipo:
+     * - Key: key, modifiers
+     * - Text: codepoint
+     * - MousePress/MouseRelease/MouseMove: x, y, button (0 izquierdo)
+     * - Scroll: delta (x si horizontal), horizontal
+     * - Resize: width, height
+     * - Paste: text
+     * - Splice: position y deleteCount en codepoints, text insertado
+     */
+    struct TraceEvent {
+        TraceEventType type = TraceEventType::Key;
+        uint64_t timeUs = 0;    // Desde el inicio de la grabación
+
+        TraceKey key = TraceKey::Unknown;
+        uint8_t modifiers = 0;
+        uint32_t codepoint = 0;
+        float x = 0.0f;
+        float y = 0.0f;
+        uint8_t button = 0;
+        float delta = 0.0f;
+        bool horizontal = false;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint64_t position = 0;
+        uint64_t deleteCount = 0;
+        std::string text;
+
+        bool hasModifier(TraceModifier modifier) const { return (modifiers & modifier) != 0; }
+    };
+
+    /**
+     * @brief Sesión de edición grabada
+     *
+     * Responsable de:
+     * - Guardar el documento inicial, el tamaño de ventana y los eventos
+     * - Formato binario compacto (.cctrace): enteros de longitud variable,
+     *   tiempos como diferencias y coordenadas en píxeles enteros
+     * - Importar trazas publicadas en JSON ({"startContent", "endContent",
+     *   "txns": [{"patches": [[pos, borrar, "texto"]]}]}) como Splice
+     */
+    struct EditTrace {
+        std::string initialText;
+        std::string expectedText;   // Resultado conocido (vacío si no se sabe)
+        bool hasExpectedText = false;
+        uint32_t windowWidth = 1200;
+        uint32_t windowHeight = 800;
+        std::vector<TraceEvent> events;
+
+        bool save(const std::string& path, std::string& error) const;
+        bool load(const std::string& path, std::string& error);
+
+        // Formato en memoria (lo usan save/load)
+        std::string serialize() const;
+        bool deserialize(const std::string& data, std::string& error);
+
+        // Traza publicada en JSON (descomprimida)
+        bool importEditingTrace(const std::string& path, std::string& error);
+        bool parseEditingTrace(const std::string& json, std::string& error);
+
+        static constexpr char MAGIC[8] = {'C', 'C', 'T', 'R', 'A', 'C', 'E', '1'};
+    };
+
+    /**
+     * @brief Graba eventos de entrada con su marca de tiempo
+     *
+     * Lo alimenta EventHandler con cada KeyInfo/MouseInfo recibido. No es
+     * seguro entre hilos: se usa desde el hilo de eventos.
+     */
+    class EditTraceRecorder {
+    public:
+        EditTraceRecorder();
+
+        void start(const std::string& initialText, uint32_t windowWidth, uint32_t windowHeight);
+        void stop();
+        bool isRecording() const { return recording_; }
+
+        void recordKey(TraceKey key, uint8_t modifiers);
+        void recordText(uint32_t codepoint);
+        void recordMouse(TraceEventType type, float x, float y, uint8_t button);
+        void recordScroll(float delta, bool horizontal);
+        void recordResize(uint32_t width, uint32_t height);
+        void recordPaste(const std::string& text);
+
+        const EditTrace& getTrace() const { return trace_; }
+        bool save(const std::string& path, std::string& error) const { return trace_.save(path, error); }
+
+    private:
+        EditTrace trace_;
+        std::chrono::steady_clock::time_point startTime_;
+        bool recording_;
+
+        TraceEvent& append(TraceEventType type);
+    };
+
+} // namespace CoralCode
@@ -1,9 +1,16 @@
 #pragma once
 
+#include "FrameProfiler.hpp"
+#include "MemoryUsage.hpp"
 #include "TextBuffer.hpp"
+#include "TextEdit.hpp"
 #include "Viewport.hpp"
 #include "SyntaxHighlighter.hpp"
+#include "TaskScheduler.hpp"
+#include <atomic>
 #include <cstddef>
+#include <functional>
+#include <future>
 #include <string>
 #include <memory>
 
@@ -13,24 +20,20 @@ namespace CoralCode {
     class Window;
     class UndoRedoManager;
     class ClipboardManager;
-    
-    /**
-     * @brief Posición del cursor en el editor
-     */
-    struct CursorPosition {
-        size_t line;
-        size_t column;
-        
-        CursorPosition(size_t l = 0, size_t c = 0) : line(l), column(c) {}
-        
-        bool operator==(const CursorPosition& other) const {
-            return line == other.line && column == other.column;
-        }
-        
-        bool operator!=(const CursorPosition& other) const {
-            return !(*this == other);
-        }
-    };
+    class IncrementalParser;
+    class SearchEngine;
+    class RegexEngine;
+    class SearchMatchIndex;
+    class CompletionIndex;
+    class CursorSet;
+    enum class OperationType;
+    class ProjectSearch;
+    class FileIndex;
+    class FileWatcher;
+    class WrapIndex;
+    struct SearchMatch;
+    struct ProjectSearchResult;
+    struct FileMatch;
     
     /**
      * @brief Selección de texto en el editor
@@ -110,6 +113,20 @@ namespace CoralCode {
         void clearSelection();
         std::string getSelectedText() const;
         
+        // Múltiples cursores y selección rectangular: cada pulsación se aplica
+        // a todos los cursores como una sola edición y un solo paso de undo
+        void addCursor(const CursorPosition& position);
+        bool addCursorAbove();
+        bool addCursorBelow();
+        bool addCursorAtNextOccurrence();
+        void setColumnSelection(const CursorPosition& anchor, const CursorPosition& head);
+        void clearSecondaryCursors();
+        size_t getCursorCount() const;
+        std::vector<TextSelection> getCursorSelections() const;
+        void typeAtCursors(const std::string& text);
+        void deleteAtCursors(bool forward);
+        void moveCursors(int deltaLine, int deltaCol, bool extend);
+        
         // Clipboard
         void copy();
         void cut();
@@ -124,7 +141,72 @@ namespace CoralCode {
         bool findNext();
         bool findPrevious();
         void replace(const std::string& oldText, const std::string& newText);
-        void replaceAll(const std::string& oldText, const std::string& newText);
+        
+        // Reemplazo masivo en una pasada y un solo paso de undo. onProgress
+        // recibe la fracción recorrida; cancelSearch() lo interrumpe sin cambios.
+        using ProgressCallback = std::function<void(double)>;
+        size_t replaceAll(const std::string& oldText, const std::string& newText,
+                          const ProgressCallback& onProgress = nullptr);
+        
+        // Expresiones regulares (find/replace usan el patrón como regex)
+        void setRegexSearch(bool enabled);
+        bool isRegexSearch() const;
+        std::string getSearchError() const;
+        void cancelSearch();
+        
+        // Índice de coincidencias: se completa por tramos (llamar cada frame)
+        size_t updateSearchIndex(size_t maxLines);
+        bool isSearchIndexComplete() const;
+        size_t getSearchMatchCount() const;
+        size_t getCurrentMatchNumber() const;
+        std::vector<SearchMatch> getVisibleSearchMatches() const;
+        
+        // Autocompletado con identificadores del buffer: el índice se completa
+        // por tramos (llamar cada frame) y después sigue las ediciones
+        size_t updateCompletionIndex(size_t maxLines);
+        std::vector<std::string> getCompletions(size_t limit = 20);
+        std::string getCompletionPrefix() const;
+        size_t getCompletionIndexMemory() const;
+        
+        // Búsqueda en archivos: corre en segundo plano, resultados por frame
+        bool findInFiles(const std::string& root, const std::string& text,
+                         bool caseSensitive = false, bool wholeWord = false);
+        size_t updateProjectSearch();
+        bool isProjectSearchRunning() const;
+        void cancelProjectSearch();
+        const std::vector<ProjectSearchResult>& getProjectSearchResults() const;
+        bool openProjectSearchResult(size_t index);
+        
+        // Espacio de trabajo: índice de rutas para apertura rápida. Se carga o
+        // construye en segundo plano; updateWorkspace() aplica los cambios del
+        // sistema de archivos (llamar cada frame)
+        bool openWorkspace(const std::string& root);
+        void closeWorkspace();
+        size_t updateWorkspace();
+        bool isWorkspaceIndexReady() const;
+        std::vector<FileMatch> quickOpen(const std::string& query, size_t limit = 50);
+        bool openQuickOpenResult(const FileMatch& match);
+        
+        // Trabajo en segundo plano (planificador compartido): el token se
+        // cancela solo en cuanto el buffer cambia de versión
+        CancellationToken createBufferToken();
+        std::vector<TaskStats> getTaskStats() const;
+        
+        // Perfilador de frames: fases del bucle, draw calls y asignaciones.
+        // El overlay (F12) lo muestra; activarlo no abre el overlay
+        void setProfiling(bool enabled);
+        bool isProfiling() const;
+        void toggleProfilerOverlay();
+        bool isProfilerOverlayVisible() const;
+        FrameProfiler& getFrameProfiler();
+        const FrameProfiler& getFrameProfiler() const;
+        
+        // Memoria por subsistema (barra de estado y volcado de depuración).
+        // Buffer y tokens se recorren solo cuando cambia la versión del
+        // buffer; el atlas de glifos lo informa el render
+        MemoryUsage getMemoryUsage() const;
+        std::string getMemoryStatus() const;
+        void setGlyphAtlasMemory(size_t bytes);
         
         // Estado del editor
         CursorPosition getCursorPosition() const;
@@ -138,6 +220,21 @@ namespace CoralCode {
         void setTheme(const std::string& theme);
         void setTabSize(size_t size);
         void setWordWrap(bool enabled);
+        bool isWordWrap() const { return wordWrap_; }
+        // Avances de la fuente cargada para posicionar clics y cursor
+        void setGlyphAdvanceProvider(TextLayout::GlyphAdvanceFunction provider);
+        
+        // Análisis incremental (opcional): tokens con tipos, plegado y outline
+        void setIncrementalParsing(bool enabled);
+        IncrementalParser* getIncrementalParser() const;
+        
+        // Ajuste de línea: scroll y barra en filas visuales, O(log n).
+        // Sin ajuste, una fila por línea
+        WrapIndex* getWrapIndex() const;
+        size_t getVisualLineCount() const;
+        size_t getFirstVisualRow() const;
+        void scrollToVisualRow(size_t row);
+        std::vector<std::pair<std::string, TokenColor>> getHighlightedLine(size_t line) const;
         
         // Eventos (llamados por EventHandler)
         void onKeyPressed(int keyCode, bool ctrl, bool shift, bool alt);
@@ -155,6 +252,16 @@ namespace CoralCode {
         std::unique_ptr<Window> window_;
         std::unique_ptr<UndoRedoManager> undoRedoManager_;
         std::unique_ptr<ClipboardManager> clipboardManager_;
+        std::unique_ptr<IncrementalParser> incrementalParser_;
+        std::unique_ptr<SearchEngine> searchEngine_;
+        std::unique_ptr<RegexEngine> regexEngine_;
+        std::unique_ptr<SearchMatchIndex> matchIndex_;
+        std::unique_ptr<CompletionIndex> completionIndex_;
+        std::unique_ptr<CursorSet> cursors_;
+        std::unique_ptr<ProjectSearch> projectSearch_;
+        std::unique_ptr<FileIndex> fileIndex_;
+        std::unique_ptr<FileWatcher> fileWatcher_;
+        std::unique_ptr<WrapIndex> wrapIndex_;
         
         // Estado del editor
         CursorPosition cursor_;
@@ -172,6 +279,31 @@ namespace CoralCode {
         bool lastSearchCaseSensitive_;
         bool lastSearchWholeWord_;
         CursorPosition lastSearchPosition_;
+        bool regexSearch_ = false;
+        std::string searchError_;
+        std::atomic<bool> searchCancelled_{false};
+        
+        std::vector<ProjectSearchResult> projectResults_;
+        
+        // Estado del espacio de trabajo
+        std::string workspaceRoot_;
+        std::future<std::unique_ptr<FileIndex>> pendingIndex_;
+        std::atomic<bool> indexCancelled_{false};
+        
+        // Versión del buffer visible desde los workers (tokens de cancelación)
+        std::shared_ptr<std::atomic<uint64_t>> bufferVersion_;
+        
+        // Perfilador de frames (desactivado por defecto)
+        FrameProfiler frameProfiler_;
+        bool profilerOverlay_ = false;
+        
+        // Memoria: partes O(n) cacheadas por versión del buffer
+        size_t glyphAtlasBytes_ = 0;
+        mutable MemoryUsage memoryCache_;
+        mutable uint64_t memoryCacheVersion_ = UINT64_MAX;
+        
+        // Líneas por tramo en replaceAll (granularidad de progreso/cancelación)
+        static constexpr size_t REPLACE_CHUNK_LINES = 65536;
         
         // Métodos internos
         void updateTitle();
@@ -179,6 +311,12 @@ namespace CoralCode {
         void saveState();
         bool confirmUnsavedChanges();
         
+        // Múltiples cursores
+        CursorSet& beginMultiCursor();
+        void commitCursorEdit(std::vector<TextEdit> inverse, const CursorPosition& cursorBefore,
+                              OperationType operation, const std::string& description);
+        void syncPrimaryCursor();
+        
         // Validación
         void validateCursorPosition();
         void adjustSelectionAfterEdit();
@@ -187,6 +325,11 @@ namespace CoralCode {
         bool isWordCharacter(char ch) const;
         CursorPosition findInText(const std::string& text, const CursorPosition& startPos,
                                   bool caseSensitive, bool wholeWord) const;
+        void selectSearchMatch(const SearchMatch& match);
+        bool prepareSearch(const std::string& text, bool caseSensitive, bool wholeWord);
+        bool findMatch(const CursorPosition& from, bool forward, SearchMatch& match) const;
+        bool matchAt(const CursorPosition& start, SearchMatch& match, std::string& replacement,
+                     const std::string& newText) const;
     };
     
 } // namespace CoralCode
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "EditTrace.hpp"
 #include <SFML/Window/Event.hpp>
 #include <functional>
 #include <unordered_map>
@@ -76,6 +77,11 @@ namespace CoralCode {
         void setTextInputFilter(std::function<bool(char)> filter);
         void setKeyFilter(std::function<bool(const KeyInfo&)> filter);
         
+        // Grabación de la sesión para reproducirla sin ventana (nullptr la
+        // desactiva). Cada handler graba su evento antes de despacharlo.
+        void setTraceRecorder(EditTraceRecorder* recorder);
+        static TraceKey toTraceKey(sf::Keyboard::Key key);
+        
         // Configuración específica por plataforma
         void configureMacShortcuts();
         void configureWindowsShortcuts();
@@ -121,6 +127,12 @@ namespace CoralCode {
         std::function<bool(char)> textInputFilter_;
         std::function<bool(const KeyInfo&)> keyFilter_;
         
+        // Grabación
+        EditTraceRecorder* traceRecorder_ = nullptr;
+        void recordKey(const KeyInfo& keyInfo);
+        void recordText(uint32_t codepoint);
+        void recordMouse(TraceEventType type, const MouseInfo& mouseInfo);
+        
         // Handlers específicos
         bool handleKeyPressed(const sf::Event::KeyEvent& keyEvent);
         bool handleKeyReleased(const sf::Event::KeyEvent& keyEvent);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "AsyncFileIO.hpp"
+#include <cstdint>
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace CoralCode {
+    
+    /**
+     * @brief Lectura y guardado de archivos del editor
+     * 
+     * Responsable de:
+     * - Abrir y guardar sin bloquear la UI: las variantes *Async devuelven
+     *   un futuro que la UI consulta cada frame
+     * - Cargar o guardar muchos archivos a la vez (proyecto, "guardar todo",
+     *   autoguardado) con todas las operaciones en vuelo simultáneamente
+     * - Guardado atómico conservando permisos (ver AsyncFileIO)
+     * - Variantes bloqueantes para herramientas de línea de comandos
+     */
+    class FileHandler {
+    public:
+        explicit FileHandler(AsyncFileIO& io = AsyncFileIO::shared());
+        ~FileHandler() = default;
+        
+        // Asíncrono: nunca bloquea al que llama
+        std::future<FileReadResult> readAsync(const std::string& path) const;
+        std::future<FileWriteResult> writeAsync(const std::string& path, std::string content) const;
+        
+        // Lotes: los futuros siguen el orden de entrada
+        std::vector<std::future<FileReadResult>> readAll(const std::vector<std::string>& paths) const;
+        std::vector<std::future<FileWriteResult>> writeAll(
+            std::vector<std::pair<std::string, std::string>> files) const;
+        
+        // Bloqueante (espera el futuro)
+        bool readFile(const std::string& path, std::string& content);
+        bool writeFile(const std::string& path, const std::string& content);
+        
+        // Configuración
+        void setMaxFileSize(uint64_t bytes) { maxFileSize_ = bytes; }
+        uint64_t getMaxFileSize() const { return maxFileSize_; }
+        
+        const std::string& getLastError() const { return lastError_; }
+        const char* getBackendName() const { return io_.getBackendName(); }
+        
+    private:
+        AsyncFileIO& io_;
+        uint64_t maxFileSize_;
+        std::string lastError_;
+    };
+    
+} // namespace CoralCode
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "WorkspaceWalker.hpp"
+#include "FileWatcher.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Resultado de la apertura rápida
+     *
+     * positions son los bytes de la ruta que coinciden con la consulta
+     * (para resaltarlos en la paleta).
+     */
+    struct FileMatch {
+        std::string path;
+        int score;
+        std::vector<uint32_t> positions;
+    };
+
+    /**
+     * @brief Índice de rutas del espacio de trabajo para apertura rápida
+     *
+     * Responsable de:
+     * - Construir la lista de archivos en paralelo con WorkspaceWalker
+     * - Índice de trigramas de los nombres de archivo (CSR compacto) para
+     *   consultas de tres o más caracteres
+     * - Nombres ordenados para prefijos cortos (uno o dos caracteres)
+     * - Puntuación difusa: subsecuencia con bonificación por inicio de
+     *   componente, camelCase, caracteres consecutivos y nombre de archivo
+     * - Refinar la consulta anterior cuando el usuario sigue escribiendo
+     * - Guardar y cargar el índice en disco con rutas en codificación
+     *   frontal, y aplicar eventos de FileWatcher sin reconstruir
+     *
+     * Un índice no es seguro entre hilos: se construye en segundo plano y
+     * después solo lo usa el hilo de la UI.
+     */
+    class FileIndex {
+    public:
+        FileIndex();
+
+        // Construcción
+        bool build(const std::string& root, const WalkOptions& options = WalkOptions(),
+                   const std::atomic<bool>* cancel = nullptr);
+        bool reconcile(const std::atomic<bool>* cancel = nullptr);
+        void compact();
+
+        // Persistencia
+        bool save(const std::string& filePath);
+        bool load(const std::string& filePath);
+        static std::string defaultIndexPath(const std::string& root);
+
+        // Cambios incrementales
+        void addFile(const std::string& relativePath);
+        void removeFile(const std::string& relativePath);
+        void removeDirectory(const std::string& relativePath);
+        bool applyEvents(const std::vector<FileEvent>& events);
+
+        // Consulta
+        std::vector<FileMatch> query(const std::string& pattern, size_t limit = 50);
+        static int scorePath(const char* path, size_t length, size_t nameStart, const std::string& query,
+                             std::vector<uint32_t>* positions = nullptr);
+
+        // Estado
+        size_t size() const { return entries_.size() - deadCount_; }
+        const std::string& getRoot() const { return root_; }
+        const WalkOptions& getWalkOptions() const { return options_; }
+        const std::string& getLastError() const { return lastError_; }
+        size_t getMemoryUsage() const;
+
+        // Consultas a partir de las cuales se usan trigramas
+        static constexpr size_t TRIGRAM_QUERY_LENGTH = 3;
+        static constexpr uint32_t TRIGRAM_SPACE = 1u << 18;
+
+    private:
+        struct Entry {
+            uint32_t offset;
+            uint32_t length;
+            uint32_t nameStart;
+            bool alive;
+        };
+
+        std::string root_;
+        WalkOptions options_;
+        std::string lastError_;
+
+        // Rutas relativas concatenadas y su máscara de caracteres
+        std::string paths_;
+        std::vector<Entry> entries_;
+        std::vector<uint64_t> masks_;
+        std::unordered_map<std::string, std::vector<uint32_t>> directoryEntries_;
+        size_t deadCount_;
+
+        // Trigramas de los nombres: CSR (offsets por clave) + altas recientes
+        std::vector<uint32_t> trigramOffsets_;
+        std::vector<uint32_t> trigramIds_;
+        std::unordered_map<uint32_t, std::vector<uint32_t>> recentTrigrams_;
+
+        // Identificadores ordenados por nombre en minúsculas + altas recientes
+        std::vector<uint32_t> sortedNames_;
+        std::vector<uint32_t> recentNames_;
+
+        // Refinamiento de la consulta anterior
+        std::string lastQuery_;
+        std::vector<uint32_t> lastCandidates_;
+        bool lastCandidatesValid_;
+
+        void reset();
+        void setPaths(std::vector<std::string> paths);
+        uint32_t appendEntry(const std::string& relativePath);
+        void buildTrigrams();
+        void buildSortedNames();
+        void invalidateQuery() { lastCandidatesValid_ = false; }
+
+        const char* pathData(const Entry& entry) const { return paths_.data() + entry.offset; }
+        std::string pathOf(uint32_t id) const;
+        std::vector<std::string> alivePaths() const;
+        void collectTrigrams(uint32_t id, std::vector<uint32_t>& keys) const;
+        std::vector<uint32_t> trigramCandidates(const std::string& query) const;
+        std::vector<uint32_t> prefixCandidates(const std::string& query, size_t limit) const;
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "WorkspaceWalker.hpp"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Tipo de cambio en el sistema de archivos
+     *
+     * Overflow indica que se perdieron eventos: quien mantenga un índice
+     * debe reconstruirlo.
+     */
+    enum class FileEventType {
+        Created,
+        Deleted,
+        Modified,
+        Overflow
+    };
+
+    /**
+     * @brief Cambio en un archivo o directorio del espacio de trabajo
+     */
+    struct FileEvent {
+        FileEventType type;
+        std::string relativePath;
+        bool isDirectory;
+    };
+
+    /**
+     * @brief Observa un árbol de directorios
+     *
+     * Responsable de:
+     * - Vigilar cada directorio no ignorado (inotify en Linux) y añadir
+     *   los directorios nuevos a medida que aparecen
+     * - Traducir los eventos a rutas relativas a la raíz
+     * - Descartar rutas ignoradas (.gitignore, ocultos, .git)
+     *
+     * poll() no bloquea y se llama una vez por frame. En plataformas sin
+     * soporte start() devuelve false y el llamador debe re-escanear.
+     */
+    class FileWatcher {
+    public:
+        FileWatcher();
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        bool start(const std::string& root, const WalkOptions& options = WalkOptions());
+        void stop();
+        bool isWatching() const { return fd_ >= 0; }
+        static bool isSupported();
+
+        std::vector<FileEvent> poll();
+
+        size_t getWatchCount() const { return watches_.size(); }
+        const std::string& getLastError() const { return lastError_; }
+
+    private:
+        std::string root_;
+        WalkOptions options_;
+        std::unique_ptr<IgnoreMatcher> ignore_;
+        int fd_;
+        std::unordered_map<int, std::string> watches_;     // descriptor -> directorio relativo
+        std::string lastError_;
+
+        void watchTree(const std::string& relativeDirectory);
+        bool addWatch(const std::string& relativeDirectory);
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "AllocationTracker.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace CoralCode {
+
+    /**
+     * @brief Fases del bucle principal medidas en cada frame
+     *
+     * Edits y Highlight ocurren en el hilo del modelo y se atribuyen al
+     * frame que muestra su resultado.
+     */
+    enum class FramePhase : uint8_t {
+        Events,     // Recoger eventos de la ventana
+        Edits,      // Aplicar los eventos al texto
+        Highlight,  // Colorear las líneas visibles
+        Layout,     // Posiciones y tamaños (render menos las llamadas a draw)
+        Draw,       // Llamadas a draw
+        Present,    // display()
+        Count
+    };
+
+    /**
+     * @brief Percentiles de una serie del historial
+     */
+    struct FrameMetric {
+        double p50 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    /**
+     * @brief Resumen del historial reciente (tiempos en milisegundos)
+     */
+    struct FrameStats {
+        size_t frames = 0;
+        double fps = 0.0;
+        FrameMetric frameMs;
+        std::array<FrameMetric, static_cast<size_t>(FramePhase::Count)> phaseMs{};
+        FrameMetric drawCalls;
+        FrameMetric allocations;
+        std::array<FrameMetric, AllocationTracker::SITE_COUNT> siteAllocations{};
+    };
+
+    /**
+     * @brief Perfilador de frames del bucle principal
+     *
+     * Responsable de:
+     * - Acumular el tiempo de cada fase del frame en curso (un solo hilo
+     *   escribe: el del bucle de la ventana)
+     * - Guardar cada frame terminado en un historial circular sin bloqueos;
+     *   cualquier hilo puede leerlo (cada entrada lleva un contador de
+     *   secuencia y las que se sobrescriben durante la copia se descartan)
+     * - Calcular p50/p99 de cada fase, llamadas a draw y asignaciones de
+     *   memoria por frame, en total y por sitio (AllocationTracker)
+     *
+     * Desactivado no mide nada: cada método vuelve en la primera comprobación.
+     */
+    class FrameProfiler {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        FrameProfiler();
+        ~FrameProfiler();
+
+        FrameProfiler(const FrameProfiler&) = delete;
+        FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+        void setEnabled(bool enabled);
+        bool isEnabled() const { return enabled_; }
+
+        // Hilo del bucle principal
+        void beginFrame();
+        void endFrame();
+        void beginPhase(FramePhase phase);
+        void endPhase(FramePhase phase);
+        void addPhaseTime(FramePhase phase, uint64_t nanoseconds);
+        void countDrawCall() { if (enabled_) ++drawCalls_; }
+
+        // Cualquier hilo
+        FrameStats computeStats() const;
+        uint64_t getFrameCount() const { return written_.load(std::memory_order_acquire); }
+
+        // Texto del overlay (una fila por fase) y resumen de una línea
+        static std::string formatOverlay(const FrameStats& stats);
+        static std::string formatSummary(const FrameStats& stats);
+        static const char* phaseName(FramePhase phase);
+
+        // Asignaciones del proceso (operator new) mientras el recuento
+        // esté activo; 0 si nunca lo estuvo
+        static uint64_t getAllocationCount() { return AllocationTracker::totalCount(); }
+
+        static uint64_t now() {
+            return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+        }
+
+        // Mide una fase en un ámbito
+        class ScopedPhase {
+        public:
+            ScopedPhase(FrameProfiler& profiler, FramePhase phase) : profiler_(profiler), phase_(phase) {
+                profiler_.beginPhase(phase_);
+            }
+            ~ScopedPhase() { profiler_.endPhase(phase_); }
+
+            ScopedPhase(const ScopedPhase&) = delete;
+            ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+        private:
+            FrameProfiler& profiler_;
+            FramePhase phase_;
+        };
+
+        static constexpr size_t PHASE_COUNT = static_cast<size_t>(FramePhase::Count);
+        static constexpr size_t HISTORY_SIZE = 256;     // Potencia de dos
+
+    private:
+        // Entrada del historial: campos atómicos y secuencia impar mientras
+        // se escribe (seqlock de un solo escritor)
+        struct Slot {
+            std::atomic<uint64_t> sequence{0};
+            std::atomic<uint64_t> frameNs{0};
+            std::array<std::atomic<uint64_t>, PHASE_COUNT> phaseNs{};
+            std::atomic<uint32_t> drawCalls{0};
+            std::atomic<uint32_t> allocations{0};
+            std::array<std::atomic<uint32_t>, AllocationTracker::SITE_COUNT> siteAllocations{};
+            std::atomic<uint64_t> endTime{0};
+        };
+
+        bool enabled_;
+        bool inFrame_;
+
+        // Frame en curso (solo el hilo del bucle)
+        uint64_t frameStart_;
+        std::array<uint64_t, PHASE_COUNT> phaseStart_;
+        std::array<uint64_t, PHASE_COUNT> phaseNs_;
+        uint32_t drawCalls_;
+        AllocationCounts allocationsAtStart_;
+
+        std::array<Slot, HISTORY_SIZE> history_;
+        std::atomic<uint64_t> written_;
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "TextBuffer.hpp"
+#include "SyntaxHighlighter.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+
+namespace CoralCode {
+
+    /**
+     * @brief Rango de líneas plegable (bloque entre llaves, paréntesis, etc.)
+     */
+    struct FoldRange {
+        size_t startLine;
+        size_t endLine;
+    };
+
+    /**
+     * @brief Entrada del outline del documento (clases, funciones, namespaces)
+     */
+    struct OutlineEntry {
+        std::string name;
+        std::string kind;
+        size_t line;
+        size_t column;
+    };
+
+    /**
+     * @brief Análisis sintáctico incremental del documento
+     *
+     * Responsable de:
+     * - Mantener tokens y estado léxico por línea (comentarios de bloque)
+     *   usando el lexer de SyntaxHighlighter
+     * - Re-analizar solo las líneas editadas hasta que el estado converge
+     * - Distinguir tipos de variables (declaraciones, plantillas, `::`)
+     * - Emparejar delimitadores, incluidos `<>` de plantillas anidadas
+     * - Alimentar highlighting, plegado de código y outline
+     *
+     * La estructura de delimitadores se guarda como un árbol de segmentos
+     * sobre las líneas, de modo que una edición de un carácter cuesta
+     * O(longitud de línea + log n) y buscar la pareja de un delimitador
+     * cuesta O(log n) aunque el bloque abarque miles de líneas.
+     */
+    class IncrementalParser {
+    public:
+        explicit IncrementalParser(const SyntaxHighlighter& highlighter);
+        ~IncrementalParser();
+
+        IncrementalParser(const IncrementalParser&) = delete;
+        IncrementalParser& operator=(const IncrementalParser&) = delete;
+
+        // Conexión con el buffer
+        void attach(TextBuffer& buffer);
+        void detach();
+        void invalidate();
+
+        // Análisis incremental
+        void applyChange(const TextChange& change);
+        size_t reparse();
+        bool needsReparse() const;
+
+        // Consultas para highlighting
+        std::vector<Token> getLineTokens(size_t line) const;
+        bool isKnownType(const std::string& name) const;
+
+        // Consultas estructurales
+        bool findMatchingBracket(size_t line, size_t col, size_t& matchLine, size_t& matchCol) const;
+        std::vector<FoldRange> getFoldRanges(size_t firstLine, size_t lastLine) const;
+        std::vector<OutlineEntry> getOutline() const;
+
+        // Memoria de la caché de tokens, delimitadores y tipos declarados
+        size_t getMemoryUsage() const;
+
+    private:
+        using LexState = SyntaxHighlighter::MultiLineState;
+
+        /**
+         * @brief Token compacto (sin copia del texto)
+         */
+        struct Span {
+            uint32_t start;
+            uint32_t end;
+            TokenType type;
+        };
+
+        /**
+         * @brief Delimitador estructural dentro de una línea
+         */
+        struct BracketMark {
+            uint32_t column;
+            char ch;
+        };
+
+        /**
+         * @brief Nodo del árbol de segmentos de delimitadores
+         *
+         * delta = aperturas - cierres; minPrefix/maxSuffix permiten encontrar
+         * dónde se cierra (o abre) un bloque sin recorrer línea por línea.
+         */
+        struct BracketNode {
+            int32_t delta = 0;
+            int32_t minPrefix = 0;
+            int32_t maxSuffix = 0;
+        };
+
+        /**
+         * @brief Resultado del análisis de una línea
+         */
+        struct LineInfo {
+            std::vector<Span> spans;
+            std::vector<BracketMark> brackets;
+            std::vector<std::string> declaredTypes;
+            std::vector<OutlineEntry> outline;
+            LexState endState;
+            bool parsed = false;
+            bool stateKnown = false;
+        };
+
+        const SyntaxHighlighter* highlighter_;
+        TextBuffer* buffer_;
+        size_t listenerId_;
+
+        // Punteros para que insertar líneas no mueva el contenido analizado
+        std::vector<std::unique_ptr<LineInfo>> lines_;
+        std::unordered_map<std::string, size_t> declaredTypeCounts_;
+
+        // Región pendiente de re-análisis
+        size_t dirtyBegin_;
+        size_t dirtyEnd_;
+
+        // Árbol de segmentos (hojas = resúmenes contiguos por línea)
+        std::vector<BracketNode> lineSummaries_;
+        std::vector<BracketNode> bracketTree_;
+        size_t treeLeaves_;
+        bool treeNeedsRebuild_;
+
+        // Análisis interno
+        void lexLine(const std::string& text, LexState& state, LineInfo& info) const;
+        void markTemplatesAndBrackets(const std::string& text, LineInfo& info) const;
+        void classifyLine(const std::string& text, LineInfo& info) const;
+        static size_t templateArgumentsEnd(const std::string& text, size_t openPos);
+        static bool sameState(const LexState& a, const LexState& b);
+
+        // Tipos declarados
+        void registerTypes(const LineInfo& info);
+        void unregisterTypes(const LineInfo& info);
+
+        // Árbol de delimitadores
+        static BracketNode summarizeLine(const LineInfo& info);
+        static BracketNode combine(const BracketNode& left, const BracketNode& right);
+        void rebuildBracketTree();
+        void updateBracketLeaf(size_t line);
+        size_t findCloserLine(size_t fromLine, int32_t& depth) const;
+        size_t findOpenerLine(size_t toLine, int32_t& depth) const;
+        size_t descendForward(size_t node, size_t lo, size_t hi, size_t fromLine, int32_t& depth) const;
+        size_t descendBackward(size_t node, size_t lo, size_t hi, size_t toLine, int32_t& depth) const;
+        bool matchInLine(size_t line, size_t startIndex, bool forward, int32_t& depth, size_t& matchCol) const;
+
+        void markDirty(size_t begin, size_t end);
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Fase de una flecha entre spans de distintos hilos
+     */
+    enum class TraceFlow : uint8_t {
+        Start,      // Donde nace el evento (entrega de SFML)
+        Step,       // Cada etapa que lo procesa
+        End         // Donde termina (display() devuelve)
+    };
+
+    /**
+     * @brief Trazas de latencia exportables a Chrome/Perfetto
+     *
+     * Responsable de:
+     * - Un búfer circular por hilo, sin bloqueos: solo su hilo escribe y el
+     *   exportador copia descartando lo que se sobrescribe durante la copia
+     * - Spans síncronos por hilo (eventos, edición, resaltado, render,
+     *   display), spans asíncronos en pistas propias (latencia de cada
+     *   evento de entrada, tareas en segundo plano por nombre) y flechas
+     *   que siguen cada evento de entrada a través de los hilos
+     * - Exportar en el formato JSON de trazas de Chrome (chrome://tracing,
+     *   ui.perfetto.dev)
+     *
+     * Desactivado, cada llamada se reduce a una lectura atómica. Los nombres
+     * y categorías deben vivir tanto como el trazador (literales o intern()).
+     */
+    class LatencyTracer {
+    public:
+        LatencyTracer();
+        ~LatencyTracer();
+
+        LatencyTracer(const LatencyTracer&) = delete;
+        LatencyTracer& operator=(const LatencyTracer&) = delete;
+
+        // Trazador de todo el proceso
+        static LatencyTracer& shared();
+
+        void setEnabled(bool enabled);
+        bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+        // Nombre de la pista del hilo actual (se aplica al crear su búfer)
+        static void setThreadName(const char* name);
+
+        // Identificador para un evento de entrada o una tarea asíncrona
+        uint64_t newId() { return nextId_.fetch_add(1, std::memory_order_relaxed); }
+
+        // Registro (desde cualquier hilo, en su propio búfer)
+        void span(const char* category, const char* name, uint64_t start, uint64_t end, uint64_t id = 0);
+        void asyncSpan(const char* category, const char* name, uint64_t id, uint64_t start, uint64_t end);
+        void flow(TraceFlow phase, uint64_t id, uint64_t timestamp);
+
+        // Copia estable de un nombre dinámico (tareas, hilos)
+        const char* intern(const std::string& name);
+
+        // Exportación
+        void writeChromeTrace(std::ostream& out) const;
+        bool exportChromeTrace(const std::string& path, std::string& error) const;
+        size_t getRecordCount() const;
+        void clear();
+
+        static uint64_t now() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        static uint64_t toNanoseconds(std::chrono::steady_clock::time_point time) {
+            return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count());
+        }
+
+        // Span síncrono de un ámbito en el hilo actual
+        class ScopedSpan {
+        public:
+            ScopedSpan(LatencyTracer& tracer, const char* category, const char* name, uint64_t id = 0)
+                : tracer_(tracer), category_(category), name_(name), id_(id),
+                  start_(tracer.isEnabled() ? now() : 0) {}
+            ~ScopedSpan() {
+                if (start_ != 0) tracer_.span(category_, name_, start_, now(), id_);
+            }
+
+            ScopedSpan(const ScopedSpan&) = delete;
+            ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+        private:
+            LatencyTracer& tracer_;
+            const char* category_;
+            const char* name_;
+            uint64_t id_;
+            uint64_t start_;
+        };
+
+        static constexpr size_t RECORDS_PER_THREAD = 16384;     // Potencia de dos
+
+    private:
+        enum class RecordKind : uint8_t {
+            Span, Async, FlowStart, FlowStep, FlowEnd
+        };
+
+        // Campos atómicos: el exportador lee mientras el hilo escribe
+        struct Record {
+            std::atomic<const char*> category{nullptr};
+            std::atomic<const char*> name{nullptr};
+            std::atomic<uint64_t> start{0};
+            std::atomic<uint64_t> end{0};
+            std::atomic<uint64_t> id{0};
+            std::atomic<uint8_t> kind{0};
+        };
+
+        struct ThreadBuffer {
+            uint32_t track = 0;
+            const char* name = nullptr;
+            std::atomic<uint64_t> written{0};
+            std::atomic<uint64_t> cleared{0};       // clear(): se exporta desde aquí
+            std::array<Record, RECORDS_PER_THREAD> records;
+        };
+
+        // Copia no atómica para exportar
+        struct RecordCopy {
+            RecordKind kind;
+            const char* category;
+            const char* name;
+            uint64_t start;
+            uint64_t end;
+            uint64_t id;
+            uint32_t track;
+        };
+
+        std::atomic<bool> enabled_;
+        std::atomic<uint64_t> nextId_;
+        uint64_t origin_;
+        uint64_t instance_;         // Distingue trazadores en la caché por hilo
+
+        mutable std::mutex buffersMutex_;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+
+        std::mutex internMutex_;
+        std::unordered_set<std::string> interned_;
+
+        ThreadBuffer& currentBuffer();
+        void record(RecordKind kind, const char* category, const char* name, uint64_t start, uint64_t end,
+                    uint64_t id);
+        std::vector<RecordCopy> snapshot(std::vector<std::pair<uint32_t, const char*>>& tracks) const;
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace CoralCode {
+
+    /**
+     * @brief Subsistemas con memoria propia
+     */
+    enum class MemorySubsystem {
+        Buffer,             // Texto de las líneas
+        LineIndex,          // Tabla de líneas (un std::string por línea)
+        UndoHistory,
+        TokenCache,         // Tokens y estado léxico por línea
+        GlyphAtlas,         // Texturas de la fuente en la GPU
+        Minimap,            // Imagen de densidad del documento (memoria y textura)
+        SearchIndex,        // Coincidencias de la búsqueda activa
+        ClipboardHistory,
+        CompletionIndex,
+        FileIndex,          // Rutas del espacio de trabajo
+        Count
+    };
+
+    /**
+     * @brief Bytes vivos por subsistema
+     *
+     * Cada subsistema informa de lo que reserva (capacidad, no tamaño);
+     * la sobrecarga del asignador no se cuenta.
+     */
+    struct MemoryUsage {
+        static constexpr size_t SUBSYSTEM_COUNT = static_cast<size_t>(MemorySubsystem::Count);
+
+        std::array<size_t, SUBSYSTEM_COUNT> bytes{};
+
+        size_t& operator[](MemorySubsystem subsystem) { return bytes[static_cast<size_t>(subsystem)]; }
+        size_t operator[](MemorySubsystem subsystem) const { return bytes[static_cast<size_t>(subsystem)]; }
+
+        size_t total() const;
+        MemorySubsystem largest() const;
+
+        // "Memoria: 48.2 MB (buffer 30.1 MB)" para la barra de estado
+        std::string formatStatus() const;
+        // Una fila por subsistema, de mayor a menor, con porcentaje
+        std::string formatReport() const;
+
+        static const char* subsystemName(MemorySubsystem subsystem);
+        static std::string formatBytes(size_t bytes);
+
+        // Bytes en el heap de un string (0 si cabe en el propio objeto)
+        static size_t stringBytes(const std::string& text) {
+            const uintptr_t data = reinterpret_cast<uintptr_t>(text.data());
+            const uintptr_t self = reinterpret_cast<uintptr_t>(&text);
+            return data >= self && data < self + sizeof(std::string) ? 0 : text.capacity() + 1;
+        }
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "SearchEngine.hpp"
+#include "RegexEngine.hpp"
+#include "TaskScheduler.hpp"
+#include "WorkspaceWalker.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Opciones de la búsqueda en archivos
+     */
+    struct ProjectSearchOptions {
+        bool caseSensitive = true;
+        bool wholeWord = false;
+        bool regex = false;
+        WalkOptions walk;
+        uint64_t maxFileSize = 256ull << 20;
+        size_t maxResults = 100000;
+    };
+
+    /**
+     * @brief Coincidencia en un archivo del proyecto
+     *
+     * preview es la línea de la coincidencia (recortada) para la lista.
+     */
+    struct ProjectSearchResult {
+        std::string path;
+        SearchMatch range;
+        std::string preview;
+    };
+
+    /**
+     * @brief Contadores de una búsqueda en archivos
+     */
+    struct ProjectSearchStats {
+        size_t filesSearched = 0;
+        size_t filesMatched = 0;
+        size_t filesSkipped = 0;
+        uint64_t bytesSearched = 0;
+        size_t matches = 0;
+        bool truncated = false;
+    };
+
+    /**
+     * @brief Búsqueda en todos los archivos de un directorio
+     *
+     * Responsable de:
+     * - Recorrer el árbol en paralelo respetando las reglas de ignore
+     * - Leer archivos pequeños a un búfer por hilo y proyectar (mmap)
+     *   los grandes, descartando binarios
+     * - Buscar con SearchEngine o RegexEngine directamente sobre el
+     *   contenido, sin construir un TextBuffer
+     * - Acumular resultados que la UI recoge cada frame con takeResults()
+     * - Cancelación en cualquier momento
+     *
+     * La búsqueda corre como tarea Background del planificador compartido;
+     * start() vuelve enseguida.
+     */
+    class ProjectSearch {
+    public:
+        ProjectSearch();
+        ~ProjectSearch();
+
+        ProjectSearch(const ProjectSearch&) = delete;
+        ProjectSearch& operator=(const ProjectSearch&) = delete;
+
+        // Control
+        bool start(const std::string& root, const std::string& pattern,
+                   const ProjectSearchOptions& options = ProjectSearchOptions());
+        void cancel();
+        void wait();
+        bool isRunning() const;
+
+        // Resultados (nuevos desde la última llamada)
+        std::vector<ProjectSearchResult> takeResults();
+        ProjectSearchStats getStats() const;
+        const std::string& getLastError() const { return lastError_; }
+
+        static constexpr size_t PREVIEW_LENGTH = 240;
+        static constexpr uint64_t MMAP_THRESHOLD = 1ull << 20;
+        static constexpr size_t BINARY_PROBE_LENGTH = 8192;
+
+    private:
+        ProjectSearchOptions options_;
+        SearchEngine literal_;
+        RegexEngine regex_;
+        std::string lastError_;
+
+        // Búsqueda en curso
+        CancellationToken token_;
+        std::future<void> done_;
+
+        // Resultados pendientes de entregar
+        mutable std::mutex mutex_;
+        std::vector<ProjectSearchResult> pending_;
+        bool truncated_;
+
+        std::atomic<size_t> filesSearched_;
+        std::atomic<size_t> filesMatched_;
+        std::atomic<size_t> filesSkipped_;
+        std::atomic<uint64_t> bytesSearched_;
+        std::atomic<size_t> matchCount_;
+
+        void searchFile(const WorkspaceFile& file, std::string& scratch);
+        void searchLiteral(const std::string& path, const char* data, size_t length,
+                           std::vector<ProjectSearchResult>& out) const;
+        void searchRegex(const std::string& path, const char* data, size_t length,
+                         std::vector<ProjectSearchResult>& out) const;
+        void publish(std::vector<ProjectSearchResult>& results);
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "TextBuffer.hpp"
+#include "SearchEngine.hpp"
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Coincidencia de una expresión regular con sus grupos
+     *
+     * groups[0] es la coincidencia completa; los grupos que no participaron
+     * tienen line == SearchEngine::npos.
+     */
+    struct RegexMatch {
+        SearchMatch range;
+        std::vector<SearchMatch> groups;
+    };
+
+    /**
+     * @brief Resultado de una búsqueda que puede interrumpirse
+     */
+    enum class SearchStatus {
+        Completed,
+        Stopped,
+        Cancelled
+    };
+
+    /**
+     * @brief Control de una búsqueda en curso
+     *
+     * cancel se consulta periódicamente (puede activarse desde otro hilo);
+     * endLine limita la última línea donde puede empezar una coincidencia.
+     */
+    struct SearchControl {
+        const std::atomic<bool>* cancel = nullptr;
+        size_t endLine = SearchEngine::npos;
+        size_t maxMatches = SearchEngine::npos;
+    };
+
+    /**
+     * @brief Motor de expresiones regulares de tiempo lineal
+     *
+     * Responsable de:
+     * - Compilar el patrón a un programa de autómata (NFA de Thompson)
+     * - Simular el autómata con una máquina de Pike: todos los estados
+     *   avanzan juntos, sin retroceso, en O(texto × programa)
+     * - Recorrer el buffer como flujo de bytes, cruzando saltos de línea
+     * - Descartar líneas sin coincidencia posible con un DFA perezoso y
+     *   saltar hasta el prefijo literal con SearchEngine
+     * - Reportar coincidencias a medida que aparecen y admitir cancelación
+     * - Expandir plantillas de reemplazo ($1, ${name}, \n)
+     *
+     * Sintaxis: literales, `.`, clases `[...]`, `\d \w \s \b` y negados,
+     * `^ $` por línea, grupos `(...)` y `(?:...)`, alternancia y cuantificadores
+     * `* + ? {n,m}` con variante perezosa. `.` y las clases negadas no
+     * cruzan líneas; un salto de línea explícito (`\n`) sí.
+     */
+    class RegexEngine {
+    public:
+        using MatchCallback = std::function<bool(const RegexMatch&)>;
+
+        RegexEngine();
+
+        // Compilación
+        bool compile(const std::string& pattern, bool caseSensitive = true);
+        bool isValid() const { return valid_; }
+        const std::string& getPattern() const { return pattern_; }
+        bool isCaseSensitive() const { return caseSensitive_; }
+        const std::string& getLastError() const { return lastError_; }
+        size_t getGroupCount() const { return groupCount_; }
+        bool isSingleLine() const { return singleLine_; }
+        // Saltos de línea que puede cruzar una coincidencia (npos: sin límite)
+        size_t getLineSpan() const { return lineSpan_; }
+
+        // Búsqueda en streaming (el callback devuelve false para detenerse)
+        SearchStatus search(const TextBuffer& buffer, size_t line, size_t col,
+                            const MatchCallback& onMatch,
+                            const SearchControl& control = SearchControl()) const;
+
+        // Lo mismo sobre un bloque de texto contiguo, partido en líneas como
+        // TextBuffer::fromString (sin copiarlo a un buffer)
+        SearchStatus search(const char* data, size_t length, size_t line, size_t col,
+                            const MatchCallback& onMatch,
+                            const SearchControl& control = SearchControl()) const;
+
+        // Descarte rápido de un bloque de texto sin el prefijo literal obligatorio
+        bool mayMatch(const char* data, size_t length) const;
+
+        // Búsqueda puntual
+        bool findForward(const TextBuffer& buffer, size_t line, size_t col, RegexMatch& match,
+                         const std::atomic<bool>* cancel = nullptr) const;
+        bool findBackward(const TextBuffer& buffer, size_t line, size_t col, RegexMatch& match,
+                          const std::atomic<bool>* cancel = nullptr) const;
+
+        // Reemplazo
+        std::string expandReplacement(const std::string& replacement, const RegexMatch& match,
+                                      const TextBuffer& buffer) const;
+
+        // Límites del compilador
+        static constexpr size_t MAX_PROGRAM_SIZE = 100000;
+        static constexpr uint32_t MAX_REPEAT = 1000;
+        static constexpr size_t MAX_NESTING = 200;
+
+    private:
+        enum class Op : uint8_t {
+            Byte,
+            Set,
+            Any,
+            Split,
+            Jump,
+            Save,
+            Assert,
+            Match
+        };
+
+        enum class Assertion : uint8_t {
+            LineStart,
+            LineEnd,
+            WordBoundary,
+            NotWordBoundary
+        };
+
+        /**
+         * @brief Instrucción del programa del autómata
+         *
+         * Split: x = rama preferida, y = alternativa. Set: x = índice de clase.
+         * Save: x = ranura de captura.
+         */
+        struct Instruction {
+            Op op;
+            uint8_t byte;
+            uint32_t x;
+            uint32_t y;
+        };
+
+        struct Node;
+        class Parser;
+        class LazyDfa;
+
+        std::string pattern_;
+        bool caseSensitive_;
+        bool valid_;
+        std::string lastError_;
+        size_t groupCount_;
+        std::vector<std::string> groupNames_;
+
+        std::vector<Instruction> program_;
+        std::vector<std::bitset<256>> sets_;
+
+        // Bytes que pueden iniciar una coincidencia (para saltar texto)
+        std::bitset<256> firstBytes_;
+        bool canSkip_;
+
+        // Prefijo literal obligatorio y patrones que no cruzan líneas
+        std::string prefix_;
+        SearchEngine prefixSearch_;
+        bool singleLine_;
+        size_t lineSpan_;
+
+        // Compilación
+        bool emit(const Node& node);
+        bool emitInstruction(const Instruction& instruction);
+        void computeFirstBytes();
+        void computePrefix();
+        size_t lineSpanOf(const Node& node) const;
+
+        // Ejecución
+        struct Position {
+            size_t line;
+            size_t column;
+        };
+        class ThreadList;
+        struct Context;
+
+        template <typename Lines>
+        SearchStatus searchLines(Lines& lines, size_t line, size_t col, const MatchCallback& onMatch,
+                                 const SearchControl& control) const;
+        void addThread(ThreadList& list, uint32_t pc, std::vector<Position>& caps,
+                       const Context& context, std::vector<std::pair<uint32_t, Position>>& stack) const;
+        bool consumes(const Instruction& instruction, int byte) const;
+        static bool assertionHolds(Assertion assertion, const Context& context);
+        RegexMatch makeMatch(const std::vector<Position>& caps) const;
+    };
+
+} // namespace CoralCode
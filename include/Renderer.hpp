@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Color RGBA de 8 bits por canal
+     */
+    struct RenderColor {
+        uint8_t r = 0;
+        uint8_t g = 0;
+        uint8_t b = 0;
+        uint8_t a = 255;
+
+        constexpr RenderColor() = default;
+        constexpr RenderColor(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha = 255)
+            : r(red), g(green), b(blue), a(alpha) {}
+    };
+
+    /**
+     * @brief Rectángulo en píxeles de la ventana
+     */
+    struct RenderRect {
+        float x = 0.0f;
+        float y = 0.0f;
+        float width = 0.0f;
+        float height = 0.0f;
+    };
+
+    // Imagen creada por el backend (0: ninguna)
+    using ImageId = uint32_t;
+
+    /**
+     * @brief Trabajo que un frame pide al backend
+     *
+     * Los cambios de estado cuentan cada vez que una primitiva necesita
+     * otra textura que la anterior: rectángulos sin textura, el atlas de la
+     * fuente de cada tamaño (uno solo para todos con campos de distancia) o
+     * una imagen. Es lo que parte los lotes de una GPU, así que mide cuánto
+     * ayudaría ordenar o agrupar el dibujo.
+     */
+    struct RenderStats {
+        size_t drawCalls = 0;           // Primitivas enviadas (rectángulos, textos, imágenes)
+        size_t quads = 0;               // Rectángulos, glifos e imágenes a rasterizar
+        size_t glyphs = 0;              // Caracteres visibles (los blancos no generan quad)
+        size_t textRuns = 0;
+        size_t images = 0;
+        size_t stateChanges = 0;
+        size_t uploadedBytes = 0;       // Píxeles subidos a imágenes
+
+        RenderStats& operator+=(const RenderStats& other);
+    };
+
+    /**
+     * @brief Interfaz de dibujo del editor
+     *
+     * Responsable de:
+     * - Recibir las primitivas de un frame (rectángulos de color, textos e
+     *   imágenes RGBA) sin depender de la biblioteca gráfica
+     * - Contar el trabajo de cada frame igual en todos los backends
+     * - Gestionar imágenes que se crean una vez y se actualizan por filas
+     *
+     * Los backends implementan los métodos on*. SfmlRenderer dibuja en la
+     * ventana; NullRenderer solo cuenta y graba, para medir el layout de un
+     * frame en máquinas sin pantalla ni GPU.
+     */
+    class Renderer {
+    public:
+        virtual ~Renderer() = default;
+
+        Renderer(const Renderer&) = delete;
+        Renderer& operator=(const Renderer&) = delete;
+
+        // Frame: presentar en pantalla es cosa de la ventana
+        void beginFrame(unsigned width, unsigned height, RenderColor background);
+        void endFrame();
+
+        // Primitivas
+        void fillRect(const RenderRect& rect, RenderColor color);
+        void drawText(const char* text, size_t length, float x, float y, unsigned size, RenderColor color);
+        void drawText(const std::string& text, float x, float y, unsigned size, RenderColor color) {
+            drawText(text.data(), text.size(), x, y, size, color);
+        }
+
+        // Imágenes: se crean una vez y se actualizan por filas
+        ImageId createImage(unsigned width, unsigned height, bool smooth);
+        void updateImage(ImageId image, const uint8_t* pixels, unsigned firstRow, unsigned rowCount);
+        // Las rows primeras filas de la imagen, escaladas a destination
+        void drawImage(ImageId image, unsigned rows, const RenderRect& destination);
+
+        // Tamaño del texto (varias líneas) para colocar paneles
+        virtual RenderRect measureText(const std::string& text, unsigned size) const = 0;
+
+        // Estadísticas del último frame terminado y acumuladas
+        const RenderStats& getFrameStats() const { return frameStats_; }
+        const RenderStats& getTotalStats() const { return totalStats_; }
+        uint64_t getFrameCount() const { return frameCount_; }
+
+        virtual const char* getName() const = 0;
+
+    protected:
+        Renderer() = default;
+
+        virtual void onBeginFrame(unsigned width, unsigned height, RenderColor background) = 0;
+        virtual void onEndFrame() {}
+        virtual void onFillRect(const RenderRect& rect, RenderColor color) = 0;
+        virtual void onDrawText(const char* text, size_t length, float x, float y, unsigned size,
+                                RenderColor color) = 0;
+        virtual void onCreateImage(ImageId image, unsigned width, unsigned height, bool smooth) = 0;
+        virtual void onUpdateImage(ImageId image, const uint8_t* pixels, unsigned firstRow, unsigned rowCount) = 0;
+        virtual void onDrawImage(ImageId image, unsigned rows, const RenderRect& destination) = 0;
+
+        // Ancho de las imágenes creadas (índice id - 1)
+        unsigned getImageWidth(ImageId image) const;
+
+        // Todos los tamaños de fuente salen del mismo atlas (campos de distancia)
+        void setSingleFontAtlas(bool single) { singleFontAtlas_ = single; }
+
+    private:
+        // Textura que usa la primitiva en curso
+        enum class Binding : uint8_t { None, Solid, Font, Image };
+
+        Binding binding_ = Binding::None;
+        uint32_t bindingKey_ = 0;           // Tamaño de fuente o imagen
+        bool singleFontAtlas_ = false;
+        std::vector<unsigned> imageWidths_;
+
+        RenderStats currentStats_;
+        RenderStats frameStats_;
+        RenderStats totalStats_;
+        uint64_t frameCount_ = 0;
+
+        void bind(Binding binding, uint32_t key);
+    };
+
+    /**
+     * @brief Backend sin salida: cuenta y graba las primitivas
+     *
+     * Con la grabación activa guarda los comandos del frame en curso (se
+     * vacían en beginFrame conservando la capacidad, así que en estado
+     * estable no asigna memoria). El texto se mide con un avance fijo.
+     */
+    class NullRenderer : public Renderer {
+    public:
+        enum class CommandType : uint8_t { Rect, Text, Image };
+
+        struct Command {
+            CommandType type;
+            RenderRect rect;                // Texto: posición; imagen: destino
+            RenderColor color;
+            unsigned size = 0;              // Tamaño de fuente o filas de la imagen
+            ImageId image = 0;
+            size_t textOffset = 0;          // En el texto grabado del frame
+            size_t textLength = 0;
+        };
+
+        NullRenderer() = default;
+
+        void setRecording(bool recording) { recording_ = recording; }
+        bool isRecording() const { return recording_; }
+
+        // Cuenta los cambios de estado como un backend de campos de distancia
+        void setSingleFontAtlas(bool single) { Renderer::setSingleFontAtlas(single); }
+
+        const std::vector<Command>& getCommands() const { return commands_; }
+        std::string getText(const Command& command) const;
+
+        RenderRect measureText(const std::string& text, unsigned size) const override;
+        const char* getName() const override { return "nulo"; }
+
+        // Avance de cada carácter respecto al tamaño de fuente
+        static constexpr float ADVANCE_RATIO = 0.6f;
+
+    protected:
+        void onBeginFrame(unsigned width, unsigned height, RenderColor background) override;
+        void onFillRect(const RenderRect& rect, RenderColor color) override;
+        void onDrawText(const char* text, size_t length, float x, float y, unsigned size,
+                        RenderColor color) override;
+        void onCreateImage(ImageId image, unsigned width, unsigned height, bool smooth) override;
+        void onUpdateImage(ImageId image, const uint8_t* pixels, unsigned firstRow, unsigned rowCount) override;
+        void onDrawImage(ImageId image, unsigned rows, const RenderRect& destination) override;
+
+    private:
+        bool recording_ = false;
+        std::vector<Command> commands_;
+        std::string text_;
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "TextBuffer.hpp"
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Coincidencia de búsqueda en el buffer (rango semiabierto)
+     */
+    struct SearchMatch {
+        size_t line;
+        size_t column;
+        size_t endLine;
+        size_t endColumn;
+    };
+
+    /**
+     * @brief Motor de búsqueda de subcadenas
+     *
+     * Responsable de:
+     * - Buscar un patrón literal en memoria contigua o en el buffer
+     * - Filtrar candidatos comparando el primer y último byte del patrón
+     *   en bloques de 16 bytes (SSE2), con Horspool como alternativa
+     * - Búsqueda sin distinción de mayúsculas sin copiar el texto
+     * - Coincidencias que cruzan saltos de línea (patrones con '\n')
+     * - Filtrar por palabra completa
+     *
+     * El patrón se prepara una sola vez con setPattern(); las búsquedas
+     * posteriores no reservan memoria.
+     */
+    class SearchEngine {
+    public:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        SearchEngine();
+        explicit SearchEngine(const std::string& pattern, bool caseSensitive = true, bool wholeWord = false);
+
+        // Configuración del patrón
+        void setPattern(const std::string& pattern, bool caseSensitive = true, bool wholeWord = false);
+        const std::string& getPattern() const { return pattern_; }
+        bool isCaseSensitive() const { return caseSensitive_; }
+        bool isWholeWord() const { return wholeWord_; }
+        bool isEmpty() const { return pattern_.empty(); }
+        bool isMultiLine() const { return segments_.size() > 1; }
+        size_t getLineSpan() const { return segments_.empty() ? 0 : segments_.size() - 1; }
+
+        // Búsqueda en memoria contigua (posición de inicio o npos)
+        size_t find(const char* data, size_t length, size_t from = 0) const;
+        size_t findLast(const char* data, size_t length, size_t before) const;
+
+        // Búsqueda en el buffer
+        bool findForward(const TextBuffer& buffer, size_t line, size_t col, SearchMatch& match,
+                         size_t endLine = npos) const;
+        bool findBackward(const TextBuffer& buffer, size_t line, size_t col, SearchMatch& match) const;
+        std::vector<SearchMatch> findAll(const TextBuffer& buffer) const;
+
+        static bool isWordByte(unsigned char ch);
+
+    private:
+        std::string pattern_;
+        std::string foldedPattern_;
+        std::vector<std::string> segments_;
+        bool caseSensitive_;
+        bool foldCase_;
+        bool wholeWord_;
+
+        // Tabla de saltos de Horspool (sin SSE2)
+        std::array<size_t, 256> skip_;
+
+        size_t scan(const char* data, size_t length, size_t from) const;
+        bool isWordBoundary(const char* data, size_t length, size_t start, size_t end) const;
+        bool segmentEquals(const std::string& text, size_t offset, const std::string& segment) const;
+        bool matchLinesAt(const TextBuffer& buffer, size_t line, SearchMatch& match) const;
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "TextBuffer.hpp"
+#include "SearchEngine.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace CoralCode {
+
+    class RegexEngine;
+
+    /**
+     * @brief Conjunto de coincidencias de la búsqueda activa
+     *
+     * Responsable de:
+     * - Recorrer el documento por tramos (scanStep) sin bloquear la UI
+     * - Mantener las coincidencias ordenadas y al día con cada edición:
+     *   solo se re-escanean las líneas editadas y las posteriores se
+     *   desplazan
+     * - Responder "coincidencia i de N" y siguiente/anterior en O(log n)
+     * - Entregar las coincidencias visibles para resaltarlas
+     *
+     * Los motores de búsqueda pertenecen al Editor; el índice solo guarda
+     * punteros y debe reiniciarse con setSearch() al cambiar el patrón.
+     */
+    class SearchMatchIndex {
+    public:
+        static constexpr size_t npos = SearchEngine::npos;
+
+        SearchMatchIndex();
+        ~SearchMatchIndex();
+
+        SearchMatchIndex(const SearchMatchIndex&) = delete;
+        SearchMatchIndex& operator=(const SearchMatchIndex&) = delete;
+
+        // Conexión con el buffer
+        void attach(TextBuffer& buffer);
+        void detach();
+
+        // Búsqueda activa (exactamente uno de los motores, o ninguno)
+        void setSearch(const SearchEngine* literal, const RegexEngine* regex);
+        void clear();
+
+        // Escaneo por tramos
+        size_t scanStep(size_t maxLines);
+        bool isComplete() const;
+        double getProgress() const;
+
+        // Consultas
+        size_t getMatchCount() const { return matches_.size(); }
+        const SearchMatch& getMatch(size_t index) const { return matches_[index]; }
+        size_t findNextIndex(size_t line, size_t col) const;
+        size_t findPreviousIndex(size_t line, size_t col) const;
+        size_t indexOf(size_t line, size_t col) const;
+        std::vector<SearchMatch> getMatchesInLines(size_t firstLine, size_t lastLine) const;
+        size_t getMemoryUsage() const { return sizeof(*this) + matches_.capacity() * sizeof(SearchMatch); }
+
+        // Actualización incremental
+        void applyChange(const TextChange& change);
+
+        // Regiones editadas más grandes se re-escanean con scanStep()
+        static constexpr size_t MAX_SYNC_RESCAN_LINES = 2048;
+
+    private:
+        TextBuffer* buffer_;
+        size_t listenerId_;
+
+        const SearchEngine* literal_;
+        const RegexEngine* regex_;
+
+        // Líneas que puede abarcar una coincidencia además de la inicial
+        // (npos: sin límite, el escaneo por tramos se retoma antes de la edición)
+        size_t lineSpan_;
+
+        // Coincidencias ordenadas que empiezan en [0, scannedUntil_)
+        std::vector<SearchMatch> matches_;
+        size_t scannedUntil_;
+
+        bool isActive() const { return buffer_ && (literal_ || regex_); }
+        void restart();
+        void scanLines(size_t firstLine, size_t endLine, std::vector<SearchMatch>& out) const;
+        std::vector<SearchMatch>::iterator lowerBound(size_t line, size_t col);
+        std::vector<SearchMatch>::const_iterator lowerBound(size_t line, size_t col) const;
+    };
+
+} // namespace CoralCode
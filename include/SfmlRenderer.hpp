@@ -0,0 +1,96 @@
+#pragma once
+
+#include "DistanceFieldAtlas.hpp"
+#include "Renderer.hpp"
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace CoralCode {
+
+    class FrameProfiler;
+
+    /**
+     * @brief Backend de Renderer sobre un sf::RenderTarget
+     *
+     * Responsable de:
+     * - Dibujar rectángulos, textos e imágenes con objetos SFML reutilizados
+     *   entre frames (un sf::Text por frame asignaría sus vértices)
+     * - Mantener una textura y un sprite por imagen
+     * - Atribuir cada draw al perfilador de frames, si lo hay
+     *
+     * Con shaders, el texto sale de un DistanceFieldAtlas generado una vez
+     * por fuente: cualquier tamaño (zoom) usa el mismo atlas y los textos
+     * seguidos se agrupan en un solo draw hasta la siguiente primitiva de
+     * otro tipo. Sin shaders se dibujan los bitmaps que SFML rasteriza para
+     * cada tamaño.
+     *
+     * Sin fuente los textos se cuentan pero no se dibujan. La fuente y el
+     * destino deben vivir más que el backend.
+     */
+    class SfmlRenderer : public Renderer {
+    public:
+        SfmlRenderer(sf::RenderTarget& target, const sf::Font* font, FrameProfiler* profiler = nullptr,
+                     bool distanceField = true);
+        ~SfmlRenderer() override;
+
+        RenderRect measureText(const std::string& text, unsigned size) const override;
+        const char* getName() const override { return distanceField_ ? "SFML (campos de distancia)" : "SFML"; }
+
+        bool usesDistanceField() const { return distanceField_; }
+
+        // Avance con el que se dibuja el glifo a ese tamaño (0 sin fuente)
+        float getGlyphAdvance(char32_t codepoint, unsigned size) const;
+
+        // Bytes de las texturas de las imágenes (RGBA)
+        size_t getImageMemory() const;
+        // Bytes de los glifos: atlas de distancia o páginas de cada tamaño dibujado
+        size_t getGlyphAtlasMemory() const;
+
+    protected:
+        void onBeginFrame(unsigned width, unsigned height, RenderColor background) override;
+        void onEndFrame() override;
+        void onFillRect(const RenderRect& rect, RenderColor color) override;
+        void onDrawText(const char* text, size_t length, float x, float y, unsigned size,
+                        RenderColor color) override;
+        void onCreateImage(ImageId image, unsigned width, unsigned height, bool smooth) override;
+        void onUpdateImage(ImageId image, const uint8_t* pixels, unsigned firstRow, unsigned rowCount) override;
+        void onDrawImage(ImageId image, unsigned rows, const RenderRect& destination) override;
+
+    private:
+        struct Image {
+            sf::Texture texture;
+            std::unique_ptr<sf::Sprite> sprite;
+        };
+
+        sf::RenderTarget& target_;
+        const sf::Font* font_;
+        FrameProfiler* profiler_;
+
+        sf::RectangleShape rect_;
+        std::unique_ptr<sf::Text> text_;
+        std::string scratch_;
+        std::vector<unsigned> bitmapSizes_;         // Tamaños rasterizados por SFML
+        std::vector<std::unique_ptr<Image>> images_;
+
+        // Campos de distancia: atlas, su textura y los glifos pendientes de dibujar
+        bool distanceField_ = false;
+        bool atlasFull_ = false;
+        std::unique_ptr<DistanceFieldAtlas> atlas_;
+        sf::Texture atlasTexture_;
+        sf::Shader distanceShader_;
+        sf::VertexArray glyphVertices_;
+        std::vector<char32_t> missingGlyphs_;
+        std::vector<uint8_t> coverage_;
+
+        const DistanceFieldAtlas::Glyph* findGlyph(char32_t codepoint);
+        bool addMissingGlyphs();
+        void uploadAtlas();
+        void appendGlyphs(const char* text, size_t length, float x, float y, unsigned size, sf::Color color);
+        void flushGlyphs();
+
+        void draw(const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default);
+    };
+
+} // namespace CoralCode
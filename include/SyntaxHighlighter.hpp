@@ -3,8 +3,10 @@
 #include <string>
 #include <vector>
 #include <unordered_set>
+#include <unordered_map>
 #include <utility>
 #include <memory>
+#include <cstdint>
 
 namespace CoralCode {
     
@@ -13,6 +15,7 @@ namespace CoralCode {
      */
     enum class TokenType {
         Keyword,
+        Type,
         String,
         Comment,
         Number,
@@ -50,6 +53,7 @@ namespace CoralCode {
      */
     struct LanguageDefinition {
         std::string name;
+        std::vector<std::string> extensions;
         std::unordered_set<std::string> keywords;
         std::vector<std::string> singleLineComments;
         std::vector<std::pair<std::string, std::string>> multiLineComments;
@@ -92,6 +96,11 @@ namespace CoralCode {
         
         std::vector<std::pair<std::string, TokenColor>> highlightLineWithState(
             const std::string& line, MultiLineState& state) const;
+        std::vector<Token> tokenizeLineWithState(const std::string& line, MultiLineState& state) const;
+        
+        // Colores para tokens producidos externamente (IncrementalParser)
+        std::vector<std::pair<std::string, TokenColor>> highlightTokens(const std::vector<Token>& tokens) const;
+        const LanguageDefinition& getLanguageDefinition() const;
         
         // Configuración de colores
         void setTokenColor(TokenType type, const TokenColor& color);
@@ -117,6 +126,7 @@ namespace CoralCode {
         
         // Análisis interno
         std::vector<Token> parseTokens(const std::string& line) const;
+        std::vector<Token> parseTokens(const std::string& line, MultiLineState& state) const;
         TokenType classifyToken(const std::string& token) const;
         bool isStringDelimiter(char ch) const;
         bool isOperator(char ch) const;
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Clases de prioridad (de mayor a menor)
+     *
+     * Interactive: la UI espera el resultado (consultas, autocompletado).
+     * Visible: afecta a lo que está en pantalla (highlighting, coincidencias).
+     * Background: indexado, guardado, reconstrucciones.
+     */
+    enum class TaskPriority {
+        Interactive = 0,
+        Visible = 1,
+        Background = 2
+    };
+
+    /**
+     * @brief Token de cancelación cooperativa
+     *
+     * Se cancela explícitamente con cancel() o, si se creó con forVersion(),
+     * en cuanto el reloj de versiones deja de coincidir (el buffer cambió y
+     * el resultado ya no sirve). Las copias comparten el estado.
+     */
+    class CancellationToken {
+    public:
+        // Token que nunca se cancela
+        CancellationToken();
+
+        static CancellationToken create();
+        static CancellationToken forVersion(std::shared_ptr<const std::atomic<uint64_t>> clock, uint64_t version);
+
+        void cancel() const;
+        bool isCancelled() const;
+
+        // Bandera compatible con las APIs que reciben const std::atomic<bool>*
+        const std::atomic<bool>* flag() const { return flag_.get(); }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> flag_;
+        std::shared_ptr<const std::atomic<uint64_t>> clock_;
+        uint64_t version_;
+    };
+
+    /**
+     * @brief Tiempos acumulados de las tareas con un mismo nombre
+     */
+    struct TaskStats {
+        std::string name;
+        TaskPriority priority = TaskPriority::Background;
+        size_t completed = 0;
+        size_t cancelled = 0;
+        double totalRunMs = 0.0;
+        double maxRunMs = 0.0;
+        double totalWaitMs = 0.0;   // Desde submit() hasta empezar
+    };
+
+    /**
+     * @brief Planificador compartido para el trabajo en segundo plano
+     *
+     * Responsable de:
+     * - Un conjunto fijo de hilos (núcleos menos uno: el hilo de la UI
+     *   conserva el suyo) creado una sola vez para todo el editor
+     * - Una cola por hilo y prioridad: el dueño toma lo último que encoló
+     *   y los hilos ociosos roban lo más antiguo de las colas ajenas
+     * - Servir siempre antes Interactive y Visible que Background; las
+     *   tareas Background nunca ocupan todos los hilos
+     * - Descartar sin ejecutar las tareas cuyo token ya se canceló
+     * - Medir espera y ejecución de cada tarea por nombre
+     *
+     * Una tarea no debe esperar un futuro de otra tarea (podría no quedar
+     * hilo libre para ejecutarla); para repartir trabajo desde una tarea
+     * se usa parallelFor(), donde el hilo que llama también trabaja.
+     */
+    class TaskScheduler {
+    public:
+        using Work = std::function<void(const CancellationToken&)>;
+
+        explicit TaskScheduler(size_t workerCount = 0);
+        ~TaskScheduler();
+
+        TaskScheduler(const TaskScheduler&) = delete;
+        TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+        // Planificador de todo el proceso
+        static TaskScheduler& shared();
+
+        // Encolar trabajo
+        void submit(const std::string& name, TaskPriority priority, Work work,
+                    CancellationToken token = CancellationToken());
+
+        // Igual que submit() con el resultado en un futuro. Si la tarea se
+        // descarta por cancelación, el futuro termina en broken_promise.
+        template <typename F>
+        auto async(const std::string& name, TaskPriority priority, F work,
+                   CancellationToken token = CancellationToken())
+            -> std::future<std::invoke_result_t<F, const CancellationToken&>> {
+            using Result = std::invoke_result_t<F, const CancellationToken&>;
+            auto task = std::make_shared<std::packaged_task<Result(const CancellationToken&)>>(std::move(work));
+            std::future<Result> future = task->get_future();
+            submit(name, priority, [task](const CancellationToken& current) { (*task)(current); }, std::move(token));
+            return future;
+        }
+
+        // Ejecuta body(part, begin, end) para cada una de las parts porciones
+        // de [0, count); el hilo que llama participa y vuelve al terminar todas
+        void parallelFor(const std::string& name, TaskPriority priority, size_t count, size_t parts,
+                         const std::function<void(size_t, size_t, size_t)>& body);
+
+        // Espera a que no quede nada encolado ni en ejecución
+        void waitIdle();
+
+        size_t getWorkerCount() const { return workers_.size(); }
+        size_t getPendingCount() const;
+        std::vector<TaskStats> getStats() const;
+        void resetStats();
+
+        static constexpr size_t PRIORITY_COUNT = 3;
+
+    private:
+        struct Task {
+            std::string name;
+            TaskPriority priority;
+            Work work;
+            CancellationToken token;
+            std::chrono::steady_clock::time_point queuedAt;
+        };
+
+        struct Worker {
+            std::mutex mutex;
+            std::deque<Task> queues[PRIORITY_COUNT];
+            std::thread thread;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::atomic<size_t> nextWorker_;
+        size_t maxBackground_;
+
+        // Sueño y despertar de los hilos
+        mutable std::mutex sleepMutex_;
+        std::condition_variable wake_;
+        std::condition_variable idle_;
+        bool stopping_;
+        std::atomic<size_t> queued_[PRIORITY_COUNT];
+        std::atomic<size_t> runningBackground_;
+        std::atomic<size_t> outstanding_;   // Encoladas + en ejecución
+
+        // Estadísticas por nombre
+        mutable std::mutex statsMutex_;
+        std::unordered_map<std::string, TaskStats> stats_;
+
+        void workerLoop(size_t index);
+        bool hasRunnableWork() const;
+        bool takeTask(size_t index, Task& task);
+        bool popFrom(Worker& worker, size_t priority, bool newest, Task& task);
+        void runTask(Task& task);
+        void finishTask(Task& task, bool ran, double waitMs, double runMs);
+    };
+
+} // namespace CoralCode
@@ -1,11 +1,28 @@
 #pragma once
 
+#include "TextEdit.hpp"
 #include <vector>
 #include <string>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
 
 namespace CoralCode {
     
+    /**
+     * @brief Describe un cambio de líneas en el buffer
+     * 
+     * Las líneas [firstLine, firstLine + removedLines) del contenido anterior
+     * fueron reemplazadas por [firstLine, firstLine + insertedLines). Una edición
+     * dentro de una sola línea se reporta como {line, 1, 1}.
+     */
+    struct TextChange {
+        size_t firstLine;
+        size_t removedLines;
+        size_t insertedLines;
+    };
+    
     /**
      * @brief Gestiona el contenido de texto del editor
      * 
@@ -45,6 +62,16 @@ namespace CoralCode {
         std::vector<std::string> getLines(size_t startLine, size_t endLine) const;
         void replaceLines(size_t startLine, const std::vector<std::string>& newLines);
         
+        // Operaciones de rango (fin exclusivo, puede abarcar varias líneas)
+        std::string getText(size_t startLine, size_t startCol, size_t endLine, size_t endCol) const;
+        void replaceRange(size_t startLine, size_t startCol, size_t endLine, size_t endCol,
+                          const std::string& text);
+        
+        // Ediciones en lote: rangos ordenados y sin solapar, una sola
+        // reconstrucción y una sola notificación. Devuelve las inversas.
+        std::vector<TextEdit> applyEdits(const std::vector<TextEdit>& edits);
+        void setLines(std::vector<std::string> lines);
+        
         // Conversión
         std::string toString() const;
         void fromString(const std::string& content);
@@ -53,11 +80,27 @@ namespace CoralCode {
         size_t getTotalCharacters() const;
         bool isEmpty() const;
         
+        // Memoria: texto de las líneas y tabla de líneas (O(n), para informes)
+        size_t getMemoryUsage() const;
+        size_t getLineIndexMemory() const;
+        
+        // Notificación de cambios (parser, índices, layout)
+        using ChangeListener = std::function<void(const TextChange&)>;
+        size_t addChangeListener(ChangeListener listener);
+        void removeChangeListener(size_t listenerId);
+        uint64_t getVersion() const { return version_; }
+        
     private:
         std::vector<std::string> lines_;
         
+        // Observadores del contenido
+        std::vector<std::pair<size_t, ChangeListener>> listeners_;
+        size_t nextListenerId_;
+        uint64_t version_;
+        
         void ensureLineExists(size_t line);
         void validateLineIndex(size_t line) const;
+        void notifyChange(size_t firstLine, size_t removedLines, size_t insertedLines);
     };
     
 } // namespace CoralCode
\ No newline at end of file
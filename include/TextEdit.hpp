@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace CoralCode {
+    
+    /**
+     * @brief Posición del cursor en el editor
+     */
+    struct CursorPosition {
+        size_t line;
+        size_t column;
+        
+        CursorPosition(size_t l = 0, size_t c = 0) : line(l), column(c) {}
+        
+        bool operator==(const CursorPosition& other) const {
+            return line == other.line && column == other.column;
+        }
+        
+        bool operator!=(const CursorPosition& other) const {
+            return !(*this == other);
+        }
+    };
+    
+    /**
+     * @brief Reemplazo de un rango del buffer por un texto (fin exclusivo)
+     */
+    struct TextEdit {
+        size_t line;
+        size_t column;
+        size_t endLine;
+        size_t endColumn;
+        std::string text;
+    };
+    
+} // namespace CoralCode
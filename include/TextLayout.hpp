@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace CoralCode {
+
+    // Decodifica el carácter UTF-8 en text[i]; devuelve cuántos bytes
+    // ocupa. Una secuencia inválida cuenta como un byte (U+FFFD).
+    size_t decodeUtf8(const char* text, size_t size, size_t i, char32_t& codepoint);
+
+    /**
+     * @brief Posiciones horizontales de una línea ya medida
+     *
+     * offsets[i] es la x (desde el inicio de la línea) del byte i y
+     * columns[i] su columna visual con las tabulaciones expandidas; los
+     * bytes de continuación UTF-8 comparten el valor de su primer byte.
+     * La última entrada (índice size) es el ancho total.
+     */
+    struct LineLayout {
+        std::vector<float> offsets;
+        std::vector<uint32_t> columns;
+        uint64_t generation = 0;        // Generación del TextLayout que la midió (0: sin medir)
+
+        size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+        float width() const { return offsets.empty() ? 0.0f : offsets.back(); }
+
+        // x del byte col (col se limita al final de la línea)
+        float offsetOf(size_t col) const;
+        size_t visualColumnOf(size_t col) const;
+
+        // Byte (inicio de carácter) más cercano a x: O(log n)
+        size_t hitTest(float x) const;
+
+        size_t getMemoryUsage() const {
+            return offsets.capacity() * sizeof(float) + columns.capacity() * sizeof(uint32_t);
+        }
+    };
+
+    /**
+     * @brief Métrica horizontal del texto: avances de glifo y tabulaciones
+     *
+     * Responsable de:
+     * - Consultar el avance de cada glifo a la fuente cargada una sola vez
+     *   (tabla directa para ASCII, mapa para el resto)
+     * - Llevar cada tabulación a la siguiente parada (tabSize espacios)
+     * - Medir líneas en un LineLayout reutilizable
+     *
+     * Sin fuente, todos los glifos miden el avance fijo. La escala (zoom)
+     * multiplica los avances cacheados sin volver a consultar la fuente.
+     * Cambiar la fuente, el avance fijo, la escala o el tamaño de tabulación
+     * incrementa la generación y deja obsoletos todos los LineLayout medidos antes.
+     */
+    class TextLayout {
+    public:
+        using GlyphAdvanceFunction = std::function<float(char32_t)>;
+
+        static constexpr float DEFAULT_ADVANCE = 9.6f;
+        static constexpr size_t DEFAULT_TAB_SIZE = 4;
+
+        TextLayout();
+
+        void setGlyphAdvanceProvider(GlyphAdvanceFunction provider);
+        void setFixedAdvance(float advance);
+        void setTabSize(size_t tabSize);
+        void setScale(float scale);
+
+        size_t getTabSize() const { return tabSize_; }
+        float getScale() const { return scale_; }
+        bool hasGlyphAdvances() const { return static_cast<bool>(provider_); }
+        uint64_t getGeneration() const { return generation_; }
+
+        float getGlyphAdvance(char32_t codepoint) const;
+        float getTabWidth() const { return static_cast<float>(tabSize_) * getGlyphAdvance(U' '); }
+
+        // Mide text en out reutilizando su capacidad
+        void layoutLine(const std::string& text, LineLayout& out) const;
+        void layoutLine(const char* text, size_t length, LineLayout& out) const;
+
+    private:
+        GlyphAdvanceFunction provider_;
+        float fixedAdvance_;
+        float scale_ = 1.0f;
+        size_t tabSize_;
+        uint64_t generation_;
+
+        // Caché de avances sin escalar: ASCII en tabla (negativo = sin consultar)
+        mutable std::array<float, 128> asciiAdvances_;
+        mutable std::unordered_map<char32_t, float> advances_;
+
+        void resetCache();
+    };
+
+    /**
+     * @brief Caché de LineLayout por línea, de correspondencia directa
+     *
+     * Cada línea ocupa la ranura line % slots; una entrada vale mientras no
+     * cambien el texto (versión del documento) ni la generación del
+     * TextLayout. Con las líneas visibles por debajo del número de ranuras
+     * no hay colisiones y, una vez llenas, consultar no asigna memoria.
+     */
+    class LineLayoutCache {
+    public:
+        explicit LineLayoutCache(size_t slots = DEFAULT_SLOTS);
+
+        const LineLayout& get(const TextLayout& layout, size_t line, const std::string& text,
+                              uint64_t textVersion);
+        void clear();
+
+        size_t getMemoryUsage() const;
+
+        static constexpr size_t DEFAULT_SLOTS = 256;
+
+    private:
+        struct Slot {
+            size_t line = SIZE_MAX;
+            uint64_t textVersion = 0;
+            LineLayout layout;
+        };
+
+        std::vector<Slot> slots_;
+    };
+
+} // namespace CoralCode
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "TextBuffer.hpp"
+#include "TextEdit.hpp"
 #include <deque>
 #include <string>
 #include <memory>
 #include <chrono>
+#include <vector>
 
 namespace CoralCode {
     
@@ -20,9 +22,18 @@ namespace CoralCode {
     
     /**
      * @brief Estado del editor para undo/redo
+     * 
+     * Puede ser una copia completa de las líneas o, si isDelta, solo las
+     * ediciones que deshacen la operación (para cambios masivos como
+     * "reemplazar todo", donde copiar el documento sería prohibitivo).
+     * Una operación compuesta puede juntar varios lotes de applyEdits;
+     * batchEnds marca dónde acaba cada uno (vacío: un solo lote).
      */
     struct EditorState {
         std::vector<std::string> lines;
+        std::vector<TextEdit> edits;
+        std::vector<size_t> batchEnds;
+        bool isDelta = false;
         CursorPosition cursor;
         std::chrono::steady_clock::time_point timestamp;
         OperationType operation;
@@ -33,6 +44,10 @@ namespace CoralCode {
                    OperationType op, const std::string& desc)
             : lines(l), cursor(c), timestamp(std::chrono::steady_clock::now()),
               operation(op), description(desc) {}
+        EditorState(std::vector<TextEdit> e, const CursorPosition& c,
+                   OperationType op, const std::string& desc)
+            : edits(std::move(e)), isDelta(true), cursor(c),
+              timestamp(std::chrono::steady_clock::now()), operation(op), description(desc) {}
     };
     
     /**
@@ -55,6 +70,10 @@ namespace CoralCode {
         bool undo(TextBuffer& buffer, CursorPosition& cursor);
         bool redo(TextBuffer& buffer, CursorPosition& cursor);
         
+        // Registro compacto: ediciones inversas devueltas por TextBuffer::applyEdits
+        void recordEdits(std::vector<TextEdit> inverseEdits, const CursorPosition& cursor,
+                         OperationType operation, const std::string& description);
+        
         // Estado del historial
         bool canUndo() const;
         bool canRedo() const;
@@ -89,13 +108,14 @@ namespace CoralCode {
         bool inCompoundOperation_;
         std::string compoundDescription_;
         std::unique_ptr<EditorState> compoundStartState_;
+        size_t currentGroupSize_;
         
         // Configuración de agrupación
         static constexpr auto MAX_GROUP_TIME = std::chrono::milliseconds(1000);
         static constexpr size_t MAX_GROUP_SIZE = 50;
         
         // Métodos internos
-        void addToHistory(const EditorState& state);
+        void addToHistory(EditorState state);
         void clearRedoHistory();
         bool shouldGroupWithPrevious(const EditorState& newState) const;
         void trimHistoryIfNeeded();
@@ -103,6 +123,7 @@ namespace CoralCode {
         // Utilidades
         size_t calculateStateSize(const EditorState& state) const;
         bool statesAreEqual(const EditorState& a, const EditorState& b) const;
+        EditorState restoreState(EditorState state, TextBuffer& buffer, CursorPosition& cursor);
     };
     
 } // namespace CoralCode
\ No newline at end of file
@@ -1,10 +1,13 @@
 #pragma once
 
+#include "TextLayout.hpp"
 #include <cstddef>
 #include <utility>
 
 namespace CoralCode {
     
+    class TextBuffer;
+    
     /**
      * @brief Gestiona el viewport y scroll del editor
      * 
@@ -13,6 +16,8 @@ namespace CoralCode {
      * - Cálculo de líneas/columnas visibles
      * - Auto-scroll basado en cursor
      * - Validación de límites de scroll
+     * - Posiciones horizontales con los avances reales de la fuente y las
+     *   paradas de tabulación (un LineLayout cacheado por línea visible)
      */
     class Viewport {
     public:
@@ -24,6 +29,12 @@ namespace CoralCode {
         void setCharacterMetrics(float charWidth, float lineHeight);
         void setUIMetrics(float lineNumberWidth, float statusBarHeight, float scrollBarWidth);
         
+        // Métrica horizontal del texto (sin fuente: charWidth fijo)
+        void setGlyphAdvanceProvider(TextLayout::GlyphAdvanceFunction provider);
+        void setTabSize(size_t tabSize);
+        size_t getTabSize() const { return layout_.getTabSize(); }
+        const TextLayout& getTextLayout() const { return layout_; }
+        
         // Gestión del scroll
         void setScrollPosition(size_t line, size_t col);
         void scrollToLine(size_t line);
@@ -42,11 +53,18 @@ namespace CoralCode {
         size_t getLastVisibleLine(size_t totalLines) const;
         size_t getFirstVisibleColumn() const;
         size_t getLastVisibleColumn() const;
+        float getTextAreaWidth() const;
         
         // Conversión de coordenadas
         std::pair<size_t, size_t> screenToTextPosition(float x, float y) const;
         std::pair<float, float> textToScreenPosition(size_t line, size_t col) const;
         
+        // Con el texto real: avances por glifo y tabulaciones. El byte más
+        // cercano se busca en O(log longitud de la línea)
+        std::pair<size_t, size_t> screenToTextPosition(float x, float y, const TextBuffer& buffer) const;
+        std::pair<float, float> textToScreenPosition(size_t line, size_t col, const TextBuffer& buffer) const;
+        const LineLayout& getLineLayout(size_t line, const TextBuffer& buffer) const;
+        
         // Estado del scroll
         bool canScrollUp() const;
         bool canScrollDown(size_t totalLines) const;
@@ -85,8 +103,11 @@ namespace CoralCode {
         float statusBarHeight_;
         float scrollBarWidth_;
         
+        // Layout horizontal: se recalcula por línea al cambiar su texto
+        mutable TextLayout layout_;
+        mutable LineLayoutCache layoutCache_;
+        
         // Cálculos internos
-        float getTextAreaWidth() const;
         float getTextAreaHeight() const;
         void validateScrollPosition(size_t totalLines, size_t maxLineLength);
     };
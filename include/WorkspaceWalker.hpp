@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace CoralCode {
+
+    /**
+     * @brief Opciones del recorrido del espacio de trabajo
+     */
+    struct WalkOptions {
+        bool includeHidden = false;
+        bool respectIgnoreFiles = true;
+        size_t threadCount = 0;     // 0: hilos del planificador más el que llama
+        bool reportDirectories = false;
+    };
+
+    /**
+     * @brief Archivo encontrado durante el recorrido
+     */
+    struct WorkspaceFile {
+        std::string path;           // ruta completa
+        std::string relativePath;   // relativa a la raíz, separada por '/'
+        bool isDirectory;
+    };
+
+    // Reglas de un archivo de ignore (definidas en WorkspaceWalker.cpp)
+    class IgnoreRules;
+
+    /**
+     * @brief Aplica las reglas de ignore a rutas sueltas
+     *
+     * Para eventos del sistema de archivos, donde no hay recorrido que
+     * herede las reglas. Guarda las reglas de cada directorio consultado;
+     * invalidate() las descarta tras cambiar un .gitignore.
+     */
+    class IgnoreMatcher {
+    public:
+        IgnoreMatcher(const std::string& root, const WalkOptions& options);
+
+        bool isIgnored(const std::string& relativePath, bool isDirectory);
+        void invalidate();
+
+    private:
+        friend class WorkspaceWalker;
+
+        std::string root_;
+        WalkOptions options_;
+        std::unordered_map<std::string, std::shared_ptr<const IgnoreRules>> cache_;
+
+        // Reglas vigentes dentro de un directorio ("" es la raíz)
+        std::shared_ptr<const IgnoreRules> rulesFor(const std::string& directory);
+    };
+
+    /**
+     * @brief Recorre un árbol de directorios en paralelo
+     *
+     * Responsable de:
+     * - Aplicar las reglas de .gitignore/.ignore de cada directorio
+     *   (comodines, `**`, anclaje con '/', negación con '!')
+     * - Omitir ocultos, .git y enlaces simbólicos (evita ciclos)
+     * - Repartir directorios y archivos entre colas propias, recorridas
+     *   con parallelFor en el planificador compartido (Background); una
+     *   cola sin trabajo roba la tarea más antigua de otra
+     *
+     * El callback se llama desde varios hilos a la vez; recibe el índice
+     * del hilo para que el llamador use memoria de trabajo por hilo.
+     */
+    class WorkspaceWalker {
+    public:
+        using FileCallback = std::function<void(const WorkspaceFile&, size_t worker)>;
+
+        explicit WorkspaceWalker(const WalkOptions& options = WalkOptions());
+
+        // Bloquea hasta terminar o hasta que cancel se active
+        bool walk(const std::string& root, const FileCallback& onFile,
+                  const std::atomic<bool>* cancel = nullptr);
+
+        // Solo un subdirectorio, con las reglas heredadas de la raíz
+        bool walk(const std::string& root, const std::string& subdirectory, const FileCallback& onFile,
+                  const std::atomic<bool>* cancel = nullptr);
+
+        size_t getThreadCount() const { return threadCount_; }
+        size_t getDirectoryCount() const { return directoryCount_; }
+        const std::string& getLastError() const { return lastError_; }
+
+        // Coincidencia de un patrón de ignore con una ruta relativa
+        static bool globMatch(const char* pattern, const char* text);
+
+    private:
+        WalkOptions options_;
+        size_t threadCount_;
+        size_t directoryCount_;
+        std::string lastError_;
+
+        struct Task;
+        struct Worker;
+    };
+
+} // namespace CoralCode
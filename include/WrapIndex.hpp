@@ -0,0 +1,100 @@
+#pragma once
+
+#include "TextBuffer.hpp"
+#include "TextLayout.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace CoralCode {
+
+    /**
+     * @brief Fila visual dentro del documento ajustado
+     */
+    struct VisualPosition {
+        size_t line;        // Línea lógica
+        size_t row;         // Fila dentro de esa línea (0: la primera)
+    };
+
+    /**
+     * @brief Ajuste de línea (soft wrap) con índice de filas visuales
+     *
+     * Responsable de:
+     * - Contar las filas visuales de cada línea con los avances reales del
+     *   TextLayout: se corta tras el último espacio que cabe, o en mitad de
+     *   la palabra si no hay ninguno
+     * - Mantener un árbol de Fenwick sobre esas cuentas: fila visual de una
+     *   línea y línea de una fila visual en O(log n)
+     * - Volver a medir solo las líneas editadas; insertar o borrar líneas
+     *   desplaza las cuentas sin medir las demás y deja el árbol pendiente
+     *   desde la primera línea tocada: la siguiente consulta reconstruye
+     *   solo ese sufijo, una vez por muchas ediciones seguidas
+     * - Tras un cambio de ancho, de fuente o de tabulación, medir todo de
+     *   nuevo en la siguiente consulta, repartido entre los hilos del
+     *   TaskScheduler compartido
+     *
+     * El TextLayout pertenece al Viewport y debe vivir más que el índice.
+     * Al medir en paralelo cada hilo usa una copia del layout; la caché
+     * ASCII se llena antes en el hilo que llama, así que el proveedor de
+     * avances solo se consulta desde otros hilos para caracteres no ASCII.
+     */
+    class WrapIndex {
+    public:
+        WrapIndex();
+        ~WrapIndex();
+
+        WrapIndex(const WrapIndex&) = delete;
+        WrapIndex& operator=(const WrapIndex&) = delete;
+
+        // Conexión con el buffer
+        void attach(TextBuffer& buffer, const TextLayout& layout);
+        void detach();
+
+        // Ancho disponible en píxeles (0: sin ajuste, una fila por línea)
+        void setWrapWidth(float width);
+        float getWrapWidth() const { return width_; }
+        void invalidate();
+
+        // Consultas (miden antes lo pendiente)
+        size_t getVisualLineCount() const;
+        size_t getRowCount(size_t line) const;
+        size_t visualRowOfLine(size_t line) const;
+        VisualPosition lineAtVisualRow(size_t row) const;
+
+        // Byte de inicio de cada fila de line (la primera siempre es 0)
+        void getRowStarts(size_t line, std::vector<size_t>& starts) const;
+
+        // Actualización incremental
+        void applyChange(const TextChange& change);
+
+        size_t getMemoryUsage() const;
+
+        // Por debajo de estas líneas no compensa repartir la medida
+        static constexpr size_t PARALLEL_MIN_LINES = 16384;
+
+    private:
+        TextBuffer* buffer_;
+        size_t listenerId_;
+        const TextLayout* layout_;
+        float width_;
+
+        // Filas por línea y árbol de Fenwick sobre ellas (índices desde 1).
+        // Se recalculan en las consultas const cuando están obsoletos; solo
+        // los nodos [1, treeValid_] del árbol están al día
+        mutable std::vector<uint32_t> rows_;
+        mutable std::vector<size_t> tree_;
+        mutable size_t treeValid_;
+        mutable size_t totalRows_;
+        mutable bool stale_;
+        mutable uint64_t layoutGeneration_;
+        mutable LineLayout scratch_;
+
+        void refresh() const;
+        void measureRange(size_t first, size_t end) const;
+        uint32_t measureLine(size_t line, const TextLayout& layout, LineLayout& scratch) const;
+        void rebuildTree(size_t from) const;
+        void addToTree(size_t line, int64_t delta) const;
+        size_t prefixRows(size_t line) const;
+    };
+
+} // namespace CoralCode
@@ -0,0 +1,71 @@
+/**
+ * @file batch_main.cpp
+ * @brief Punto de entrada de coralcode_batch (sin ventana ni SFML)
+ *
+ * Uso:
+ *   coralcode_batch <script> [--jobs n] [--include glob] [--dry-run]
+ *                   [--verbose] <archivos|directorios>
+ *
+ * Equivale a "coralcode --batch <script> ...", pero solo enlaza el núcleo
+ * de edición y la E/S de archivos, de modo que sirve en servidores de CI
+ * sin pantalla ni SFML.
+ */
+
+#include "BatchEditor.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+    void printUsage() {
+        std::cout << "Uso: coralcode_batch <script> [opciones] <archivos|directorios>\n"
+                  << "  --jobs <n>            Hilos (por defecto, uno por núcleo)\n"
+                  << "  --include <glob>      Solo archivos que coincidan (repetible)\n"
+                  << "  --dry-run             Informar sin escribir\n"
+                  << "  --verbose             Listar cada archivo modificado\n\n"
+                  << "Órdenes del script (una por línea, '#' comenta):\n"
+                  << "  replace \"viejo\" \"nuevo\" [-i] [-w]    replace-regex \"patrón\" \"nuevo $1\" [-i]\n"
+                  << "  delete-lines \"patrón\"                 insert-line <n|end> \"texto\"\n"
+                  << "  trim-trailing-whitespace               expand-tabs [ancho]\n"
+                  << "  ensure-final-newline                   require[-regex] \"patrón\" (si falta, se omite)\n";
+    }
+
+    bool parseArguments(int argc, char* argv[], CoralCode::BatchRequest& request) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if (argument == "--jobs" && hasValue) {
+                request.options.jobs = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (argument == "--include" && hasValue) {
+                request.include.push_back(argv[++i]);
+            } else if (argument == "--dry-run") {
+                request.options.dryRun = true;
+            } else if (argument == "--verbose") {
+                request.verbose = true;
+            } else if (argument == "--batch" && hasValue && request.scriptPath.empty()) {
+                request.scriptPath = argv[++i];
+            } else if (argument.rfind("--", 0) == 0) {
+                return false;
+            } else if (request.scriptPath.empty()) {
+                request.scriptPath = argument;
+            } else {
+                request.inputs.push_back(argument);
+            }
+        }
+        return !request.scriptPath.empty() && !request.inputs.empty();
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace CoralCode;
+
+    BatchRequest request;
+    if (!parseArguments(argc, argv, request)) {
+        printUsage();
+        return 2;
+    }
+    return BatchEditor::runRequest(request);
+}
@@ -0,0 +1,571 @@
+/**
+ * @file BatchEditor.cpp
+ * @brief Scripts de edición por lotes aplicados sin ventana y en paralelo
+ */
+
+#include "BatchEditor.hpp"
+#include "FileHandler.hpp"
+#include "TaskScheduler.hpp"
+#include "WorkspaceWalker.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+
+namespace CoralCode {
+
+    namespace {
+
+        // ====================================================================
+        // Análisis del script
+        // ====================================================================
+
+        bool tokenize(const std::string& line, std::vector<std::string>& tokens, std::string& error) {
+            size_t i = 0;
+            while (i < line.size()) {
+                if (line[i] == ' ' || line[i] == '\t') {
+                    ++i;
+                    continue;
+                }
+                if (line[i] == '#') break;
+
+                std::string token;
+                if (line[i] == '"') {
+                    ++i;
+                    bool closed = false;
+                    while (i < line.size()) {
+                        const char ch = line[i++];
+                        if (ch == '"') {
+                            closed = true;
+                            break;
+                        }
+                        if (ch == '\\' && i < line.size()) {
+                            const char escaped = line[i++];
+                            switch (escaped) {
+                                case 'n': token += '\n'; break;
+                                case 't': token += '\t'; break;
+                                default: token += escaped; break;
+                            }
+                        } else {
+                            token += ch;
+                        }
+                    }
+                    if (!closed) {
+                        error = "comillas sin cerrar";
+                        return false;
+                    }
+                } else {
+                    while (i < line.size() && line[i] != ' ' && line[i] != '\t') {
+                        token += line[i++];
+                    }
+                }
+                tokens.push_back(std::move(token));
+            }
+            return true;
+        }
+
+        struct CommandSpec {
+            const char* name;
+            BatchCommandType type;
+            size_t minArgs;
+            size_t maxArgs;
+        };
+
+        const CommandSpec COMMANDS[] = {
+            {"replace", BatchCommandType::Replace, 2, 2},
+            {"replace-regex", BatchCommandType::ReplaceRegex, 2, 2},
+            {"delete-lines", BatchCommandType::DeleteLines, 1, 1},
+            {"insert-line", BatchCommandType::InsertLine, 2, 2},
+            {"trim-trailing-whitespace", BatchCommandType::TrimTrailingWhitespace, 0, 0},
+            {"expand-tabs", BatchCommandType::ExpandTabs, 0, 1},
+            {"ensure-final-newline", BatchCommandType::EnsureFinalNewline, 0, 0},
+            {"require", BatchCommandType::Require, 1, 1},
+            {"require-regex", BatchCommandType::RequireRegex, 1, 1},
+        };
+
+        bool parseNumber(const std::string& text, size_t& value) {
+            if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) return false;
+            value = static_cast<size_t>(std::stoull(text));
+            return true;
+        }
+
+        // ====================================================================
+        // Construcción de ediciones
+        // ====================================================================
+
+        // Descarta coincidencias solapadas o vacías en el final de la anterior
+        void addEdit(std::vector<TextEdit>& edits, const SearchMatch& range, std::string text) {
+            if (!edits.empty()) {
+                const TextEdit& last = edits.back();
+                bool overlaps = range.line < last.endLine ||
+                                (range.line == last.endLine && range.column < last.endColumn);
+                bool emptyAtLastEnd = range.line == last.endLine && range.column == last.endColumn &&
+                                      range.endLine == range.line && range.endColumn == range.column;
+                if (overlaps || emptyAtLastEnd) return;
+            }
+            edits.push_back(TextEdit{range.line, range.column, range.endLine, range.endColumn, std::move(text)});
+        }
+
+        // Borra las líneas marcadas, agrupando las consecutivas
+        std::vector<TextEdit> deleteMarkedLines(const TextBuffer& buffer, const std::vector<bool>& marked) {
+            std::vector<TextEdit> edits;
+            const size_t count = buffer.getLineCount();
+            size_t line = 0;
+            while (line < count) {
+                if (!marked[line]) {
+                    ++line;
+                    continue;
+                }
+                size_t end = line;
+                while (end + 1 < count && marked[end + 1]) ++end;
+
+                if (end + 1 < count) {
+                    edits.push_back(TextEdit{line, 0, end + 1, 0, ""});
+                } else if (line > 0) {
+                    // Hasta el final: se come el salto de línea anterior
+                    edits.push_back(TextEdit{line - 1, buffer.getLineLength(line - 1), end,
+                                             buffer.getLineLength(end), ""});
+                } else {
+                    edits.push_back(TextEdit{0, 0, end, buffer.getLineLength(end), ""});
+                }
+                line = end + 1;
+            }
+            return edits;
+        }
+
+        std::string expandTabs(const std::string& text, size_t startColumn, size_t width) {
+            std::string out;
+            size_t column = startColumn;
+            for (char ch : text) {
+                if (ch == '\t') {
+                    const size_t spaces = width - column % width;
+                    out.append(spaces, ' ');
+                    column += spaces;
+                } else {
+                    out += ch;
+                    ++column;
+                }
+            }
+            return out;
+        }
+
+        bool contains(const BatchCommand& command, const TextBuffer& buffer) {
+            if (command.regex) {
+                bool found = false;
+                command.regex->search(buffer, 0, 0, [&found](const RegexMatch&) noexcept {
+                    found = true;
+                    return false;
+                });
+                return found;
+            }
+            SearchMatch match{};
+            return command.search->findForward(buffer, 0, 0, match);
+        }
+
+        std::vector<TextEdit> buildEdits(const BatchCommand& command, const TextBuffer& buffer) {
+            std::vector<TextEdit> edits;
+            const size_t lineCount = buffer.getLineCount();
+
+            switch (command.type) {
+                case BatchCommandType::Replace:
+                    for (const SearchMatch& match : command.search->findAll(buffer)) {
+                        addEdit(edits, match, command.text);
+                    }
+                    break;
+
+                case BatchCommandType::ReplaceRegex:
+                    // Las expansiones leen el texto original: recolectar antes de aplicar
+                    command.regex->search(buffer, 0, 0, [&](const RegexMatch& match) {
+                        addEdit(edits, match.range, command.regex->expandReplacement(command.text, match, buffer));
+                        return true;
+                    });
+                    break;
+
+                case BatchCommandType::DeleteLines: {
+                    std::vector<bool> marked(lineCount, false);
+                    command.regex->search(buffer, 0, 0, [&marked](const RegexMatch& match) {
+                        for (size_t line = match.range.line; line <= match.range.endLine; ++line) {
+                            marked[line] = true;
+                        }
+                        return true;
+                    });
+                    edits = deleteMarkedLines(buffer, marked);
+                    break;
+                }
+
+                case BatchCommandType::InsertLine: {
+                    const size_t last = lineCount - 1;
+                    if (command.number > 0 && command.number <= lineCount) {
+                        edits.push_back(TextEdit{command.number - 1, 0, command.number - 1, 0, command.text + "\n"});
+                    } else if (buffer.getLineLength(last) == 0 && lineCount > 1) {
+                        // Termina en salto de línea: la nueva línea va antes de la vacía
+                        edits.push_back(TextEdit{last, 0, last, 0, command.text + "\n"});
+                    } else {
+                        const size_t length = buffer.getLineLength(last);
+                        edits.push_back(TextEdit{last, length, last, length, "\n" + command.text});
+                    }
+                    break;
+                }
+
+                case BatchCommandType::TrimTrailingWhitespace:
+                    for (size_t line = 0; line < lineCount; ++line) {
+                        const std::string& text = buffer.getLine(line);
+                        const size_t keep = text.find_last_not_of(" \t");
+                        const size_t start = keep == std::string::npos ? 0 : keep + 1;
+                        if (start < text.size()) {
+                            edits.push_back(TextEdit{line, start, line, text.size(), ""});
+                        }
+                    }
+                    break;
+
+                case BatchCommandType::ExpandTabs:
+                    for (size_t line = 0; line < lineCount; ++line) {
+                        const std::string& text = buffer.getLine(line);
+                        const size_t tab = text.find('\t');
+                        if (tab == std::string::npos) continue;
+                        edits.push_back(TextEdit{line, tab, line, text.size(),
+                                                 expandTabs(text.substr(tab), tab, command.number)});
+                    }
+                    break;
+
+                case BatchCommandType::EnsureFinalNewline: {
+                    const size_t last = lineCount - 1;
+                    const size_t length = buffer.getLineLength(last);
+                    if (length > 0) edits.push_back(TextEdit{last, length, last, length, "\n"});
+                    break;
+                }
+
+                case BatchCommandType::Require:
+                case BatchCommandType::RequireRegex:
+                default:
+                    break;
+            }
+            return edits;
+        }
+
+        std::string toCrlf(const std::string& text) {
+            std::string out;
+            out.reserve(text.size() + text.size() / 32);
+            for (char ch : text) {
+                if (ch == '\n') out += '\r';
+                out += ch;
+            }
+            return out;
+        }
+
+    } // namespace
+
+    // ========================================================================
+    // BatchScript
+    // ========================================================================
+
+    bool BatchScript::parse(const std::string& text, std::string& error) {
+        std::vector<BatchCommand> commands;
+        size_t lineNumber = 0;
+        size_t start = 0;
+
+        while (start <= text.size()) {
+            size_t end = text.find('\n', start);
+            if (end == std::string::npos) end = text.size();
+            std::string line = text.substr(start, end - start);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            start = end + 1;
+            ++lineNumber;
+
+            std::vector<std::string> tokens;
+            std::string tokenError;
+            auto fail = [&](const std::string& message) {
+                error = "Línea " + std::to_string(lineNumber) + ": " + message;
+                return false;
+            };
+            if (!tokenize(line, tokens, tokenError)) return fail(tokenError);
+            if (tokens.empty()) continue;
+
+            const CommandSpec* spec = nullptr;
+            for (const CommandSpec& candidate : COMMANDS) {
+                if (tokens[0] == candidate.name) spec = &candidate;
+            }
+            if (!spec) return fail("orden desconocida '" + tokens[0] + "'");
+
+            BatchCommand command;
+            command.type = spec->type;
+            command.sourceLine = lineNumber;
+
+            // Opciones -i / -w en cualquier posición
+            std::vector<std::string> arguments;
+            for (size_t i = 1; i < tokens.size(); ++i) {
+                if (tokens[i] == "-i") command.caseSensitive = false;
+                else if (tokens[i] == "-w") command.wholeWord = true;
+                else arguments.push_back(tokens[i]);
+            }
+            if (arguments.size() < spec->minArgs || arguments.size() > spec->maxArgs) {
+                return fail("número de argumentos incorrecto para '" + tokens[0] + "'");
+            }
+
+            switch (command.type) {
+                case BatchCommandType::Replace:
+                case BatchCommandType::Require:
+                    command.pattern = arguments[0];
+                    if (command.pattern.empty()) return fail("el texto a buscar está vacío");
+                    if (arguments.size() > 1) command.text = arguments[1];
+                    command.search = std::make_shared<SearchEngine>(command.pattern, command.caseSensitive,
+                                                                    command.wholeWord);
+                    break;
+
+                case BatchCommandType::ReplaceRegex:
+                case BatchCommandType::DeleteLines:
+                case BatchCommandType::RequireRegex: {
+                    command.pattern = arguments[0];
+                    if (arguments.size() > 1) command.text = arguments[1];
+                    auto regex = std::make_shared<RegexEngine>();
+                    if (!regex->compile(command.pattern, command.caseSensitive)) {
+                        return fail("expresión regular no válida: " + regex->getLastError());
+                    }
+                    command.regex = regex;
+                    break;
+                }
+
+                case BatchCommandType::InsertLine:
+                    if (arguments[0] != "end" && (!parseNumber(arguments[0], command.number) || command.number == 0)) {
+                        return fail("se esperaba un número de línea (desde 1) o 'end'");
+                    }
+                    command.text = arguments[1];
+                    break;
+
+                case BatchCommandType::ExpandTabs:
+                    command.number = BatchEditor::DEFAULT_TAB_WIDTH;
+                    if (!arguments.empty() && (!parseNumber(arguments[0], command.number) || command.number == 0)) {
+                        return fail("ancho de tabulación no válido");
+                    }
+                    break;
+
+                case BatchCommandType::TrimTrailingWhitespace:
+                case BatchCommandType::EnsureFinalNewline:
+                default:
+                    break;
+            }
+            commands.push_back(std::move(command));
+        }
+
+        if (commands.empty()) {
+            error = "El script no contiene órdenes";
+            return false;
+        }
+        commands_ = std::move(commands);
+        return true;
+    }
+
+    bool BatchScript::load(const std::string& path, std::string& error) {
+        FileHandler files;
+        std::string text;
+        if (!files.readFile(path, text)) {
+            error = files.getLastError();
+            return false;
+        }
+        return parse(text, error);
+    }
+
+    // ========================================================================
+    // BatchEditor
+    // ========================================================================
+
+    BatchEditor::BatchEditor(const BatchScript& script, const BatchOptions& options)
+        : script_(script), options_(options) {}
+
+    bool BatchEditor::apply(TextBuffer& buffer, UndoRedoManager& history, BatchFileResult& result) const {
+        CursorPosition cursor;
+        size_t steps = 0;
+
+        for (const BatchCommand& command : script_.getCommands()) {
+            if (command.type == BatchCommandType::Require || command.type == BatchCommandType::RequireRegex) {
+                if (contains(command, buffer)) continue;
+                // Deshacer lo ya aplicado: el archivo queda como estaba
+                for (; steps > 0; --steps) history.undo(buffer, cursor);
+                result.skipped = true;
+                result.edits = 0;
+                return true;
+            }
+
+            std::vector<TextEdit> edits = buildEdits(command, buffer);
+            if (edits.empty()) continue;
+            result.edits += edits.size();
+            history.recordEdits(buffer.applyEdits(edits), cursor, OperationType::Replace,
+                                "Línea " + std::to_string(command.sourceLine) + " del script");
+            ++steps;
+        }
+        return true;
+    }
+
+    void BatchEditor::processFile(const std::string& path, std::string content, BatchFileResult& result,
+                                  std::string& output) const {
+        result.path = path;
+        if (content.find('\0') != std::string::npos) {
+            result.error = "Archivo binario";
+            return;
+        }
+
+        const bool crlf = content.find("\r\n") != std::string::npos;
+        TextBuffer buffer;
+        buffer.fromString(content);
+        UndoRedoManager history(script_.getCommands().size() + 1);
+
+        if (!apply(buffer, history, result)) return;
+        result.success = true;
+        if (result.skipped || result.edits == 0) return;
+
+        output = buffer.toString();
+        if (crlf) output = toCrlf(output);
+        result.changed = output != content;
+    }
+
+    BatchSummary BatchEditor::run(const std::vector<std::string>& paths, const FileCallback& onFile) const {
+        const auto start = std::chrono::steady_clock::now();
+        BatchSummary summary;
+
+        std::unique_ptr<TaskScheduler> ownScheduler;
+        if (options_.jobs > 0) ownScheduler = std::make_unique<TaskScheduler>(options_.jobs);
+        TaskScheduler& scheduler = ownScheduler ? *ownScheduler : TaskScheduler::shared();
+        FileHandler files;
+
+        for (size_t first = 0; first < paths.size(); first += BATCH_CHUNK) {
+            const size_t count = std::min(BATCH_CHUNK, paths.size() - first);
+            std::vector<std::string> chunk(paths.begin() + static_cast<std::ptrdiff_t>(first),
+                                           paths.begin() + static_cast<std::ptrdiff_t>(first + count));
+
+            // Todas las lecturas del bloque en vuelo antes de esperar ninguna
+            std::vector<std::future<FileReadResult>> reads = files.readAll(chunk);
+            std::vector<BatchFileResult> results(count);
+            std::vector<std::string> outputs(count);
+
+            scheduler.parallelFor("batch-edit", TaskPriority::Interactive, count, scheduler.getWorkerCount() + 1,
+                                  [&](size_t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    FileReadResult read = reads[i].get();
+                    if (!read.success) {
+                        results[i].path = chunk[i];
+                        results[i].error = read.error;
+                        continue;
+                    }
+                    processFile(chunk[i], std::move(read.content), results[i], outputs[i]);
+                }
+            });
+
+            // Guardar solo lo que cambió (atómico, conserva permisos)
+            std::vector<std::pair<std::string, std::string>> writes;
+            std::vector<size_t> writeIndex;
+            for (size_t i = 0; i < count; ++i) {
+                if (results[i].changed && !options_.dryRun) {
+                    writes.emplace_back(chunk[i], std::move(outputs[i]));
+                    writeIndex.push_back(i);
+                }
+            }
+            std::vector<std::future<FileWriteResult>> saved = files.writeAll(std::move(writes));
+            for (size_t w = 0; w < saved.size(); ++w) {
+                FileWriteResult write = saved[w].get();
+                if (!write.success) {
+                    BatchFileResult& result = results[writeIndex[w]];
+                    result.success = false;
+                    result.error = write.error;
+                }
+            }
+
+            for (const BatchFileResult& result : results) {
+                ++summary.files;
+                if (!result.success) ++summary.failed;
+                else if (result.skipped) ++summary.skipped;
+                else if (result.changed) ++summary.changed;
+                if (result.success) summary.edits += result.edits;
+                if (onFile) onFile(result);
+            }
+        }
+
+        summary.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return summary;
+    }
+
+    bool BatchEditor::expandPaths(const std::vector<std::string>& inputs, const std::vector<std::string>& include,
+                                  std::vector<std::string>& paths, std::string& error) {
+        auto included = [&include](const std::string& relativePath) {
+            if (include.empty()) return true;
+            const std::string name = std::filesystem::path(relativePath).filename().string();
+            for (const std::string& pattern : include) {
+                if (WorkspaceWalker::globMatch(pattern.c_str(), relativePath.c_str()) ||
+                    WorkspaceWalker::globMatch(pattern.c_str(), name.c_str())) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        for (const std::string& input : inputs) {
+            std::error_code code;
+            if (std::filesystem::is_directory(input, code)) {
+                std::vector<std::string> found;
+                std::mutex foundMutex;
+                WorkspaceWalker walker;
+                if (!walker.walk(input, [&](const WorkspaceFile& file, size_t) {
+                        if (file.isDirectory || !included(file.relativePath)) return;
+                        std::lock_guard<std::mutex> lock(foundMutex);
+                        found.push_back(file.path);
+                    })) {
+                    error = walker.getLastError();
+                    return false;
+                }
+                // Orden estable: mismos resultados en cada ejecución
+                std::sort(found.begin(), found.end());
+                paths.insert(paths.end(), found.begin(), found.end());
+            } else if (std::filesystem::is_regular_file(input, code)) {
+                paths.push_back(input);
+            } else {
+                error = "No existe: " + input;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int BatchEditor::runRequest(const BatchRequest& request) {
+        try {
+            BatchScript script;
+            std::string error;
+            if (!script.load(request.scriptPath, error)) {
+                std::cerr << "❌ Error en el script " << request.scriptPath << ": " << error << "\n";
+                return 2;
+            }
+
+            std::vector<std::string> paths;
+            if (request.inputs.empty()) {
+                std::cerr << "❌ Error: --batch necesita archivos o directorios\n";
+                return 2;
+            }
+            if (!expandPaths(request.inputs, request.include, paths, error)) {
+                std::cerr << "❌ Error: " << error << "\n";
+                return 2;
+            }
+
+            const bool dryRun = request.options.dryRun;
+            BatchEditor batch(script, request.options);
+
+            BatchSummary summary = batch.run(paths, [&request, dryRun](const BatchFileResult& result) {
+                if (!result.success) {
+                    std::cerr << "⚠️  " << result.path << ": " << result.error << "\n";
+                } else if (request.verbose && result.changed) {
+                    std::cout << (dryRun ? "📝 (simulado) " : "📝 ") << result.path
+                              << " (" << result.edits << " ediciones)\n";
+                }
+            });
+
+            std::cout << summary.files << " archivos, " << summary.changed << " modificados, "
+                      << summary.skipped << " omitidos, " << summary.failed << " con errores, "
+                      << summary.edits << " ediciones en " << static_cast<long long>(summary.elapsedMs) << " ms"
+                      << (dryRun ? " (sin escribir)" : "") << "\n";
+            return summary.failed > 0 ? 1 : 0;
+
+        } catch (const std::exception& e) {
+            std::cerr << "💥 Error fatal: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+} // namespace CoralCode
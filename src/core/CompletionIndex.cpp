@@ -0,0 +1,312 @@
+/**
+ * @file CompletionIndex.cpp
+ * @brief Índice incremental de identificadores para autocompletado
+ */
+
+#include "CompletionIndex.hpp"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace CoralCode {
+
+    namespace {
+
+        char lowerByte(char ch) {
+            return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch;
+        }
+
+        // Orden sin distinguir mayúsculas (clave principal del arreglo ordenado)
+        int compareFolded(std::string_view a, std::string_view b) {
+            const size_t length = std::min(a.length(), b.length());
+            for (size_t i = 0; i < length; ++i) {
+                char x = lowerByte(a[i]);
+                char y = lowerByte(b[i]);
+                if (x != y) return static_cast<unsigned char>(x) < static_cast<unsigned char>(y) ? -1 : 1;
+            }
+            if (a.length() == b.length()) return 0;
+            return a.length() < b.length() ? -1 : 1;
+        }
+
+        bool startsWithFolded(std::string_view text, std::string_view foldedPrefix) {
+            if (text.length() < foldedPrefix.length()) return false;
+            for (size_t i = 0; i < foldedPrefix.length(); ++i) {
+                if (lowerByte(text[i]) != foldedPrefix[i]) return false;
+            }
+            return true;
+        }
+
+        // Palabras muertas que se toleran antes de renumerar
+        constexpr size_t kCompactMinDeadWords = 4096;
+
+    } // namespace
+
+    CompletionIndex::CompletionIndex() : buffer_(nullptr), listenerId_(0), liveWords_(0) {}
+
+    CompletionIndex::~CompletionIndex() {
+        detach();
+    }
+
+    bool CompletionIndex::isWordByte(char ch) {
+        return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') ||
+               ch == '_' || static_cast<unsigned char>(ch) >= 0x80;
+    }
+
+    // ========================================================================
+    // Conexión con el buffer
+    // ========================================================================
+
+    void CompletionIndex::attach(TextBuffer& buffer) {
+        detach();
+        buffer_ = &buffer;
+        listenerId_ = buffer.addChangeListener([this](const TextChange& change) { applyChange(change); });
+    }
+
+    void CompletionIndex::detach() {
+        if (buffer_) {
+            buffer_->removeChangeListener(listenerId_);
+            buffer_ = nullptr;
+        }
+        restart();
+    }
+
+    void CompletionIndex::restart() {
+        words_.clear();
+        ids_.clear();
+        liveWords_ = 0;
+        sorted_.clear();
+        pending_.clear();
+        lineWords_.clear();
+    }
+
+    // ========================================================================
+    // Escaneo
+    // ========================================================================
+
+    size_t CompletionIndex::indexStep(size_t maxLines) {
+        if (isComplete() || maxLines == 0) return 0;
+
+        const size_t firstLine = lineWords_.size();
+        const size_t endLine = std::min(firstLine + maxLines, buffer_->getLineCount());
+        lineWords_.reserve(buffer_->getLineCount());
+        for (size_t line = firstLine; line < endLine; ++line) {
+            lineWords_.emplace_back();
+            scanLine(line, lineWords_.back());
+        }
+        return endLine - firstLine;
+    }
+
+    bool CompletionIndex::isComplete() const {
+        return !buffer_ || lineWords_.size() >= buffer_->getLineCount();
+    }
+
+    void CompletionIndex::scanLine(size_t line, std::vector<uint32_t>& out) {
+        const std::string& text = buffer_->getLine(line);
+        const size_t length = text.length();
+        size_t i = 0;
+        while (i < length) {
+            if (!isWordByte(text[i])) {
+                ++i;
+                continue;
+            }
+            const size_t start = i;
+            while (i < length && isWordByte(text[i])) ++i;
+
+            // Los números no son identificadores
+            const size_t wordLength = i - start;
+            if ((text[start] >= '0' && text[start] <= '9') ||
+                wordLength < MIN_WORD_LENGTH || wordLength > MAX_WORD_LENGTH) {
+                continue;
+            }
+            out.push_back(intern(std::string_view(text).substr(start, wordLength)));
+        }
+    }
+
+    uint32_t CompletionIndex::intern(std::string_view text) {
+        auto it = ids_.find(text);
+        if (it != ids_.end()) {
+            Word& word = words_[it->second];
+            if (word.count++ == 0) ++liveWords_;
+            return it->second;
+        }
+
+        auto id = static_cast<uint32_t>(words_.size());
+        words_.push_back(Word{std::string(text), 1});
+        ids_.emplace(std::string_view(words_.back().text), id);
+        ++liveWords_;
+
+        pending_.push_back(id);
+        if (pending_.size() > MAX_PENDING_WORDS) {
+            mergePending();
+        }
+        return id;
+    }
+
+    void CompletionIndex::releaseLine(std::vector<uint32_t>& ids) {
+        for (uint32_t id : ids) {
+            if (--words_[id].count == 0) --liveWords_;
+        }
+        ids.clear();
+    }
+
+    void CompletionIndex::truncate(size_t firstLine) {
+        for (size_t line = firstLine; line < lineWords_.size(); ++line) {
+            releaseLine(lineWords_[line]);
+        }
+        lineWords_.resize(firstLine);
+    }
+
+    // ========================================================================
+    // Actualización incremental
+    // ========================================================================
+
+    void CompletionIndex::applyChange(const TextChange& change) {
+        const size_t indexed = lineWords_.size();
+        if (!buffer_ || change.firstLine >= indexed) return;
+
+        if (change.firstLine + change.removedLines > indexed || change.insertedLines > MAX_SYNC_RESCAN_LINES) {
+            // Cambio grande o que cruza el límite escaneado: se re-escanea por tramos
+            truncate(change.firstLine);
+        } else {
+            // Las líneas reemplazadas reutilizan su entrada; el resto se inserta o borra
+            const size_t first = change.firstLine;
+            const size_t reused = std::min(change.removedLines, change.insertedLines);
+            for (size_t k = 0; k < reused; ++k) {
+                releaseLine(lineWords_[first + k]);
+                scanLine(first + k, lineWords_[first + k]);
+            }
+
+            auto tail = lineWords_.begin() + static_cast<std::ptrdiff_t>(first + reused);
+            if (change.removedLines > reused) {
+                auto end = tail + static_cast<std::ptrdiff_t>(change.removedLines - reused);
+                for (auto it = tail; it != end; ++it) releaseLine(*it);
+                lineWords_.erase(tail, end);
+            } else if (change.insertedLines > reused) {
+                lineWords_.insert(tail, change.insertedLines - reused, std::vector<uint32_t>());
+                for (size_t k = reused; k < change.insertedLines; ++k) {
+                    scanLine(first + k, lineWords_[first + k]);
+                }
+            }
+        }
+
+        const size_t deadWords = words_.size() - liveWords_;
+        if (deadWords > kCompactMinDeadWords && deadWords > liveWords_) {
+            compact();
+        }
+    }
+
+    void CompletionIndex::compact() {
+        // Renumerar solo las palabras vivas (las muertas se conservan para
+        // reutilizarlas mientras no dominen el índice)
+        const uint32_t removed = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> remap(words_.size(), removed);
+        std::deque<Word> live;
+        for (size_t id = 0; id < words_.size(); ++id) {
+            if (words_[id].count == 0) continue;
+            remap[id] = static_cast<uint32_t>(live.size());
+            live.push_back(std::move(words_[id]));
+        }
+        words_.swap(live);
+
+        ids_.clear();
+        ids_.reserve(words_.size());
+        for (size_t id = 0; id < words_.size(); ++id) {
+            ids_.emplace(std::string_view(words_[id].text), static_cast<uint32_t>(id));
+        }
+        for (auto& ids : lineWords_) {
+            for (uint32_t& id : ids) id = remap[id];
+        }
+        auto renumber = [&remap, removed](std::vector<uint32_t>& list) {
+            size_t kept = 0;
+            for (uint32_t id : list) {
+                if (remap[id] != removed) list[kept++] = remap[id];
+            }
+            list.resize(kept);
+        };
+        renumber(sorted_);
+        renumber(pending_);
+    }
+
+    // ========================================================================
+    // Consultas
+    // ========================================================================
+
+    bool CompletionIndex::wordLess(uint32_t a, uint32_t b) const {
+        int order = compareFolded(words_[a].text, words_[b].text);
+        return order != 0 ? order < 0 : words_[a].text < words_[b].text;
+    }
+
+    void CompletionIndex::mergePending() {
+        if (pending_.empty()) return;
+        auto less = [this](uint32_t a, uint32_t b) { return wordLess(a, b); };
+        std::sort(pending_.begin(), pending_.end(), less);
+
+        std::vector<uint32_t> merged;
+        merged.reserve(sorted_.size() + pending_.size());
+        std::merge(sorted_.begin(), sorted_.end(), pending_.begin(), pending_.end(), std::back_inserter(merged), less);
+        sorted_.swap(merged);
+        pending_.clear();
+    }
+
+    std::vector<std::string> CompletionIndex::complete(const std::string& prefix, size_t limit,
+                                                       bool excludeSingleExact) {
+        if (prefix.empty() || limit == 0) return {};
+
+        std::string folded(prefix);
+        std::transform(folded.begin(), folded.end(), folded.begin(), lowerByte);
+
+        std::vector<uint32_t> candidates;
+        auto consider = [&](uint32_t id) {
+            const Word& word = words_[id];
+            if (word.count == 0) return;
+            // La palabra que se está escribiendo aparece una vez y es el prefijo
+            if (excludeSingleExact && word.count == 1 && word.text == prefix) return;
+            candidates.push_back(id);
+        };
+
+        auto it = std::lower_bound(sorted_.begin(), sorted_.end(), folded, [this](uint32_t id, const std::string& key) {
+            return compareFolded(words_[id].text, key) < 0;
+        });
+        for (; it != sorted_.end() && startsWithFolded(words_[*it].text, folded); ++it) {
+            consider(*it);
+        }
+        for (uint32_t id : pending_) {
+            if (startsWithFolded(words_[id].text, folded)) consider(id);
+        }
+
+        auto better = [this](uint32_t a, uint32_t b) {
+            if (words_[a].count != words_[b].count) return words_[a].count > words_[b].count;
+            if (words_[a].text.length() != words_[b].text.length()) {
+                return words_[a].text.length() < words_[b].text.length();
+            }
+            return wordLess(a, b);
+        };
+        const size_t count = std::min(limit, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(count),
+                          candidates.end(), better);
+
+        std::vector<std::string> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            result.push_back(words_[candidates[i]].text);
+        }
+        return result;
+    }
+
+    size_t CompletionIndex::getMemoryUsage() const {
+        size_t bytes = sizeof(*this);
+        for (const Word& word : words_) {
+            bytes += sizeof(Word) + word.text.capacity();
+        }
+        // Nodos de la tabla: clave, valor y puntero al siguiente
+        bytes += ids_.bucket_count() * sizeof(void*) +
+                 ids_.size() * (sizeof(std::pair<const std::string_view, uint32_t>) + sizeof(void*));
+        bytes += (sorted_.capacity() + pending_.capacity()) * sizeof(uint32_t);
+        bytes += lineWords_.capacity() * sizeof(std::vector<uint32_t>);
+        for (const auto& ids : lineWords_) {
+            bytes += ids.capacity() * sizeof(uint32_t);
+        }
+        return bytes;
+    }
+
+} // namespace CoralCode
@@ -0,0 +1,294 @@
+/**
+ * @file CursorSet.cpp
+ * @brief Múltiples cursores y selección rectangular con edición en lote
+ */
+
+#include "CursorSet.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace CoralCode {
+
+    namespace {
+
+        bool positionLess(const CursorPosition& a, const CursorPosition& b) {
+            return a.line < b.line || (a.line == b.line && a.column < b.column);
+        }
+
+        bool isContinuationByte(char ch) {
+            return (static_cast<unsigned char>(ch) & 0xC0) == 0x80;
+        }
+
+    } // namespace
+
+    const CursorPosition& CursorRange::start() const {
+        return positionLess(head, anchor) ? head : anchor;
+    }
+
+    const CursorPosition& CursorRange::end() const {
+        return positionLess(head, anchor) ? anchor : head;
+    }
+
+    CursorSet::CursorSet() : ranges_(1), primary_(0) {}
+
+    // ========================================================================
+    // Gestión de cursores
+    // ========================================================================
+
+    void CursorSet::reset(const CursorPosition& position) {
+        reset(position, position);
+    }
+
+    void CursorSet::reset(const CursorPosition& anchor, const CursorPosition& head) {
+        ranges_.assign(1, CursorRange(anchor, head));
+        primary_ = 0;
+    }
+
+    void CursorSet::add(const CursorPosition& anchor, const CursorPosition& head) {
+        ranges_.emplace_back(anchor, head);
+        primary_ = ranges_.size() - 1;
+        normalize();
+    }
+
+    bool CursorSet::addAbove(const TextBuffer& buffer) {
+        const CursorPosition& top = ranges_.front().head;
+        if (top.line == 0) return false;
+        add(clampPosition(buffer, CursorPosition(top.line - 1, top.column)));
+        return true;
+    }
+
+    bool CursorSet::addBelow(const TextBuffer& buffer) {
+        const CursorPosition& bottom = ranges_.back().head;
+        if (bottom.line + 1 >= buffer.getLineCount()) return false;
+        add(clampPosition(buffer, CursorPosition(bottom.line + 1, bottom.column)));
+        return true;
+    }
+
+    void CursorSet::setColumnSelection(const TextBuffer& buffer, const CursorPosition& anchor,
+                                       const CursorPosition& head) {
+        // Un rango por línea entre las dos columnas; las líneas más cortas que
+        // el borde izquierdo se saltan (salvo la del anchor)
+        const size_t lastLine = buffer.getLineCount() - 1;
+        const size_t first = std::min(std::min(anchor.line, head.line), lastLine);
+        const size_t last = std::min(std::max(anchor.line, head.line), lastLine);
+        const size_t left = std::min(anchor.column, head.column);
+
+        ranges_.clear();
+        primary_ = 0;
+        for (size_t line = first; line <= last; ++line) {
+            const size_t length = buffer.getLineLength(line);
+            if (length < left && line != anchor.line) continue;
+            if (line == head.line) primary_ = ranges_.size();
+            ranges_.emplace_back(CursorPosition(line, std::min(anchor.column, length)),
+                                 CursorPosition(line, std::min(head.column, length)));
+        }
+        if (ranges_.empty()) {
+            ranges_.emplace_back(clampPosition(buffer, head));
+        }
+    }
+
+    void CursorSet::collapseToPrimary() {
+        CursorRange primary = ranges_[primary_];
+        ranges_.assign(1, primary);
+        primary_ = 0;
+    }
+
+    std::vector<std::string> CursorSet::getSelectedTexts(const TextBuffer& buffer) const {
+        std::vector<std::string> texts;
+        texts.reserve(ranges_.size());
+        for (const CursorRange& range : ranges_) {
+            texts.push_back(buffer.getText(range.start().line, range.start().column,
+                                           range.end().line, range.end().column));
+        }
+        return texts;
+    }
+
+    void CursorSet::normalize() {
+        // Ordenar por inicio y fusionar rangos que se solapan o cursores que
+        // coinciden/tocan otro rango; el primario sigue siendo el que contiene su head
+        const CursorPosition primaryHead = ranges_[primary_].head;
+        auto byStart = [](const CursorRange& a, const CursorRange& b) {
+            return positionLess(a.start(), b.start()) ||
+                   (a.start() == b.start() && positionLess(a.end(), b.end()));
+        };
+        if (!std::is_sorted(ranges_.begin(), ranges_.end(), byStart)) {
+            std::sort(ranges_.begin(), ranges_.end(), byStart);
+        }
+
+        size_t kept = 0;
+        for (size_t i = 1; i < ranges_.size(); ++i) {
+            CursorRange& last = ranges_[kept];
+            const CursorRange& next = ranges_[i];
+            const bool overlaps = positionLess(next.start(), last.end()) ||
+                                  (next.start() == last.end() && (next.isEmpty() || last.isEmpty()));
+            if (!overlaps) {
+                ranges_[++kept] = next;
+                continue;
+            }
+            CursorPosition start = last.start();
+            CursorPosition end = positionLess(last.end(), next.end()) ? next.end() : last.end();
+            last = positionLess(last.head, last.anchor) ? CursorRange(end, start) : CursorRange(start, end);
+        }
+        ranges_.resize(kept + 1);
+
+        primary_ = 0;
+        for (size_t i = 0; i < ranges_.size(); ++i) {
+            if (!positionLess(primaryHead, ranges_[i].start()) && !positionLess(ranges_[i].end(), primaryHead)) {
+                primary_ = i;
+                break;
+            }
+        }
+    }
+
+    // ========================================================================
+    // Edición en lote
+    // ========================================================================
+
+    std::vector<TextEdit> CursorSet::apply(TextBuffer& buffer, std::vector<TextEdit> edits) {
+        // Una edición por rango, en el mismo orden; las inversas indican dónde
+        // quedó el texto nuevo y por tanto dónde va cada cursor
+        std::vector<TextEdit> inverse = buffer.applyEdits(edits);
+        for (size_t i = 0; i < ranges_.size(); ++i) {
+            ranges_[i] = CursorRange(CursorPosition(inverse[i].endLine, inverse[i].endColumn));
+        }
+        normalize();
+        return inverse;
+    }
+
+    std::vector<TextEdit> CursorSet::insertText(TextBuffer& buffer, const std::string& text) {
+        std::vector<TextEdit> edits;
+        edits.reserve(ranges_.size());
+        for (const CursorRange& range : ranges_) {
+            edits.push_back(TextEdit{range.start().line, range.start().column,
+                                     range.end().line, range.end().column, text});
+        }
+        return apply(buffer, std::move(edits));
+    }
+
+    std::vector<TextEdit> CursorSet::insertTexts(TextBuffer& buffer, const std::vector<std::string>& texts) {
+        // Un texto por cursor (p. ej. pegar N líneas en N cursores); si no
+        // coinciden, todos reciben el texto completo
+        if (texts.size() != ranges_.size()) {
+            std::string joined;
+            for (size_t i = 0; i < texts.size(); ++i) {
+                if (i > 0) joined += '\n';
+                joined += texts[i];
+            }
+            return insertText(buffer, joined);
+        }
+
+        std::vector<TextEdit> edits;
+        edits.reserve(ranges_.size());
+        for (size_t i = 0; i < ranges_.size(); ++i) {
+            const CursorRange& range = ranges_[i];
+            edits.push_back(TextEdit{range.start().line, range.start().column,
+                                     range.end().line, range.end().column, texts[i]});
+        }
+        return apply(buffer, std::move(edits));
+    }
+
+    std::vector<TextEdit> CursorSet::deleteBackward(TextBuffer& buffer) {
+        std::vector<TextEdit> edits;
+        edits.reserve(ranges_.size());
+        for (const CursorRange& range : ranges_) {
+            CursorPosition start = range.isEmpty() ? stepBackward(buffer, range.head) : range.start();
+            edits.push_back(TextEdit{start.line, start.column, range.end().line, range.end().column, std::string()});
+        }
+        return apply(buffer, std::move(edits));
+    }
+
+    std::vector<TextEdit> CursorSet::deleteForward(TextBuffer& buffer) {
+        std::vector<TextEdit> edits;
+        edits.reserve(ranges_.size());
+        for (const CursorRange& range : ranges_) {
+            CursorPosition end = range.isEmpty() ? stepForward(buffer, range.head) : range.end();
+            edits.push_back(TextEdit{range.start().line, range.start().column, end.line, end.column, std::string()});
+        }
+        return apply(buffer, std::move(edits));
+    }
+
+    // ========================================================================
+    // Movimiento
+    // ========================================================================
+
+    void CursorSet::move(const TextBuffer& buffer, int deltaLine, int deltaCol, bool extend) {
+        for (CursorRange& range : ranges_) {
+            // Sin extender, una flecha lateral colapsa la selección hacia ese lado
+            if (!extend && !range.isEmpty() && deltaLine == 0 && deltaCol != 0) {
+                range = CursorRange(deltaCol < 0 ? range.start() : range.end());
+                continue;
+            }
+
+            CursorPosition head = range.head;
+            if (deltaLine != 0) {
+                const size_t lastLine = buffer.getLineCount() - 1;
+                if (deltaLine < 0) {
+                    head.line -= std::min(head.line, static_cast<size_t>(-static_cast<long>(deltaLine)));
+                } else {
+                    head.line = std::min(lastLine, head.line + static_cast<size_t>(deltaLine));
+                }
+                head = clampPosition(buffer, head);
+            }
+            for (int step = 0; step < std::abs(deltaCol); ++step) {
+                head = deltaCol < 0 ? stepBackward(buffer, head) : stepForward(buffer, head);
+            }
+            range = extend ? CursorRange(range.anchor, head) : CursorRange(head);
+        }
+        normalize();
+    }
+
+    void CursorSet::moveToLineStart(bool extend) {
+        for (CursorRange& range : ranges_) {
+            CursorPosition head(range.head.line, 0);
+            range = extend ? CursorRange(range.anchor, head) : CursorRange(head);
+        }
+        normalize();
+    }
+
+    void CursorSet::moveToLineEnd(const TextBuffer& buffer, bool extend) {
+        for (CursorRange& range : ranges_) {
+            CursorPosition head(range.head.line, buffer.getLineLength(range.head.line));
+            range = extend ? CursorRange(range.anchor, head) : CursorRange(head);
+        }
+        normalize();
+    }
+
+    void CursorSet::clamp(const TextBuffer& buffer) {
+        for (CursorRange& range : ranges_) {
+            range = CursorRange(clampPosition(buffer, range.anchor), clampPosition(buffer, range.head));
+        }
+        normalize();
+    }
+
+    // ========================================================================
+    // Utilidades
+    // ========================================================================
+
+    CursorPosition CursorSet::clampPosition(const TextBuffer& buffer, const CursorPosition& position) {
+        const size_t line = std::min(position.line, buffer.getLineCount() - 1);
+        return CursorPosition(line, std::min(position.column, buffer.getLineLength(line)));
+    }
+
+    CursorPosition CursorSet::stepBackward(const TextBuffer& buffer, const CursorPosition& position) {
+        if (position.column == 0) {
+            if (position.line == 0) return position;
+            return CursorPosition(position.line - 1, buffer.getLineLength(position.line - 1));
+        }
+        const std::string& line = buffer.getLine(position.line);
+        size_t column = std::min(position.column, line.length()) - 1;
+        while (column > 0 && isContinuationByte(line[column])) --column;
+        return CursorPosition(position.line, column);
+    }
+
+    CursorPosition CursorSet::stepForward(const TextBuffer& buffer, const CursorPosition& position) {
+        const std::string& line = buffer.getLine(position.line);
+        if (position.column >= line.length()) {
+            if (position.line + 1 >= buffer.getLineCount()) return position;
+            return CursorPosition(position.line + 1, 0);
+        }
+        size_t column = position.column + 1;
+        while (column < line.length() && isContinuationByte(line[column])) ++column;
+        return CursorPosition(position.line, column);
+    }
+
+} // namespace CoralCode
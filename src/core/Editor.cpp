@@ -0,0 +1,921 @@
+/**
+ * @file Editor.cpp
+ * @brief Orquestación del editor: configuración, highlighting y subsistemas
+ */
+
+#include "Editor.hpp"
+#include "IncrementalParser.hpp"
+#include "SearchEngine.hpp"
+#include "RegexEngine.hpp"
+#include "SearchMatchIndex.hpp"
+#include "CompletionIndex.hpp"
+#include "CursorSet.hpp"
+#include "ProjectSearch.hpp"
+#include "FileIndex.hpp"
+#include "FileWatcher.hpp"
+#include "UndoRedoManager.hpp"
+#include "ClipboardManager.hpp"
+#include "WrapIndex.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+
+namespace CoralCode {
+
+    namespace {
+
+        /**
+         * @brief Posición tras aplicar ediciones ordenadas
+         *
+         * inverse son las ediciones que devolvió applyEdits: sus rangos ya
+         * están en el texto nuevo. Una posición dentro de un texto
+         * reemplazado pasa al principio del nuevo.
+         */
+        CursorPosition mapThroughEdits(const CursorPosition& position, const std::vector<TextEdit>& edits,
+                                       const std::vector<TextEdit>& inverse) {
+            auto next = std::upper_bound(edits.begin(), edits.end(), position,
+                                         [](const CursorPosition& target, const TextEdit& edit) {
+                                             return target.line < edit.line ||
+                                                    (target.line == edit.line && target.column < edit.column);
+                                         });
+            if (next == edits.begin()) return position;
+
+            const size_t index = static_cast<size_t>(next - edits.begin()) - 1;
+            const TextEdit& edit = edits[index];
+            const TextEdit& result = inverse[index];
+            if (position.line < edit.endLine || (position.line == edit.endLine && position.column < edit.endColumn)) {
+                return CursorPosition(result.line, result.column);
+            }
+            if (position.line == edit.endLine) {
+                return CursorPosition(result.endLine, result.endColumn + position.column - edit.endColumn);
+            }
+            return CursorPosition(position.line - edit.endLine + result.endLine, position.column);
+        }
+
+    } // namespace
+
+    // ========================================================================
+    // Configuración
+    // ========================================================================
+
+    void Editor::setLanguage(const std::string& language) {
+        syntaxHighlighter_->setLanguage(language);
+        if (incrementalParser_) {
+            incrementalParser_->invalidate();
+        }
+    }
+
+    void Editor::setTabSize(size_t size) {
+        tabSize_ = std::max<size_t>(1, size);
+        viewport_->setTabSize(tabSize_);
+    }
+
+    void Editor::setGlyphAdvanceProvider(TextLayout::GlyphAdvanceFunction provider) {
+        viewport_->setGlyphAdvanceProvider(std::move(provider));
+    }
+
+    // ========================================================================
+    // Análisis incremental
+    // ========================================================================
+
+    void Editor::setIncrementalParsing(bool enabled) {
+        if (!enabled) {
+            incrementalParser_.reset();
+            return;
+        }
+        if (!incrementalParser_) {
+            incrementalParser_ = std::make_unique<IncrementalParser>(*syntaxHighlighter_);
+            incrementalParser_->attach(*textBuffer_);
+        }
+    }
+
+    IncrementalParser* Editor::getIncrementalParser() const {
+        return incrementalParser_.get();
+    }
+
+    std::vector<std::pair<std::string, TokenColor>> Editor::getHighlightedLine(size_t line) const {
+        if (incrementalParser_) {
+            // Solo re-analiza la región editada desde el último frame
+            if (incrementalParser_->needsReparse()) {
+                incrementalParser_->reparse();
+            }
+            return syntaxHighlighter_->highlightTokens(incrementalParser_->getLineTokens(line));
+        }
+        return syntaxHighlighter_->highlightLine(textBuffer_->getLine(line));
+    }
+
+    // ========================================================================
+    // Ajuste de línea
+    // ========================================================================
+
+    void Editor::setWordWrap(bool enabled) {
+        wordWrap_ = enabled;
+        if (!enabled) {
+            wrapIndex_.reset();
+            return;
+        }
+        if (!wrapIndex_) {
+            // La medida se hace en la primera consulta, no aquí
+            wrapIndex_ = std::make_unique<WrapIndex>();
+            wrapIndex_->attach(*textBuffer_, viewport_->getTextLayout());
+            wrapIndex_->setWrapWidth(viewport_->getTextAreaWidth());
+        }
+    }
+
+    WrapIndex* Editor::getWrapIndex() const {
+        return wrapIndex_.get();
+    }
+
+    size_t Editor::getVisualLineCount() const {
+        return wrapIndex_ ? wrapIndex_->getVisualLineCount() : textBuffer_->getLineCount();
+    }
+
+    size_t Editor::getFirstVisualRow() const {
+        const size_t line = viewport_->getScrollLine();
+        return wrapIndex_ ? wrapIndex_->visualRowOfLine(line) : line;
+    }
+
+    void Editor::scrollToVisualRow(size_t row) {
+        // El viewport hace scroll por líneas lógicas: se queda con la línea
+        // que contiene la fila
+        viewport_->scrollToLine(wrapIndex_ ? wrapIndex_->lineAtVisualRow(row).line : row);
+    }
+
+    void Editor::onWindowResized(size_t width, size_t height) {
+        viewport_->setWindowSize(width, height);
+        if (wrapIndex_) {
+            // Solo marca el índice: se vuelve a medir al consultarlo
+            wrapIndex_->setWrapWidth(viewport_->getTextAreaWidth());
+        }
+    }
+
+    // ========================================================================
+    // Undo/Redo
+    // ========================================================================
+
+    void Editor::undo() {
+        if (undoRedoManager_ && undoRedoManager_->undo(*textBuffer_, cursor_)) {
+            selection_.clear();
+            if (cursors_) cursors_->reset(cursor_);
+            validateCursorPosition();
+            ensureCursorVisible();
+            markAsModified();
+        }
+    }
+
+    void Editor::redo() {
+        if (undoRedoManager_ && undoRedoManager_->redo(*textBuffer_, cursor_)) {
+            selection_.clear();
+            if (cursors_) cursors_->reset(cursor_);
+            validateCursorPosition();
+            ensureCursorVisible();
+            markAsModified();
+        }
+    }
+
+    // ========================================================================
+    // Múltiples cursores
+    // ========================================================================
+
+    CursorSet& Editor::beginMultiCursor() {
+        // Con un solo cursor el estado vive en cursor_/selection_; se copia al
+        // conjunto antes de cada operación
+        if (!cursors_) {
+            cursors_ = std::make_unique<CursorSet>();
+        }
+        if (!cursors_->isMulti()) {
+            CursorPosition anchor = cursor_;
+            if (selection_.hasSelection()) {
+                anchor = selection_.start == cursor_ ? selection_.end : selection_.start;
+            }
+            cursors_->reset(anchor, cursor_);
+        }
+        return *cursors_;
+    }
+
+    void Editor::syncPrimaryCursor() {
+        const CursorRange& primary = cursors_->getPrimary();
+        cursor_ = primary.head;
+        if (primary.isEmpty()) {
+            selection_.clear();
+        } else {
+            selection_ = TextSelection(primary.anchor, primary.head);
+        }
+        ensureCursorVisible();
+    }
+
+    void Editor::commitCursorEdit(std::vector<TextEdit> inverse, const CursorPosition& cursorBefore,
+                                  OperationType operation, const std::string& description) {
+        if (undoRedoManager_) {
+            undoRedoManager_->recordEdits(std::move(inverse), cursorBefore, operation, description);
+        }
+        syncPrimaryCursor();
+        markAsModified();
+    }
+
+    void Editor::addCursor(const CursorPosition& position) {
+        auto [line, column] = textBuffer_->clampPosition(position.line, position.column);
+        beginMultiCursor().add(CursorPosition(line, column));
+        syncPrimaryCursor();
+    }
+
+    bool Editor::addCursorAbove() {
+        if (!beginMultiCursor().addAbove(*textBuffer_)) return false;
+        syncPrimaryCursor();
+        return true;
+    }
+
+    bool Editor::addCursorBelow() {
+        if (!beginMultiCursor().addBelow(*textBuffer_)) return false;
+        syncPrimaryCursor();
+        return true;
+    }
+
+    bool Editor::addCursorAtNextOccurrence() {
+        CursorSet& cursors = beginMultiCursor();
+        const CursorRange primary = cursors.getPrimary();
+
+        // Sin selección: seleccionar la palabra bajo el cursor
+        if (primary.isEmpty()) {
+            const std::string& line = textBuffer_->getLine(primary.head.line);
+            size_t start = std::min(primary.head.column, line.length());
+            size_t end = start;
+            while (start > 0 && isWordCharacter(line[start - 1])) --start;
+            while (end < line.length() && isWordCharacter(line[end])) ++end;
+            if (start == end) return false;
+            cursors.reset(CursorPosition(primary.head.line, start), CursorPosition(primary.head.line, end));
+            syncPrimaryCursor();
+            return true;
+        }
+
+        const std::string text = textBuffer_->getText(primary.start().line, primary.start().column,
+                                                      primary.end().line, primary.end().column);
+        CursorPosition found = findInText(text, primary.end(), true, false);
+        if (found.line == SearchEngine::npos) return false;
+
+        CursorPosition end = found;
+        size_t newline = text.rfind('\n');
+        if (newline == std::string::npos) {
+            end.column += text.length();
+        } else {
+            end.line += static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+            end.column = text.length() - newline - 1;
+        }
+
+        // Todas las apariciones ya tienen cursor (la búsqueda dio la vuelta)
+        for (const CursorRange& range : cursors.getRanges()) {
+            if (range.start() == found) return false;
+        }
+        cursors.add(found, end);
+        syncPrimaryCursor();
+        return true;
+    }
+
+    void Editor::setColumnSelection(const CursorPosition& anchor, const CursorPosition& head) {
+        beginMultiCursor().setColumnSelection(*textBuffer_, anchor, head);
+        syncPrimaryCursor();
+    }
+
+    void Editor::clearSecondaryCursors() {
+        if (cursors_ && cursors_->isMulti()) {
+            cursors_->collapseToPrimary();
+            syncPrimaryCursor();
+        }
+    }
+
+    size_t Editor::getCursorCount() const {
+        return cursors_ && cursors_->isMulti() ? cursors_->size() : 1;
+    }
+
+    std::vector<TextSelection> Editor::getCursorSelections() const {
+        if (!cursors_ || !cursors_->isMulti()) {
+            return {selection_.hasSelection() ? selection_ : TextSelection(cursor_, cursor_)};
+        }
+        std::vector<TextSelection> selections;
+        selections.reserve(cursors_->size());
+        for (const CursorRange& range : cursors_->getRanges()) {
+            selections.emplace_back(range.anchor, range.head);
+        }
+        return selections;
+    }
+
+    void Editor::typeAtCursors(const std::string& text) {
+        const CursorPosition before = cursor_;
+        std::vector<TextEdit> inverse = beginMultiCursor().insertText(*textBuffer_, text);
+        commitCursorEdit(std::move(inverse), before, OperationType::Insert, "Escribir");
+    }
+
+    void Editor::deleteAtCursors(bool forward) {
+        const CursorPosition before = cursor_;
+        CursorSet& cursors = beginMultiCursor();
+        std::vector<TextEdit> inverse = forward ? cursors.deleteForward(*textBuffer_)
+                                                : cursors.deleteBackward(*textBuffer_);
+        commitCursorEdit(std::move(inverse), before, OperationType::Delete, "Borrar");
+    }
+
+    void Editor::moveCursors(int deltaLine, int deltaCol, bool extend) {
+        beginMultiCursor().move(*textBuffer_, deltaLine, deltaCol, extend);
+        syncPrimaryCursor();
+    }
+
+    // ========================================================================
+    // Búsqueda
+    // ========================================================================
+
+    bool Editor::find(const std::string& text, bool caseSensitive, bool wholeWord) {
+        if (!prepareSearch(text, caseSensitive, wholeWord)) return false;
+
+        // La primera búsqueda incluye la posición actual del cursor
+        if (selection_.hasSelection()) {
+            cursor_ = selection_.getOrderedBounds().first;
+        }
+        return findNext();
+    }
+
+    bool Editor::findNext() {
+        SearchMatch match{};
+        if (!findMatch(cursor_, true, match)) return false;
+
+        // Una coincidencia vacía en el cursor no avanza: buscar desde el siguiente byte
+        if (match.line == match.endLine && match.column == match.endColumn &&
+            CursorPosition(match.line, match.column) == lastSearchPosition_ && selection_.active) {
+            CursorPosition from = cursor_;
+            if (from.column < textBuffer_->getLineLength(from.line)) {
+                ++from.column;
+            } else if (from.line + 1 < textBuffer_->getLineCount()) {
+                from = CursorPosition(from.line + 1, 0);
+            } else {
+                from = CursorPosition(0, 0);
+            }
+            if (!findMatch(from, true, match)) return false;
+        }
+
+        selectSearchMatch(match);
+        return true;
+    }
+
+    bool Editor::findPrevious() {
+        CursorPosition from = selection_.hasSelection() ? selection_.getOrderedBounds().first : cursor_;
+        SearchMatch match{};
+        if (!findMatch(from, false, match)) return false;
+        selectSearchMatch(match);
+        return true;
+    }
+
+    void Editor::replace(const std::string& oldText, const std::string& newText) {
+        const bool ready = regexSearch_ ? regexEngine_ && regexEngine_->isValid() : searchEngine_ != nullptr;
+        if ((oldText != lastSearchText_ || !ready) &&
+            !prepareSearch(oldText, lastSearchCaseSensitive_, lastSearchWholeWord_)) {
+            return;
+        }
+
+        // Solo se reemplaza si la selección es exactamente una coincidencia
+        if (selection_.hasSelection()) {
+            auto [start, end] = selection_.getOrderedBounds();
+            SearchMatch match{};
+            std::string replacement;
+            if (matchAt(start, match, replacement, newText) &&
+                match.endLine == end.line && match.endColumn == end.column) {
+                saveState();
+                textBuffer_->replaceRange(start.line, start.column, end.line, end.column, replacement);
+
+                size_t newlines = static_cast<size_t>(std::count(replacement.begin(), replacement.end(), '\n'));
+                size_t lastBreak = replacement.rfind('\n');
+                cursor_ = newlines == 0
+                    ? CursorPosition(start.line, start.column + replacement.length())
+                    : CursorPosition(start.line + newlines, replacement.length() - lastBreak - 1);
+                selection_.clear();
+                markAsModified();
+            }
+        }
+        findNext();
+    }
+
+    size_t Editor::replaceAll(const std::string& oldText, const std::string& newText,
+                              const ProgressCallback& onProgress) {
+        const bool ready = regexSearch_ ? regexEngine_ && regexEngine_->isValid() : searchEngine_ != nullptr;
+        if (oldText != lastSearchText_ || !ready) {
+            if (!prepareSearch(oldText, lastSearchCaseSensitive_, lastSearchWholeWord_)) return 0;
+        } else {
+            searchCancelled_.store(false, std::memory_order_relaxed);
+        }
+
+        const size_t lineCount = textBuffer_->getLineCount();
+        auto report = [&](size_t line) {
+            if (onProgress) onProgress(static_cast<double>(line) / static_cast<double>(lineCount));
+        };
+
+        // Recolectar primero (las expansiones leen el texto original) y
+        // aplicar todo en una sola reconstrucción del buffer
+        std::vector<TextEdit> edits;
+        auto addEdit = [&edits](const SearchMatch& range, std::string text) {
+            if (!edits.empty()) {
+                const TextEdit& last = edits.back();
+                bool overlaps = range.line < last.endLine ||
+                                (range.line == last.endLine && range.column < last.endColumn);
+                bool emptyAtLastEnd = range.line == last.endLine && range.column == last.endColumn &&
+                                      range.endLine == range.line && range.endColumn == range.column;
+                if (overlaps || emptyAtLastEnd) return;
+            }
+            edits.push_back(TextEdit{range.line, range.column, range.endLine, range.endColumn, std::move(text)});
+        };
+
+        if (!regexSearch_ && matchIndex_->isComplete()) {
+            // El índice ya tiene todas las coincidencias: no hace falta recorrer
+            edits.reserve(matchIndex_->getMatchCount());
+            for (size_t i = 0; i < matchIndex_->getMatchCount(); ++i) {
+                addEdit(matchIndex_->getMatch(i), newText);
+            }
+        } else {
+            // Por tramos de líneas: progreso y cancelación entre tramos
+            size_t line = 0;
+            size_t col = 0;
+            while (line < lineCount) {
+                const size_t lastStartLine = std::min(line + REPLACE_CHUNK_LINES, lineCount) - 1;
+                if (regexSearch_) {
+                    SearchControl control;
+                    control.cancel = &searchCancelled_;
+                    control.endLine = lastStartLine;
+                    SearchStatus status = regexEngine_->search(*textBuffer_, line, col, [&](const RegexMatch& match) {
+                        addEdit(match.range, regexEngine_->expandReplacement(newText, match, *textBuffer_));
+                        return true;
+                    }, control);
+                    if (status == SearchStatus::Cancelled) return 0;
+                } else {
+                    SearchMatch match{};
+                    size_t matchLine = line;
+                    size_t matchCol = col;
+                    while (searchEngine_->findForward(*textBuffer_, matchLine, matchCol, match, lastStartLine)) {
+                        addEdit(match, newText);
+                        matchLine = match.endLine;
+                        matchCol = match.endColumn;
+                    }
+                }
+
+                // El siguiente tramo empieza tras la última coincidencia si esta lo invade
+                line = lastStartLine + 1;
+                col = 0;
+                if (!edits.empty() && (edits.back().endLine > line ||
+                                       (edits.back().endLine == line && edits.back().endColumn > 0))) {
+                    line = edits.back().endLine;
+                    col = edits.back().endColumn;
+                }
+                report(std::min(line, lineCount));
+                if (searchCancelled_.load(std::memory_order_relaxed)) return 0;
+            }
+        }
+        if (edits.empty()) return 0;
+
+        // Un único paso de undo con solo el texto reemplazado
+        CursorPosition cursorBefore = cursor_;
+        std::vector<TextEdit> inverse = textBuffer_->applyEdits(edits);
+
+        // El cursor sigue al texto que tenía al lado; los secundarios se descartan
+        cursor_ = mapThroughEdits(cursor_, edits, inverse);
+        selection_.clear();
+        validateCursorPosition();
+        if (cursors_) cursors_->reset(cursor_);
+
+        if (undoRedoManager_) {
+            undoRedoManager_->recordEdits(std::move(inverse), cursorBefore, OperationType::Replace,
+                                          "Reemplazar todo");
+        }
+        markAsModified();
+        report(lineCount);
+        return edits.size();
+    }
+
+    void Editor::setRegexSearch(bool enabled) {
+        if (regexSearch_ == enabled) return;
+        regexSearch_ = enabled;
+        if (!lastSearchText_.empty()) {
+            prepareSearch(lastSearchText_, lastSearchCaseSensitive_, lastSearchWholeWord_);
+        }
+    }
+
+    bool Editor::isRegexSearch() const {
+        return regexSearch_;
+    }
+
+    std::string Editor::getSearchError() const {
+        return searchError_;
+    }
+
+    void Editor::cancelSearch() {
+        searchCancelled_.store(true, std::memory_order_relaxed);
+    }
+
+    size_t Editor::updateSearchIndex(size_t maxLines) {
+        return matchIndex_ ? matchIndex_->scanStep(maxLines) : 0;
+    }
+
+    bool Editor::isSearchIndexComplete() const {
+        return !matchIndex_ || matchIndex_->isComplete();
+    }
+
+    size_t Editor::getSearchMatchCount() const {
+        return matchIndex_ ? matchIndex_->getMatchCount() : 0;
+    }
+
+    size_t Editor::getCurrentMatchNumber() const {
+        // 1-based para la barra de estado; 0 si la selección no es una coincidencia
+        if (!matchIndex_ || !selection_.active) return 0;
+        size_t index = matchIndex_->indexOf(lastSearchPosition_.line, lastSearchPosition_.column);
+        return index == SearchMatchIndex::npos ? 0 : index + 1;
+    }
+
+    std::vector<SearchMatch> Editor::getVisibleSearchMatches() const {
+        if (!matchIndex_) return {};
+        return matchIndex_->getMatchesInLines(viewport_->getFirstVisibleLine(),
+                                              viewport_->getLastVisibleLine(textBuffer_->getLineCount()));
+    }
+
+    // ========================================================================
+    // Autocompletado
+    // ========================================================================
+
+    size_t Editor::updateCompletionIndex(size_t maxLines) {
+        if (!completionIndex_) {
+            completionIndex_ = std::make_unique<CompletionIndex>();
+            completionIndex_->attach(*textBuffer_);
+        }
+        return completionIndex_->indexStep(maxLines);
+    }
+
+    std::string Editor::getCompletionPrefix() const {
+        // Parte del identificador a la izquierda del cursor
+        const std::string& line = textBuffer_->getLine(cursor_.line);
+        size_t end = std::min(cursor_.column, line.length());
+        size_t start = end;
+        while (start > 0 && CompletionIndex::isWordByte(line[start - 1])) --start;
+        if (start < end && std::isdigit(static_cast<unsigned char>(line[start]))) return std::string();
+        return line.substr(start, end - start);
+    }
+
+    std::vector<std::string> Editor::getCompletions(size_t limit) {
+        // Hasta que el índice cubre el documento se sugiere lo ya indexado
+        std::string prefix = getCompletionPrefix();
+        if (prefix.empty() || !completionIndex_) return {};
+        return completionIndex_->complete(prefix, limit);
+    }
+
+    size_t Editor::getCompletionIndexMemory() const {
+        return completionIndex_ ? completionIndex_->getMemoryUsage() : 0;
+    }
+
+    // ========================================================================
+    // Búsqueda en archivos
+    // ========================================================================
+
+    bool Editor::findInFiles(const std::string& root, const std::string& text,
+                             bool caseSensitive, bool wholeWord) {
+        if (!projectSearch_) {
+            projectSearch_ = std::make_unique<ProjectSearch>();
+        }
+        projectResults_.clear();
+
+        ProjectSearchOptions options;
+        options.caseSensitive = caseSensitive;
+        options.wholeWord = wholeWord;
+        options.regex = regexSearch_;
+        if (!projectSearch_->start(root, text, options)) {
+            searchError_ = projectSearch_->getLastError();
+            return false;
+        }
+        searchError_.clear();
+        return true;
+    }
+
+    size_t Editor::updateProjectSearch() {
+        if (!projectSearch_) return 0;
+        std::vector<ProjectSearchResult> results = projectSearch_->takeResults();
+        projectResults_.insert(projectResults_.end(), std::make_move_iterator(results.begin()),
+                               std::make_move_iterator(results.end()));
+        return results.size();
+    }
+
+    bool Editor::isProjectSearchRunning() const {
+        return projectSearch_ && projectSearch_->isRunning();
+    }
+
+    void Editor::cancelProjectSearch() {
+        if (projectSearch_) {
+            projectSearch_->cancel();
+        }
+    }
+
+    const std::vector<ProjectSearchResult>& Editor::getProjectSearchResults() const {
+        return projectResults_;
+    }
+
+    bool Editor::openProjectSearchResult(size_t index) {
+        if (index >= projectResults_.size()) return false;
+
+        const ProjectSearchResult& result = projectResults_[index];
+        if (result.path != currentFilePath_ && !openFile(result.path)) return false;
+
+        // El archivo pudo cambiar desde la búsqueda: ajustar al contenido actual
+        auto [line, column] = textBuffer_->clampPosition(result.range.line, result.range.column);
+        auto [endLine, endColumn] = textBuffer_->clampPosition(result.range.endLine, result.range.endColumn);
+        selectSearchMatch(SearchMatch{line, column, endLine, endColumn});
+        return true;
+    }
+
+    // ========================================================================
+    // Espacio de trabajo y apertura rápida
+    // ========================================================================
+
+    bool Editor::openWorkspace(const std::string& root) {
+        std::error_code error;
+        if (!std::filesystem::is_directory(root, error)) {
+            searchError_ = "No es un directorio: " + root;
+            return false;
+        }
+        closeWorkspace();
+        workspaceRoot_ = root;
+        indexCancelled_.store(false, std::memory_order_relaxed);
+
+        // El observador arranca antes que el índice: los eventos ocurridos
+        // durante la construcción se aplican cuando el índice esté listo
+        fileWatcher_ = std::make_unique<FileWatcher>();
+        fileWatcher_->start(root);
+
+        pendingIndex_ = TaskScheduler::shared().async("workspace-index", TaskPriority::Background,
+                                                      [root, this](const CancellationToken&) {
+            auto index = std::make_unique<FileIndex>();
+            if (index->load(FileIndex::defaultIndexPath(root)) && index->getRoot() == root) {
+                if (index->reconcile(&indexCancelled_)) return index;
+            }
+            if (!index->build(root, WalkOptions(), &indexCancelled_)) return std::unique_ptr<FileIndex>();
+            return index;
+        });
+        return true;
+    }
+
+    void Editor::closeWorkspace() {
+        if (pendingIndex_.valid()) {
+            indexCancelled_.store(true, std::memory_order_relaxed);
+            pendingIndex_.wait();
+            pendingIndex_ = {};
+        }
+        fileWatcher_.reset();
+        if (fileIndex_) {
+            fileIndex_->save(FileIndex::defaultIndexPath(workspaceRoot_));
+            fileIndex_.reset();
+        }
+        workspaceRoot_.clear();
+    }
+
+    size_t Editor::updateWorkspace() {
+        if (pendingIndex_.valid() &&
+            pendingIndex_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            std::unique_ptr<FileIndex> index = pendingIndex_.get();
+            if (index) fileIndex_ = std::move(index);
+        }
+        if (!fileIndex_ || !fileWatcher_ || pendingIndex_.valid()) return 0;
+
+        // Sin observador (plataforma sin soporte) el índice solo se actualiza
+        // al reabrir el espacio de trabajo
+        std::vector<FileEvent> events = fileWatcher_->poll();
+        if (events.empty()) return 0;
+        if (!fileIndex_->applyEvents(events)) {
+            // Se perdieron eventos: reconstruir en segundo plano con el índice
+            // actual todavía disponible para consultas
+            const std::string root = workspaceRoot_;
+            const WalkOptions options = fileIndex_->getWalkOptions();
+            pendingIndex_ = TaskScheduler::shared().async("workspace-index", TaskPriority::Background,
+                                                          [root, options, this](const CancellationToken&) {
+                auto index = std::make_unique<FileIndex>();
+                if (!index->build(root, options, &indexCancelled_)) return std::unique_ptr<FileIndex>();
+                return index;
+            });
+        }
+        return events.size();
+    }
+
+    bool Editor::isWorkspaceIndexReady() const {
+        return fileIndex_ != nullptr;
+    }
+
+    std::vector<FileMatch> Editor::quickOpen(const std::string& query, size_t limit) {
+        if (!fileIndex_) return {};
+        return fileIndex_->query(query, limit);
+    }
+
+    bool Editor::openQuickOpenResult(const FileMatch& match) {
+        if (workspaceRoot_.empty()) return false;
+        return openFile((std::filesystem::path(workspaceRoot_) / match.path).string());
+    }
+
+    // ========================================================================
+    // Trabajo en segundo plano
+    // ========================================================================
+
+    CancellationToken Editor::createBufferToken() {
+        if (!bufferVersion_) {
+            // Los workers no pueden leer el TextBuffer: la versión se publica
+            // en un atómico compartido desde el listener de cambios
+            bufferVersion_ = std::make_shared<std::atomic<uint64_t>>(textBuffer_->getVersion());
+            const TextBuffer* buffer = textBuffer_.get();
+            textBuffer_->addChangeListener([version = bufferVersion_, buffer](const TextChange&) noexcept {
+                version->store(buffer->getVersion(), std::memory_order_release);
+            });
+        }
+        return CancellationToken::forVersion(bufferVersion_, bufferVersion_->load(std::memory_order_relaxed));
+    }
+
+    std::vector<TaskStats> Editor::getTaskStats() const {
+        return TaskScheduler::shared().getStats();
+    }
+
+    // ========================================================================
+    // Perfilador de frames
+    // ========================================================================
+
+    void Editor::setProfiling(bool enabled) {
+        frameProfiler_.setEnabled(enabled);
+        if (!enabled) profilerOverlay_ = false;
+    }
+
+    bool Editor::isProfiling() const {
+        return frameProfiler_.isEnabled();
+    }
+
+    void Editor::toggleProfilerOverlay() {
+        profilerOverlay_ = !profilerOverlay_;
+        // Mostrar el overlay sin datos no sirve: lo activa si hace falta
+        if (profilerOverlay_) frameProfiler_.setEnabled(true);
+    }
+
+    bool Editor::isProfilerOverlayVisible() const {
+        return profilerOverlay_;
+    }
+
+    FrameProfiler& Editor::getFrameProfiler() {
+        return frameProfiler_;
+    }
+
+    const FrameProfiler& Editor::getFrameProfiler() const {
+        return frameProfiler_;
+    }
+
+    // ========================================================================
+    // Memoria
+    // ========================================================================
+
+    MemoryUsage Editor::getMemoryUsage() const {
+        if (memoryCacheVersion_ != textBuffer_->getVersion()) {
+            memoryCache_[MemorySubsystem::Buffer] = textBuffer_->getMemoryUsage();
+            memoryCache_[MemorySubsystem::LineIndex] = textBuffer_->getLineIndexMemory();
+            memoryCache_[MemorySubsystem::TokenCache] = incrementalParser_ ? incrementalParser_->getMemoryUsage() : 0;
+            memoryCacheVersion_ = textBuffer_->getVersion();
+        }
+
+        MemoryUsage usage = memoryCache_;
+        usage[MemorySubsystem::UndoHistory] = undoRedoManager_ ? undoRedoManager_->getMemoryUsage() : 0;
+        usage[MemorySubsystem::GlyphAtlas] = glyphAtlasBytes_;
+        usage[MemorySubsystem::SearchIndex] = matchIndex_ ? matchIndex_->getMemoryUsage() : 0;
+        usage[MemorySubsystem::ClipboardHistory] = clipboardManager_ ? clipboardManager_->getMemoryUsage() : 0;
+        usage[MemorySubsystem::CompletionIndex] = completionIndex_ ? completionIndex_->getMemoryUsage() : 0;
+        usage[MemorySubsystem::FileIndex] = fileIndex_ ? fileIndex_->getMemoryUsage() : 0;
+        return usage;
+    }
+
+    std::string Editor::getMemoryStatus() const {
+        return getMemoryUsage().formatStatus();
+    }
+
+    void Editor::setGlyphAtlasMemory(size_t bytes) {
+        glyphAtlasBytes_ = bytes;
+    }
+
+    bool Editor::prepareSearch(const std::string& text, bool caseSensitive, bool wholeWord) {
+        lastSearchText_ = text;
+        lastSearchCaseSensitive_ = caseSensitive;
+        lastSearchWholeWord_ = wholeWord;
+        searchError_.clear();
+        searchCancelled_.store(false, std::memory_order_relaxed);
+
+        if (!matchIndex_) {
+            matchIndex_ = std::make_unique<SearchMatchIndex>();
+            matchIndex_->attach(*textBuffer_);
+        }
+        matchIndex_->clear();
+
+        if (text.empty()) return false;
+
+        if (regexSearch_) {
+            if (!regexEngine_) {
+                regexEngine_ = std::make_unique<RegexEngine>();
+            }
+            std::string pattern = wholeWord ? "\\b(?:" + text + ")\\b" : text;
+            if (!regexEngine_->compile(pattern, caseSensitive)) {
+                searchError_ = regexEngine_->getLastError();
+                return false;
+            }
+            matchIndex_->setSearch(nullptr, regexEngine_.get());
+            return true;
+        }
+
+        if (!searchEngine_) {
+            searchEngine_ = std::make_unique<SearchEngine>();
+        }
+        searchEngine_->setPattern(text, caseSensitive, wholeWord);
+        matchIndex_->setSearch(searchEngine_.get(), nullptr);
+        return true;
+    }
+
+    bool Editor::findMatch(const CursorPosition& from, bool forward, SearchMatch& match) const {
+        const size_t npos = SearchEngine::npos;
+
+        // Con el índice completo, siguiente/anterior es una búsqueda binaria
+        if (matchIndex_ && matchIndex_->isComplete() && !lastSearchText_.empty()) {
+            size_t count = matchIndex_->getMatchCount();
+            if (count == 0) return false;
+            size_t index = forward ? matchIndex_->findNextIndex(from.line, from.column)
+                                   : matchIndex_->findPreviousIndex(from.line, from.column);
+            if (index == npos) {
+                index = forward ? 0 : count - 1;
+            }
+            match = matchIndex_->getMatch(index);
+            return true;
+        }
+
+        if (regexSearch_) {
+            if (!regexEngine_ || !regexEngine_->isValid()) return false;
+            RegexMatch found;
+            bool ok = forward
+                ? regexEngine_->findForward(*textBuffer_, from.line, from.column, found, &searchCancelled_) ||
+                  regexEngine_->findForward(*textBuffer_, 0, 0, found, &searchCancelled_)
+                : regexEngine_->findBackward(*textBuffer_, from.line, from.column, found, &searchCancelled_) ||
+                  regexEngine_->findBackward(*textBuffer_, npos, npos, found, &searchCancelled_);
+            if (ok) match = found.range;
+            return ok;
+        }
+
+        if (!searchEngine_ || searchEngine_->isEmpty()) return false;
+        return forward
+            ? searchEngine_->findForward(*textBuffer_, from.line, from.column, match) ||
+              searchEngine_->findForward(*textBuffer_, 0, 0, match)
+            : searchEngine_->findBackward(*textBuffer_, from.line, from.column, match) ||
+              searchEngine_->findBackward(*textBuffer_, npos, npos, match);
+    }
+
+    bool Editor::matchAt(const CursorPosition& start, SearchMatch& match, std::string& replacement,
+                         const std::string& newText) const {
+        if (regexSearch_) {
+            RegexMatch found;
+            if (!regexEngine_ || !regexEngine_->findForward(*textBuffer_, start.line, start.column, found)) {
+                return false;
+            }
+            match = found.range;
+            replacement = regexEngine_->expandReplacement(newText, found, *textBuffer_);
+        } else {
+            if (!searchEngine_ || !searchEngine_->findForward(*textBuffer_, start.line, start.column, match)) {
+                return false;
+            }
+            replacement = newText;
+        }
+        return match.line == start.line && match.column == start.column;
+    }
+
+    void Editor::selectSearchMatch(const SearchMatch& match) {
+        CursorPosition start(match.line, match.column);
+        CursorPosition end(match.endLine, match.endColumn);
+
+        selection_ = TextSelection(start, end);
+        cursor_ = end;
+        lastSearchPosition_ = start;
+        ensureCursorVisible();
+    }
+
+    CursorPosition Editor::findInText(const std::string& text, const CursorPosition& startPos,
+                                      bool caseSensitive, bool wholeWord) const {
+        // Reutiliza el patrón preparado si coincide con la última búsqueda
+        const bool reuse = searchEngine_ && searchEngine_->getPattern() == text &&
+                           searchEngine_->isCaseSensitive() == caseSensitive &&
+                           searchEngine_->isWholeWord() == wholeWord;
+        SearchEngine local;
+        if (!reuse) {
+            local.setPattern(text, caseSensitive, wholeWord);
+        }
+        const SearchEngine& engine = reuse ? *searchEngine_ : local;
+
+        SearchMatch match{};
+        if (engine.findForward(*textBuffer_, startPos.line, startPos.column, match) ||
+            engine.findForward(*textBuffer_, 0, 0, match)) {
+            return CursorPosition(match.line, match.column);
+        }
+        return CursorPosition(SearchEngine::npos, SearchEngine::npos);
+    }
+
+    // ========================================================================
+    // Utilidades
+    // ========================================================================
+
+    bool Editor::isWordCharacter(char ch) const {
+        return std::isalnum(static_cast<unsigned char>(ch)) != 0 || ch == '_';
+    }
+
+} // namespace CoralCode
@@ -0,0 +1,778 @@
+/**
+ * @file FileIndex.cpp
+ * @brief Índice de rutas con trigramas y puntuación difusa
+ */
+
+#include "FileIndex.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace CoralCode {
+
+    namespace {
+
+        namespace fs = std::filesystem;
+
+        constexpr char kIndexMagic[8] = {'C', 'C', 'F', 'I', 'D', 'X', '0', '1'};
+
+        // Tamaño mínimo de porción al repartir listas grandes (construcción y puntuación)
+        constexpr size_t kParallelChunk = 65536;
+
+        char lowerByte(char ch) {
+            return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch;
+        }
+
+        // Alfabeto de 64 símbolos: letras, dígitos y el resto plegado
+        uint32_t symbolOf(char ch) {
+            ch = lowerByte(ch);
+            if (ch >= 'a' && ch <= 'z') return static_cast<uint32_t>(ch - 'a');
+            if (ch >= '0' && ch <= '9') return static_cast<uint32_t>(ch - '0') + 26;
+            return 36 + static_cast<uint32_t>(static_cast<unsigned char>(ch)) % 28;
+        }
+
+        uint64_t maskOf(const char* text, size_t length) {
+            uint64_t mask = 0;
+            for (size_t i = 0; i < length; ++i) {
+                mask |= 1ull << symbolOf(text[i]);
+            }
+            return mask;
+        }
+
+        uint32_t trigramKey(const char* text) {
+            return symbolOf(text[0]) << 12 | symbolOf(text[1]) << 6 | symbolOf(text[2]);
+        }
+
+        // Porciones para parallelFor: los workers compartidos más el hilo que llama
+        size_t workerCount(size_t items) {
+            size_t threads = TaskScheduler::shared().getWorkerCount() + 1;
+            return std::max<size_t>(1, std::min(threads, items / kParallelChunk));
+        }
+
+        void writeVarint(std::string& out, uint64_t value) {
+            while (value >= 0x80) {
+                out += static_cast<char>((value & 0x7F) | 0x80);
+                value >>= 7;
+            }
+            out += static_cast<char>(value);
+        }
+
+        bool readVarint(const char*& cursor, const char* end, uint64_t& value) {
+            value = 0;
+            for (int shift = 0; cursor < end && shift < 64; shift += 7) {
+                auto byte = static_cast<unsigned char>(*cursor++);
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return true;
+            }
+            return false;
+        }
+
+        bool isWordSeparator(char ch) {
+            return ch == '_' || ch == '-' || ch == '.' || ch == ' ';
+        }
+
+        /**
+         * @brief Mejores resultados de una consulta (montículo de tamaño fijo)
+         */
+        struct Ranked {
+            int score;
+            uint32_t length;
+            uint32_t id;
+        };
+
+        bool rankedBefore(const Ranked& a, const Ranked& b) {
+            if (a.score != b.score) return a.score > b.score;
+            if (a.length != b.length) return a.length < b.length;
+            return a.id < b.id;
+        }
+
+    } // namespace
+
+    FileIndex::FileIndex() : deadCount_(0), lastCandidatesValid_(false) {
+        reset();
+    }
+
+    void FileIndex::reset() {
+        paths_.clear();
+        entries_.clear();
+        masks_.clear();
+        directoryEntries_.clear();
+        deadCount_ = 0;
+        trigramOffsets_.assign(TRIGRAM_SPACE + 1, 0);
+        trigramIds_.clear();
+        recentTrigrams_.clear();
+        sortedNames_.clear();
+        recentNames_.clear();
+        lastQuery_.clear();
+        lastCandidates_.clear();
+        lastCandidatesValid_ = false;
+    }
+
+    // ========================================================================
+    // Construcción
+    // ========================================================================
+
+    bool FileIndex::build(const std::string& root, const WalkOptions& options, const std::atomic<bool>* cancel) {
+        lastError_.clear();
+        options_ = options;
+        options_.reportDirectories = false;
+
+        WorkspaceWalker walker(options_);
+        std::vector<std::vector<std::string>> found(walker.getThreadCount());
+        if (!walker.walk(root, [&found](const WorkspaceFile& file, size_t worker) {
+                found[worker].push_back(file.relativePath);
+            }, cancel)) {
+            lastError_ = walker.getLastError().empty() ? "Indexación cancelada" : walker.getLastError();
+            return false;
+        }
+
+        std::vector<std::string> paths;
+        for (auto& list : found) {
+            paths.insert(paths.end(), std::make_move_iterator(list.begin()), std::make_move_iterator(list.end()));
+        }
+        root_ = root;
+        setPaths(std::move(paths));
+        return true;
+    }
+
+    bool FileIndex::reconcile(const std::atomic<bool>* cancel) {
+        // Compara el árbol actual con el índice (p. ej. tras cargarlo de disco)
+        FileIndex current;
+        if (!current.build(root_, options_, cancel)) {
+            lastError_ = current.getLastError();
+            return false;
+        }
+        std::vector<std::string> now = current.alivePaths();
+        std::vector<std::string> before = alivePaths();
+
+        std::vector<std::string> added;
+        std::vector<std::string> removed;
+        std::set_difference(now.begin(), now.end(), before.begin(), before.end(), std::back_inserter(added));
+        std::set_difference(before.begin(), before.end(), now.begin(), now.end(), std::back_inserter(removed));
+
+        if (added.size() + removed.size() > now.size() / 4) {
+            *this = std::move(current);
+            return true;
+        }
+        for (const std::string& path : removed) removeFile(path);
+        for (const std::string& path : added) addFile(path);
+        return true;
+    }
+
+    void FileIndex::compact() {
+        setPaths(alivePaths());
+    }
+
+    void FileIndex::setPaths(std::vector<std::string> paths) {
+        std::sort(paths.begin(), paths.end());
+        paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+
+        reset();
+        size_t bytes = 0;
+        for (const std::string& path : paths) bytes += path.length();
+        paths_.reserve(bytes);
+        entries_.reserve(paths.size());
+        masks_.reserve(paths.size());
+        for (const std::string& path : paths) {
+            appendEntry(path);
+        }
+        buildTrigrams();
+        buildSortedNames();
+    }
+
+    uint32_t FileIndex::appendEntry(const std::string& relativePath) {
+        size_t slash = relativePath.rfind('/');
+        uint32_t nameStart = slash == std::string::npos ? 0 : static_cast<uint32_t>(slash + 1);
+        auto id = static_cast<uint32_t>(entries_.size());
+
+        entries_.push_back(Entry{static_cast<uint32_t>(paths_.length()), static_cast<uint32_t>(relativePath.length()),
+                                 nameStart, true});
+        paths_ += relativePath;
+        masks_.push_back(maskOf(relativePath.data(), relativePath.length()));
+        directoryEntries_[relativePath.substr(0, nameStart == 0 ? 0 : nameStart - 1)].push_back(id);
+        return id;
+    }
+
+    void FileIndex::collectTrigrams(uint32_t id, std::vector<uint32_t>& keys) const {
+        keys.clear();
+        const Entry& entry = entries_[id];
+        const char* name = pathData(entry) + entry.nameStart;
+        const size_t length = entry.length - entry.nameStart;
+        for (size_t i = 0; i + 3 <= length; ++i) {
+            keys.push_back(trigramKey(name + i));
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    }
+
+    void FileIndex::buildTrigrams() {
+        // Dos pasadas (contar, rellenar) sobre tramos de ids por hilo; cada hilo
+        // escribe en su hueco de cada lista, así las listas quedan ordenadas
+        const size_t count = entries_.size();
+        const size_t workers = workerCount(count);
+        std::vector<std::vector<uint32_t>> slots(workers, std::vector<uint32_t>(TRIGRAM_SPACE, 0));
+
+        TaskScheduler::shared().parallelFor("file-index-build", TaskPriority::Background, count, workers,
+                                            [this, &slots](size_t worker, size_t begin, size_t end) {
+            std::vector<uint32_t> keys;
+            for (size_t id = begin; id < end; ++id) {
+                if (!entries_[id].alive) continue;
+                collectTrigrams(static_cast<uint32_t>(id), keys);
+                for (uint32_t key : keys) ++slots[worker][key];
+            }
+        });
+
+        uint32_t total = 0;
+        for (uint32_t key = 0; key < TRIGRAM_SPACE; ++key) {
+            trigramOffsets_[key] = total;
+            for (auto& slot : slots) {
+                uint32_t size = slot[key];
+                slot[key] = total;
+                total += size;
+            }
+        }
+        trigramOffsets_[TRIGRAM_SPACE] = total;
+        trigramIds_.assign(total, 0);
+
+        TaskScheduler::shared().parallelFor("file-index-build", TaskPriority::Background, count, workers,
+                                            [this, &slots](size_t worker, size_t begin, size_t end) {
+            std::vector<uint32_t> keys;
+            for (size_t id = begin; id < end; ++id) {
+                if (!entries_[id].alive) continue;
+                collectTrigrams(static_cast<uint32_t>(id), keys);
+                for (uint32_t key : keys) trigramIds_[slots[worker][key]++] = static_cast<uint32_t>(id);
+            }
+        });
+    }
+
+    void FileIndex::buildSortedNames() {
+        sortedNames_.clear();
+        sortedNames_.reserve(entries_.size() - deadCount_);
+        for (uint32_t id = 0; id < entries_.size(); ++id) {
+            if (entries_[id].alive) sortedNames_.push_back(id);
+        }
+        std::sort(sortedNames_.begin(), sortedNames_.end(), [this](uint32_t a, uint32_t b) {
+            const Entry& left = entries_[a];
+            const Entry& right = entries_[b];
+            const char* x = pathData(left) + left.nameStart;
+            const char* y = pathData(right) + right.nameStart;
+            size_t xLength = left.length - left.nameStart;
+            size_t yLength = right.length - right.nameStart;
+            for (size_t i = 0; i < std::min(xLength, yLength); ++i) {
+                char cx = lowerByte(x[i]);
+                char cy = lowerByte(y[i]);
+                if (cx != cy) return cx < cy;
+            }
+            if (xLength != yLength) return xLength < yLength;
+            return left.length < right.length || (left.length == right.length && a < b);
+        });
+    }
+
+    // ========================================================================
+    // Cambios incrementales
+    // ========================================================================
+
+    void FileIndex::addFile(const std::string& relativePath) {
+        size_t slash = relativePath.rfind('/');
+        auto directory = directoryEntries_.find(slash == std::string::npos ? std::string() : relativePath.substr(0, slash));
+        if (directory != directoryEntries_.end()) {
+            for (uint32_t id : directory->second) {
+                if (pathOf(id) == relativePath) return;
+            }
+        }
+
+        uint32_t id = appendEntry(relativePath);
+        std::vector<uint32_t> keys;
+        collectTrigrams(id, keys);
+        for (uint32_t key : keys) {
+            recentTrigrams_[key].push_back(id);
+        }
+        recentNames_.push_back(id);
+        invalidateQuery();
+    }
+
+    void FileIndex::removeFile(const std::string& relativePath) {
+        size_t slash = relativePath.rfind('/');
+        auto directory = directoryEntries_.find(slash == std::string::npos ? std::string() : relativePath.substr(0, slash));
+        if (directory == directoryEntries_.end()) return;
+
+        auto& ids = directory->second;
+        for (auto it = ids.begin(); it != ids.end(); ++it) {
+            if (pathOf(*it) == relativePath) {
+                entries_[*it].alive = false;
+                ++deadCount_;
+                ids.erase(it);
+                invalidateQuery();
+                return;
+            }
+        }
+    }
+
+    void FileIndex::removeDirectory(const std::string& relativePath) {
+        const std::string prefix = relativePath + "/";
+        for (auto it = directoryEntries_.begin(); it != directoryEntries_.end(); ) {
+            if (it->first == relativePath || it->first.compare(0, prefix.length(), prefix) == 0) {
+                for (uint32_t id : it->second) {
+                    entries_[id].alive = false;
+                    ++deadCount_;
+                }
+                it = directoryEntries_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        invalidateQuery();
+    }
+
+    bool FileIndex::applyEvents(const std::vector<FileEvent>& events) {
+        // false: se perdieron eventos y hay que llamar a reconcile()
+        bool complete = true;
+        for (const FileEvent& event : events) {
+            switch (event.type) {
+                case FileEventType::Created:
+                    if (event.isDirectory) {
+                        WalkOptions options = options_;
+                        options.threadCount = 1;
+                        WorkspaceWalker walker(options);
+                        walker.walk(root_, event.relativePath, [this](const WorkspaceFile& file, size_t) {
+                            addFile(file.relativePath);
+                        });
+                    } else {
+                        addFile(event.relativePath);
+                    }
+                    break;
+                case FileEventType::Deleted:
+                    if (event.isDirectory) {
+                        removeDirectory(event.relativePath);
+                    } else {
+                        removeFile(event.relativePath);
+                    }
+                    break;
+                case FileEventType::Modified:
+                    break;
+                case FileEventType::Overflow:
+                    complete = false;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return complete;
+    }
+
+    // ========================================================================
+    // Consulta
+    // ========================================================================
+
+    int FileIndex::scorePath(const char* path, size_t length, size_t nameStart, const std::string& query,
+                             std::vector<uint32_t>* positions) {
+        if (query.empty() || query.length() > length) return -1;
+
+        // Subsecuencia: preferentemente dentro del nombre de archivo
+        auto locate = [&](size_t from, size_t& last) {
+            size_t matched = 0;
+            for (size_t i = from; i < length && matched < query.length(); ++i) {
+                if (lowerByte(path[i]) == query[matched]) {
+                    last = i;
+                    ++matched;
+                }
+            }
+            return matched == query.length();
+        };
+        size_t end = 0;
+        if (!locate(nameStart, end) && (nameStart == 0 || !locate(0, end))) return -1;
+
+        // Desde el final hacia atrás: el tramo más corto que contiene la consulta
+        size_t start = end + 1;
+        for (size_t remaining = query.length(); remaining > 0; ) {
+            --start;
+            if (lowerByte(path[start]) == query[remaining - 1]) --remaining;
+        }
+
+        int score = 0;
+        size_t matched = 0;
+        bool previousMatched = false;
+        for (size_t i = start; i <= end; ++i) {
+            if (matched < query.length() && lowerByte(path[i]) == query[matched]) {
+                int bonus = 16;
+                if (i == 0 || path[i - 1] == '/') {
+                    bonus += 24;
+                } else if (isWordSeparator(path[i - 1])) {
+                    bonus += 16;
+                } else if (path[i] >= 'A' && path[i] <= 'Z' && path[i - 1] >= 'a' && path[i - 1] <= 'z') {
+                    bonus += 16;
+                }
+                if (previousMatched) bonus += 12;
+                if (i >= nameStart) bonus += 8;
+                score += bonus;
+                if (positions) positions->push_back(static_cast<uint32_t>(i));
+                previousMatched = true;
+                ++matched;
+            } else {
+                score -= previousMatched ? 3 : 1;
+                previousMatched = false;
+            }
+        }
+        if (start == nameStart) score += 16;
+        score -= static_cast<int>(length / 8);
+        return std::max(score, 0);
+    }
+
+    std::vector<uint32_t> FileIndex::prefixCandidates(const std::string& query, size_t limit) const {
+        // Nombres que empiezan por la consulta (rango contiguo de sortedNames_)
+        auto nameLess = [this, &query](uint32_t id, const std::string&) {
+            const Entry& entry = entries_[id];
+            const char* name = pathData(entry) + entry.nameStart;
+            size_t length = entry.length - entry.nameStart;
+            for (size_t i = 0; i < std::min(length, query.length()); ++i) {
+                char ch = lowerByte(name[i]);
+                if (ch != query[i]) return ch < query[i];
+            }
+            return length < query.length();
+        };
+        auto startsWith = [this, &query](uint32_t id) {
+            const Entry& entry = entries_[id];
+            if (entry.length - entry.nameStart < query.length()) return false;
+            const char* name = pathData(entry) + entry.nameStart;
+            for (size_t i = 0; i < query.length(); ++i) {
+                if (lowerByte(name[i]) != query[i]) return false;
+            }
+            return true;
+        };
+
+        std::vector<uint32_t> candidates;
+        auto it = std::lower_bound(sortedNames_.begin(), sortedNames_.end(), query, nameLess);
+        for (; it != sortedNames_.end() && startsWith(*it); ++it) {
+            if (entries_[*it].alive) candidates.push_back(*it);
+        }
+        for (uint32_t id : recentNames_) {
+            if (entries_[id].alive && startsWith(id)) candidates.push_back(id);
+        }
+        (void)limit;
+        return candidates;
+    }
+
+    std::vector<uint32_t> FileIndex::trigramCandidates(const std::string& query) const {
+        // Intersección de las listas de cada trigrama, empezando por la más corta
+        std::vector<uint32_t> keys;
+        for (size_t i = 0; i + 3 <= query.length(); ++i) {
+            keys.push_back(trigramKey(query.data() + i));
+        }
+        std::sort(keys.begin(), keys.end(), [this](uint32_t a, uint32_t b) {
+            return trigramOffsets_[a + 1] - trigramOffsets_[a] < trigramOffsets_[b + 1] - trigramOffsets_[b];
+        });
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        std::vector<uint32_t> base(trigramIds_.begin() + trigramOffsets_[keys[0]],
+                                   trigramIds_.begin() + trigramOffsets_[keys[0] + 1]);
+        std::vector<uint32_t> next;
+        for (size_t k = 1; k < keys.size() && !base.empty(); ++k) {
+            next.clear();
+            std::set_intersection(base.begin(), base.end(), trigramIds_.begin() + trigramOffsets_[keys[k]],
+                                  trigramIds_.begin() + trigramOffsets_[keys[k] + 1], std::back_inserter(next));
+            base.swap(next);
+        }
+
+        std::vector<uint32_t> recent;
+        for (size_t k = 0; k < keys.size(); ++k) {
+            auto list = recentTrigrams_.find(keys[k]);
+            if (list == recentTrigrams_.end()) {
+                recent.clear();
+                break;
+            }
+            if (k == 0) {
+                recent = list->second;
+            } else {
+                next.clear();
+                std::set_intersection(recent.begin(), recent.end(), list->second.begin(), list->second.end(),
+                                      std::back_inserter(next));
+                recent.swap(next);
+            }
+        }
+
+        std::vector<uint32_t> candidates;
+        candidates.reserve(base.size() + recent.size());
+        for (uint32_t id : base) {
+            if (entries_[id].alive) candidates.push_back(id);
+        }
+        for (uint32_t id : recent) {
+            if (entries_[id].alive) candidates.push_back(id);
+        }
+        return candidates;
+    }
+
+    std::vector<FileMatch> FileIndex::query(const std::string& pattern, size_t limit) {
+        std::string query;
+        for (char ch : pattern) {
+            if (ch != ' ') query += lowerByte(ch);
+        }
+        if (query.empty() || limit == 0) {
+            invalidateQuery();
+            return {};
+        }
+        const uint64_t mask = maskOf(query.data(), query.length());
+
+        // Candidatos: refinar la consulta anterior, o prefijo/trigramas si
+        // bastan para llenar la lista, o recorrido completo con la máscara
+        std::vector<uint32_t> candidates;
+        bool exhaustive = false;
+        const bool refine = lastCandidatesValid_ && !lastQuery_.empty() &&
+                            query.compare(0, lastQuery_.length(), lastQuery_) == 0;
+        if (refine) {
+            for (uint32_t id : lastCandidates_) {
+                if ((masks_[id] & mask) == mask) candidates.push_back(id);
+            }
+            exhaustive = true;
+        } else if (query.length() < TRIGRAM_QUERY_LENGTH) {
+            candidates = prefixCandidates(query, limit);
+        } else if (query.find('/') == std::string::npos) {
+            candidates = trigramCandidates(query);
+        }
+        if (!exhaustive && candidates.size() < limit) {
+            candidates.clear();
+            for (uint32_t id = 0; id < entries_.size(); ++id) {
+                if (entries_[id].alive && (masks_[id] & mask) == mask) candidates.push_back(id);
+            }
+            exhaustive = true;
+        }
+
+        // Puntuación en paralelo; cada hilo guarda sus mejores y sus aciertos
+        const size_t workers = workerCount(candidates.size());
+        std::vector<std::vector<Ranked>> best(workers);
+        std::vector<std::vector<uint32_t>> hits(workers);
+        TaskScheduler::shared().parallelFor("file-index-query", TaskPriority::Interactive, candidates.size(), workers,
+                                            [&](size_t worker, size_t begin, size_t end) {
+            auto& heap = best[worker];
+            auto worse = [](const Ranked& a, const Ranked& b) { return rankedBefore(a, b); };
+            for (size_t i = begin; i < end; ++i) {
+                const Entry& entry = entries_[candidates[i]];
+                int score = scorePath(pathData(entry), entry.length, entry.nameStart, query);
+                if (score < 0) continue;
+                if (exhaustive) hits[worker].push_back(candidates[i]);
+
+                Ranked ranked{score, entry.length, candidates[i]};
+                if (heap.size() < limit) {
+                    heap.push_back(ranked);
+                    std::push_heap(heap.begin(), heap.end(), worse);
+                } else if (rankedBefore(ranked, heap.front())) {
+                    std::pop_heap(heap.begin(), heap.end(), worse);
+                    heap.back() = ranked;
+                    std::push_heap(heap.begin(), heap.end(), worse);
+                }
+            }
+        });
+
+        std::vector<Ranked> ranked;
+        for (auto& list : best) ranked.insert(ranked.end(), list.begin(), list.end());
+        std::sort(ranked.begin(), ranked.end(), rankedBefore);
+        if (ranked.size() > limit) ranked.resize(limit);
+
+        lastQuery_ = query;
+        lastCandidatesValid_ = exhaustive;
+        lastCandidates_.clear();
+        if (exhaustive) {
+            for (auto& list : hits) lastCandidates_.insert(lastCandidates_.end(), list.begin(), list.end());
+        }
+
+        std::vector<FileMatch> matches;
+        matches.reserve(ranked.size());
+        for (const Ranked& item : ranked) {
+            const Entry& entry = entries_[item.id];
+            FileMatch match{pathOf(item.id), item.score, {}};
+            scorePath(pathData(entry), entry.length, entry.nameStart, query, &match.positions);
+            matches.push_back(std::move(match));
+        }
+        return matches;
+    }
+
+    // ========================================================================
+    // Persistencia
+    // ========================================================================
+
+    std::string FileIndex::defaultIndexPath(const std::string& root) {
+        fs::path base;
+#ifdef _WIN32
+        if (const char* local = std::getenv("LOCALAPPDATA")) base = fs::path(local) / "CoralCode";
+#else
+        if (const char* cache = std::getenv("XDG_CACHE_HOME")) {
+            base = fs::path(cache) / "coralcode";
+        } else if (const char* home = std::getenv("HOME")) {
+            base = fs::path(home) / ".cache" / "coralcode";
+        }
+#endif
+        if (base.empty()) base = fs::temp_directory_path() / "coralcode";
+
+        std::error_code error;
+        std::string absolute = fs::absolute(root, error).lexically_normal().string();
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016zx.idx", std::hash<std::string>()(absolute));
+        return (base / "file-index" / name).string();
+    }
+
+    bool FileIndex::save(const std::string& filePath) {
+        // Compactar: ids = orden de las rutas, sin bajas ni altas recientes
+        if (deadCount_ > 0 || !recentNames_.empty()) {
+            compact();
+        }
+
+        std::string out(kIndexMagic, sizeof(kIndexMagic));
+        writeVarint(out, root_.length());
+        out += root_;
+        out += static_cast<char>(options_.includeHidden);
+        out += static_cast<char>(options_.respectIgnoreFiles);
+
+        // Rutas ordenadas en codificación frontal (prefijo compartido + resto)
+        writeVarint(out, entries_.size());
+        const char* previous = nullptr;
+        size_t previousLength = 0;
+        for (const Entry& entry : entries_) {
+            const char* path = pathData(entry);
+            size_t shared = 0;
+            while (shared < previousLength && shared < entry.length && previous[shared] == path[shared]) ++shared;
+            writeVarint(out, shared);
+            writeVarint(out, entry.length - shared);
+            out.append(path + shared, entry.length - shared);
+            previous = path;
+            previousLength = entry.length;
+        }
+
+        // Listas de trigramas con diferencias entre ids consecutivos
+        for (uint32_t key = 0; key < TRIGRAM_SPACE; ++key) {
+            const uint32_t begin = trigramOffsets_[key];
+            const uint32_t end = trigramOffsets_[key + 1];
+            writeVarint(out, end - begin);
+            uint32_t last = 0;
+            for (uint32_t i = begin; i < end; ++i) {
+                writeVarint(out, trigramIds_[i] - last);
+                last = trigramIds_[i];
+            }
+        }
+
+        for (uint32_t id : sortedNames_) {
+            writeVarint(out, id);
+        }
+
+        // Escritura atómica: archivo temporal y renombrado
+        std::error_code error;
+        fs::create_directories(fs::path(filePath).parent_path(), error);
+        const std::string temporary = filePath + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.write(out.data(), static_cast<std::streamsize>(out.size()))) {
+                lastError_ = "No se pudo escribir " + temporary;
+                return false;
+            }
+        }
+        fs::rename(temporary, filePath, error);
+        if (error) {
+            lastError_ = "No se pudo guardar el índice: " + error.message();
+            return false;
+        }
+        return true;
+    }
+
+    bool FileIndex::load(const std::string& filePath) {
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file) {
+            lastError_ = "No existe el índice " + filePath;
+            return false;
+        }
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        auto fail = [this, &filePath]() {
+            reset();
+            lastError_ = "Índice dañado o de otra versión: " + filePath;
+            return false;
+        };
+        if (data.size() < sizeof(kIndexMagic) || std::memcmp(data.data(), kIndexMagic, sizeof(kIndexMagic)) != 0) {
+            return fail();
+        }
+
+        const char* cursor = data.data() + sizeof(kIndexMagic);
+        const char* end = data.data() + data.size();
+        uint64_t value = 0;
+
+        reset();
+        if (!readVarint(cursor, end, value) || value + 2 > static_cast<uint64_t>(end - cursor)) return fail();
+        root_.assign(cursor, static_cast<size_t>(value));
+        cursor += value;
+        options_ = WalkOptions();
+        options_.includeHidden = *cursor++ != 0;
+        options_.respectIgnoreFiles = *cursor++ != 0;
+
+        uint64_t count = 0;
+        if (!readVarint(cursor, end, count)) return fail();
+        std::string path;
+        for (uint64_t i = 0; i < count; ++i) {
+            uint64_t shared = 0;
+            uint64_t rest = 0;
+            if (!readVarint(cursor, end, shared) || !readVarint(cursor, end, rest) ||
+                shared > path.length() || rest > static_cast<uint64_t>(end - cursor)) {
+                return fail();
+            }
+            path.resize(static_cast<size_t>(shared));
+            path.append(cursor, static_cast<size_t>(rest));
+            cursor += rest;
+            appendEntry(path);
+        }
+
+        for (uint32_t key = 0; key < TRIGRAM_SPACE; ++key) {
+            uint64_t size = 0;
+            if (!readVarint(cursor, end, size)) return fail();
+            trigramOffsets_[key] = static_cast<uint32_t>(trigramIds_.size());
+            uint64_t last = 0;
+            for (uint64_t i = 0; i < size; ++i) {
+                if (!readVarint(cursor, end, value) || last + value >= count) return fail();
+                last += value;
+                trigramIds_.push_back(static_cast<uint32_t>(last));
+            }
+        }
+        trigramOffsets_[TRIGRAM_SPACE] = static_cast<uint32_t>(trigramIds_.size());
+
+        sortedNames_.reserve(static_cast<size_t>(count));
+        for (uint64_t i = 0; i < count; ++i) {
+            if (!readVarint(cursor, end, value) || value >= count) return fail();
+            sortedNames_.push_back(static_cast<uint32_t>(value));
+        }
+        lastError_.clear();
+        return true;
+    }
+
+    // ========================================================================
+    // Utilidades
+    // ========================================================================
+
+    std::string FileIndex::pathOf(uint32_t id) const {
+        const Entry& entry = entries_[id];
+        return std::string(pathData(entry), entry.length);
+    }
+
+    std::vector<std::string> FileIndex::alivePaths() const {
+        std::vector<std::string> paths;
+        paths.reserve(entries_.size() - deadCount_);
+        for (uint32_t id = 0; id < entries_.size(); ++id) {
+            if (entries_[id].alive) paths.push_back(pathOf(id));
+        }
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    size_t FileIndex::getMemoryUsage() const {
+        size_t bytes = paths_.capacity() + entries_.capacity() * sizeof(Entry) + masks_.capacity() * sizeof(uint64_t);
+        bytes += (trigramOffsets_.capacity() + trigramIds_.capacity()) * sizeof(uint32_t);
+        bytes += (sortedNames_.capacity() + recentNames_.capacity() + lastCandidates_.capacity()) * sizeof(uint32_t);
+        for (const auto& directory : directoryEntries_) {
+            bytes += sizeof(directory) + directory.first.capacity() + directory.second.capacity() * sizeof(uint32_t);
+        }
+        for (const auto& list : recentTrigrams_) {
+            bytes += sizeof(list) + list.second.capacity() * sizeof(uint32_t);
+        }
+        return bytes;
+    }
+
+} // namespace CoralCode
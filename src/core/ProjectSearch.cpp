@@ -0,0 +1,313 @@
+/**
+ * @file ProjectSearch.cpp
+ * @brief Búsqueda paralela en los archivos del proyecto
+ */
+
+#include "ProjectSearch.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+#ifdef CORALCODE_WINDOWS
+    #include <fstream>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace CoralCode {
+
+    namespace {
+
+        /**
+         * @brief Contenido de un archivo en memoria: proyectado o leído
+         */
+        class FileView {
+        public:
+            FileView() : data_(nullptr), size_(0), mapped_(false) {}
+            ~FileView() { release(); }
+
+            FileView(const FileView&) = delete;
+            FileView& operator=(const FileView&) = delete;
+
+            // false si no es un archivo regular legible o supera maxSize
+            bool open(const std::string& path, uint64_t maxSize, std::string& scratch) {
+#ifdef CORALCODE_WINDOWS
+                std::ifstream file(path, std::ios::binary | std::ios::ate);
+                if (!file) return false;
+                auto size = static_cast<uint64_t>(file.tellg());
+                if (size > maxSize) return false;
+                scratch.resize(static_cast<size_t>(size));
+                file.seekg(0);
+                if (!file.read(scratch.data(), static_cast<std::streamsize>(size))) return false;
+                data_ = scratch.data();
+                size_ = scratch.size();
+                return true;
+#else
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) return false;
+
+                struct stat info {};
+                if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) ||
+                    static_cast<uint64_t>(info.st_size) > maxSize) {
+                    ::close(fd);
+                    return false;
+                }
+                size_ = static_cast<size_t>(info.st_size);
+
+                if (size_ >= ProjectSearch::MMAP_THRESHOLD) {
+                    // Archivos grandes: sin copia, el kernel lee por delante
+                    void* address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                    ::close(fd);
+                    if (address == MAP_FAILED) return false;
+                    ::madvise(address, size_, MADV_SEQUENTIAL);
+                    data_ = static_cast<const char*>(address);
+                    mapped_ = true;
+                    return true;
+                }
+
+                // Archivos pequeños: una lectura al búfer del hilo (mmap cuesta más)
+                scratch.resize(size_);
+                size_t done = 0;
+                while (done < size_) {
+                    ssize_t count = ::read(fd, scratch.data() + done, size_ - done);
+                    if (count <= 0) break;
+                    done += static_cast<size_t>(count);
+                }
+                ::close(fd);
+                size_ = done;
+                data_ = scratch.data();
+                return true;
+#endif
+            }
+
+            const char* data() const { return data_; }
+            size_t size() const { return size_; }
+
+        private:
+            const char* data_;
+            size_t size_;
+            bool mapped_;
+
+            void release() {
+#ifndef CORALCODE_WINDOWS
+                if (mapped_) {
+                    ::munmap(const_cast<char*>(data_), size_);
+                }
+#endif
+                mapped_ = false;
+                data_ = nullptr;
+                size_ = 0;
+            }
+        };
+
+        std::string makePreview(const char* data, size_t length, size_t lineStart) {
+            const char* begin = data + lineStart;
+            const void* newline = std::memchr(begin, '\n', length - lineStart);
+            size_t lineLength = newline ? static_cast<size_t>(static_cast<const char*>(newline) - begin)
+                                        : length - lineStart;
+            if (lineLength > 0 && begin[lineLength - 1] == '\r') --lineLength;
+            return std::string(begin, std::min(lineLength, ProjectSearch::PREVIEW_LENGTH));
+        }
+
+    } // namespace
+
+    ProjectSearch::ProjectSearch()
+        : truncated_(false), filesSearched_(0), filesMatched_(0),
+          filesSkipped_(0), bytesSearched_(0), matchCount_(0) {}
+
+    ProjectSearch::~ProjectSearch() {
+        cancel();
+        wait();
+    }
+
+    // ========================================================================
+    // Control
+    // ========================================================================
+
+    bool ProjectSearch::start(const std::string& root, const std::string& pattern,
+                              const ProjectSearchOptions& options) {
+        cancel();
+        wait();
+
+        lastError_.clear();
+        pending_.clear();
+        truncated_ = false;
+        filesSearched_ = 0;
+        filesMatched_ = 0;
+        filesSkipped_ = 0;
+        bytesSearched_ = 0;
+        matchCount_ = 0;
+        token_ = CancellationToken::create();
+        options_ = options;
+
+        if (pattern.empty()) {
+            lastError_ = "Patrón vacío";
+            return false;
+        }
+        std::error_code error;
+        if (!std::filesystem::is_directory(root, error)) {
+            lastError_ = "No es un directorio: " + root;
+            return false;
+        }
+
+        if (options.regex) {
+            std::string source = options.wholeWord ? "\\b(?:" + pattern + ")\\b" : pattern;
+            if (!regex_.compile(source, options.caseSensitive)) {
+                lastError_ = regex_.getLastError();
+                return false;
+            }
+        } else {
+            literal_.setPattern(pattern, options.caseSensitive, options.wholeWord);
+        }
+
+        done_ = TaskScheduler::shared().async("project-search", TaskPriority::Background,
+                                              [this, root](const CancellationToken& token) {
+            WorkspaceWalker walker(options_.walk);
+            std::vector<std::string> scratch(walker.getThreadCount());
+            walker.walk(root, [this, &scratch](const WorkspaceFile& file, size_t worker) {
+                searchFile(file, scratch[worker]);
+            }, token.flag());
+        }, token_);
+        return true;
+    }
+
+    void ProjectSearch::cancel() {
+        token_.cancel();
+    }
+
+    void ProjectSearch::wait() {
+        // Una tarea descartada por cancelación también deja el futuro listo
+        if (done_.valid()) {
+            done_.wait();
+        }
+    }
+
+    bool ProjectSearch::isRunning() const {
+        return done_.valid() && done_.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    }
+
+    // ========================================================================
+    // Resultados
+    // ========================================================================
+
+    std::vector<ProjectSearchResult> ProjectSearch::takeResults() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<ProjectSearchResult> results;
+        results.swap(pending_);
+        return results;
+    }
+
+    ProjectSearchStats ProjectSearch::getStats() const {
+        ProjectSearchStats stats;
+        stats.filesSearched = filesSearched_.load(std::memory_order_relaxed);
+        stats.filesMatched = filesMatched_.load(std::memory_order_relaxed);
+        stats.filesSkipped = filesSkipped_.load(std::memory_order_relaxed);
+        stats.bytesSearched = bytesSearched_.load(std::memory_order_relaxed);
+        stats.matches = matchCount_.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.truncated = truncated_;
+        return stats;
+    }
+
+    void ProjectSearch::publish(std::vector<ProjectSearchResult>& results) {
+        size_t total = matchCount_.fetch_add(results.size(), std::memory_order_relaxed) + results.size();
+        filesMatched_.fetch_add(1, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.insert(pending_.end(), std::make_move_iterator(results.begin()),
+                        std::make_move_iterator(results.end()));
+        if (total >= options_.maxResults) {
+            // Demasiados resultados para una lista útil: parar el recorrido
+            truncated_ = true;
+            token_.cancel();
+        }
+    }
+
+    // ========================================================================
+    // Búsqueda por archivo
+    // ========================================================================
+
+    void ProjectSearch::searchFile(const WorkspaceFile& file, std::string& scratch) {
+        FileView view;
+        if (!view.open(file.path, options_.maxFileSize, scratch)) {
+            filesSkipped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Un byte nulo al principio delata un binario
+        if (std::memchr(view.data(), 0, std::min(view.size(), BINARY_PROBE_LENGTH))) {
+            filesSkipped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        filesSearched_.fetch_add(1, std::memory_order_relaxed);
+        bytesSearched_.fetch_add(view.size(), std::memory_order_relaxed);
+
+        std::vector<ProjectSearchResult> results;
+        if (options_.regex) {
+            searchRegex(file.path, view.data(), view.size(), results);
+        } else {
+            searchLiteral(file.path, view.data(), view.size(), results);
+        }
+        if (!results.empty()) {
+            publish(results);
+        }
+    }
+
+    void ProjectSearch::searchLiteral(const std::string& path, const char* data, size_t length,
+                                      std::vector<ProjectSearchResult>& out) const {
+        const std::string& pattern = literal_.getPattern();
+        const size_t patternBreaks = static_cast<size_t>(std::count(pattern.begin(), pattern.end(), '\n'));
+        const size_t lastBreak = pattern.rfind('\n');
+        const size_t tailLength = patternBreaks == 0 ? pattern.length() : pattern.length() - lastBreak - 1;
+
+        // Líneas contadas de forma incremental entre coincidencias
+        size_t line = 0;
+        size_t lineStart = 0;
+        size_t counted = 0;
+
+        size_t pos = literal_.find(data, length, 0);
+        while (pos != SearchEngine::npos) {
+            line += static_cast<size_t>(std::count(data + counted, data + pos, '\n'));
+            size_t back = pos;
+            while (back > counted && data[back - 1] != '\n') --back;
+            if (back > counted) lineStart = back;
+            counted = pos;
+
+            SearchMatch range{line, pos - lineStart, line + patternBreaks,
+                              patternBreaks == 0 ? pos - lineStart + tailLength : tailLength};
+            out.push_back(ProjectSearchResult{path, range, makePreview(data, length, lineStart)});
+
+            if (out.size() >= options_.maxResults || token_.isCancelled()) return;
+            pos = literal_.find(data, length, pos + pattern.length());
+        }
+    }
+
+    void ProjectSearch::searchRegex(const std::string& path, const char* data, size_t length,
+                                    std::vector<ProjectSearchResult>& out) const {
+        if (!regex_.mayMatch(data, length)) return;
+
+        // Directamente sobre el archivo; el inicio de línea de la vista previa
+        // avanza de coincidencia en coincidencia, como en la búsqueda literal
+        size_t line = 0;
+        size_t lineStart = 0;
+
+        SearchControl control;
+        control.cancel = token_.flag();
+        control.maxMatches = options_.maxResults;
+        regex_.search(data, length, 0, 0, [&](const RegexMatch& match) {
+            while (line < match.range.line) {
+                const void* newline = std::memchr(data + lineStart, '\n', length - lineStart);
+                lineStart = static_cast<size_t>(static_cast<const char*>(newline) - data) + 1;
+                ++line;
+            }
+            out.push_back(ProjectSearchResult{path, match.range, makePreview(data, length, lineStart)});
+            return true;
+        }, control);
+    }
+
+} // namespace CoralCode
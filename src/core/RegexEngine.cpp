@@ -0,0 +1,1381 @@
+/**
+ * @file RegexEngine.cpp
+ * @brief Expresiones regulares compiladas a NFA y simuladas con máquina de Pike
+ */
+
+#include "RegexEngine.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+
+namespace CoralCode {
+
+    namespace {
+
+        constexpr uint32_t kUnbounded = std::numeric_limits<uint32_t>::max();
+        constexpr uint32_t kRestoreFlag = 0x80000000u;
+
+        bool isDigit(char ch) {
+            return ch >= '0' && ch <= '9';
+        }
+
+        int hexValue(char ch) {
+            if (ch >= '0' && ch <= '9') return ch - '0';
+            if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+            if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+            return -1;
+        }
+
+        void addRange(std::bitset<256>& set, unsigned char from, unsigned char to) {
+            for (unsigned value = from; value <= to; ++value) {
+                set.set(value);
+            }
+        }
+
+        void addWordBytes(std::bitset<256>& set) {
+            addRange(set, 'a', 'z');
+            addRange(set, 'A', 'Z');
+            addRange(set, '0', '9');
+            set.set('_');
+        }
+
+        void addSpaceBytes(std::bitset<256>& set) {
+            for (char ch : {' ', '\t', '\n', '\r', '\f', '\v'}) {
+                set.set(static_cast<unsigned char>(ch));
+            }
+        }
+
+        // Añade la otra variante ASCII de cada letra del conjunto
+        void foldSet(std::bitset<256>& set) {
+            for (unsigned ch = 'a'; ch <= 'z'; ++ch) {
+                if (set.test(ch) || set.test(ch - 32)) {
+                    set.set(ch);
+                    set.set(ch - 32);
+                }
+            }
+        }
+
+        /**
+         * @brief Líneas de un TextBuffer
+         */
+        class BufferLines {
+        public:
+            explicit BufferLines(const TextBuffer& buffer) : buffer_(buffer) {}
+
+            size_t count() const { return buffer_.getLineCount(); }
+
+            void get(size_t line, const char*& data, size_t& length) {
+                const std::string& text = buffer_.getLine(line);
+                data = text.data();
+                length = text.length();
+            }
+
+        private:
+            const TextBuffer& buffer_;
+        };
+
+        /**
+         * @brief Líneas de un bloque de texto contiguo (archivo leído o proyectado)
+         *
+         * Igual que TextBuffer::fromString: se parte por '\n' y se quita el
+         * '\r' final. Solo recuerda la última línea pedida; el recorrido
+         * avanza casi siempre a la siguiente, así que no hace falta índice.
+         */
+        class ViewLines {
+        public:
+            ViewLines(const char* data, size_t length)
+                : data_(data), length_(length),
+                  count_(static_cast<size_t>(std::count(data, data + length, '\n')) + 1),
+                  line_(0), start_(0), end_(lineEnd(0)) {}
+
+            size_t count() const { return count_; }
+
+            void get(size_t line, const char*& data, size_t& length) {
+                while (line_ < line) {
+                    start_ = end_ + 1;
+                    end_ = lineEnd(start_);
+                    ++line_;
+                }
+                while (line_ > line) {
+                    end_ = start_ - 1;
+                    start_ = end_;
+                    while (start_ > 0 && data_[start_ - 1] != '\n') --start_;
+                    --line_;
+                }
+                data = data_ + start_;
+                length = end_ - start_;
+                if (length > 0 && data[length - 1] == '\r') --length;
+            }
+
+        private:
+            const char* data_;
+            size_t length_;
+            size_t count_;
+            size_t line_;
+            size_t start_;
+            size_t end_;    // Posición del '\n' (o el final del bloque)
+
+            size_t lineEnd(size_t from) const {
+                const void* newline = from < length_ ? std::memchr(data_ + from, '\n', length_ - from) : nullptr;
+                return newline ? static_cast<size_t>(static_cast<const char*>(newline) - data_) : length_;
+            }
+        };
+
+        /**
+         * @brief Recorre las líneas como un flujo de bytes con '\n' entre ellas
+         */
+        template <typename Lines>
+        class StreamCursor {
+        public:
+            StreamCursor(Lines& lines, size_t line, size_t col)
+                : lines_(lines), lineCount_(lines.count()), line_(0), col_(0), text_(nullptr), length_(0) {
+                seek(line, col);
+            }
+
+            void seek(size_t line, size_t col) {
+                line_ = std::min(line, lineCount_ - 1);
+                lines_.get(line_, text_, length_);
+                col_ = std::min(col, length_);
+            }
+
+            size_t line() const { return line_; }
+            size_t column() const { return col_; }
+            bool atLineEnd() const { return col_ >= length_; }
+
+            // Byte en la posición actual (-1 al final del texto)
+            int current() const {
+                if (col_ < length_) return byteAt(text_, col_);
+                return line_ + 1 < lineCount_ ? '\n' : -1;
+            }
+
+            int previous() const {
+                if (col_ > 0) return byteAt(text_, col_ - 1);
+                return line_ > 0 ? '\n' : -1;
+            }
+
+            // Byte siguiente al actual
+            int peek() const {
+                if (col_ + 1 < length_) return byteAt(text_, col_ + 1);
+                if (col_ + 1 == length_) return line_ + 1 < lineCount_ ? '\n' : -1;
+                if (line_ + 1 >= lineCount_) return -1;
+
+                const char* nextText = nullptr;
+                size_t nextLength = 0;
+                lines_.get(line_ + 1, nextText, nextLength);
+                if (nextLength > 0) return byteAt(nextText, 0);
+                return line_ + 2 < lineCount_ ? '\n' : -1;
+            }
+
+            bool advance() {
+                if (col_ < length_) {
+                    ++col_;
+                    return true;
+                }
+                if (line_ + 1 < lineCount_) {
+                    seek(line_ + 1, 0);
+                    return true;
+                }
+                return false;
+            }
+
+            bool nextLine() {
+                if (line_ + 1 >= lineCount_) return false;
+                seek(line_ + 1, 0);
+                return true;
+            }
+
+            const char* data() const { return text_; }
+            size_t length() const { return length_; }
+
+            /**
+             * @brief Avanza dentro de la línea hasta un posible inicio
+             *
+             * Usa el prefijo literal si existe, memchr con un único byte
+             * inicial o la tabla de bytes iniciales. Devuelve false (con el
+             * cursor al final de la línea) si no hay candidato.
+             */
+            bool skipInLine(const std::bitset<256>& bytes, int single, const SearchEngine* prefix) {
+                if (prefix) {
+                    size_t pos = prefix->find(text_, length_, col_);
+                    col_ = pos == SearchEngine::npos ? length_ : pos;
+                } else if (single >= 0) {
+                    const void* hit = col_ < length_ ? std::memchr(text_ + col_, single, length_ - col_) : nullptr;
+                    col_ = hit ? static_cast<size_t>(static_cast<const char*>(hit) - text_) : length_;
+                } else {
+                    while (col_ < length_ && !bytes.test(static_cast<unsigned char>(text_[col_]))) {
+                        ++col_;
+                    }
+                }
+
+                if (col_ < length_) return true;
+                return bytes.test('\n') && line_ + 1 < lineCount_;
+            }
+
+        private:
+            Lines& lines_;
+            size_t lineCount_;
+            size_t line_;
+            size_t col_;
+            const char* text_;
+            size_t length_;
+
+            static int byteAt(const char* text, size_t index) {
+                return static_cast<unsigned char>(text[index]);
+            }
+        };
+
+    } // namespace
+
+    // ========================================================================
+    // Estructuras internas
+    // ========================================================================
+
+    /**
+     * @brief Nodo del árbol sintáctico del patrón
+     */
+    struct RegexEngine::Node {
+        enum class Kind {
+            Empty,
+            Byte,
+            Set,
+            Any,
+            Assert,
+            Group,
+            Concat,
+            Alternate,
+            Repeat
+        };
+
+        Kind kind = Kind::Empty;
+        uint8_t byte = 0;
+        uint32_t index = 0;
+        bool capturing = false;
+        uint32_t min = 0;
+        uint32_t max = 0;
+        bool greedy = true;
+        std::vector<Node> children;
+    };
+
+    struct RegexEngine::Context {
+        Position position;
+        int previous;
+        int next;
+    };
+
+    /**
+     * @brief Lista de hilos de la máquina de Pike
+     *
+     * Conjunto disperso de instrucciones visitadas (limpieza O(1)) más los
+     * hilos en orden de prioridad con sus capturas contiguas.
+     */
+    class RegexEngine::ThreadList {
+    public:
+        ThreadList(size_t programSize, size_t slots)
+            : sparse_(programSize), dense_(programSize), visited_(0),
+              pcs_(programSize), caps_(programSize * slots), count_(0), slots_(slots) {}
+
+        bool contains(uint32_t pc) const {
+            uint32_t index = sparse_[pc];
+            return index < visited_ && dense_[index] == pc;
+        }
+
+        void mark(uint32_t pc) {
+            sparse_[pc] = visited_;
+            dense_[visited_++] = pc;
+        }
+
+        void push(uint32_t pc, const std::vector<Position>& caps) {
+            pcs_[count_] = pc;
+            std::copy(caps.begin(), caps.end(), caps_.begin() + static_cast<std::ptrdiff_t>(count_ * slots_));
+            ++count_;
+        }
+
+        void clear() {
+            visited_ = 0;
+            count_ = 0;
+        }
+
+        size_t size() const { return count_; }
+        bool empty() const { return count_ == 0; }
+        uint32_t pc(size_t index) const { return pcs_[index]; }
+
+        void copyCaps(size_t index, std::vector<Position>& out) const {
+            auto first = caps_.begin() + static_cast<std::ptrdiff_t>(index * slots_);
+            std::copy(first, first + static_cast<std::ptrdiff_t>(slots_), out.begin());
+        }
+
+    private:
+        std::vector<uint32_t> sparse_;
+        std::vector<uint32_t> dense_;
+        uint32_t visited_;
+        std::vector<uint32_t> pcs_;
+        std::vector<Position> caps_;
+        size_t count_;
+        size_t slots_;
+    };
+
+    /**
+     * @brief DFA perezoso usado como filtro por línea
+     *
+     * Cada estado es el conjunto de instrucciones vivas de la simulación
+     * no anclada; las transiciones se calculan al primer uso y se guardan
+     * en una tabla de 256 entradas por estado. Las aserciones se tratan
+     * como ciertas, así que el filtro puede aceptar líneas de más pero
+     * nunca descarta una línea con coincidencia. Si la caché crece
+     * demasiado se vacía y se reconstruye desde el estado actual.
+     */
+    class RegexEngine::LazyDfa {
+    public:
+        explicit LazyDfa(const RegexEngine& engine)
+            : engine_(engine), start_(0), marks_(engine.program_.size(), 0), generation_(1) {
+            std::vector<uint32_t> startSet;
+            closure(startSet, 0);
+            normalize(startSet);
+            startSet_ = startSet;
+            start_ = intern(std::move(startSet));
+        }
+
+        // ¿Puede empezar y terminar una coincidencia en data[0, length)?
+        bool mayMatch(const char* data, size_t length) {
+            uint32_t state = start_;
+            if (accepting_[state]) return true;
+
+            for (size_t i = 0; i < length; ++i) {
+                auto byte = static_cast<unsigned char>(data[i]);
+                uint32_t next = transitions_[state * 256 + byte];
+                if (next == kUnknown) {
+                    next = computeTransition(state, byte);
+                }
+                state = next;
+                if (accepting_[state]) return true;
+            }
+            return false;
+        }
+
+    private:
+        static constexpr uint32_t kUnknown = std::numeric_limits<uint32_t>::max();
+        static constexpr size_t kMaxStates = 2048;
+
+        const RegexEngine& engine_;
+        std::vector<std::vector<uint32_t>> states_;
+        std::vector<bool> accepting_;
+        std::vector<uint32_t> transitions_;
+        std::map<std::vector<uint32_t>, uint32_t> index_;
+        std::vector<uint32_t> startSet_;
+        uint32_t start_;
+
+        // Marcas por generación para no repetir instrucciones en un cierre
+        std::vector<uint32_t> marks_;
+        uint32_t generation_;
+
+        void closure(std::vector<uint32_t>& set, uint32_t pc) {
+            std::vector<uint32_t> pending{pc};
+            while (!pending.empty()) {
+                uint32_t current = pending.back();
+                pending.pop_back();
+                if (marks_[current] == generation_) continue;
+                marks_[current] = generation_;
+                set.push_back(current);
+
+                const Instruction& instruction = engine_.program_[current];
+                switch (instruction.op) {
+                    case Op::Split: pending.push_back(instruction.y); pending.push_back(instruction.x); break;
+                    case Op::Jump: pending.push_back(instruction.x); break;
+                    case Op::Save:
+                    case Op::Assert: pending.push_back(current + 1); break;
+                    default: break;
+                }
+            }
+        }
+
+        // Solo interesan las instrucciones que consumen bytes y Match
+        void normalize(std::vector<uint32_t>& set) const {
+            set.erase(std::remove_if(set.begin(), set.end(), [this](uint32_t pc) {
+                Op op = engine_.program_[pc].op;
+                return op == Op::Split || op == Op::Jump || op == Op::Save || op == Op::Assert;
+            }), set.end());
+            std::sort(set.begin(), set.end());
+        }
+
+        uint32_t intern(std::vector<uint32_t> set) {
+            auto it = index_.find(set);
+            if (it != index_.end()) return it->second;
+
+            auto id = static_cast<uint32_t>(states_.size());
+            bool accepting = std::any_of(set.begin(), set.end(), [this](uint32_t pc) {
+                return engine_.program_[pc].op == Op::Match;
+            });
+            index_.emplace(set, id);
+            states_.push_back(std::move(set));
+            accepting_.push_back(accepting);
+            transitions_.resize(states_.size() * 256, kUnknown);
+            return id;
+        }
+
+        uint32_t computeTransition(uint32_t state, unsigned char byte) {
+            // Búsqueda no anclada: el estado inicial siempre está presente
+            std::vector<uint32_t> next = startSet_;
+            ++generation_;
+            for (uint32_t pc : states_[state]) {
+                if (engine_.consumes(engine_.program_[pc], byte)) {
+                    closure(next, pc + 1);
+                }
+            }
+            normalize(next);
+            next.erase(std::unique(next.begin(), next.end()), next.end());
+
+            if (states_.size() >= kMaxStates) {
+                states_.clear();
+                accepting_.clear();
+                transitions_.clear();
+                index_.clear();
+                start_ = intern(startSet_);
+                return intern(std::move(next));
+            }
+
+            uint32_t target = intern(std::move(next));
+            transitions_[state * 256 + byte] = target;
+            return target;
+        }
+    };
+
+    // ========================================================================
+    // Parser
+    // ========================================================================
+
+    /**
+     * @brief Parser descendente recursivo del patrón
+     */
+    class RegexEngine::Parser {
+    public:
+        Parser(const std::string& pattern, RegexEngine& engine)
+            : pattern_(pattern), pos_(0), depth_(0), engine_(engine) {}
+
+        bool parse(Node& root) {
+            if (!parseAlternation(root)) return false;
+            if (pos_ < pattern_.length()) {
+                return fail("')' sin '(' correspondiente");
+            }
+            return true;
+        }
+
+        const std::string& getError() const { return error_; }
+
+    private:
+        const std::string& pattern_;
+        size_t pos_;
+        size_t depth_;
+        RegexEngine& engine_;
+        std::string error_;
+
+        bool fail(const std::string& message) {
+            error_ = message + " (posición " + std::to_string(pos_) + ")";
+            return false;
+        }
+
+        bool atEnd() const { return pos_ >= pattern_.length(); }
+        char peek() const { return pattern_[pos_]; }
+
+        uint32_t addSet(std::bitset<256> set) {
+            if (!engine_.caseSensitive_) {
+                foldSet(set);
+            }
+            engine_.sets_.push_back(set);
+            return static_cast<uint32_t>(engine_.sets_.size() - 1);
+        }
+
+        void makeByte(Node& out, unsigned char ch) {
+            bool isLetter = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+            if (!engine_.caseSensitive_ && isLetter) {
+                std::bitset<256> set;
+                set.set(ch);
+                out.kind = Node::Kind::Set;
+                out.index = addSet(set);
+                return;
+            }
+            out.kind = Node::Kind::Byte;
+            out.byte = ch;
+        }
+
+        bool parseAlternation(Node& out) {
+            if (++depth_ > MAX_NESTING) return fail("anidamiento demasiado profundo");
+
+            Node branch;
+            if (!parseConcat(branch)) return false;
+
+            if (atEnd() || peek() != '|') {
+                out = std::move(branch);
+                --depth_;
+                return true;
+            }
+
+            out.kind = Node::Kind::Alternate;
+            out.children.push_back(std::move(branch));
+            while (!atEnd() && peek() == '|') {
+                ++pos_;
+                Node next;
+                if (!parseConcat(next)) return false;
+                out.children.push_back(std::move(next));
+            }
+            --depth_;
+            return true;
+        }
+
+        bool parseConcat(Node& out) {
+            out.kind = Node::Kind::Concat;
+            while (!atEnd() && peek() != '|' && peek() != ')') {
+                Node item;
+                if (!parseRepeat(item)) return false;
+                out.children.push_back(std::move(item));
+            }
+            if (out.children.empty()) {
+                out.kind = Node::Kind::Empty;
+            } else if (out.children.size() == 1) {
+                Node single = std::move(out.children.front());
+                out = std::move(single);
+            }
+            return true;
+        }
+
+        bool parseRepeat(Node& out) {
+            if (peek() == '*' || peek() == '+' || peek() == '?') {
+                return fail("cuantificador sin operando");
+            }
+            if (!parseAtom(out)) return false;
+
+            while (!atEnd()) {
+                uint32_t min = 0;
+                uint32_t max = 0;
+                char ch = peek();
+                if (ch == '*') {
+                    min = 0; max = kUnbounded; ++pos_;
+                } else if (ch == '+') {
+                    min = 1; max = kUnbounded; ++pos_;
+                } else if (ch == '?') {
+                    min = 0; max = 1; ++pos_;
+                } else if (ch == '{') {
+                    size_t saved = pos_;
+                    if (!parseCounted(min, max)) {
+                        if (!error_.empty()) return false;
+                        // No es un cuantificador: '{' literal
+                        pos_ = saved;
+                        break;
+                    }
+                } else {
+                    break;
+                }
+
+                bool greedy = true;
+                if (!atEnd() && peek() == '?') {
+                    greedy = false;
+                    ++pos_;
+                }
+
+                Node repeat;
+                repeat.kind = Node::Kind::Repeat;
+                repeat.min = min;
+                repeat.max = max;
+                repeat.greedy = greedy;
+                repeat.children.push_back(std::move(out));
+                out = std::move(repeat);
+            }
+            return true;
+        }
+
+        bool parseNumber(uint32_t& value) {
+            size_t start = pos_;
+            uint64_t result = 0;
+            while (!atEnd() && isDigit(peek())) {
+                result = std::min<uint64_t>(result * 10 + static_cast<uint64_t>(peek() - '0'), kUnbounded);
+                ++pos_;
+            }
+            value = static_cast<uint32_t>(result);
+            return pos_ > start;
+        }
+
+        bool parseCounted(uint32_t& min, uint32_t& max) {
+            ++pos_;
+            if (!parseNumber(min)) return false;
+            max = min;
+            if (!atEnd() && peek() == ',') {
+                ++pos_;
+                if (!parseNumber(max)) max = kUnbounded;
+            }
+            if (atEnd() || peek() != '}') return false;
+            ++pos_;
+
+            if (min > MAX_REPEAT || (max != kUnbounded && max > MAX_REPEAT)) {
+                return fail("repetición mayor que " + std::to_string(MAX_REPEAT));
+            }
+            if (max < min) {
+                return fail("repetición con rango invertido");
+            }
+            return true;
+        }
+
+        bool parseAtom(Node& out) {
+            char ch = peek();
+            ++pos_;
+
+            switch (ch) {
+                case '(':
+                    return parseGroup(out);
+                case '[':
+                    return parseClass(out);
+                case '.':
+                    out.kind = Node::Kind::Any;
+                    return true;
+                case '^':
+                    out.kind = Node::Kind::Assert;
+                    out.index = static_cast<uint32_t>(Assertion::LineStart);
+                    return true;
+                case '$':
+                    out.kind = Node::Kind::Assert;
+                    out.index = static_cast<uint32_t>(Assertion::LineEnd);
+                    return true;
+                case '\\':
+                    return parseEscape(out);
+                default:
+                    makeByte(out, static_cast<unsigned char>(ch));
+                    return true;
+            }
+        }
+
+        bool parseGroup(Node& out) {
+            out.kind = Node::Kind::Group;
+            out.capturing = true;
+
+            if (pos_ + 1 < pattern_.length() && peek() == '?') {
+                char kind = pattern_[pos_ + 1];
+                if (kind == ':') {
+                    out.capturing = false;
+                    pos_ += 2;
+                } else if (kind == '<' || kind == 'P') {
+                    pos_ += kind == 'P' ? 3 : 2;
+                    size_t close = pattern_.find('>', pos_);
+                    if (close == std::string::npos || close == pos_) {
+                        return fail("nombre de grupo inválido");
+                    }
+                    engine_.groupNames_.resize(engine_.groupCount_ + 2);
+                    engine_.groupNames_[engine_.groupCount_ + 1] = pattern_.substr(pos_, close - pos_);
+                    pos_ = close + 1;
+                } else {
+                    return fail("construcción de grupo no soportada");
+                }
+            }
+
+            if (out.capturing) {
+                out.index = static_cast<uint32_t>(++engine_.groupCount_);
+            }
+
+            Node inner;
+            if (!parseAlternation(inner)) return false;
+            if (atEnd() || peek() != ')') {
+                return fail("falta ')'");
+            }
+            ++pos_;
+            out.children.push_back(std::move(inner));
+            return true;
+        }
+
+        // Clases abreviadas \d \w \s y sus negaciones
+        static bool shorthandSet(char ch, std::bitset<256>& set, bool& negated) {
+            negated = ch == 'D' || ch == 'W' || ch == 'S';
+            switch (ch) {
+                case 'd': case 'D': addRange(set, '0', '9'); return true;
+                case 'w': case 'W': addWordBytes(set); return true;
+                case 's': case 'S': addSpaceBytes(set); return true;
+                default: return false;
+            }
+        }
+
+        // Escape de un solo byte (después de la barra invertida)
+        bool escapedByte(char ch, unsigned char& byte) {
+            switch (ch) {
+                case 'n': byte = '\n'; return true;
+                case 't': byte = '\t'; return true;
+                case 'r': byte = '\r'; return true;
+                case 'f': byte = '\f'; return true;
+                case 'v': byte = '\v'; return true;
+                case '0': byte = '\0'; return true;
+                case 'x': {
+                    if (pos_ + 1 >= pattern_.length() || hexValue(peek()) < 0 ||
+                        hexValue(pattern_[pos_ + 1]) < 0) {
+                        return fail("escape \\x inválido");
+                    }
+                    byte = static_cast<unsigned char>(hexValue(peek()) * 16 + hexValue(pattern_[pos_ + 1]));
+                    pos_ += 2;
+                    return true;
+                }
+                default:
+                    if ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || isDigit(ch)) {
+                        return fail(std::string("escape desconocido \\") + ch);
+                    }
+                    byte = static_cast<unsigned char>(ch);
+                    return true;
+            }
+        }
+
+        bool parseEscape(Node& out) {
+            if (atEnd()) return fail("'\\' al final del patrón");
+            char ch = peek();
+            ++pos_;
+
+            if (ch == 'b' || ch == 'B') {
+                out.kind = Node::Kind::Assert;
+                out.index = static_cast<uint32_t>(ch == 'b' ? Assertion::WordBoundary : Assertion::NotWordBoundary);
+                return true;
+            }
+
+            std::bitset<256> set;
+            bool negated = false;
+            if (shorthandSet(ch, set, negated)) {
+                if (negated) {
+                    set.flip();
+                    set.reset('\n');
+                }
+                out.kind = Node::Kind::Set;
+                out.index = addSet(set);
+                return true;
+            }
+
+            unsigned char byte = 0;
+            if (!escapedByte(ch, byte)) return false;
+            makeByte(out, byte);
+            return true;
+        }
+
+        bool parseClass(Node& out) {
+            std::bitset<256> set;
+            bool negated = false;
+            if (!atEnd() && peek() == '^') {
+                negated = true;
+                ++pos_;
+            }
+
+            bool first = true;
+            while (true) {
+                if (atEnd()) return fail("falta ']'");
+                char ch = peek();
+                if (ch == ']' && !first) {
+                    ++pos_;
+                    break;
+                }
+                first = false;
+                ++pos_;
+
+                unsigned char low = static_cast<unsigned char>(ch);
+                if (ch == '\\') {
+                    if (atEnd()) return fail("falta ']'");
+                    char escaped = peek();
+                    ++pos_;
+                    bool shorthandNegated = false;
+                    std::bitset<256> shorthand;
+                    if (shorthandSet(escaped, shorthand, shorthandNegated)) {
+                        if (shorthandNegated) {
+                            shorthand.flip();
+                            shorthand.reset('\n');
+                        }
+                        set |= shorthand;
+                        continue;
+                    }
+                    if (!escapedByte(escaped, low)) return false;
+                }
+
+                // Rango a-z (un '-' final es literal)
+                if (pos_ + 1 < pattern_.length() && peek() == '-' && pattern_[pos_ + 1] != ']') {
+                    ++pos_;
+                    unsigned char high = static_cast<unsigned char>(peek());
+                    ++pos_;
+                    if (high == '\\') {
+                        if (atEnd()) return fail("falta ']'");
+                        char escaped = peek();
+                        ++pos_;
+                        if (!escapedByte(escaped, high)) return false;
+                    }
+                    if (high < low) return fail("rango de clase invertido");
+                    addRange(set, low, high);
+                } else {
+                    set.set(low);
+                }
+            }
+
+            if (!engine_.caseSensitive_) {
+                foldSet(set);
+            }
+            if (negated) {
+                set.flip();
+                set.reset('\n');
+            }
+
+            out.kind = Node::Kind::Set;
+            engine_.sets_.push_back(set);
+            out.index = static_cast<uint32_t>(engine_.sets_.size() - 1);
+            return true;
+        }
+    };
+
+    // ========================================================================
+    // Compilación
+    // ========================================================================
+
+    RegexEngine::RegexEngine()
+        : caseSensitive_(true), valid_(false), groupCount_(0), canSkip_(false), singleLine_(true),
+          lineSpan_(0) {}
+
+    bool RegexEngine::compile(const std::string& pattern, bool caseSensitive) {
+        pattern_ = pattern;
+        caseSensitive_ = caseSensitive;
+        valid_ = false;
+        lastError_.clear();
+        groupCount_ = 0;
+        groupNames_.clear();
+        program_.clear();
+        sets_.clear();
+
+        Node root;
+        Parser parser(pattern_, *this);
+        if (!parser.parse(root)) {
+            lastError_ = parser.getError();
+            return false;
+        }
+        groupNames_.resize(groupCount_ + 1);
+
+        // Programa: Save 0, patrón, Save 1, Match
+        if (!emitInstruction({Op::Save, 0, 0, 0}) || !emit(root) ||
+            !emitInstruction({Op::Save, 0, 1, 0}) || !emitInstruction({Op::Match, 0, 0, 0})) {
+            lastError_ = "patrón demasiado complejo";
+            program_.clear();
+            return false;
+        }
+
+        computeFirstBytes();
+        computePrefix();
+        lineSpan_ = lineSpanOf(root);
+        valid_ = true;
+        return true;
+    }
+
+    bool RegexEngine::emitInstruction(const Instruction& instruction) {
+        if (program_.size() >= MAX_PROGRAM_SIZE) return false;
+        program_.push_back(instruction);
+        return true;
+    }
+
+    bool RegexEngine::emit(const Node& node) {
+        auto here = [this]() { return static_cast<uint32_t>(program_.size()); };
+
+        switch (node.kind) {
+            case Node::Kind::Empty:
+                return true;
+            case Node::Kind::Byte:
+                return emitInstruction({Op::Byte, node.byte, 0, 0});
+            case Node::Kind::Set:
+                return emitInstruction({Op::Set, 0, node.index, 0});
+            case Node::Kind::Any:
+                return emitInstruction({Op::Any, 0, 0, 0});
+            case Node::Kind::Assert:
+                return emitInstruction({Op::Assert, static_cast<uint8_t>(node.index), 0, 0});
+
+            case Node::Kind::Group:
+                if (!node.capturing) return emit(node.children.front());
+                return emitInstruction({Op::Save, 0, node.index * 2, 0}) &&
+                       emit(node.children.front()) &&
+                       emitInstruction({Op::Save, 0, node.index * 2 + 1, 0});
+
+            case Node::Kind::Concat:
+                for (const Node& child : node.children) {
+                    if (!emit(child)) return false;
+                }
+                return true;
+
+            case Node::Kind::Alternate: {
+                std::vector<uint32_t> jumps;
+                for (size_t i = 0; i < node.children.size(); ++i) {
+                    if (i + 1 == node.children.size()) {
+                        if (!emit(node.children[i])) return false;
+                        break;
+                    }
+                    uint32_t split = here();
+                    if (!emitInstruction({Op::Split, 0, split + 1, 0}) || !emit(node.children[i])) return false;
+                    jumps.push_back(here());
+                    if (!emitInstruction({Op::Jump, 0, 0, 0})) return false;
+                    program_[split].y = here();
+                }
+                for (uint32_t jump : jumps) {
+                    program_[jump].x = here();
+                }
+                return true;
+            }
+
+            case Node::Kind::Repeat: {
+                const Node& body = node.children.front();
+                for (uint32_t i = 0; i < node.min; ++i) {
+                    if (!emit(body)) return false;
+                }
+
+                if (node.max == kUnbounded) {
+                    uint32_t loop = here();
+                    if (!emitInstruction({Op::Split, 0, 0, 0}) || !emit(body) ||
+                        !emitInstruction({Op::Jump, 0, loop, 0})) {
+                        return false;
+                    }
+                    uint32_t end = here();
+                    program_[loop].x = node.greedy ? loop + 1 : end;
+                    program_[loop].y = node.greedy ? end : loop + 1;
+                    return true;
+                }
+
+                // x{n,m}: m - n copias opcionales encadenadas
+                std::vector<uint32_t> splits;
+                for (uint32_t i = node.min; i < node.max; ++i) {
+                    splits.push_back(here());
+                    if (!emitInstruction({Op::Split, 0, 0, 0}) || !emit(body)) return false;
+                }
+                uint32_t end = here();
+                for (uint32_t split : splits) {
+                    program_[split].x = node.greedy ? split + 1 : end;
+                    program_[split].y = node.greedy ? end : split + 1;
+                }
+                return true;
+            }
+
+            default:
+                break;
+        }
+        return false;
+    }
+
+    void RegexEngine::computeFirstBytes() {
+        // Cierre épsilon desde el inicio; las aserciones se ignoran (superconjunto)
+        firstBytes_.reset();
+        canSkip_ = true;
+
+        std::vector<bool> visited(program_.size(), false);
+        std::vector<uint32_t> pending{0};
+        while (!pending.empty()) {
+            uint32_t pc = pending.back();
+            pending.pop_back();
+            if (visited[pc]) continue;
+            visited[pc] = true;
+
+            const Instruction& instruction = program_[pc];
+            switch (instruction.op) {
+                case Op::Byte: firstBytes_.set(instruction.byte); break;
+                case Op::Set: firstBytes_ |= sets_[instruction.x]; break;
+                case Op::Any: firstBytes_.set(); firstBytes_.reset('\n'); break;
+                case Op::Split: pending.push_back(instruction.y); pending.push_back(instruction.x); break;
+                case Op::Jump: pending.push_back(instruction.x); break;
+                case Op::Save:
+                case Op::Assert: pending.push_back(pc + 1); break;
+                case Op::Match: canSkip_ = false; break;
+                default: break;
+            }
+        }
+    }
+
+    void RegexEngine::computePrefix() {
+        // Bytes literales consecutivos al inicio del programa (tras Save 0);
+        // con mayúsculas plegadas, las clases {x, X} cuentan como literal
+        prefix_.clear();
+        for (size_t pc = 1; pc < program_.size(); ++pc) {
+            const Instruction& instruction = program_[pc];
+            if (instruction.op == Op::Byte && instruction.byte != '\n') {
+                prefix_ += static_cast<char>(instruction.byte);
+                continue;
+            }
+            if (instruction.op == Op::Set && !caseSensitive_ && sets_[instruction.x].count() == 2) {
+                const auto& set = sets_[instruction.x];
+                char letter = 0;
+                for (char ch = 'a'; ch <= 'z' && letter == 0; ++ch) {
+                    auto lower = static_cast<unsigned char>(ch);
+                    if (set.test(lower) && set.test(lower - 32u)) letter = ch;
+                }
+                if (letter != 0) {
+                    prefix_ += letter;
+                    continue;
+                }
+            }
+            break;
+        }
+        prefixSearch_.setPattern(prefix_, caseSensitive_);
+
+        // Sin instrucciones que consuman '\n' la coincidencia cabe en una línea
+        singleLine_ = std::none_of(program_.begin(), program_.end(), [this](const Instruction& instruction) {
+            return consumes(instruction, '\n');
+        });
+    }
+
+    size_t RegexEngine::lineSpanOf(const Node& node) const {
+        // Máximo de '\n' que consume el nodo; npos si una repetición sin
+        // límite puede consumirlos
+        constexpr size_t unbounded = SearchEngine::npos;
+        switch (node.kind) {
+            case Node::Kind::Byte:
+                return node.byte == '\n' ? 1 : 0;
+            case Node::Kind::Set:
+                return sets_[node.index].test('\n') ? 1 : 0;
+            case Node::Kind::Group:
+                return lineSpanOf(node.children.front());
+            case Node::Kind::Concat: {
+                size_t total = 0;
+                for (const Node& child : node.children) {
+                    size_t span = lineSpanOf(child);
+                    if (span == unbounded || total > unbounded - 1 - span) return unbounded;
+                    total += span;
+                }
+                return total;
+            }
+            case Node::Kind::Alternate: {
+                size_t widest = 0;
+                for (const Node& child : node.children) {
+                    widest = std::max(widest, lineSpanOf(child));
+                }
+                return widest;
+            }
+            case Node::Kind::Repeat: {
+                size_t span = lineSpanOf(node.children.front());
+                if (span == 0 || node.max == 0) return 0;
+                if (span == unbounded || node.max == kUnbounded || span > (unbounded - 1) / node.max) {
+                    return unbounded;
+                }
+                return span * node.max;
+            }
+            default:
+                break;
+        }
+        return 0;
+    }
+
+    // ========================================================================
+    // Ejecución
+    // ========================================================================
+
+    bool RegexEngine::consumes(const Instruction& instruction, int byte) const {
+        switch (instruction.op) {
+            case Op::Byte: return instruction.byte == byte;
+            case Op::Set: return sets_[instruction.x].test(static_cast<size_t>(byte));
+            case Op::Any: return byte != '\n';
+            default: return false;
+        }
+    }
+
+    bool RegexEngine::assertionHolds(Assertion assertion, const Context& context) {
+        auto isWord = [](int byte) {
+            return byte >= 0 && SearchEngine::isWordByte(static_cast<unsigned char>(byte));
+        };
+
+        switch (assertion) {
+            case Assertion::LineStart: return context.previous < 0 || context.previous == '\n';
+            case Assertion::LineEnd: return context.next < 0 || context.next == '\n';
+            case Assertion::WordBoundary: return isWord(context.previous) != isWord(context.next);
+            case Assertion::NotWordBoundary: return isWord(context.previous) == isWord(context.next);
+            default: break;
+        }
+        return false;
+    }
+
+    void RegexEngine::addThread(ThreadList& list, uint32_t pc, std::vector<Position>& caps,
+                                const Context& context,
+                                std::vector<std::pair<uint32_t, Position>>& stack) const {
+        // Recorrido en profundidad con pila explícita: el orden de llegada
+        // fija la prioridad de los hilos (semántica leftmost-first)
+        stack.clear();
+        stack.emplace_back(pc, Position{});
+
+        while (!stack.empty()) {
+            auto [entry, saved] = stack.back();
+            stack.pop_back();
+
+            if (entry & kRestoreFlag) {
+                caps[entry & ~kRestoreFlag] = saved;
+                continue;
+            }
+
+            uint32_t current = entry;
+            while (!list.contains(current)) {
+                list.mark(current);
+                const Instruction& instruction = program_[current];
+
+                if (instruction.op == Op::Jump) {
+                    current = instruction.x;
+                } else if (instruction.op == Op::Split) {
+                    stack.emplace_back(instruction.y, Position{});
+                    current = instruction.x;
+                } else if (instruction.op == Op::Save) {
+                    stack.emplace_back(instruction.x | kRestoreFlag, caps[instruction.x]);
+                    caps[instruction.x] = context.position;
+                    ++current;
+                } else if (instruction.op == Op::Assert) {
+                    if (!assertionHolds(static_cast<Assertion>(instruction.byte), context)) break;
+                    ++current;
+                } else {
+                    list.push(current, caps);
+                    break;
+                }
+            }
+        }
+    }
+
+    RegexMatch RegexEngine::makeMatch(const std::vector<Position>& caps) const {
+        RegexMatch match;
+        match.groups.resize(groupCount_ + 1);
+        for (size_t group = 0; group <= groupCount_; ++group) {
+            const Position& start = caps[group * 2];
+            const Position& end = caps[group * 2 + 1];
+            if (start.line == SearchEngine::npos || end.line == SearchEngine::npos) {
+                match.groups[group] = {SearchEngine::npos, SearchEngine::npos, SearchEngine::npos, SearchEngine::npos};
+            } else {
+                match.groups[group] = {start.line, start.column, end.line, end.column};
+            }
+        }
+        match.range = match.groups[0];
+        return match;
+    }
+
+    SearchStatus RegexEngine::search(const TextBuffer& buffer, size_t line, size_t col,
+                                     const MatchCallback& onMatch, const SearchControl& control) const {
+        BufferLines lines(buffer);
+        return searchLines(lines, line, col, onMatch, control);
+    }
+
+    SearchStatus RegexEngine::search(const char* data, size_t length, size_t line, size_t col,
+                                     const MatchCallback& onMatch, const SearchControl& control) const {
+        ViewLines lines(data, length);
+        return searchLines(lines, line, col, onMatch, control);
+    }
+
+    template <typename Lines>
+    SearchStatus RegexEngine::searchLines(Lines& lines, size_t line, size_t col,
+                                          const MatchCallback& onMatch, const SearchControl& control) const {
+        if (!valid_ || line >= lines.count()) return SearchStatus::Completed;
+
+        const size_t slots = 2 * (groupCount_ + 1);
+        const Position none{SearchEngine::npos, SearchEngine::npos};
+
+        ThreadList current(program_.size(), slots);
+        ThreadList next(program_.size(), slots);
+        std::vector<Position> caps(slots, none);
+        std::vector<Position> best(slots, none);
+        std::vector<std::pair<uint32_t, Position>> stack;
+
+        int single = -1;
+        if (canSkip_ && firstBytes_.count() == 1) {
+            for (int byte = 0; byte < 256; ++byte) {
+                if (firstBytes_.test(static_cast<size_t>(byte))) single = byte;
+            }
+        }
+
+        const SearchEngine* prefix = prefix_.length() >= 2 ? &prefixSearch_ : nullptr;
+        std::unique_ptr<LazyDfa> dfa;
+        size_t filteredLine = SearchEngine::npos;
+        if (singleLine_) {
+            dfa = std::make_unique<LazyDfa>(*this);
+        }
+
+        StreamCursor<Lines> cursor(lines, line, col);
+        bool matched = false;
+        size_t matchCount = 0;
+        size_t steps = 0;
+
+        auto cancelled = [&]() {
+            return (++steps & 0x3FFF) == 0 && control.cancel &&
+                   control.cancel->load(std::memory_order_relaxed);
+        };
+
+        while (true) {
+            if (cancelled()) return SearchStatus::Cancelled;
+
+            if (!matched && current.empty()) {
+                // Sin hilos vivos: saltar el texto que no puede iniciar una
+                // coincidencia (prefijo/bytes iniciales, luego el DFA por línea)
+                bool candidate = false;
+                while (!candidate) {
+                    if (cursor.line() > control.endLine) return SearchStatus::Completed;
+                    if (cancelled()) return SearchStatus::Cancelled;
+
+                    candidate = !canSkip_ || cursor.skipInLine(firstBytes_, single, prefix);
+                    if (candidate && dfa && filteredLine != cursor.line()) {
+                        filteredLine = cursor.line();
+                        candidate = dfa->mayMatch(cursor.data() + cursor.column(), cursor.length() - cursor.column());
+                    }
+                    if (!candidate && !cursor.nextLine()) return SearchStatus::Completed;
+                }
+            }
+
+            const int byte = cursor.current();
+            const Position here{cursor.line(), cursor.column()};
+
+            // Un hilo nuevo por posición, con la prioridad más baja
+            if (!matched && here.line <= control.endLine &&
+                (!canSkip_ || (byte >= 0 && firstBytes_.test(static_cast<size_t>(byte))))) {
+                std::fill(caps.begin(), caps.end(), none);
+                addThread(current, 0, caps, Context{here, cursor.previous(), byte}, stack);
+            }
+
+            Position after = here;
+            int afterNext = -1;
+            if (byte >= 0) {
+                after = cursor.atLineEnd() ? Position{here.line + 1, 0} : Position{here.line, here.column + 1};
+                afterNext = cursor.peek();
+            }
+
+            next.clear();
+            for (size_t i = 0; i < current.size(); ++i) {
+                const Instruction& instruction = program_[current.pc(i)];
+                if (instruction.op == Op::Match) {
+                    // Los hilos de menor prioridad se descartan
+                    current.copyCaps(i, best);
+                    matched = true;
+                    break;
+                }
+                if (byte >= 0 && consumes(instruction, byte)) {
+                    current.copyCaps(i, caps);
+                    addThread(next, current.pc(i) + 1, caps, Context{after, byte, afterNext}, stack);
+                }
+            }
+            std::swap(current, next);
+
+            if (matched && current.empty()) {
+                if (!onMatch(makeMatch(best))) return SearchStatus::Stopped;
+                if (++matchCount >= control.maxMatches) return SearchStatus::Stopped;
+
+                // Continuar tras la coincidencia; una vacía avanza un byte
+                matched = false;
+                cursor.seek(best[1].line, best[1].column);
+                if (best[0].line == best[1].line && best[0].column == best[1].column && !cursor.advance()) {
+                    return SearchStatus::Completed;
+                }
+                continue;
+            }
+
+            if (byte < 0) return SearchStatus::Completed;
+            cursor.advance();
+        }
+    }
+
+    bool RegexEngine::mayMatch(const char* data, size_t length) const {
+        return valid_ && (prefix_.empty() || prefixSearch_.find(data, length, 0) != SearchEngine::npos);
+    }
+
+    bool RegexEngine::findForward(const TextBuffer& buffer, size_t line, size_t col, RegexMatch& match,
+                                  const std::atomic<bool>* cancel) const {
+        bool found = false;
+        SearchControl control;
+        control.cancel = cancel;
+        control.maxMatches = 1;
+
+        search(buffer, line, col, [&](const RegexMatch& candidate) {
+            match = candidate;
+            found = true;
+            return false;
+        }, control);
+        return found;
+    }
+
+    bool RegexEngine::findBackward(const TextBuffer& buffer, size_t line, size_t col, RegexMatch& match,
+                                   const std::atomic<bool>* cancel) const {
+        if (!valid_ || buffer.getLineCount() == 0) return false;
+        if (line >= buffer.getLineCount()) {
+            line = buffer.getLineCount() - 1;
+            col = SearchEngine::npos;
+        }
+
+        // Ventanas crecientes hacia atrás: normalmente basta con unas pocas
+        // líneas y no se recorre el documento desde el principio
+        size_t window = 64;
+        while (true) {
+            size_t startLine = line > window ? line - window : 0;
+            bool found = false;
+
+            SearchControl control;
+            control.cancel = cancel;
+            control.endLine = line;
+
+            SearchStatus status = search(buffer, startLine, 0, [&](const RegexMatch& candidate) {
+                if (candidate.range.line < line || candidate.range.column < col) {
+                    match = candidate;
+                    found = true;
+                    return true;
+                }
+                return false;
+            }, control);
+
+            if (status == SearchStatus::Cancelled) return false;
+            if (found || startLine == 0) return found;
+            window *= 8;
+        }
+    }
+
+    // ========================================================================
+    // Reemplazo
+    // ========================================================================
+
+    std::string RegexEngine::expandReplacement(const std::string& replacement, const RegexMatch& match,
+                                               const TextBuffer& buffer) const {
+        auto appendGroup = [&](std::string& out, size_t group) {
+            if (group >= match.groups.size()) return;
+            const SearchMatch& range = match.groups[group];
+            if (range.line == SearchEngine::npos) return;
+            out += buffer.getText(range.line, range.column, range.endLine, range.endColumn);
+        };
+
+        std::string result;
+        result.reserve(replacement.length());
+
+        for (size_t i = 0; i < replacement.length(); ++i) {
+            char ch = replacement[i];
+            bool hasNext = i + 1 < replacement.length();
+
+            if (ch == '\\' && hasNext) {
+                char escaped = replacement[++i];
+                result += escaped == 'n' ? '\n' : escaped == 't' ? '\t' : escaped;
+                continue;
+            }
+            if (ch != '$' || !hasNext) {
+                result += ch;
+                continue;
+            }
+
+            char next = replacement[i + 1];
+            if (next == '$') {
+                result += '$';
+                ++i;
+            } else if (isDigit(next)) {
+                // $1..$99 (el número más largo que exista como grupo)
+                size_t group = static_cast<size_t>(next - '0');
+                ++i;
+                if (i + 1 < replacement.length() && isDigit(replacement[i + 1])) {
+                    size_t wider = group * 10 + static_cast<size_t>(replacement[i + 1] - '0');
+                    if (wider <= groupCount_) {
+                        group = wider;
+                        ++i;
+                    }
+                }
+                appendGroup(result, group);
+            } else if (next == '{') {
+                size_t close = replacement.find('}', i + 2);
+                if (close == std::string::npos) {
+                    result += ch;
+                    continue;
+                }
+                std::string name = replacement.substr(i + 2, close - i - 2);
+                i = close;
+                if (!name.empty() && name.length() < 10 && std::all_of(name.begin(), name.end(), isDigit)) {
+                    appendGroup(result, static_cast<size_t>(std::stoul(name)));
+                } else {
+                    auto it = std::find(groupNames_.begin(), groupNames_.end(), name);
+                    if (it != groupNames_.end() && !name.empty()) {
+                        appendGroup(result, static_cast<size_t>(it - groupNames_.begin()));
+                    }
+                }
+            } else {
+                result += ch;
+            }
+        }
+        return result;
+    }
+
+} // namespace CoralCode
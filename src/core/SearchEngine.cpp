@@ -0,0 +1,365 @@
+/**
+ * @file SearchEngine.cpp
+ * @brief Búsqueda de subcadenas con filtrado por bloques
+ */
+
+#include "SearchEngine.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CORALCODE_SEARCH_SSE2 1
+#endif
+
+namespace CoralCode {
+
+    namespace {
+
+        /**
+         * @brief Tablas de plegado ASCII (minúscula y caso opuesto)
+         *
+         * Los bytes >= 0x80 (UTF-8) no se pliegan.
+         */
+        struct FoldTables {
+            unsigned char lower[256];
+            unsigned char other[256];
+
+            FoldTables() : lower{}, other{} {
+                for (int i = 0; i < 256; ++i) {
+                    auto ch = static_cast<unsigned char>(i);
+                    lower[i] = ch;
+                    other[i] = ch;
+                    if (ch >= 'A' && ch <= 'Z') {
+                        lower[i] = static_cast<unsigned char>(ch + 32);
+                        other[i] = lower[i];
+                    } else if (ch >= 'a' && ch <= 'z') {
+                        other[i] = static_cast<unsigned char>(ch - 32);
+                    }
+                }
+            }
+        };
+
+        const FoldTables kFold;
+
+        inline unsigned char byteAt(const char* data, size_t index) {
+            return static_cast<unsigned char>(data[index]);
+        }
+
+        // Compara `count` bytes plegando mayúsculas; `folded` ya está en minúsculas
+        inline bool foldedEquals(const char* text, const char* folded, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                if (kFold.lower[byteAt(text, i)] != byteAt(folded, i)) return false;
+            }
+            return true;
+        }
+
+#ifdef CORALCODE_SEARCH_SSE2
+        inline unsigned lowestBit(unsigned mask) {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+
+        /**
+         * @brief Filtro por primer y último byte en bloques de 16 posiciones
+         *
+         * Solo las posiciones donde ambos extremos coinciden se verifican
+         * byte a byte, por lo que el coste típico es de dos cargas y dos
+         * comparaciones por cada 16 bytes de texto.
+         */
+        template <bool Fold>
+        size_t scanBlocks(const char* data, size_t length, size_t from,
+                          const char* needle, size_t m) {
+            const size_t lastStart = length - m;
+            const unsigned char firstByte = byteAt(needle, 0);
+            const unsigned char lastByte = byteAt(needle, m - 1);
+
+            const __m128i first = _mm_set1_epi8(static_cast<char>(firstByte));
+            const __m128i last = _mm_set1_epi8(static_cast<char>(lastByte));
+            const __m128i firstAlt = _mm_set1_epi8(static_cast<char>(kFold.other[firstByte]));
+            const __m128i lastAlt = _mm_set1_epi8(static_cast<char>(kFold.other[lastByte]));
+
+            size_t i = from;
+            while (i + 15 <= lastStart) {
+                __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + m - 1));
+
+                __m128i eqHead = _mm_cmpeq_epi8(head, first);
+                __m128i eqTail = _mm_cmpeq_epi8(tail, last);
+                if (Fold) {
+                    eqHead = _mm_or_si128(eqHead, _mm_cmpeq_epi8(head, firstAlt));
+                    eqTail = _mm_or_si128(eqTail, _mm_cmpeq_epi8(tail, lastAlt));
+                }
+
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(eqHead, eqTail)));
+                while (mask != 0) {
+                    size_t pos = i + lowestBit(mask);
+                    bool equal = m <= 2 ||
+                        (Fold ? foldedEquals(data + pos + 1, needle + 1, m - 2)
+                              : std::memcmp(data + pos + 1, needle + 1, m - 2) == 0);
+                    if (equal) return pos;
+                    mask &= mask - 1;
+                }
+                i += 16;
+            }
+
+            // Cola de menos de 16 posiciones
+            for (; i <= lastStart; ++i) {
+                unsigned char head = byteAt(data, i);
+                if ((Fold ? kFold.lower[head] : head) != firstByte) continue;
+                bool equal = Fold ? foldedEquals(data + i + 1, needle + 1, m - 1)
+                                  : std::memcmp(data + i + 1, needle + 1, m - 1) == 0;
+                if (equal) return i;
+            }
+            return SearchEngine::npos;
+        }
+#else
+        /**
+         * @brief Boyer-Moore-Horspool sobre bytes (plegados si Fold)
+         */
+        template <bool Fold>
+        size_t scanHorspool(const char* data, size_t length, size_t from,
+                            const char* needle, size_t m, const std::array<size_t, 256>& skip) {
+            const size_t lastStart = length - m;
+            const unsigned char lastByte = byteAt(needle, m - 1);
+
+            size_t i = from;
+            while (i <= lastStart) {
+                unsigned char ch = byteAt(data, i + m - 1);
+                if (Fold) ch = kFold.lower[ch];
+                if (ch == lastByte) {
+                    bool equal = Fold ? foldedEquals(data + i, needle, m - 1)
+                                      : std::memcmp(data + i, needle, m - 1) == 0;
+                    if (equal) return i;
+                }
+                i += skip[ch];
+            }
+            return SearchEngine::npos;
+        }
+#endif
+
+    } // namespace
+
+    SearchEngine::SearchEngine()
+        : caseSensitive_(true), foldCase_(false), wholeWord_(false), skip_{} {}
+
+    SearchEngine::SearchEngine(const std::string& pattern, bool caseSensitive, bool wholeWord)
+        : caseSensitive_(true), foldCase_(false), wholeWord_(false), skip_{} {
+        setPattern(pattern, caseSensitive, wholeWord);
+    }
+
+    // ========================================================================
+    // Configuración del patrón
+    // ========================================================================
+
+    void SearchEngine::setPattern(const std::string& pattern, bool caseSensitive, bool wholeWord) {
+        pattern_ = pattern;
+        wholeWord_ = wholeWord;
+
+        // Sin letras ASCII, plegar no cambia nada: usar la ruta exacta
+        bool hasLetters = std::any_of(pattern.begin(), pattern.end(), [](char ch) {
+            auto byte = static_cast<unsigned char>(ch);
+            return kFold.other[byte] != byte;
+        });
+        caseSensitive_ = caseSensitive;
+        foldCase_ = !caseSensitive && hasLetters;
+
+        foldedPattern_ = pattern;
+        if (foldCase_) {
+            for (char& ch : foldedPattern_) {
+                ch = static_cast<char>(kFold.lower[static_cast<unsigned char>(ch)]);
+            }
+        }
+
+        // Segmentos separados por '\n' para buscar en el buffer por líneas
+        segments_.clear();
+        size_t start = 0;
+        while (true) {
+            size_t next = foldedPattern_.find('\n', start);
+            if (next == std::string::npos) {
+                segments_.push_back(foldedPattern_.substr(start));
+                break;
+            }
+            segments_.push_back(foldedPattern_.substr(start, next - start));
+            start = next + 1;
+        }
+
+        const size_t m = foldedPattern_.length();
+        skip_.fill(m == 0 ? 1 : m);
+        for (size_t i = 0; i + 1 < m; ++i) {
+            skip_[static_cast<unsigned char>(foldedPattern_[i])] = m - 1 - i;
+        }
+    }
+
+    // ========================================================================
+    // Búsqueda en memoria contigua
+    // ========================================================================
+
+    size_t SearchEngine::scan(const char* data, size_t length, size_t from) const {
+        const size_t m = foldedPattern_.length();
+        if (m == 0 || length < m || from > length - m) return npos;
+
+        const char* needle = foldedPattern_.data();
+        if (m == 1 && !foldCase_) {
+            const void* hit = std::memchr(data + from, needle[0], length - from);
+            return hit ? static_cast<size_t>(static_cast<const char*>(hit) - data) : npos;
+        }
+
+#ifdef CORALCODE_SEARCH_SSE2
+        return foldCase_ ? scanBlocks<true>(data, length, from, needle, m)
+                         : scanBlocks<false>(data, length, from, needle, m);
+#else
+        return foldCase_ ? scanHorspool<true>(data, length, from, needle, m, skip_)
+                         : scanHorspool<false>(data, length, from, needle, m, skip_);
+#endif
+    }
+
+    size_t SearchEngine::find(const char* data, size_t length, size_t from) const {
+        size_t pos = scan(data, length, from);
+        if (!wholeWord_) return pos;
+
+        while (pos != npos && !isWordBoundary(data, length, pos, pos + pattern_.length())) {
+            pos = scan(data, length, pos + 1);
+        }
+        return pos;
+    }
+
+    size_t SearchEngine::findLast(const char* data, size_t length, size_t before) const {
+        size_t last = npos;
+        size_t pos = find(data, length, 0);
+        while (pos != npos && pos < before) {
+            last = pos;
+            pos = find(data, length, pos + 1);
+        }
+        return last;
+    }
+
+    // ========================================================================
+    // Búsqueda en el buffer
+    // ========================================================================
+
+    bool SearchEngine::findForward(const TextBuffer& buffer, size_t line, size_t col, SearchMatch& match,
+                                   size_t endLine) const {
+        if (pattern_.empty()) return false;
+
+        // endLine es la última línea (inclusive) donde puede empezar la coincidencia
+        const size_t lineCount = endLine < buffer.getLineCount() ? endLine + 1 : buffer.getLineCount();
+        for (size_t current = line; current < lineCount; ++current) {
+            if (isMultiLine()) {
+                if (!matchLinesAt(buffer, current, match)) continue;
+                if (current == line && match.column < col) continue;
+                return true;
+            }
+
+            const std::string& text = buffer.getLine(current);
+            size_t from = current == line ? std::min(col, text.length()) : 0;
+            size_t pos = find(text.data(), text.length(), from);
+            if (pos != npos) {
+                match = {current, pos, current, pos + pattern_.length()};
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool SearchEngine::findBackward(const TextBuffer& buffer, size_t line, size_t col, SearchMatch& match) const {
+        if (pattern_.empty() || buffer.getLineCount() == 0) return false;
+
+        // Coincidencias que empiezan estrictamente antes de (line, col)
+        size_t current = std::min(line, buffer.getLineCount() - 1);
+        if (current < line) col = npos;
+
+        while (true) {
+            if (isMultiLine()) {
+                if (matchLinesAt(buffer, current, match) && (current < line || match.column < col)) {
+                    return true;
+                }
+            } else {
+                const std::string& text = buffer.getLine(current);
+                size_t before = current == line ? col : npos;
+                size_t pos = findLast(text.data(), text.length(), before);
+                if (pos != npos) {
+                    match = {current, pos, current, pos + pattern_.length()};
+                    return true;
+                }
+            }
+
+            if (current == 0) return false;
+            --current;
+        }
+    }
+
+    std::vector<SearchMatch> SearchEngine::findAll(const TextBuffer& buffer) const {
+        std::vector<SearchMatch> matches;
+        SearchMatch match{};
+        size_t line = 0;
+        size_t col = 0;
+
+        while (findForward(buffer, line, col, match)) {
+            matches.push_back(match);
+            // Sin solapamientos: continuar tras el final de la coincidencia
+            line = match.endLine;
+            col = match.endColumn;
+            if (line == match.line && col == match.column) ++col;
+        }
+        return matches;
+    }
+
+    // ========================================================================
+    // Métodos internos
+    // ========================================================================
+
+    bool SearchEngine::isWordByte(unsigned char ch) {
+        return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') ||
+               (ch >= '0' && ch <= '9') || ch == '_';
+    }
+
+    bool SearchEngine::isWordBoundary(const char* data, size_t length, size_t start, size_t end) const {
+        if (start > 0 && isWordByte(byteAt(data, start - 1))) return false;
+        if (end < length && isWordByte(byteAt(data, end))) return false;
+        return true;
+    }
+
+    bool SearchEngine::segmentEquals(const std::string& text, size_t offset, const std::string& segment) const {
+        if (offset + segment.length() > text.length()) return false;
+        return foldCase_ ? foldedEquals(text.data() + offset, segment.data(), segment.length())
+                         : text.compare(offset, segment.length(), segment) == 0;
+    }
+
+    bool SearchEngine::matchLinesAt(const TextBuffer& buffer, size_t line, SearchMatch& match) const {
+        // El primer segmento termina la línea, los intermedios la ocupan
+        // entera y el último empieza la línea final
+        const size_t lastSegment = segments_.size() - 1;
+        if (line + lastSegment >= buffer.getLineCount()) return false;
+
+        const std::string& firstLine = buffer.getLine(line);
+        if (firstLine.length() < segments_[0].length()) return false;
+        size_t column = firstLine.length() - segments_[0].length();
+        if (!segmentEquals(firstLine, column, segments_[0])) return false;
+
+        for (size_t i = 1; i < lastSegment; ++i) {
+            const std::string& middle = buffer.getLine(line + i);
+            if (middle.length() != segments_[i].length() || !segmentEquals(middle, 0, segments_[i])) {
+                return false;
+            }
+        }
+
+        const std::string& endLine = buffer.getLine(line + lastSegment);
+        const size_t endColumn = segments_[lastSegment].length();
+        if (!segmentEquals(endLine, 0, segments_[lastSegment])) return false;
+
+        if (wholeWord_) {
+            if (column > 0 && isWordByte(byteAt(firstLine.data(), column - 1))) return false;
+            if (endColumn < endLine.length() && isWordByte(byteAt(endLine.data(), endColumn))) return false;
+        }
+
+        match = {line, column, line + lastSegment, endColumn};
+        return true;
+    }
+
+} // namespace CoralCode
@@ -0,0 +1,261 @@
+/**
+ * @file SearchMatchIndex.cpp
+ * @brief Índice de coincidencias mantenido entre ediciones
+ */
+
+#include "SearchMatchIndex.hpp"
+#include "RegexEngine.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace CoralCode {
+
+    namespace {
+
+        bool startsBefore(const SearchMatch& a, const SearchMatch& b) {
+            return a.line < b.line || (a.line == b.line && a.column < b.column);
+        }
+
+        // La coincidencia sigue abierta al empezar la línea
+        bool covers(const SearchMatch& match, size_t line) {
+            return match.endLine > line || (match.endLine == line && match.endColumn > 0);
+        }
+
+    } // namespace
+
+    SearchMatchIndex::SearchMatchIndex()
+        : buffer_(nullptr), listenerId_(0), literal_(nullptr), regex_(nullptr),
+          lineSpan_(0), scannedUntil_(0) {}
+
+    SearchMatchIndex::~SearchMatchIndex() {
+        detach();
+    }
+
+    // ========================================================================
+    // Conexión con el buffer
+    // ========================================================================
+
+    void SearchMatchIndex::attach(TextBuffer& buffer) {
+        detach();
+        buffer_ = &buffer;
+        listenerId_ = buffer.addChangeListener([this](const TextChange& change) { applyChange(change); });
+        restart();
+    }
+
+    void SearchMatchIndex::detach() {
+        if (buffer_) {
+            buffer_->removeChangeListener(listenerId_);
+            buffer_ = nullptr;
+        }
+        matches_.clear();
+        scannedUntil_ = 0;
+    }
+
+    void SearchMatchIndex::setSearch(const SearchEngine* literal, const RegexEngine* regex) {
+        literal_ = literal && !literal->isEmpty() ? literal : nullptr;
+        regex_ = !literal_ && regex && regex->isValid() ? regex : nullptr;
+
+        if (literal_) {
+            lineSpan_ = literal_->getLineSpan();
+        } else {
+            lineSpan_ = regex_ ? regex_->getLineSpan() : 0;
+        }
+        restart();
+    }
+
+    void SearchMatchIndex::clear() {
+        setSearch(nullptr, nullptr);
+    }
+
+    void SearchMatchIndex::restart() {
+        matches_.clear();
+        scannedUntil_ = 0;
+    }
+
+    // ========================================================================
+    // Escaneo por tramos
+    // ========================================================================
+
+    size_t SearchMatchIndex::scanStep(size_t maxLines) {
+        if (!isActive() || isComplete() || maxLines == 0) return 0;
+
+        const size_t endLine = std::min(scannedUntil_ + maxLines, buffer_->getLineCount());
+        scanLines(scannedUntil_, endLine, matches_);
+
+        size_t scanned = endLine - scannedUntil_;
+        scannedUntil_ = endLine;
+        return scanned;
+    }
+
+    bool SearchMatchIndex::isComplete() const {
+        return !isActive() || scannedUntil_ >= buffer_->getLineCount();
+    }
+
+    double SearchMatchIndex::getProgress() const {
+        if (isComplete()) return 1.0;
+        return static_cast<double>(scannedUntil_) / static_cast<double>(buffer_->getLineCount());
+    }
+
+    void SearchMatchIndex::scanLines(size_t firstLine, size_t endLine, std::vector<SearchMatch>& out) const {
+        // Coincidencias que empiezan en [firstLine, endLine); pueden terminar después.
+        // Si la anterior cruza hasta firstLine, el recorrido sigue desde su final
+        size_t line = firstLine;
+        size_t col = 0;
+        auto previous = lowerBound(firstLine, 0);
+        if (previous != matches_.begin() && covers(*std::prev(previous), firstLine)) {
+            line = std::prev(previous)->endLine;
+            col = std::prev(previous)->endColumn;
+        }
+        if (line >= endLine) return;
+
+        if (literal_) {
+            SearchMatch match{};
+            while (literal_->findForward(*buffer_, line, col, match, endLine - 1)) {
+                out.push_back(match);
+                line = match.endLine;
+                col = match.endColumn;
+                if (line == match.line && col == match.column) ++col;
+                if (line >= endLine) break;
+            }
+            return;
+        }
+
+        SearchControl control;
+        control.endLine = endLine - 1;
+        regex_->search(*buffer_, line, col, [&out, endLine](const RegexMatch& match) {
+            if (match.range.line >= endLine) return false;
+            out.push_back(match.range);
+            return true;
+        }, control);
+    }
+
+    // ========================================================================
+    // Consultas
+    // ========================================================================
+
+    std::vector<SearchMatch>::iterator SearchMatchIndex::lowerBound(size_t line, size_t col) {
+        return std::lower_bound(matches_.begin(), matches_.end(), SearchMatch{line, col, line, col}, startsBefore);
+    }
+
+    std::vector<SearchMatch>::const_iterator SearchMatchIndex::lowerBound(size_t line, size_t col) const {
+        return std::lower_bound(matches_.begin(), matches_.end(), SearchMatch{line, col, line, col}, startsBefore);
+    }
+
+    size_t SearchMatchIndex::findNextIndex(size_t line, size_t col) const {
+        auto it = lowerBound(line, col);
+        return it == matches_.end() ? npos : static_cast<size_t>(it - matches_.begin());
+    }
+
+    size_t SearchMatchIndex::findPreviousIndex(size_t line, size_t col) const {
+        auto it = lowerBound(line, col);
+        return it == matches_.begin() ? npos : static_cast<size_t>(it - matches_.begin()) - 1;
+    }
+
+    size_t SearchMatchIndex::indexOf(size_t line, size_t col) const {
+        auto it = lowerBound(line, col);
+        if (it == matches_.end() || it->line != line || it->column != col) return npos;
+        return static_cast<size_t>(it - matches_.begin());
+    }
+
+    std::vector<SearchMatch> SearchMatchIndex::getMatchesInLines(size_t firstLine, size_t lastLine) const {
+        // Incluye coincidencias multi-línea que empiezan antes y entran en el rango
+        size_t from = lineSpan_ == npos || lineSpan_ > firstLine ? 0 : firstLine - lineSpan_;
+        std::vector<SearchMatch> result;
+        for (auto it = lowerBound(from, 0); it != matches_.end() && it->line <= lastLine; ++it) {
+            if (it->endLine >= firstLine) {
+                result.push_back(*it);
+            }
+        }
+        return result;
+    }
+
+    // ========================================================================
+    // Actualización incremental
+    // ========================================================================
+
+    void SearchMatchIndex::applyChange(const TextChange& change) {
+        if (!isActive()) return;
+
+        const size_t oldEnd = change.firstLine + change.removedLines;
+        const size_t newEnd = change.firstLine + change.insertedLines;
+
+        if (lineSpan_ == npos) {
+            // Patrón sin límite de líneas: el escaneo por tramos sigue desde la
+            // última coincidencia que termina antes de la edición (o desde el
+            // principio), no desde cero en cada pulsación
+            auto reaching = std::partition_point(matches_.begin(), matches_.end(),
+                                                 [&change](const SearchMatch& match) {
+                                                     return match.endLine < change.firstLine;
+                                                 });
+            const size_t resume = reaching == matches_.begin() ? 0 : std::prev(reaching)->line;
+            if (resume < scannedUntil_) {
+                matches_.erase(lowerBound(resume, 0), matches_.end());
+                scannedUntil_ = resume;
+            }
+            return;
+        }
+
+        const size_t regionStart = change.firstLine > lineSpan_ ? change.firstLine - lineSpan_ : 0;
+
+        // Edición en la parte aún no escaneada: el recorrido la alcanzará
+        if (regionStart >= scannedUntil_) return;
+
+        // Quitar las coincidencias que empiezan en la región afectada; la
+        // última marca hasta dónde llegaba el escaneo anterior
+        auto first = lowerBound(regionStart, 0);
+        auto last = lowerBound(oldEnd, 0);
+        SearchMatch stale{newEnd, 0, newEnd, 0};
+        if (last != first && std::prev(last)->endLine >= oldEnd) {
+            stale.endLine = std::prev(last)->endLine - oldEnd + newEnd;
+            stale.endColumn = std::prev(last)->endColumn;
+        }
+        auto insertAt = matches_.erase(first, last);
+
+        // Desplazar las posteriores
+        if (newEnd != oldEnd) {
+            for (auto it = insertAt; it != matches_.end(); ++it) {
+                it->line = it->line - oldEnd + newEnd;
+                it->endLine = it->endLine - oldEnd + newEnd;
+            }
+        }
+
+        std::vector<SearchMatch> fresh;
+        size_t scanEnd = newEnd;
+        if (scannedUntil_ >= oldEnd) {
+            scannedUntil_ = scannedUntil_ - oldEnd + newEnd;
+
+            // Re-escanear hasta una línea que ni las coincidencias quitadas ni
+            // las nuevas cruzan: desde ella el recorrido es el mismo que antes
+            // y las coincidencias conservadas siguen siendo válidas
+            while (scanEnd <= scannedUntil_ && scanEnd - regionStart <= MAX_SYNC_RESCAN_LINES) {
+                auto keep = std::lower_bound(insertAt, matches_.end(), SearchMatch{scanEnd, 0, scanEnd, 0}, startsBefore);
+                if (keep != insertAt) {
+                    stale = *std::prev(keep);
+                    insertAt = matches_.erase(insertAt, keep);
+                }
+
+                fresh.clear();
+                scanLines(regionStart, scanEnd, fresh);
+
+                size_t reach = scanEnd;
+                if (covers(stale, scanEnd)) {
+                    reach = stale.endLine + (stale.endColumn > 0 ? 1 : 0);
+                }
+                if (!fresh.empty() && covers(fresh.back(), scanEnd)) {
+                    reach = std::max(reach, fresh.back().endLine + (fresh.back().endColumn > 0 ? 1 : 0));
+                }
+                if (reach == scanEnd) {
+                    matches_.insert(insertAt, fresh.begin(), fresh.end());
+                    return;
+                }
+                scanEnd = reach;
+            }
+        }
+
+        // Región que corta el límite del escaneo o demasiado grande para
+        // hacerla en la edición: el escaneo por tramos sigue desde ella
+        matches_.erase(insertAt, matches_.end());
+        scannedUntil_ = regionStart;
+    }
+
+} // namespace CoralCode
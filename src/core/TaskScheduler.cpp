@@ -0,0 +1,328 @@
+/**
+ * @file TaskScheduler.cpp
+ * @brief Planificador de tareas con robo de trabajo y prioridades
+ */
+
+#include "TaskScheduler.hpp"
+#include "LatencyTracer.hpp"
+#include <algorithm>
+
+namespace CoralCode {
+
+    namespace {
+
+        // Hilo actual (si es un worker) para encolar en su propia cola
+        thread_local const TaskScheduler* tCurrentScheduler = nullptr;
+        thread_local size_t tCurrentWorker = 0;
+
+        double elapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+            return std::chrono::duration<double, std::milli>(to - from).count();
+        }
+
+    } // namespace
+
+    // ========================================================================
+    // CancellationToken
+    // ========================================================================
+
+    CancellationToken::CancellationToken() : version_(0) {}
+
+    CancellationToken CancellationToken::create() {
+        CancellationToken token;
+        token.flag_ = std::make_shared<std::atomic<bool>>(false);
+        return token;
+    }
+
+    CancellationToken CancellationToken::forVersion(std::shared_ptr<const std::atomic<uint64_t>> clock,
+                                                    uint64_t version) {
+        CancellationToken token = create();
+        token.clock_ = std::move(clock);
+        token.version_ = version;
+        return token;
+    }
+
+    void CancellationToken::cancel() const {
+        if (flag_) {
+            flag_->store(true, std::memory_order_relaxed);
+        }
+    }
+
+    bool CancellationToken::isCancelled() const {
+        if (flag_ && flag_->load(std::memory_order_relaxed)) return true;
+        return clock_ && clock_->load(std::memory_order_acquire) != version_;
+    }
+
+    // ========================================================================
+    // Ciclo de vida
+    // ========================================================================
+
+    TaskScheduler::TaskScheduler(size_t workerCount)
+        : nextWorker_(0), maxBackground_(1), stopping_(false), runningBackground_(0), outstanding_(0) {
+        if (workerCount == 0) {
+            // Un núcleo queda para el hilo de la UI
+            const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+            workerCount = hardware > 1 ? hardware - 1 : 1;
+        }
+        // Background deja siempre un hilo libre para Interactive/Visible
+        maxBackground_ = workerCount > 1 ? workerCount - 1 : 1;
+        for (auto& queued : queued_) {
+            queued.store(0, std::memory_order_relaxed);
+        }
+
+        workers_.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers_[i]->thread = std::thread(&TaskScheduler::workerLoop, this, i);
+        }
+    }
+
+    TaskScheduler::~TaskScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+
+        // Lo que quedó encolado se descarta (los futuros reciben broken_promise)
+        for (auto& worker : workers_) {
+            for (auto& queue : worker->queues) {
+                for (Task& task : queue) {
+                    finishTask(task, false, 0.0, 0.0);
+                }
+                queue.clear();
+            }
+        }
+    }
+
+    TaskScheduler& TaskScheduler::shared() {
+        static TaskScheduler scheduler;
+        return scheduler;
+    }
+
+    // ========================================================================
+    // Encolado
+    // ========================================================================
+
+    void TaskScheduler::submit(const std::string& name, TaskPriority priority, Work work, CancellationToken token) {
+        const size_t level = static_cast<size_t>(priority);
+        const size_t target = tCurrentScheduler == this
+                                  ? tCurrentWorker
+                                  : nextWorker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+
+        outstanding_.fetch_add(1, std::memory_order_relaxed);
+        {
+            Worker& worker = *workers_[target];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.queues[level].push_back(
+                Task{name, priority, std::move(work), std::move(token), std::chrono::steady_clock::now()});
+            queued_[level].fetch_add(1, std::memory_order_release);
+        }
+        {
+            // Sincroniza con un worker que está comprobando si dormirse
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+        }
+        wake_.notify_one();
+    }
+
+    void TaskScheduler::parallelFor(const std::string& name, TaskPriority priority, size_t count, size_t parts,
+                                    const std::function<void(size_t, size_t, size_t)>& body) {
+        parts = std::min(parts, count);
+        if (parts <= 1) {
+            body(0, 0, count);
+            return;
+        }
+
+        // Las porciones se reparten por orden de llegada; las tareas auxiliares
+        // que empiecen tarde no encuentran nada y terminan sin tocar body
+        struct State {
+            std::atomic<size_t> next{0};
+            size_t done = 0;
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+        auto state = std::make_shared<State>();
+        const auto* work = &body;
+        auto runParts = [state, work, count, parts]() {
+            size_t part;
+            while ((part = state->next.fetch_add(1, std::memory_order_relaxed)) < parts) {
+                (*work)(part, count * part / parts, count * (part + 1) / parts);
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (++state->done == parts) state->finished.notify_all();
+            }
+        };
+
+        const size_t helpers = std::min(parts - 1, workers_.size());
+        for (size_t i = 0; i < helpers; ++i) {
+            submit(name, priority, [runParts](const CancellationToken&) { runParts(); });
+        }
+        runParts();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&state, parts] { return state->done == parts; });
+    }
+
+    void TaskScheduler::waitIdle() {
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        idle_.wait(lock, [this] { return outstanding_.load(std::memory_order_acquire) == 0; });
+    }
+
+    size_t TaskScheduler::getPendingCount() const {
+        size_t pending = 0;
+        for (const auto& queued : queued_) {
+            pending += queued.load(std::memory_order_relaxed);
+        }
+        return pending;
+    }
+
+    // ========================================================================
+    // Workers
+    // ========================================================================
+
+    void TaskScheduler::workerLoop(size_t index) {
+        tCurrentScheduler = this;
+        tCurrentWorker = index;
+        LatencyTracer::setThreadName(LatencyTracer::shared().intern("Worker " + std::to_string(index)));
+
+        Task task;
+        while (true) {
+            if (takeTask(index, task)) {
+                runTask(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wake_.wait(lock, [this] { return stopping_ || hasRunnableWork(); });
+            if (stopping_) return;
+        }
+    }
+
+    bool TaskScheduler::hasRunnableWork() const {
+        const size_t background = static_cast<size_t>(TaskPriority::Background);
+        for (size_t level = 0; level < background; ++level) {
+            if (queued_[level].load(std::memory_order_acquire) > 0) return true;
+        }
+        return queued_[background].load(std::memory_order_acquire) > 0 &&
+               runningBackground_.load(std::memory_order_acquire) < maxBackground_;
+    }
+
+    bool TaskScheduler::takeTask(size_t index, Task& task) {
+        const size_t count = workers_.size();
+        for (size_t level = 0; level < PRIORITY_COUNT; ++level) {
+            if (queued_[level].load(std::memory_order_acquire) == 0) continue;
+
+            // Background reserva su plaza antes de buscar
+            const bool background = level == static_cast<size_t>(TaskPriority::Background);
+            if (background && runningBackground_.fetch_add(1, std::memory_order_acq_rel) >= maxBackground_) {
+                runningBackground_.fetch_sub(1, std::memory_order_acq_rel);
+                continue;
+            }
+
+            // Primero la cola propia (lo más reciente), después robar lo más antiguo
+            if (popFrom(*workers_[index], level, true, task)) return true;
+            for (size_t offset = 1; offset < count; ++offset) {
+                if (popFrom(*workers_[(index + offset) % count], level, false, task)) return true;
+            }
+
+            if (background) {
+                runningBackground_.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        }
+        return false;
+    }
+
+    bool TaskScheduler::popFrom(Worker& worker, size_t priority, bool newest, Task& task) {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        std::deque<Task>& queue = worker.queues[priority];
+        if (queue.empty()) return false;
+        if (newest) {
+            task = std::move(queue.back());
+            queue.pop_back();
+        } else {
+            task = std::move(queue.front());
+            queue.pop_front();
+        }
+        queued_[priority].fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void TaskScheduler::runTask(Task& task) {
+        const auto start = std::chrono::steady_clock::now();
+        const bool run = !task.token.isCancelled();
+        if (run) {
+            task.work(task.token);
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        // Cada nombre de tarea tiene su propia pista en la traza
+        LatencyTracer& tracer = LatencyTracer::shared();
+        if (run && tracer.isEnabled()) {
+            tracer.asyncSpan("background", tracer.intern(task.name), tracer.newId(),
+                             LatencyTracer::toNanoseconds(start), LatencyTracer::toNanoseconds(end));
+        }
+
+        if (task.priority == TaskPriority::Background) {
+            runningBackground_.fetch_sub(1, std::memory_order_acq_rel);
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex_);
+            }
+            wake_.notify_one();
+        }
+        finishTask(task, run, elapsedMs(task.queuedAt, start), elapsedMs(start, end));
+    }
+
+    void TaskScheduler::finishTask(Task& task, bool ran, double waitMs, double runMs) {
+        {
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            TaskStats& stats = stats_[task.name];
+            stats.name = task.name;
+            stats.priority = task.priority;
+            if (ran) {
+                ++stats.completed;
+                stats.totalRunMs += runMs;
+                stats.maxRunMs = std::max(stats.maxRunMs, runMs);
+                stats.totalWaitMs += waitMs;
+            } else {
+                ++stats.cancelled;
+            }
+        }
+
+        // Soltar lo capturado antes de contar la tarea como terminada
+        task.work = nullptr;
+        task.token = CancellationToken();
+        if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            idle_.notify_all();
+        }
+    }
+
+    // ========================================================================
+    // Estadísticas
+    // ========================================================================
+
+    std::vector<TaskStats> TaskScheduler::getStats() const {
+        std::vector<TaskStats> result;
+        {
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            result.reserve(stats_.size());
+            for (const auto& entry : stats_) {
+                result.push_back(entry.second);
+            }
+        }
+        std::sort(result.begin(), result.end(), [](const TaskStats& a, const TaskStats& b) {
+            return a.totalRunMs > b.totalRunMs;
+        });
+        return result;
+    }
+
+    void TaskScheduler::resetStats() {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.clear();
+    }
+
+} // namespace CoralCode
@@ -0,0 +1,472 @@
+/**
+ * @file TextBuffer.cpp
+ * @brief Implementación del buffer de texto basado en líneas
+ */
+
+#include "TextBuffer.hpp"
+#include "MemoryUsage.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace CoralCode {
+
+    TextBuffer::TextBuffer()
+        : lines_{""}, nextListenerId_(1), version_(0) {}
+
+    TextBuffer::TextBuffer(const std::vector<std::string>& initialLines)
+        : lines_(initialLines), nextListenerId_(1), version_(0) {
+        if (lines_.empty()) {
+            lines_.push_back("");
+        }
+    }
+
+    // ========================================================================
+    // Gestión de contenido
+    // ========================================================================
+
+    void TextBuffer::insertChar(size_t line, size_t col, char ch) {
+        if (ch == '\n') {
+            splitLine(line, col);
+            return;
+        }
+
+        validateLineIndex(line);
+        std::string& target = lines_[line];
+        target.insert(std::min(col, target.length()), 1, ch);
+        notifyChange(line, 1, 1);
+    }
+
+    void TextBuffer::insertText(size_t line, size_t col, const std::string& text) {
+        validateLineIndex(line);
+        if (text.empty()) return;
+
+        std::string& target = lines_[line];
+        col = std::min(col, target.length());
+
+        size_t newlinePos = text.find('\n');
+        if (newlinePos == std::string::npos) {
+            target.insert(col, text);
+            notifyChange(line, 1, 1);
+            return;
+        }
+
+        // Texto multi-línea: dividir una sola vez y construir las líneas nuevas
+        std::string tail = target.substr(col);
+        target.erase(col);
+        target.append(text, 0, newlinePos);
+
+        std::vector<std::string> newLines;
+        size_t start = newlinePos + 1;
+        while (true) {
+            size_t next = text.find('\n', start);
+            if (next == std::string::npos) {
+                newLines.push_back(text.substr(start) + tail);
+                break;
+            }
+            newLines.push_back(text.substr(start, next - start));
+            start = next + 1;
+        }
+
+        lines_.insert(lines_.begin() + static_cast<std::ptrdiff_t>(line + 1),
+                      std::make_move_iterator(newLines.begin()),
+                      std::make_move_iterator(newLines.end()));
+        notifyChange(line, 1, 1 + newLines.size());
+    }
+
+    void TextBuffer::deleteChar(size_t line, size_t col) {
+        validateLineIndex(line);
+        std::string& target = lines_[line];
+
+        if (col < target.length()) {
+            target.erase(col, 1);
+            notifyChange(line, 1, 1);
+        } else if (line + 1 < lines_.size()) {
+            // Borrar el salto de línea fusiona con la siguiente
+            mergeLine(line);
+        }
+    }
+
+    void TextBuffer::deleteLine(size_t line) {
+        validateLineIndex(line);
+
+        if (lines_.size() == 1) {
+            // Siempre debe quedar al menos una línea
+            lines_[0].clear();
+            notifyChange(0, 1, 1);
+            return;
+        }
+
+        lines_.erase(lines_.begin() + static_cast<std::ptrdiff_t>(line));
+        notifyChange(line, 1, 0);
+    }
+
+    void TextBuffer::insertLine(size_t line, const std::string& content) {
+        line = std::min(line, lines_.size());
+        lines_.insert(lines_.begin() + static_cast<std::ptrdiff_t>(line), content);
+        notifyChange(line, 0, 1);
+    }
+
+    // ========================================================================
+    // Operaciones de línea
+    // ========================================================================
+
+    void TextBuffer::splitLine(size_t line, size_t col) {
+        validateLineIndex(line);
+        std::string& target = lines_[line];
+        col = std::min(col, target.length());
+
+        std::string remainder = target.substr(col);
+        target.erase(col);
+        lines_.insert(lines_.begin() + static_cast<std::ptrdiff_t>(line + 1), std::move(remainder));
+        notifyChange(line, 1, 2);
+    }
+
+    void TextBuffer::mergeLine(size_t line) {
+        validateLineIndex(line);
+        if (line + 1 >= lines_.size()) return;
+
+        lines_[line] += lines_[line + 1];
+        lines_.erase(lines_.begin() + static_cast<std::ptrdiff_t>(line + 1));
+        notifyChange(line, 2, 1);
+    }
+
+    // ========================================================================
+    // Acceso al contenido
+    // ========================================================================
+
+    const std::string& TextBuffer::getLine(size_t line) const {
+        validateLineIndex(line);
+        return lines_[line];
+    }
+
+    std::string& TextBuffer::getLine(size_t line) {
+        validateLineIndex(line);
+        return lines_[line];
+    }
+
+    size_t TextBuffer::getLineCount() const {
+        return lines_.size();
+    }
+
+    size_t TextBuffer::getLineLength(size_t line) const {
+        validateLineIndex(line);
+        return lines_[line].length();
+    }
+
+    // ========================================================================
+    // Validación
+    // ========================================================================
+
+    bool TextBuffer::isValidPosition(size_t line, size_t col) const {
+        return line < lines_.size() && col <= lines_[line].length();
+    }
+
+    std::pair<size_t, size_t> TextBuffer::clampPosition(size_t line, size_t col) const {
+        line = std::min(line, lines_.size() - 1);
+        col = std::min(col, lines_[line].length());
+        return {line, col};
+    }
+
+    // ========================================================================
+    // Operaciones en bloque
+    // ========================================================================
+
+    std::vector<std::string> TextBuffer::getLines(size_t startLine, size_t endLine) const {
+        // Rango semiabierto [startLine, endLine)
+        startLine = std::min(startLine, lines_.size());
+        endLine = std::min(std::max(endLine, startLine), lines_.size());
+        return std::vector<std::string>(lines_.begin() + static_cast<std::ptrdiff_t>(startLine),
+                                        lines_.begin() + static_cast<std::ptrdiff_t>(endLine));
+    }
+
+    void TextBuffer::replaceLines(size_t startLine, const std::vector<std::string>& newLines) {
+        startLine = std::min(startLine, lines_.size());
+        size_t replaced = std::min(newLines.size(), lines_.size() - startLine);
+
+        std::copy(newLines.begin(), newLines.begin() + static_cast<std::ptrdiff_t>(replaced),
+                  lines_.begin() + static_cast<std::ptrdiff_t>(startLine));
+        lines_.insert(lines_.end(), newLines.begin() + static_cast<std::ptrdiff_t>(replaced), newLines.end());
+
+        if (!newLines.empty()) {
+            notifyChange(startLine, replaced, newLines.size());
+        }
+    }
+
+    std::string TextBuffer::getText(size_t startLine, size_t startCol, size_t endLine, size_t endCol) const {
+        validateLineIndex(startLine);
+        validateLineIndex(endLine);
+        startCol = std::min(startCol, lines_[startLine].length());
+        endCol = std::min(endCol, lines_[endLine].length());
+
+        if (startLine == endLine) {
+            return endCol > startCol ? lines_[startLine].substr(startCol, endCol - startCol) : std::string();
+        }
+
+        std::string result = lines_[startLine].substr(startCol);
+        for (size_t line = startLine + 1; line < endLine; ++line) {
+            result += '\n';
+            result += lines_[line];
+        }
+        result += '\n';
+        result.append(lines_[endLine], 0, endCol);
+        return result;
+    }
+
+    void TextBuffer::replaceRange(size_t startLine, size_t startCol, size_t endLine, size_t endCol,
+                                  const std::string& text) {
+        validateLineIndex(startLine);
+        validateLineIndex(endLine);
+        startCol = std::min(startCol, lines_[startLine].length());
+        endCol = std::min(endCol, lines_[endLine].length());
+
+        if (startLine == endLine && text.find('\n') == std::string::npos) {
+            // Caso común: edición dentro de una línea, sin reconstruirla
+            std::string& target = lines_[startLine];
+            target.replace(startCol, endCol > startCol ? endCol - startCol : 0, text);
+            notifyChange(startLine, 1, 1);
+            return;
+        }
+
+        std::string tail = lines_[endLine].substr(endCol);
+        std::vector<std::string> newLines;
+        newLines.push_back(lines_[startLine].substr(0, startCol));
+
+        size_t start = 0;
+        while (true) {
+            size_t next = text.find('\n', start);
+            if (next == std::string::npos) {
+                newLines.back().append(text, start, std::string::npos);
+                break;
+            }
+            newLines.back().append(text, start, next - start);
+            newLines.emplace_back();
+            start = next + 1;
+        }
+        newLines.back() += tail;
+
+        const size_t removed = endLine - startLine + 1;
+        const size_t common = std::min(removed, newLines.size());
+        auto first = lines_.begin() + static_cast<std::ptrdiff_t>(startLine);
+        std::move(newLines.begin(), newLines.begin() + static_cast<std::ptrdiff_t>(common), first);
+        if (removed > common) {
+            lines_.erase(first + static_cast<std::ptrdiff_t>(common), first + static_cast<std::ptrdiff_t>(removed));
+        } else {
+            lines_.insert(first + static_cast<std::ptrdiff_t>(common),
+                          std::make_move_iterator(newLines.begin() + static_cast<std::ptrdiff_t>(common)),
+                          std::make_move_iterator(newLines.end()));
+        }
+        notifyChange(startLine, removed, newLines.size());
+    }
+
+    std::vector<TextEdit> TextBuffer::applyEdits(const std::vector<TextEdit>& edits) {
+        if (edits.empty()) return {};
+
+        for (size_t i = 0; i < edits.size(); ++i) {
+            const TextEdit& edit = edits[i];
+            validateLineIndex(edit.endLine);
+            bool ordered = edit.line < edit.endLine ||
+                           (edit.line == edit.endLine && edit.column <= edit.endColumn);
+            bool disjoint = i == 0 || edits[i - 1].endLine < edit.line ||
+                            (edits[i - 1].endLine == edit.line && edits[i - 1].endColumn <= edit.column);
+            if (!ordered || !disjoint) {
+                throw std::invalid_argument("TextBuffer: ediciones desordenadas o solapadas");
+            }
+        }
+
+        const size_t firstLine = edits.front().line;
+        const size_t lastLine = edits.back().endLine;
+
+        // Reconstruir solo [firstLine, lastLine]: las líneas intermedias sin
+        // ediciones se mueven, las editadas se copian una vez
+        std::vector<std::string> rebuilt;
+        rebuilt.reserve(lastLine - firstLine + 1);
+        std::vector<TextEdit> inverse;
+        inverse.reserve(edits.size());
+
+        std::string current;
+        auto appendText = [&](const std::string& text) {
+            size_t start = 0;
+            while (true) {
+                size_t next = text.find('\n', start);
+                if (next == std::string::npos) {
+                    current.append(text, start, std::string::npos);
+                    return;
+                }
+                current.append(text, start, next - start);
+                rebuilt.push_back(std::move(current));
+                current.clear();
+                start = next + 1;
+            }
+        };
+
+        size_t line = firstLine;
+        size_t col = 0;
+        for (const TextEdit& edit : edits) {
+            const size_t startCol = std::min(edit.column, lines_[edit.line].length());
+            const size_t endCol = std::min(edit.endColumn, lines_[edit.endLine].length());
+
+            // Texto sin cambios desde el final de la edición anterior
+            if (line == edit.line) {
+                current.append(lines_[line], col, startCol > col ? startCol - col : 0);
+            } else {
+                current.append(lines_[line], std::min(col, lines_[line].length()), std::string::npos);
+                rebuilt.push_back(std::move(current));
+                for (size_t middle = line + 1; middle < edit.line; ++middle) {
+                    rebuilt.push_back(std::move(lines_[middle]));
+                }
+                current.assign(lines_[edit.line], 0, startCol);
+            }
+
+            TextEdit undo{firstLine + rebuilt.size(), current.length(), 0, 0,
+                          getText(edit.line, startCol, edit.endLine, endCol)};
+            appendText(edit.text);
+            undo.endLine = firstLine + rebuilt.size();
+            undo.endColumn = current.length();
+            inverse.push_back(std::move(undo));
+
+            line = edit.endLine;
+            col = endCol;
+        }
+        current.append(lines_[line], std::min(col, lines_[line].length()), std::string::npos);
+        rebuilt.push_back(std::move(current));
+
+        const size_t removed = lastLine - firstLine + 1;
+        const size_t common = std::min(removed, rebuilt.size());
+        auto first = lines_.begin() + static_cast<std::ptrdiff_t>(firstLine);
+        std::move(rebuilt.begin(), rebuilt.begin() + static_cast<std::ptrdiff_t>(common), first);
+        if (removed > common) {
+            lines_.erase(first + static_cast<std::ptrdiff_t>(common), first + static_cast<std::ptrdiff_t>(removed));
+        } else {
+            lines_.insert(first + static_cast<std::ptrdiff_t>(common),
+                          std::make_move_iterator(rebuilt.begin() + static_cast<std::ptrdiff_t>(common)),
+                          std::make_move_iterator(rebuilt.end()));
+        }
+
+        notifyChange(firstLine, removed, rebuilt.size());
+        return inverse;
+    }
+
+    void TextBuffer::setLines(std::vector<std::string> lines) {
+        size_t previousCount = lines_.size();
+        lines_ = std::move(lines);
+        if (lines_.empty()) {
+            lines_.push_back("");
+        }
+        notifyChange(0, previousCount, lines_.size());
+    }
+
+    // ========================================================================
+    // Conversión
+    // ========================================================================
+
+    std::string TextBuffer::toString() const {
+        size_t total = lines_.size() > 0 ? lines_.size() - 1 : 0;
+        for (const auto& line : lines_) {
+            total += line.length();
+        }
+
+        std::string result;
+        result.reserve(total);
+        for (size_t i = 0; i < lines_.size(); ++i) {
+            if (i > 0) result += '\n';
+            result += lines_[i];
+        }
+        return result;
+    }
+
+    void TextBuffer::fromString(const std::string& content) {
+        size_t previousCount = lines_.size();
+        lines_.clear();
+
+        size_t start = 0;
+        while (true) {
+            size_t next = content.find('\n', start);
+            size_t end = next == std::string::npos ? content.length() : next;
+
+            // Normalizar finales de línea CRLF
+            size_t length = end - start;
+            if (length > 0 && content[end - 1] == '\r') {
+                --length;
+            }
+            lines_.emplace_back(content, start, length);
+
+            if (next == std::string::npos) break;
+            start = next + 1;
+        }
+
+        notifyChange(0, previousCount, lines_.size());
+    }
+
+    // ========================================================================
+    // Estadísticas
+    // ========================================================================
+
+    size_t TextBuffer::getTotalCharacters() const {
+        size_t total = 0;
+        for (const auto& line : lines_) {
+            total += line.length();
+        }
+        return total;
+    }
+
+    bool TextBuffer::isEmpty() const {
+        return lines_.size() == 1 && lines_[0].empty();
+    }
+
+    size_t TextBuffer::getMemoryUsage() const {
+        // Las líneas cortas viven dentro del std::string (ya en la tabla)
+        size_t bytes = 0;
+        for (const auto& line : lines_) {
+            bytes += MemoryUsage::stringBytes(line);
+        }
+        return bytes;
+    }
+
+    size_t TextBuffer::getLineIndexMemory() const {
+        return lines_.capacity() * sizeof(std::string) +
+               listeners_.capacity() * sizeof(std::pair<size_t, ChangeListener>);
+    }
+
+    // ========================================================================
+    // Notificación de cambios
+    // ========================================================================
+
+    size_t TextBuffer::addChangeListener(ChangeListener listener) {
+        size_t id = nextListenerId_++;
+        listeners_.emplace_back(id, std::move(listener));
+        return id;
+    }
+
+    void TextBuffer::removeChangeListener(size_t listenerId) {
+        listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
+                                        [listenerId](const auto& entry) { return entry.first == listenerId; }),
+                         listeners_.end());
+    }
+
+    void TextBuffer::notifyChange(size_t firstLine, size_t removedLines, size_t insertedLines) {
+        ++version_;
+        TextChange change{firstLine, removedLines, insertedLines};
+        for (const auto& entry : listeners_) {
+            entry.second(change);
+        }
+    }
+
+    // ========================================================================
+    // Métodos internos
+    // ========================================================================
+
+    void TextBuffer::ensureLineExists(size_t line) {
+        if (line < lines_.size()) return;
+
+        size_t firstNew = lines_.size();
+        lines_.resize(line + 1);
+        notifyChange(firstNew, 0, lines_.size() - firstNew);
+    }
+
+    void TextBuffer::validateLineIndex(size_t line) const {
+        if (line >= lines_.size()) {
+            throw std::out_of_range("TextBuffer: línea fuera de rango " + std::to_string(line));
+        }
+    }
+
+} // namespace CoralCode
@@ -0,0 +1,205 @@
+/**
+ * @file TextLayout.cpp
+ * @brief Avances de glifo, paradas de tabulación y medida de líneas
+ */
+
+#include "TextLayout.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace CoralCode {
+
+    size_t decodeUtf8(const char* text, size_t size, size_t i, char32_t& codepoint) {
+        const unsigned char lead = static_cast<unsigned char>(text[i]);
+        size_t length = 0;
+        if (lead < 0x80) length = 1;
+        else if ((lead >> 5) == 0x6) length = 2;
+        else if ((lead >> 4) == 0xE) length = 3;
+        else if ((lead >> 3) == 0x1E) length = 4;
+
+        if (length == 0 || i + length > size) {
+            codepoint = 0xFFFD;
+            return 1;
+        }
+        if (length == 1) {
+            codepoint = lead;
+            return 1;
+        }
+        codepoint = lead & (0x7Fu >> length);
+        for (size_t k = 1; k < length; ++k) {
+            const unsigned char next = static_cast<unsigned char>(text[i + k]);
+            if ((next & 0xC0) != 0x80) {
+                codepoint = 0xFFFD;
+                return 1;
+            }
+            codepoint = (codepoint << 6) | (next & 0x3Fu);
+        }
+        return length;
+    }
+
+    namespace {
+
+        // Única entre todas las instancias; la 0 marca un LineLayout sin medir
+        std::atomic<uint64_t> g_nextGeneration{1};
+
+        uint64_t nextGeneration() {
+            return g_nextGeneration.fetch_add(1, std::memory_order_relaxed);
+        }
+
+    } // namespace
+
+    // ========================================================================
+    // LineLayout
+    // ========================================================================
+
+    float LineLayout::offsetOf(size_t col) const {
+        if (offsets.empty()) return 0.0f;
+        return offsets[std::min(col, offsets.size() - 1)];
+    }
+
+    size_t LineLayout::visualColumnOf(size_t col) const {
+        if (columns.empty()) return 0;
+        return columns[std::min(col, columns.size() - 1)];
+    }
+
+    size_t LineLayout::hitTest(float x) const {
+        const size_t length = size();
+        if (length == 0 || x <= 0.0f) return 0;
+        if (x >= width()) return length;
+
+        // Primer byte a la derecha de x: siempre inicio de carácter, porque
+        // los bytes de continuación comparten x con el primero
+        const auto next = std::upper_bound(offsets.begin(), offsets.end(), x);
+        const size_t after = static_cast<size_t>(next - offsets.begin());
+        size_t before = after - 1;
+        while (before > 0 && offsets[before - 1] == offsets[before]) --before;
+
+        // El más cercano de los dos bordes del carácter
+        return x - offsets[before] < offsets[after] - x ? before : after;
+    }
+
+    // ========================================================================
+    // TextLayout
+    // ========================================================================
+
+    TextLayout::TextLayout()
+        : fixedAdvance_(DEFAULT_ADVANCE), tabSize_(DEFAULT_TAB_SIZE), generation_(nextGeneration()) {
+        asciiAdvances_.fill(-1.0f);
+    }
+
+    void TextLayout::resetCache() {
+        asciiAdvances_.fill(-1.0f);
+        advances_.clear();
+        generation_ = nextGeneration();
+    }
+
+    void TextLayout::setGlyphAdvanceProvider(GlyphAdvanceFunction provider) {
+        provider_ = std::move(provider);
+        resetCache();
+    }
+
+    void TextLayout::setFixedAdvance(float advance) {
+        if (advance <= 0.0f || advance == fixedAdvance_) return;
+        fixedAdvance_ = advance;
+        if (!provider_) resetCache();
+    }
+
+    void TextLayout::setTabSize(size_t tabSize) {
+        tabSize = std::max<size_t>(1, tabSize);
+        if (tabSize == tabSize_) return;
+        tabSize_ = tabSize;
+        generation_ = nextGeneration();
+    }
+
+    void TextLayout::setScale(float scale) {
+        if (scale <= 0.0f || scale == scale_) return;
+        scale_ = scale;
+        generation_ = nextGeneration();
+    }
+
+    float TextLayout::getGlyphAdvance(char32_t codepoint) const {
+        if (!provider_) return fixedAdvance_ * scale_;
+
+        if (codepoint < asciiAdvances_.size()) {
+            float& cached = asciiAdvances_[codepoint];
+            if (cached < 0.0f) cached = std::max(0.0f, provider_(codepoint));
+            return cached * scale_;
+        }
+        auto it = advances_.find(codepoint);
+        if (it == advances_.end()) {
+            it = advances_.emplace(codepoint, std::max(0.0f, provider_(codepoint))).first;
+        }
+        return it->second * scale_;
+    }
+
+    void TextLayout::layoutLine(const std::string& text, LineLayout& out) const {
+        layoutLine(text.data(), text.size(), out);
+    }
+
+    void TextLayout::layoutLine(const char* text, size_t length, LineLayout& out) const {
+        out.offsets.resize(length + 1);
+        out.columns.resize(length + 1);
+
+        const float tabWidth = getTabWidth();
+        const uint32_t tabColumns = static_cast<uint32_t>(tabSize_);
+        float x = 0.0f;
+        uint32_t column = 0;
+
+        size_t i = 0;
+        while (i < length) {
+            char32_t codepoint;
+            const size_t bytes = decodeUtf8(text, length, i, codepoint);
+            for (size_t k = i; k < i + bytes; ++k) {
+                out.offsets[k] = x;
+                out.columns[k] = column;
+            }
+
+            if (codepoint == U'\t') {
+                // Siguiente parada (el margen evita una tabulación de ancho 0 por redondeo)
+                if (tabWidth > 0.0f) x = (std::floor(x / tabWidth + 1e-4f) + 1.0f) * tabWidth;
+                column = (column / tabColumns + 1) * tabColumns;
+            } else {
+                x += getGlyphAdvance(codepoint);
+                ++column;
+            }
+            i += bytes;
+        }
+
+        out.offsets[length] = x;
+        out.columns[length] = column;
+        out.generation = generation_;
+    }
+
+    // ========================================================================
+    // LineLayoutCache
+    // ========================================================================
+
+    LineLayoutCache::LineLayoutCache(size_t slots) : slots_(std::max<size_t>(1, slots)) {}
+
+    const LineLayout& LineLayoutCache::get(const TextLayout& layout, size_t line, const std::string& text,
+                                           uint64_t textVersion) {
+        Slot& slot = slots_[line % slots_.size()];
+        if (slot.line != line || slot.textVersion != textVersion ||
+            slot.layout.generation != layout.getGeneration()) {
+            layout.layoutLine(text, slot.layout);
+            slot.line = line;
+            slot.textVersion = textVersion;
+        }
+        return slot.layout;
+    }
+
+    void LineLayoutCache::clear() {
+        for (Slot& slot : slots_) {
+            slot.line = SIZE_MAX;
+            slot.layout.generation = 0;
+        }
+    }
+
+    size_t LineLayoutCache::getMemoryUsage() const {
+        size_t bytes = slots_.capacity() * sizeof(Slot);
+        for (const Slot& slot : slots_) bytes += slot.layout.getMemoryUsage();
+        return bytes;
+    }
+
+} // namespace CoralCode
@@ -0,0 +1,311 @@
+/**
+ * @file Viewport.cpp
+ * @brief Scroll, visibilidad y posiciones de pantalla del editor
+ */
+
+#include "Viewport.hpp"
+#include "TextBuffer.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace CoralCode {
+
+    Viewport::Viewport()
+        : Viewport(800, 600) {
+    }
+
+    Viewport::Viewport(size_t windowWidth, size_t windowHeight)
+        : scrollLine_(0)
+        , scrollCol_(0)
+        , windowWidth_(windowWidth)
+        , windowHeight_(windowHeight)
+        , charWidth_(TextLayout::DEFAULT_ADVANCE)
+        , lineHeight_(24.0f)
+        , lineNumberWidth_(60.0f)
+        , statusBarHeight_(25.0f)
+        , scrollBarWidth_(15.0f) {
+        layout_.setFixedAdvance(charWidth_);
+    }
+
+    // ========================================================================
+    // Configuración
+    // ========================================================================
+
+    void Viewport::setWindowSize(size_t width, size_t height) {
+        windowWidth_ = width;
+        windowHeight_ = height;
+    }
+
+    void Viewport::setCharacterMetrics(float charWidth, float lineHeight) {
+        // Una métrica nula dejaría las divisiones sin sentido
+        if (charWidth > 0.0f) charWidth_ = charWidth;
+        if (lineHeight > 0.0f) lineHeight_ = lineHeight;
+        layout_.setFixedAdvance(charWidth_);
+    }
+
+    void Viewport::setUIMetrics(float lineNumberWidth, float statusBarHeight, float scrollBarWidth) {
+        lineNumberWidth_ = std::max(0.0f, lineNumberWidth);
+        statusBarHeight_ = std::max(0.0f, statusBarHeight);
+        scrollBarWidth_ = std::max(0.0f, scrollBarWidth);
+    }
+
+    // ========================================================================
+    // Gestión del scroll
+    // ========================================================================
+
+    void Viewport::setScrollPosition(size_t line, size_t col) {
+        scrollLine_ = line;
+        scrollCol_ = col;
+    }
+
+    void Viewport::scrollToLine(size_t line) {
+        scrollLine_ = line;
+    }
+
+    void Viewport::scrollToColumn(size_t col) {
+        scrollCol_ = col;
+    }
+
+    void Viewport::scrollVertical(int delta) {
+        if (delta < 0) {
+            const size_t up = static_cast<size_t>(-static_cast<long long>(delta));
+            scrollLine_ = up > scrollLine_ ? 0 : scrollLine_ - up;
+        } else {
+            scrollLine_ += static_cast<size_t>(delta);
+        }
+    }
+
+    void Viewport::scrollHorizontal(int delta) {
+        if (delta < 0) {
+            const size_t left = static_cast<size_t>(-static_cast<long long>(delta));
+            scrollCol_ = left > scrollCol_ ? 0 : scrollCol_ - left;
+        } else {
+            scrollCol_ += static_cast<size_t>(delta);
+        }
+    }
+
+    // ========================================================================
+    // Auto-scroll basado en cursor
+    // ========================================================================
+
+    void Viewport::ensureCursorVisible(size_t cursorLine, size_t cursorCol, size_t totalLines) {
+        // Desplazamiento mínimo: el cursor queda en el primer o último hueco visible
+        const size_t visibleLines = std::max<size_t>(getVisibleLines(), 1);
+        if (cursorLine < scrollLine_) {
+            scrollLine_ = cursorLine;
+        } else if (cursorLine >= scrollLine_ + visibleLines) {
+            scrollLine_ = cursorLine - visibleLines + 1;
+        }
+
+        const size_t visibleCols = std::max<size_t>(getVisibleColumns(), 1);
+        if (cursorCol < scrollCol_) {
+            scrollCol_ = cursorCol;
+        } else if (cursorCol >= scrollCol_ + visibleCols) {
+            scrollCol_ = cursorCol - visibleCols + 1;
+        }
+
+        validateScrollPosition(totalLines, 0);
+    }
+
+    void Viewport::autoScrollToCursor(size_t cursorLine, size_t cursorCol, size_t totalLines) {
+        // Si el cursor salió de la vista, se centra en vez de pegarlo al borde
+        const size_t visibleLines = std::max<size_t>(getVisibleLines(), 1);
+        if (cursorLine < scrollLine_ || cursorLine >= scrollLine_ + visibleLines) {
+            const size_t half = visibleLines / 2;
+            scrollLine_ = cursorLine > half ? cursorLine - half : 0;
+        }
+
+        const size_t visibleCols = std::max<size_t>(getVisibleColumns(), 1);
+        if (cursorCol < scrollCol_ || cursorCol >= scrollCol_ + visibleCols) {
+            const size_t half = visibleCols / 2;
+            scrollCol_ = cursorCol > half ? cursorCol - half : 0;
+        }
+
+        validateScrollPosition(totalLines, 0);
+    }
+
+    // ========================================================================
+    // Cálculos de visibilidad
+    // ========================================================================
+
+    float Viewport::getTextAreaHeight() const {
+        return std::max(0.0f, static_cast<float>(windowHeight_) - statusBarHeight_ - scrollBarWidth_);
+    }
+
+    float Viewport::getTextAreaWidth() const {
+        return std::max(0.0f, static_cast<float>(windowWidth_) - lineNumberWidth_ - scrollBarWidth_);
+    }
+
+    size_t Viewport::getVisibleLines() const {
+        if (lineHeight_ <= 0.0f) return 0;
+        return static_cast<size_t>(std::floor(getTextAreaHeight() / lineHeight_));
+    }
+
+    size_t Viewport::getVisibleColumns() const {
+        if (charWidth_ <= 0.0f) return 0;
+        return static_cast<size_t>(std::floor(getTextAreaWidth() / charWidth_));
+    }
+
+    size_t Viewport::getFirstVisibleLine() const {
+        return scrollLine_;
+    }
+
+    size_t Viewport::getLastVisibleLine(size_t totalLines) const {
+        // Inclusiva: la última línea que llega a verse
+        if (totalLines == 0) return 0;
+        const size_t last = scrollLine_ + std::max<size_t>(getVisibleLines(), 1) - 1;
+        return std::min(last, totalLines - 1);
+    }
+
+    size_t Viewport::getFirstVisibleColumn() const {
+        return scrollCol_;
+    }
+
+    size_t Viewport::getLastVisibleColumn() const {
+        return scrollCol_ + std::max<size_t>(getVisibleColumns(), 1) - 1;
+    }
+
+    // ========================================================================
+    // Conversión de coordenadas (ancho fijo)
+    // ========================================================================
+
+    std::pair<size_t, size_t> Viewport::screenToTextPosition(float x, float y) const {
+        size_t line = scrollLine_;
+        if (y > 0.0f && lineHeight_ > 0.0f) line += static_cast<size_t>(std::floor(y / lineHeight_));
+
+        // Se redondea a la frontera de carácter más cercana, como el hit-test con fuente
+        size_t col = scrollCol_;
+        const float textX = x - lineNumberWidth_;
+        if (textX > 0.0f && charWidth_ > 0.0f) col += static_cast<size_t>(std::lround(textX / charWidth_));
+        return {line, col};
+    }
+
+    std::pair<float, float> Viewport::textToScreenPosition(size_t line, size_t col) const {
+        const float y = line >= scrollLine_ ? static_cast<float>(line - scrollLine_) * lineHeight_
+                                             : -static_cast<float>(scrollLine_ - line) * lineHeight_;
+        const float x = col >= scrollCol_ ? static_cast<float>(col - scrollCol_) * charWidth_
+                                           : -static_cast<float>(scrollCol_ - col) * charWidth_;
+        return {lineNumberWidth_ + x, y};
+    }
+
+    // ========================================================================
+    // Métrica horizontal
+    // ========================================================================
+
+    void Viewport::setGlyphAdvanceProvider(TextLayout::GlyphAdvanceFunction provider) {
+        layout_.setGlyphAdvanceProvider(std::move(provider));
+    }
+
+    void Viewport::setTabSize(size_t tabSize) {
+        layout_.setTabSize(tabSize);
+    }
+
+    const LineLayout& Viewport::getLineLayout(size_t line, const TextBuffer& buffer) const {
+        // Sin fuente, el avance fijo sigue a setCharacterMetrics
+        layout_.setFixedAdvance(charWidth_);
+        return layoutCache_.get(layout_, line, buffer.getLine(line), buffer.getVersion());
+    }
+
+    // ========================================================================
+    // Conversión de coordenadas con el texto real
+    // ========================================================================
+
+    std::pair<size_t, size_t> Viewport::screenToTextPosition(float x, float y, const TextBuffer& buffer) const {
+        const size_t lineCount = buffer.getLineCount();
+        if (lineCount == 0) return {0, 0};
+
+        size_t line = scrollLine_;
+        if (y > 0.0f && lineHeight_ > 0.0f) line += static_cast<size_t>(std::floor(y / lineHeight_));
+        line = std::min(line, lineCount - 1);
+
+        const LineLayout& lineLayout = getLineLayout(line, buffer);
+        const float scrollX = lineLayout.offsetOf(scrollCol_);
+        const float textX = std::max(0.0f, x - lineNumberWidth_);
+        return {line, lineLayout.hitTest(scrollX + textX)};
+    }
+
+    std::pair<float, float> Viewport::textToScreenPosition(size_t line, size_t col, const TextBuffer& buffer) const {
+        const float y = line >= scrollLine_ ? static_cast<float>(line - scrollLine_) * lineHeight_
+                                             : -static_cast<float>(scrollLine_ - line) * lineHeight_;
+        if (line >= buffer.getLineCount()) return {lineNumberWidth_, y};
+
+        const LineLayout& lineLayout = getLineLayout(line, buffer);
+        return {lineNumberWidth_ + lineLayout.offsetOf(col) - lineLayout.offsetOf(scrollCol_), y};
+    }
+
+    // ========================================================================
+    // Estado del scroll
+    // ========================================================================
+
+    bool Viewport::canScrollUp() const {
+        return scrollLine_ > 0;
+    }
+
+    bool Viewport::canScrollDown(size_t totalLines) const {
+        return scrollLine_ + getVisibleLines() < totalLines;
+    }
+
+    bool Viewport::canScrollLeft() const {
+        return scrollCol_ > 0;
+    }
+
+    bool Viewport::canScrollRight(size_t maxLineLength) const {
+        return scrollCol_ + getVisibleColumns() < maxLineLength;
+    }
+
+    // ========================================================================
+    // Scroll de página
+    // ========================================================================
+
+    void Viewport::pageUp() {
+        const size_t page = std::max<size_t>(getVisibleLines(), 1);
+        scrollLine_ = page > scrollLine_ ? 0 : scrollLine_ - page;
+    }
+
+    void Viewport::pageDown(size_t totalLines) {
+        scrollLine_ += std::max<size_t>(getVisibleLines(), 1);
+        validateScrollPosition(totalLines, 0);
+    }
+
+    void Viewport::scrollToTop() {
+        scrollLine_ = 0;
+    }
+
+    void Viewport::scrollToBottom(size_t totalLines) {
+        const size_t visibleLines = getVisibleLines();
+        scrollLine_ = totalLines > visibleLines ? totalLines - visibleLines : 0;
+    }
+
+    // ========================================================================
+    // Información de scroll para UI
+    // ========================================================================
+
+    float Viewport::getVerticalScrollRatio(size_t totalLines) const {
+        const size_t visibleLines = getVisibleLines();
+        if (totalLines <= visibleLines) return 0.0f;
+        const float ratio = static_cast<float>(scrollLine_) / static_cast<float>(totalLines - visibleLines);
+        return std::clamp(ratio, 0.0f, 1.0f);
+    }
+
+    float Viewport::getHorizontalScrollRatio(size_t maxLineLength) const {
+        const size_t visibleCols = getVisibleColumns();
+        if (maxLineLength <= visibleCols) return 0.0f;
+        const float ratio = static_cast<float>(scrollCol_) / static_cast<float>(maxLineLength - visibleCols);
+        return std::clamp(ratio, 0.0f, 1.0f);
+    }
+
+    void Viewport::validateScrollPosition(size_t totalLines, size_t maxLineLength) {
+        // La última página puede quedar llena pero no pasar del final;
+        // maxLineLength 0 deja la columna libre (la longitud no se conoce)
+        const size_t visibleLines = getVisibleLines();
+        const size_t maxLine = totalLines > visibleLines ? totalLines - visibleLines : 0;
+        scrollLine_ = std::min(scrollLine_, maxLine);
+
+        if (maxLineLength > 0) {
+            const size_t visibleCols = getVisibleColumns();
+            const size_t maxCol = maxLineLength > visibleCols ? maxLineLength - visibleCols : 0;
+            scrollCol_ = std::min(scrollCol_, maxCol);
+        }
+    }
+
+} // namespace CoralCode
@@ -0,0 +1,289 @@
+/**
+ * @file WrapIndex.cpp
+ * @brief Cortes de línea y árbol de Fenwick de filas visuales
+ */
+
+#include "WrapIndex.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
+
+namespace CoralCode {
+
+    namespace {
+
+        // Líneas por porción al medir en paralelo
+        constexpr size_t kParallelChunk = 4096;
+
+        bool isContinuationByte(char c) {
+            return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+        }
+
+        // Reparte text en filas de como mucho width píxeles. Los espacios que
+        // no caben se quedan colgando al final de la fila. Devuelve el número
+        // de filas y, si starts no es nulo, el byte donde empieza cada una
+        uint32_t wrapLine(const std::string& text, const LineLayout& layout, float width,
+                          std::vector<size_t>* starts) {
+            if (starts) {
+                starts->clear();
+                starts->push_back(0);
+            }
+            uint32_t rows = 1;
+            size_t rowStart = 0;
+            size_t breakAt = 0;     // Primer byte tras el último espacio de la fila (0: ninguno)
+
+            size_t i = 0;
+            while (i < text.size()) {
+                size_t next = i + 1;
+                while (next < text.size() && isContinuationByte(text[next])) ++next;
+
+                const bool blank = text[i] == ' ' || text[i] == '\t';
+                if (!blank && i > rowStart && layout.offsets[next] - layout.offsets[rowStart] > width) {
+                    // Cortar tras el último espacio o, sin él, antes de este carácter
+                    rowStart = breakAt > rowStart ? breakAt : i;
+                    breakAt = 0;
+                    ++rows;
+                    if (starts) starts->push_back(rowStart);
+                    continue;
+                }
+                if (blank) breakAt = next;
+                i = next;
+            }
+            return rows;
+        }
+
+    } // namespace
+
+    WrapIndex::WrapIndex()
+        : buffer_(nullptr), listenerId_(0), layout_(nullptr), width_(0.0f),
+          treeValid_(0), totalRows_(0), stale_(true), layoutGeneration_(0) {}
+
+    WrapIndex::~WrapIndex() {
+        detach();
+    }
+
+    // ========================================================================
+    // Conexión con el buffer
+    // ========================================================================
+
+    void WrapIndex::attach(TextBuffer& buffer, const TextLayout& layout) {
+        detach();
+        buffer_ = &buffer;
+        layout_ = &layout;
+        listenerId_ = buffer.addChangeListener([this](const TextChange& change) { applyChange(change); });
+        invalidate();
+    }
+
+    void WrapIndex::detach() {
+        if (buffer_) {
+            buffer_->removeChangeListener(listenerId_);
+            buffer_ = nullptr;
+        }
+        layout_ = nullptr;
+        rows_.clear();
+        tree_.clear();
+        treeValid_ = 0;
+        totalRows_ = 0;
+        stale_ = true;
+    }
+
+    void WrapIndex::setWrapWidth(float width) {
+        width = std::max(0.0f, width);
+        if (width == width_) return;
+        width_ = width;
+        invalidate();
+    }
+
+    void WrapIndex::invalidate() {
+        stale_ = true;
+    }
+
+    // ========================================================================
+    // Medida
+    // ========================================================================
+
+    void WrapIndex::refresh() const {
+        if (!buffer_) return;
+        if (stale_ || layoutGeneration_ != layout_->getGeneration()) {
+            rows_.assign(buffer_->getLineCount(), 1);
+            measureRange(0, rows_.size());
+            treeValid_ = 0;
+            layoutGeneration_ = layout_->getGeneration();
+            stale_ = false;
+        }
+        if (treeValid_ < rows_.size() || tree_.size() != rows_.size() + 1) rebuildTree(treeValid_);
+    }
+
+    void WrapIndex::measureRange(size_t first, size_t end) const {
+        if (width_ <= 0.0f) {
+            std::fill(rows_.begin() + static_cast<std::ptrdiff_t>(first),
+                      rows_.begin() + static_cast<std::ptrdiff_t>(end), 1u);
+            return;
+        }
+
+        const size_t count = end - first;
+        TaskScheduler& scheduler = TaskScheduler::shared();
+        const size_t parts = std::min(scheduler.getWorkerCount() + 1, count / kParallelChunk);
+        if (count < PARALLEL_MIN_LINES || parts <= 1) {
+            for (size_t line = first; line < end; ++line) {
+                rows_[line] = measureLine(line, *layout_, scratch_);
+            }
+            return;
+        }
+
+        // Cada hilo mide con su copia del layout; con la caché ASCII ya
+        // llena, las copias no vuelven a preguntar por esos avances
+        for (char32_t codepoint = 0; codepoint < 128; ++codepoint) {
+            layout_->getGlyphAdvance(codepoint);
+        }
+        scheduler.parallelFor("wrap-index", TaskPriority::Interactive, count, parts,
+                              [this, first](size_t, size_t begin, size_t stop) {
+            TextLayout layout(*layout_);
+            LineLayout scratch;
+            for (size_t line = first + begin; line < first + stop; ++line) {
+                rows_[line] = measureLine(line, layout, scratch);
+            }
+        });
+    }
+
+    uint32_t WrapIndex::measureLine(size_t line, const TextLayout& layout, LineLayout& scratch) const {
+        const std::string& text = buffer_->getLine(line);
+        if (width_ <= 0.0f || text.empty()) return 1;
+        layout.layoutLine(text, scratch);
+        if (scratch.width() <= width_) return 1;
+        return wrapLine(text, scratch, width_, nullptr);
+    }
+
+    // ========================================================================
+    // Árbol de Fenwick
+    // ========================================================================
+
+    void WrapIndex::rebuildTree(size_t from) const {
+        // Los nodos [1, from] solo cubren líneas anteriores a from y siguen
+        // valiendo. El resto se reconstruye en O(n - from): cada nodo suma
+        // su valor a su padre, y los nodos válidos con padre por encima de
+        // from (los de la descomposición del prefijo from) aportan el suyo
+        const size_t n = rows_.size();
+        from = std::min(from, n);
+        tree_.resize(n + 1);
+        for (size_t i = from + 1; i <= n; ++i) {
+            tree_[i] = rows_[i - 1];
+        }
+        for (size_t i = from; i > 0; i -= i & (~i + 1)) {
+            const size_t parent = i + (i & (~i + 1));
+            if (parent <= n) tree_[parent] += tree_[i];
+        }
+        for (size_t i = from + 1; i <= n; ++i) {
+            const size_t parent = i + (i & (~i + 1));
+            if (parent <= n) tree_[parent] += tree_[i];
+        }
+        treeValid_ = n;
+        totalRows_ = prefixRows(n);
+    }
+
+    void WrapIndex::addToTree(size_t line, int64_t delta) const {
+        // Los nodos pendientes se recalculan desde rows_ al reconstruir
+        const size_t amount = static_cast<size_t>(delta);   // Resta en módulo 2^n
+        const size_t end = std::min(tree_.size(), treeValid_ + 1);
+        for (size_t i = line + 1; i < end; i += i & (~i + 1)) {
+            tree_[i] += amount;
+        }
+        totalRows_ += amount;
+    }
+
+    size_t WrapIndex::prefixRows(size_t line) const {
+        // Filas de las líneas [0, line)
+        size_t sum = 0;
+        for (size_t i = std::min(line, rows_.size()); i > 0; i -= i & (~i + 1)) {
+            sum += tree_[i];
+        }
+        return sum;
+    }
+
+    // ========================================================================
+    // Consultas
+    // ========================================================================
+
+    size_t WrapIndex::getVisualLineCount() const {
+        refresh();
+        return totalRows_;
+    }
+
+    size_t WrapIndex::getRowCount(size_t line) const {
+        refresh();
+        return line < rows_.size() ? rows_[line] : 0;
+    }
+
+    size_t WrapIndex::visualRowOfLine(size_t line) const {
+        refresh();
+        return prefixRows(line);
+    }
+
+    VisualPosition WrapIndex::lineAtVisualRow(size_t row) const {
+        refresh();
+        if (rows_.empty()) return {0, 0};
+        if (row >= totalRows_) return {rows_.size() - 1, rows_.back() - 1u};
+
+        // Descenso por potencias de dos: la mayor línea con prefijo <= row
+        size_t step = 1;
+        while (step * 2 <= rows_.size()) step *= 2;
+
+        size_t line = 0;
+        size_t remaining = row;
+        for (; step > 0; step /= 2) {
+            if (line + step <= rows_.size() && tree_[line + step] <= remaining) {
+                line += step;
+                remaining -= tree_[line];
+            }
+        }
+        return {line, remaining};
+    }
+
+    void WrapIndex::getRowStarts(size_t line, std::vector<size_t>& starts) const {
+        starts.assign(1, 0);
+        if (!buffer_ || line >= buffer_->getLineCount() || width_ <= 0.0f) return;
+
+        const std::string& text = buffer_->getLine(line);
+        layout_->layoutLine(text, scratch_);
+        if (scratch_.width() > width_) wrapLine(text, scratch_, width_, &starts);
+    }
+
+    // ========================================================================
+    // Actualización incremental
+    // ========================================================================
+
+    void WrapIndex::applyChange(const TextChange& change) {
+        // Con una medida completa pendiente no hay nada que mantener
+        if (stale_ || !buffer_) return;
+
+        const size_t first = std::min(change.firstLine, rows_.size());
+        const size_t oldEnd = std::min(first + change.removedLines, rows_.size());
+        const size_t newEnd = first + change.insertedLines;
+
+        if (oldEnd - first == change.insertedLines) {
+            // Mismas líneas: solo cambian sus cuentas
+            for (size_t line = first; line < newEnd; ++line) {
+                const uint32_t rows = measureLine(line, *layout_, scratch_);
+                addToTree(line, static_cast<int64_t>(rows) - static_cast<int64_t>(rows_[line]));
+                rows_[line] = rows;
+            }
+            return;
+        }
+
+        rows_.erase(rows_.begin() + static_cast<std::ptrdiff_t>(first),
+                    rows_.begin() + static_cast<std::ptrdiff_t>(oldEnd));
+        rows_.insert(rows_.begin() + static_cast<std::ptrdiff_t>(first), change.insertedLines, 1u);
+        if (rows_.size() != buffer_->getLineCount()) {
+            // Notificación que no cuadra con el buffer: medir todo
+            stale_ = true;
+            return;
+        }
+        measureRange(first, newEnd);
+        treeValid_ = std::min(treeValid_, first);
+    }
+
+    size_t WrapIndex::getMemoryUsage() const {
+        return sizeof(*this) + rows_.capacity() * sizeof(uint32_t) + tree_.capacity() * sizeof(size_t) +
+               scratch_.getMemoryUsage();
+    }
+
+} // namespace CoralCode
@@ -7,15 +7,21 @@
  * - Inicializar el sistema de logging
  * - Procesar argumentos de línea de comandos
  * - Crear e inicializar el editor
+ * - Ejecutar scripts de edición por lotes sin ventana (--batch)
  * - Manejar excepciones globales
  */
 
+#include "BatchEditor.hpp"
 #include "Editor.hpp"
+#include "FileIndex.hpp"
+#include "LatencyTracer.hpp"
 #include <iostream>
 #include <string>
 #include <vector>
 #include <exception>
 #include <memory>
+#include <filesystem>
+#include <cstdlib>
 
 #ifdef CORALCODE_WINDOWS
     #include <windows.h>
@@ -32,6 +38,14 @@ namespace CoralCode {
         std::vector<std::string> filesToOpen;
         std::string theme = "dark";
         std::string language = "auto";
+        std::string workspace;
+        std::string openQuery;
+        std::string batchScript;
+        std::vector<std::string> batchInclude;
+        size_t batchJobs = 0;
+        bool dryRun = false;
+        bool profile = false;
+        std::string tracePath;
         bool showHelp = false;
         bool showVersion = false;
         bool verbose = false;
@@ -62,6 +76,30 @@ namespace CoralCode {
             else if (arg == "--language" && i + 1 < argc) {
                 args.language = argv[++i];
             }
+            else if (arg == "--workspace" && i + 1 < argc) {
+                args.workspace = argv[++i];
+            }
+            else if (arg == "--open" && i + 1 < argc) {
+                args.openQuery = argv[++i];
+            }
+            else if (arg == "--batch" && i + 1 < argc) {
+                args.batchScript = argv[++i];
+            }
+            else if (arg == "--jobs" && i + 1 < argc) {
+                args.batchJobs = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (arg == "--include" && i + 1 < argc) {
+                args.batchInclude.push_back(argv[++i]);
+            }
+            else if (arg == "--dry-run") {
+                args.dryRun = true;
+            }
+            else if (arg == "--profile") {
+                args.profile = true;
+            }
+            else if (arg == "--trace" && i + 1 < argc) {
+                args.tracePath = argv[++i];
+            }
             else if (arg.front() != '-') {
                 // Es un archivo
                 args.filesToOpen.push_back(arg);
@@ -82,12 +120,27 @@ namespace CoralCode {
         std::cout << "  -v, --version        Mostrar versión\n";
         std::cout << "  --verbose            Modo verboso\n";
         std::cout << "  --theme <tema>       Establecer tema (dark, light, blue, green)\n";
-        std::cout << "  --language <lang>    Forzar lenguaje (auto, cpp, python, javascript, etc.)\n\n";
+        std::cout << "  --language <lang>    Forzar lenguaje (auto, cpp, python, javascript, etc.)\n";
+        std::cout << "  --workspace <dir>    Indexar un directorio para apertura rápida\n";
+        std::cout << "  --open <consulta>    Abrir el archivo del espacio de trabajo que mejor coincida\n";
+        std::cout << "  --batch <script>     Aplicar un script de edición a los archivos, sin ventana\n";
+        std::cout << "  --jobs <n>           Hilos para --batch (por defecto, uno por núcleo)\n";
+        std::cout << "  --include <glob>     Con --batch, solo archivos que coincidan (repetible)\n";
+        std::cout << "  --dry-run            Con --batch, informar sin escribir\n";
+        std::cout << "  --profile            Perfilador de frames visible y resumen al salir\n";
+        std::cout << "  --trace <archivo>    Guardar al salir la traza de latencia (JSON de Chrome/Perfetto)\n\n";
         std::cout << "Ejemplos:\n";
         std::cout << "  coralcode                          # Abrir editor vacío\n";
         std::cout << "  coralcode main.cpp                 # Abrir archivo específico\n";
         std::cout << "  coralcode --theme light *.cpp     # Abrir con tema claro\n";
-        std::cout << "  coralcode --language python *.py  # Forzar highlighting de Python\n\n";
+        std::cout << "  coralcode --language python *.py  # Forzar highlighting de Python\n";
+        std::cout << "  coralcode --workspace . --open txtbuf  # Abrir TextBuffer.cpp por coincidencia difusa\n";
+        std::cout << "  coralcode --batch fix.ccs --include '*.cpp' src  # Editar todo src/ por lotes\n\n";
+        std::cout << "Órdenes de --batch (una por línea, '#' comenta):\n";
+        std::cout << "  replace \"viejo\" \"nuevo\" [-i] [-w]    replace-regex \"patrón\" \"nuevo $1\" [-i]\n";
+        std::cout << "  delete-lines \"patrón\"                 insert-line <n|end> \"texto\"\n";
+        std::cout << "  trim-trailing-whitespace               expand-tabs [ancho]\n";
+        std::cout << "  ensure-final-newline                   require[-regex] \"patrón\" (si falta, se omite)\n\n";
         std::cout << "Controles:\n";
         std::cout << "  Ctrl/Cmd+N      Nuevo archivo\n";
         std::cout << "  Ctrl/Cmd+O      Abrir archivo\n";
@@ -96,6 +149,7 @@ namespace CoralCode {
         std::cout << "  Ctrl/Cmd+Y      Rehacer\n";
         std::cout << "  Ctrl/Cmd+C/V    Copiar/Pegar\n";
         std::cout << "  Ctrl/Cmd+F      Buscar\n";
+        std::cout << "  F12             Perfilador de frames\n";
         std::cout << "  ESC             Salir\n\n";
         std::cout << "Para más información: https://github.com/tu-usuario/coralcode\n";
     }
@@ -153,10 +207,52 @@ namespace CoralCode {
         }
     }
     
+    /**
+     * @brief Resuelve --open: mejor coincidencia del índice de rutas
+     *
+     * Usa el índice guardado si existe (revisado contra el árbol actual) y
+     * si no lo construye; en ambos casos queda guardado para la próxima vez.
+     */
+    static std::string resolveQuickOpen(const std::string& root, const std::string& query, bool verbose) {
+        FileIndex index;
+        const std::string indexPath = FileIndex::defaultIndexPath(root);
+        if (!(index.load(indexPath) && index.getRoot() == root && index.reconcile()) && !index.build(root)) {
+            std::cerr << "⚠️  Advertencia: No se pudo indexar " << root << ": " << index.getLastError() << "\n";
+            return std::string();
+        }
+        index.save(indexPath);
+
+        std::vector<FileMatch> matches = index.query(query, 1);
+        if (matches.empty()) {
+            std::cerr << "⚠️  Advertencia: Ningún archivo coincide con '" << query << "'\n";
+            return std::string();
+        }
+        if (verbose) {
+            std::cout << "🔎 " << index.size() << " archivos indexados, mejor coincidencia: "
+                      << matches.front().path << "\n";
+        }
+        return (std::filesystem::path(root) / matches.front().path).string();
+    }
+    
+    /**
+     * @brief Modo --batch: reenvía a BatchEditor::runRequest, el mismo
+     * camino que usa el ejecutable coralcode_batch
+     */
+    static int runBatch(const CommandLineArgs& args) {
+        BatchRequest request;
+        request.scriptPath = args.batchScript;
+        request.inputs = args.filesToOpen;
+        request.include = args.batchInclude;
+        request.options.jobs = args.batchJobs;
+        request.options.dryRun = args.dryRun;
+        request.verbose = args.verbose;
+        return BatchEditor::runRequest(request);
+    }
+    
     /**
      * @brief Función principal del editor
      */
-    int runEditor(const CommandLineArgs& args) {
+    static int runEditor(const CommandLineArgs& args) {
         try {
             // Crear e inicializar el editor
             auto editor = std::make_unique<Editor>();
@@ -170,6 +266,16 @@ namespace CoralCode {
                 std::cout << "✅ Editor inicializado correctamente\n";
             }
             
+            // Traza de latencia: entrada, edición, render y tareas en segundo plano
+            LatencyTracer::setThreadName("Ventana");
+            LatencyTracer::shared().setEnabled(!args.tracePath.empty());
+            
+            // Perfilador de frames con el overlay ya abierto
+            if (args.profile) {
+                editor->setProfiling(true);
+                editor->toggleProfilerOverlay();
+            }
+            
             // Configurar tema
             if (!args.theme.empty() && args.theme != "auto") {
                 editor->setTheme(args.theme);
@@ -179,8 +285,18 @@ namespace CoralCode {
             }
             
             // Abrir archivos especificados
+            std::vector<std::string> filesToOpen = args.filesToOpen;
+            const std::string workspace = args.workspace.empty() ? std::string(".") : args.workspace;
+            if (!args.openQuery.empty()) {
+                std::string match = resolveQuickOpen(workspace, args.openQuery, args.verbose);
+                if (!match.empty()) filesToOpen.push_back(match);
+            }
+            if (!args.workspace.empty() && !editor->openWorkspace(args.workspace)) {
+                std::cerr << "⚠️  Advertencia: No se pudo abrir el espacio de trabajo " << args.workspace << "\n";
+            }
+            
             bool filesOpened = false;
-            for (const auto& filepath : args.filesToOpen) {
+            for (const auto& filepath : filesToOpen) {
                 if (editor->openFile(filepath)) {
                     filesOpened = true;
                     if (args.verbose) {
@@ -214,7 +330,26 @@ namespace CoralCode {
             // Ejecutar loop principal
             editor->run();
             
-            // Limpieza
+            if (args.profile) {
+                std::cout << "⏱️  Perfil: "
+                          << FrameProfiler::formatSummary(editor->getFrameProfiler().computeStats()) << "\n";
+            }
+            
+            if (!args.tracePath.empty()) {
+                std::string error;
+                if (LatencyTracer::shared().exportChromeTrace(args.tracePath, error)) {
+                    std::cout << "🧵 Traza de latencia guardada en " << args.tracePath << "\n";
+                } else {
+                    std::cerr << "⚠️  Advertencia: " << error << "\n";
+                }
+            }
+            
+            if (args.verbose) {
+                std::cout << "\n" << editor->getMemoryUsage().formatReport();
+            }
+            
+            // Limpieza (el índice de rutas se guarda para el próximo arranque)
+            editor->closeWorkspace();
             editor->shutdown();
             
             if (args.verbose) {
@@ -260,6 +395,11 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
+    // Modo por lotes: nunca crea ventana
+    if (!args.batchScript.empty()) {
+        return runBatch(args);
+    }
+    
     // Ejecutar editor
     return runEditor(args);
 }
\ No newline at end of file
@@ -0,0 +1,682 @@
+/**
+ * @file IncrementalParser.cpp
+ * @brief Análisis incremental de estructura para highlighting, plegado y outline
+ */
+
+#include "IncrementalParser.hpp"
+#include "MemoryUsage.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace CoralCode {
+
+    namespace {
+
+        const size_t NOT_FOUND = static_cast<size_t>(-1);
+
+        bool isIdentifierChar(unsigned char ch) {
+            return std::isalnum(ch) || ch == '_' || ch >= 0x80;
+        }
+
+        bool isOpener(char ch) {
+            return ch == '(' || ch == '[' || ch == '{' || ch == '<';
+        }
+
+        bool isControlKeyword(const std::string& word) {
+            static const char* const controlWords[] = {
+                "return", "if", "else", "while", "for", "do", "switch", "case",
+                "new", "delete", "sizeof", "throw", "co_return", "co_await", "not"
+            };
+            for (const char* control : controlWords) {
+                if (word == control) return true;
+            }
+            return false;
+        }
+
+    } // namespace
+
+    IncrementalParser::IncrementalParser(const SyntaxHighlighter& highlighter)
+        : highlighter_(&highlighter), buffer_(nullptr), listenerId_(0),
+          dirtyBegin_(0), dirtyEnd_(0), treeLeaves_(0), treeNeedsRebuild_(true) {}
+
+    IncrementalParser::~IncrementalParser() {
+        detach();
+    }
+
+    // ========================================================================
+    // Conexión con el buffer
+    // ========================================================================
+
+    void IncrementalParser::attach(TextBuffer& buffer) {
+        detach();
+        buffer_ = &buffer;
+        listenerId_ = buffer.addChangeListener([this](const TextChange& change) {
+            applyChange(change);
+        });
+        invalidate();
+    }
+
+    void IncrementalParser::detach() {
+        if (buffer_) {
+            buffer_->removeChangeListener(listenerId_);
+            buffer_ = nullptr;
+        }
+        lines_.clear();
+        lineSummaries_.clear();
+        declaredTypeCounts_.clear();
+        dirtyBegin_ = dirtyEnd_ = 0;
+        treeNeedsRebuild_ = true;
+    }
+
+    void IncrementalParser::invalidate() {
+        // Re-análisis completo (p.ej. al cambiar el lenguaje del highlighter)
+        lines_.clear();
+        declaredTypeCounts_.clear();
+        if (buffer_) {
+            lines_.resize(buffer_->getLineCount());
+            for (auto& info : lines_) {
+                info = std::make_unique<LineInfo>();
+            }
+        }
+        lineSummaries_.assign(lines_.size(), BracketNode());
+        dirtyBegin_ = 0;
+        dirtyEnd_ = lines_.size();
+        treeNeedsRebuild_ = true;
+    }
+
+    // ========================================================================
+    // Análisis incremental
+    // ========================================================================
+
+    void IncrementalParser::applyChange(const TextChange& change) {
+        if (!buffer_) return;
+        if (change.firstLine > lines_.size()) {
+            invalidate();
+            return;
+        }
+
+        size_t first = change.firstLine;
+        size_t removed = std::min(change.removedLines, lines_.size() - first);
+        size_t inserted = change.insertedLines;
+
+        for (size_t i = first; i < first + removed; ++i) {
+            if (lines_[i]->parsed) {
+                unregisterTypes(*lines_[i]);
+            }
+        }
+
+        if (removed == inserted) {
+            // Edición en sitio: conservar el estado final previo para detectar convergencia
+            for (size_t i = first; i < first + removed; ++i) {
+                lines_[i]->parsed = false;
+                lines_[i]->declaredTypes.clear();
+            }
+        } else {
+            auto begin = lines_.begin() + static_cast<std::ptrdiff_t>(first);
+            lines_.erase(begin, begin + static_cast<std::ptrdiff_t>(removed));
+            std::vector<std::unique_ptr<LineInfo>> fresh(inserted);
+            for (auto& info : fresh) {
+                info = std::make_unique<LineInfo>();
+            }
+            lines_.insert(lines_.begin() + static_cast<std::ptrdiff_t>(first),
+                          std::make_move_iterator(fresh.begin()), std::make_move_iterator(fresh.end()));
+
+            auto summaries = lineSummaries_.begin() + static_cast<std::ptrdiff_t>(first);
+            lineSummaries_.erase(summaries, summaries + static_cast<std::ptrdiff_t>(removed));
+            lineSummaries_.insert(lineSummaries_.begin() + static_cast<std::ptrdiff_t>(first), inserted, BracketNode());
+            treeNeedsRebuild_ = true;
+        }
+
+        // Desplazar la región pendiente que quedaba detrás del cambio
+        if (dirtyBegin_ < dirtyEnd_) {
+            auto shift = [&](size_t pos) {
+                if (pos < first) return pos;
+                if (pos >= first + removed) return pos - removed + inserted;
+                return first;
+            };
+            dirtyBegin_ = shift(dirtyBegin_);
+            dirtyEnd_ = shift(dirtyEnd_);
+        }
+
+        // Una eliminación pura cambia el estado inicial de la línea siguiente
+        markDirty(first, first + std::max<size_t>(inserted, 1));
+    }
+
+    void IncrementalParser::markDirty(size_t begin, size_t end) {
+        end = std::min(end, lines_.size());
+        if (begin >= end) return;
+
+        if (dirtyBegin_ < dirtyEnd_) {
+            dirtyBegin_ = std::min(dirtyBegin_, begin);
+            dirtyEnd_ = std::max(dirtyEnd_, end);
+        } else {
+            dirtyBegin_ = begin;
+            dirtyEnd_ = end;
+        }
+    }
+
+    bool IncrementalParser::needsReparse() const {
+        return dirtyBegin_ < dirtyEnd_ || treeNeedsRebuild_;
+    }
+
+    size_t IncrementalParser::reparse() {
+        if (!buffer_) return 0;
+
+        size_t parsedLines = 0;
+        if (dirtyBegin_ < dirtyEnd_) {
+            size_t line = dirtyBegin_;
+            LexState state = line > 0 ? lines_[line - 1]->endState : LexState();
+
+            // Re-analizar la región editada y continuar solo mientras el estado
+            // léxico de salida difiera del que tenía la línea antes del cambio
+            while (line < lines_.size()) {
+                LineInfo& info = *lines_[line];
+                bool hadState = info.stateKnown;
+                LexState previousEnd = info.endState;
+
+                if (info.parsed) {
+                    unregisterTypes(info);
+                }
+                lexLine(buffer_->getLine(line), state, info);
+                registerTypes(info);
+                lineSummaries_[line] = summarizeLine(info);
+
+                if (!treeNeedsRebuild_) {
+                    updateBracketLeaf(line);
+                }
+
+                ++parsedLines;
+                ++line;
+
+                if (line >= dirtyEnd_ && hadState && sameState(state, previousEnd)) {
+                    break;
+                }
+            }
+            dirtyBegin_ = dirtyEnd_ = 0;
+        }
+
+        if (treeNeedsRebuild_) {
+            rebuildBracketTree();
+        }
+        return parsedLines;
+    }
+
+    // ========================================================================
+    // Análisis léxico
+    // ========================================================================
+
+    void IncrementalParser::lexLine(const std::string& text, LexState& state, LineInfo& info) const {
+        info.spans.clear();
+        info.brackets.clear();
+        info.declaredTypes.clear();
+        info.outline.clear();
+
+        std::vector<Token> tokens = highlighter_->tokenizeLineWithState(text, state);
+        info.spans.reserve(tokens.size());
+        for (const auto& token : tokens) {
+            info.spans.push_back({static_cast<uint32_t>(token.start), static_cast<uint32_t>(token.end), token.type});
+        }
+
+        info.endState = state;
+        info.parsed = info.stateKnown = true;
+        markTemplatesAndBrackets(text, info);
+        classifyLine(text, info);
+    }
+
+    bool IncrementalParser::sameState(const LexState& a, const LexState& b) {
+        return a.inBlockComment == b.inBlockComment && a.blockCommentEnd == b.blockCommentEnd;
+    }
+
+    void IncrementalParser::markTemplatesAndBrackets(const std::string& text, LineInfo& info) const {
+        // Posiciones de '>' que cierran listas de argumentos de plantilla
+        std::vector<size_t> angleClosers;
+
+        for (size_t i = 0; i < info.spans.size(); ++i) {
+            const Span& span = info.spans[i];
+            if (span.type != TokenType::Operator) continue;
+
+            char ch = text[span.start];
+            switch (ch) {
+                case '(': case '[': case '{':
+                case ')': case ']': case '}':
+                    info.brackets.push_back({span.start, ch});
+                    break;
+
+                case '<': {
+                    // `Nombre<...>` (sin espacio) o `template <...>`
+                    if (i == 0) break;
+                    size_t prev = i - 1;
+                    if (info.spans[prev].type == TokenType::Whitespace && prev > 0) {
+                        --prev;
+                    }
+                    Span& name = info.spans[prev];
+                    bool adjacentName = prev == i - 1 && name.type == TokenType::Identifier;
+                    bool templateKeyword = name.type == TokenType::Keyword &&
+                                           text.compare(name.start, name.end - name.start, "template") == 0;
+                    if (!adjacentName && !templateKeyword) break;
+
+                    size_t close = templateArgumentsEnd(text, span.start);
+                    if (close == NOT_FOUND) break;
+
+                    if (adjacentName) {
+                        name.type = TokenType::Type;
+                    }
+                    info.brackets.push_back({span.start, '<'});
+                    angleClosers.push_back(close);
+                    break;
+                }
+
+                case '>': {
+                    auto closer = std::find(angleClosers.begin(), angleClosers.end(), span.start);
+                    if (closer != angleClosers.end()) {
+                        angleClosers.erase(closer);
+                        info.brackets.push_back({span.start, '>'});
+                    }
+                    break;
+                }
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    size_t IncrementalParser::templateArgumentsEnd(const std::string& text, size_t openPos) {
+        // Descartar `<<` y `<=`
+        if (openPos + 1 < text.size() && (text[openPos + 1] == '<' || text[openPos + 1] == '=')) {
+            return NOT_FOUND;
+        }
+
+        int depth = 0;
+        int parens = 0;
+        for (size_t i = openPos; i < text.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c == '<') {
+                ++depth;
+            } else if (c == '>') {
+                if (parens > 0) return NOT_FOUND;
+                if (--depth == 0) return i;
+            } else if (c == '(') {
+                ++parens;
+            } else if (c == ')') {
+                if (--parens < 0) return NOT_FOUND;
+            } else if (!(isIdentifierChar(c) || c == ':' || c == ',' || c == ' ' || c == '*' ||
+                         c == '&' || c == '.' || c == '[' || c == ']')) {
+                // Cualquier otro carácter indica una comparación, no una plantilla
+                return NOT_FOUND;
+            }
+        }
+        return NOT_FOUND;
+    }
+
+    void IncrementalParser::classifyLine(const std::string& text, LineInfo& info) const {
+        // Índices de tokens significativos (sin espacios ni comentarios)
+        std::vector<size_t> significant;
+        significant.reserve(info.spans.size());
+        for (size_t i = 0; i < info.spans.size(); ++i) {
+            TokenType type = info.spans[i].type;
+            if (type != TokenType::Whitespace && type != TokenType::Comment) {
+                significant.push_back(i);
+            }
+        }
+
+        auto spanText = [&](size_t index) {
+            const Span& span = info.spans[index];
+            return text.substr(span.start, span.end - span.start);
+        };
+        auto isOperator = [&](size_t pos, char ch) {
+            if (pos >= significant.size()) return false;
+            const Span& span = info.spans[significant[pos]];
+            return span.type == TokenType::Operator && text[span.start] == ch;
+        };
+
+        for (size_t s = 0; s < significant.size(); ++s) {
+            Span& span = info.spans[significant[s]];
+            if (span.type != TokenType::Identifier && span.type != TokenType::Type) continue;
+
+            std::string name = spanText(significant[s]);
+            const Span* prev = s > 0 ? &info.spans[significant[s - 1]] : nullptr;
+            std::string prevWord = prev && prev->type == TokenType::Keyword ? spanText(significant[s - 1]) : "";
+
+            // Declaraciones de tipos: class/struct/enum/union/typename X
+            if (prevWord == "class" || prevWord == "struct" || prevWord == "enum" ||
+                prevWord == "union" || prevWord == "typename" || prevWord == "concept") {
+                span.type = TokenType::Type;
+                info.declaredTypes.push_back(name);
+
+                // Parámetros de plantilla (`<class T`, `, typename U`) no van al outline
+                bool templateParameter = s >= 2 && (isOperator(s - 2, '<') || isOperator(s - 2, ','));
+                if (!templateParameter && prevWord != "typename" && !isOperator(s + 1, ';')) {
+                    info.outline.push_back({name, prevWord, 0, span.start});
+                }
+                continue;
+            }
+
+            if (prevWord == "namespace") {
+                info.outline.push_back({name, prevWord, 0, span.start});
+                continue;
+            }
+
+            // Alias: using X = ...
+            if (prevWord == "using" && isOperator(s + 1, '=')) {
+                span.type = TokenType::Type;
+                info.declaredTypes.push_back(name);
+                continue;
+            }
+
+            // Calificador de ámbito: X::
+            if (isOperator(s + 1, ':') && isOperator(s + 2, ':')) {
+                span.type = TokenType::Type;
+                continue;
+            }
+
+            // Declaración `Tipo variable`, `Tipo* variable` o `Tipo& variable`
+            if (s + 1 < significant.size()) {
+                const Span& next = info.spans[significant[s + 1]];
+                bool nextIsName = next.type == TokenType::Identifier || next.type == TokenType::Type;
+                bool pointerDeclarator = (isOperator(s + 1, '*') || isOperator(s + 1, '&')) &&
+                                         next.start == span.end && next.end < text.size() &&
+                                         (text[next.end] == ' ' || text[next.end] == '\t');
+                if (nextIsName || pointerDeclarator) {
+                    span.type = TokenType::Type;
+                    continue;
+                }
+            }
+
+            // Definiciones de funciones: `Tipo nombre(` o `Tipo Clase::nombre(`
+            if (isOperator(s + 1, '(') && prev) {
+                bool typedPrefix = prev->type == TokenType::Type ||
+                                   (prev->type == TokenType::Keyword && !isControlKeyword(prevWord));
+                bool qualified = s >= 3 && isOperator(s - 1, ':') && isOperator(s - 2, ':') &&
+                                 info.spans[significant[s - 3]].type == TokenType::Type;
+                if (typedPrefix || qualified) {
+                    info.outline.push_back({name, "function", 0, span.start});
+                }
+            }
+        }
+    }
+
+    // ========================================================================
+    // Tipos declarados
+    // ========================================================================
+
+    void IncrementalParser::registerTypes(const LineInfo& info) {
+        for (const auto& name : info.declaredTypes) {
+            ++declaredTypeCounts_[name];
+        }
+    }
+
+    void IncrementalParser::unregisterTypes(const LineInfo& info) {
+        for (const auto& name : info.declaredTypes) {
+            auto it = declaredTypeCounts_.find(name);
+            if (it != declaredTypeCounts_.end() && --it->second == 0) {
+                declaredTypeCounts_.erase(it);
+            }
+        }
+    }
+
+    bool IncrementalParser::isKnownType(const std::string& name) const {
+        return declaredTypeCounts_.count(name) > 0;
+    }
+
+    // ========================================================================
+    // Consultas para highlighting
+    // ========================================================================
+
+    std::vector<Token> IncrementalParser::getLineTokens(size_t line) const {
+        std::vector<Token> tokens;
+        if (!buffer_ || line >= lines_.size()) return tokens;
+
+        const std::string& text = buffer_->getLine(line);
+        const LineInfo* info = lines_[line].get();
+
+        // Línea aún no analizada: analizarla con el último estado conocido
+        LineInfo pending;
+        if (!info->parsed) {
+            LexState state = line > 0 && lines_[line - 1]->stateKnown ? lines_[line - 1]->endState : LexState();
+            lexLine(text, state, pending);
+            info = &pending;
+        }
+
+        tokens.reserve(info->spans.size());
+        for (const auto& span : info->spans) {
+            std::string tokenText = text.substr(span.start, span.end - span.start);
+            TokenType type = span.type;
+            if (type == TokenType::Identifier && isKnownType(tokenText)) {
+                type = TokenType::Type;
+            }
+            tokens.emplace_back(tokenText, type, span.start, span.end);
+        }
+        return tokens;
+    }
+
+    // ========================================================================
+    // Árbol de delimitadores
+    // ========================================================================
+
+    IncrementalParser::BracketNode IncrementalParser::summarizeLine(const LineInfo& info) {
+        BracketNode node;
+        int32_t sum = 0;
+        for (const auto& bracket : info.brackets) {
+            sum += isOpener(bracket.ch) ? 1 : -1;
+            node.minPrefix = std::min(node.minPrefix, sum);
+        }
+        node.delta = sum;
+
+        int32_t suffix = 0;
+        for (auto it = info.brackets.rbegin(); it != info.brackets.rend(); ++it) {
+            suffix += isOpener(it->ch) ? 1 : -1;
+            node.maxSuffix = std::max(node.maxSuffix, suffix);
+        }
+        return node;
+    }
+
+    IncrementalParser::BracketNode IncrementalParser::combine(const BracketNode& left, const BracketNode& right) {
+        BracketNode node;
+        node.delta = left.delta + right.delta;
+        node.minPrefix = std::min(left.minPrefix, left.delta + right.minPrefix);
+        node.maxSuffix = std::max(right.maxSuffix, right.delta + left.maxSuffix);
+        return node;
+    }
+
+    void IncrementalParser::rebuildBracketTree() {
+        treeLeaves_ = 1;
+        while (treeLeaves_ < lines_.size()) {
+            treeLeaves_ <<= 1;
+        }
+
+        bracketTree_.assign(2 * treeLeaves_, BracketNode());
+        std::copy(lineSummaries_.begin(), lineSummaries_.end(),
+                  bracketTree_.begin() + static_cast<std::ptrdiff_t>(treeLeaves_));
+        for (size_t node = treeLeaves_ - 1; node > 0; --node) {
+            bracketTree_[node] = combine(bracketTree_[2 * node], bracketTree_[2 * node + 1]);
+        }
+        treeNeedsRebuild_ = false;
+    }
+
+    void IncrementalParser::updateBracketLeaf(size_t line) {
+        size_t node = treeLeaves_ + line;
+        bracketTree_[node] = lineSummaries_[line];
+        for (node /= 2; node > 0; node /= 2) {
+            bracketTree_[node] = combine(bracketTree_[2 * node], bracketTree_[2 * node + 1]);
+        }
+    }
+
+    size_t IncrementalParser::descendForward(size_t node, size_t lo, size_t hi, size_t fromLine,
+                                             int32_t& depth) const {
+        if (hi <= fromLine) return NOT_FOUND;
+
+        const BracketNode& summary = bracketTree_[node];
+        if (lo >= fromLine && depth + summary.minPrefix > 0) {
+            // El bloque no se cierra dentro de este nodo
+            depth += summary.delta;
+            return NOT_FOUND;
+        }
+        if (hi - lo == 1) return lo;
+
+        size_t mid = lo + (hi - lo) / 2;
+        size_t found = descendForward(2 * node, lo, mid, fromLine, depth);
+        if (found != NOT_FOUND) return found;
+        return descendForward(2 * node + 1, mid, hi, fromLine, depth);
+    }
+
+    size_t IncrementalParser::descendBackward(size_t node, size_t lo, size_t hi, size_t toLine,
+                                              int32_t& depth) const {
+        if (lo > toLine) return NOT_FOUND;
+
+        const BracketNode& summary = bracketTree_[node];
+        if (hi - 1 <= toLine && summary.maxSuffix < depth) {
+            // El bloque no se abre dentro de este nodo
+            depth -= summary.delta;
+            return NOT_FOUND;
+        }
+        if (hi - lo == 1) return lo;
+
+        size_t mid = lo + (hi - lo) / 2;
+        size_t found = descendBackward(2 * node + 1, mid, hi, toLine, depth);
+        if (found != NOT_FOUND) return found;
+        return descendBackward(2 * node, lo, mid, toLine, depth);
+    }
+
+    size_t IncrementalParser::findCloserLine(size_t fromLine, int32_t& depth) const {
+        if (treeNeedsRebuild_ || fromLine >= lines_.size()) return NOT_FOUND;
+        return descendForward(1, 0, treeLeaves_, fromLine, depth);
+    }
+
+    size_t IncrementalParser::findOpenerLine(size_t toLine, int32_t& depth) const {
+        if (treeNeedsRebuild_ || toLine >= lines_.size()) return NOT_FOUND;
+        return descendBackward(1, 0, treeLeaves_, toLine, depth);
+    }
+
+    bool IncrementalParser::matchInLine(size_t line, size_t startIndex, bool forward,
+                                        int32_t& depth, size_t& matchCol) const {
+        const auto& brackets = lines_[line]->brackets;
+
+        if (forward) {
+            for (size_t k = startIndex; k < brackets.size(); ++k) {
+                depth += isOpener(brackets[k].ch) ? 1 : -1;
+                if (depth == 0) {
+                    matchCol = brackets[k].column;
+                    return true;
+                }
+            }
+        } else {
+            // startIndex es exclusivo al recorrer hacia atrás
+            for (size_t k = std::min(startIndex, brackets.size()); k-- > 0;) {
+                depth += isOpener(brackets[k].ch) ? -1 : 1;
+                if (depth == 0) {
+                    matchCol = brackets[k].column;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // ========================================================================
+    // Consultas estructurales
+    // ========================================================================
+
+    bool IncrementalParser::findMatchingBracket(size_t line, size_t col, size_t& matchLine, size_t& matchCol) const {
+        if (line >= lines_.size() || !lines_[line]->parsed) return false;
+
+        const auto& brackets = lines_[line]->brackets;
+        auto it = std::lower_bound(brackets.begin(), brackets.end(), col,
+                                   [](const BracketMark& mark, size_t column) { return mark.column < column; });
+        if (it == brackets.end() || it->column != col) return false;
+
+        size_t index = static_cast<size_t>(it - brackets.begin());
+        int32_t depth = 0;
+
+        if (isOpener(it->ch)) {
+            if (matchInLine(line, index, true, depth, matchCol)) {
+                matchLine = line;
+                return true;
+            }
+            size_t target = findCloserLine(line + 1, depth);
+            if (target == NOT_FOUND || !matchInLine(target, 0, true, depth, matchCol)) return false;
+            matchLine = target;
+            return true;
+        }
+
+        if (matchInLine(line, index + 1, false, depth, matchCol)) {
+            matchLine = line;
+            return true;
+        }
+        if (line == 0) return false;
+        size_t target = findOpenerLine(line - 1, depth);
+        if (target == NOT_FOUND || !matchInLine(target, lines_[target]->brackets.size(), false, depth, matchCol)) {
+            return false;
+        }
+        matchLine = target;
+        return true;
+    }
+
+    std::vector<FoldRange> IncrementalParser::getFoldRanges(size_t firstLine, size_t lastLine) const {
+        std::vector<FoldRange> ranges;
+        if (treeNeedsRebuild_) return ranges;
+
+        lastLine = std::min(lastLine, lines_.empty() ? 0 : lines_.size() - 1);
+        for (size_t line = firstLine; line <= lastLine && line < lines_.size(); ++line) {
+            const auto& brackets = lines_[line]->brackets;
+
+            // Delimitador de apertura más externo que queda sin cerrar en la línea
+            size_t outermost = NOT_FOUND;
+            int32_t open = 0;
+            for (size_t k = 0; k < brackets.size(); ++k) {
+                if (isOpener(brackets[k].ch)) {
+                    if (open++ == 0) outermost = k;
+                } else if (open > 0 && --open == 0) {
+                    outermost = NOT_FOUND;
+                }
+            }
+            if (outermost == NOT_FOUND || brackets[outermost].ch == '<') continue;
+
+            int32_t depth = 0;
+            size_t matchCol = 0;
+            if (matchInLine(line, outermost, true, depth, matchCol)) continue;
+
+            size_t endLine = findCloserLine(line + 1, depth);
+            if (endLine != NOT_FOUND && endLine > line) {
+                ranges.push_back({line, endLine});
+            }
+        }
+        return ranges;
+    }
+
+    std::vector<OutlineEntry> IncrementalParser::getOutline() const {
+        std::vector<OutlineEntry> outline;
+        for (size_t line = 0; line < lines_.size(); ++line) {
+            for (const auto& entry : lines_[line]->outline) {
+                outline.push_back(entry);
+                outline.back().line = line;
+            }
+        }
+        return outline;
+    }
+
+    size_t IncrementalParser::getMemoryUsage() const {
+        size_t bytes = sizeof(*this) + lines_.capacity() * sizeof(std::unique_ptr<LineInfo>);
+        for (const auto& info : lines_) {
+            bytes += sizeof(LineInfo) + info->spans.capacity() * sizeof(Span) +
+                     info->brackets.capacity() * sizeof(BracketMark) +
+                     info->declaredTypes.capacity() * sizeof(std::string) +
+                     info->outline.capacity() * sizeof(OutlineEntry) +
+                     MemoryUsage::stringBytes(info->endState.blockCommentEnd);
+            for (const auto& name : info->declaredTypes) {
+                bytes += MemoryUsage::stringBytes(name);
+            }
+            for (const auto& entry : info->outline) {
+                bytes += MemoryUsage::stringBytes(entry.name) + MemoryUsage::stringBytes(entry.kind);
+            }
+        }
+        // Nodos de la tabla: clave, valor y puntero al siguiente
+        bytes += declaredTypeCounts_.bucket_count() * sizeof(void*);
+        for (const auto& entry : declaredTypeCounts_) {
+            bytes += sizeof(entry) + sizeof(void*) + MemoryUsage::stringBytes(entry.first);
+        }
+        bytes += (lineSummaries_.capacity() + bracketTree_.capacity()) * sizeof(BracketNode);
+        return bytes;
+    }
+
+} // namespace CoralCode
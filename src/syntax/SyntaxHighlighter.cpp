@@ -0,0 +1,484 @@
+/**
+ * @file SyntaxHighlighter.cpp
+ * @brief Análisis léxico por línea y asignación de colores
+ */
+
+#include "SyntaxHighlighter.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace CoralCode {
+
+    namespace {
+
+        bool isIdentifierStart(unsigned char ch) {
+            return std::isalpha(ch) || ch == '_' || ch >= 0x80;
+        }
+
+        bool isIdentifierChar(unsigned char ch) {
+            return std::isalnum(ch) || ch == '_' || ch >= 0x80;
+        }
+
+        std::string toLower(std::string text) {
+            std::transform(text.begin(), text.end(), text.begin(),
+                           [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+            return text;
+        }
+
+    } // namespace
+
+    SyntaxHighlighter::SyntaxHighlighter() {
+        initializeLanguages();
+        initializeColorSchemes();
+        loadDefaultTheme();
+        setLanguage("C++");
+    }
+
+    // ========================================================================
+    // Configuración de lenguaje
+    // ========================================================================
+
+    void SyntaxHighlighter::setLanguage(const std::string& languageName) {
+        const LanguageDefinition* language = findLanguageByName(languageName);
+        if (!language) {
+            language = findLanguageByName("Plain Text");
+        }
+        currentLanguage_ = std::make_unique<LanguageDefinition>(*language);
+    }
+
+    void SyntaxHighlighter::setLanguageByExtension(const std::string& fileExtension) {
+        const LanguageDefinition* language = findLanguageByExtension(fileExtension);
+        if (!language) {
+            language = findLanguageByName("Plain Text");
+        }
+        currentLanguage_ = std::make_unique<LanguageDefinition>(*language);
+    }
+
+    std::string SyntaxHighlighter::getCurrentLanguage() const {
+        return currentLanguage_ ? currentLanguage_->name : "Plain Text";
+    }
+
+    const LanguageDefinition& SyntaxHighlighter::getLanguageDefinition() const {
+        return *currentLanguage_;
+    }
+
+    // ========================================================================
+    // Análisis de líneas
+    // ========================================================================
+
+    std::vector<Token> SyntaxHighlighter::tokenizeLine(const std::string& line) const {
+        return parseTokens(line);
+    }
+
+    std::vector<Token> SyntaxHighlighter::tokenizeLineWithState(const std::string& line, MultiLineState& state) const {
+        return parseTokens(line, state);
+    }
+
+    std::vector<std::pair<std::string, TokenColor>> SyntaxHighlighter::highlightLine(const std::string& line) const {
+        return highlightTokens(parseTokens(line));
+    }
+
+    std::vector<std::pair<std::string, TokenColor>> SyntaxHighlighter::highlightLineWithState(
+        const std::string& line, MultiLineState& state) const {
+        return highlightTokens(parseTokens(line, state));
+    }
+
+    std::vector<std::pair<std::string, TokenColor>> SyntaxHighlighter::highlightTokens(
+        const std::vector<Token>& tokens) const {
+        std::vector<std::pair<std::string, TokenColor>> result;
+        result.reserve(tokens.size());
+        for (const auto& token : tokens) {
+            result.emplace_back(token.text, getTokenColor(token.type));
+        }
+        return result;
+    }
+
+    // ========================================================================
+    // Configuración de colores
+    // ========================================================================
+
+    void SyntaxHighlighter::setTokenColor(TokenType type, const TokenColor& color) {
+        colorScheme_[type] = color;
+    }
+
+    TokenColor SyntaxHighlighter::getTokenColor(TokenType type) const {
+        auto it = colorScheme_.find(type);
+        return it != colorScheme_.end() ? it->second : TokenColor();
+    }
+
+    // ========================================================================
+    // Gestión de lenguajes
+    // ========================================================================
+
+    void SyntaxHighlighter::addLanguageDefinition(const LanguageDefinition& language) {
+        for (auto& existing : languages_) {
+            if (existing->name == language.name) {
+                *existing = language;
+                return;
+            }
+        }
+        languages_.push_back(std::make_unique<LanguageDefinition>(language));
+    }
+
+    std::vector<std::string> SyntaxHighlighter::getAvailableLanguages() const {
+        std::vector<std::string> names;
+        for (const auto& language : languages_) {
+            names.push_back(language->name);
+        }
+        return names;
+    }
+
+    // ========================================================================
+    // Configuración de tema
+    // ========================================================================
+
+    void SyntaxHighlighter::setTheme(const std::string& themeName) {
+        currentTheme_ = themeName;
+
+        if (themeName == "light") {
+            colorScheme_[TokenType::Keyword] = TokenColor(0, 0, 200);
+            colorScheme_[TokenType::Type] = TokenColor(38, 127, 153);
+            colorScheme_[TokenType::String] = TokenColor(163, 21, 21);
+            colorScheme_[TokenType::Comment] = TokenColor(0, 128, 0);
+            colorScheme_[TokenType::Number] = TokenColor(9, 134, 88);
+            colorScheme_[TokenType::Operator] = TokenColor(0, 0, 0);
+            colorScheme_[TokenType::Identifier] = TokenColor(0, 0, 0);
+            colorScheme_[TokenType::Whitespace] = TokenColor(0, 0, 0);
+            colorScheme_[TokenType::Unknown] = TokenColor(0, 0, 0);
+        } else if (themeName == "green") {
+            colorScheme_[TokenType::Keyword] = TokenColor(120, 255, 120);
+            colorScheme_[TokenType::Type] = TokenColor(180, 255, 180);
+            colorScheme_[TokenType::String] = TokenColor(200, 255, 100);
+            colorScheme_[TokenType::Comment] = TokenColor(60, 140, 60);
+            colorScheme_[TokenType::Number] = TokenColor(150, 255, 200);
+            colorScheme_[TokenType::Operator] = TokenColor(0, 220, 0);
+            colorScheme_[TokenType::Identifier] = TokenColor(0, 220, 0);
+            colorScheme_[TokenType::Whitespace] = TokenColor(0, 220, 0);
+            colorScheme_[TokenType::Unknown] = TokenColor(0, 220, 0);
+        } else {
+            // Tema dark (colores del editor original)
+            currentTheme_ = themeName == "blue" ? "blue" : "dark";
+            colorScheme_[TokenType::Keyword] = TokenColor(100, 150, 255);
+            colorScheme_[TokenType::Type] = TokenColor(78, 201, 176);
+            colorScheme_[TokenType::String] = TokenColor(255, 200, 100);
+            colorScheme_[TokenType::Comment] = TokenColor(100, 200, 100);
+            colorScheme_[TokenType::Number] = TokenColor(181, 206, 168);
+            colorScheme_[TokenType::Operator] = TokenColor(255, 255, 255);
+            colorScheme_[TokenType::Identifier] = TokenColor(255, 255, 255);
+            colorScheme_[TokenType::Whitespace] = TokenColor(255, 255, 255);
+            colorScheme_[TokenType::Unknown] = TokenColor(255, 255, 255);
+            if (currentTheme_ == "blue") {
+                colorScheme_[TokenType::Identifier] = TokenColor(220, 230, 255);
+                colorScheme_[TokenType::Operator] = TokenColor(220, 230, 255);
+            }
+        }
+    }
+
+    std::vector<std::string> SyntaxHighlighter::getAvailableThemes() const {
+        return {"dark", "light", "blue", "green"};
+    }
+
+    // ========================================================================
+    // Utilidades
+    // ========================================================================
+
+    bool SyntaxHighlighter::isKeyword(const std::string& word) const {
+        if (!currentLanguage_) return false;
+        if (currentLanguage_->caseSensitive) {
+            return currentLanguage_->keywords.count(word) > 0;
+        }
+        return currentLanguage_->keywords.count(toLower(word)) > 0;
+    }
+
+    TokenType SyntaxHighlighter::identifyToken(const std::string& token) const {
+        return classifyToken(token);
+    }
+
+    // ========================================================================
+    // Análisis interno
+    // ========================================================================
+
+    std::vector<Token> SyntaxHighlighter::parseTokens(const std::string& line) const {
+        MultiLineState state;
+        return parseTokens(line, state);
+    }
+
+    std::vector<Token> SyntaxHighlighter::parseTokens(const std::string& line, MultiLineState& state) const {
+        std::vector<Token> tokens;
+        const LanguageDefinition& language = *currentLanguage_;
+        const size_t n = line.size();
+        size_t i = 0;
+
+        auto emit = [&](size_t start, size_t end, TokenType type) {
+            if (end > start) {
+                tokens.emplace_back(line.substr(start, end - start), type, start, end);
+            }
+        };
+
+        // Continuación de un comentario de bloque de la línea anterior
+        if (state.inBlockComment) {
+            size_t endPos = line.find(state.blockCommentEnd);
+            if (endPos == std::string::npos) {
+                emit(0, n, TokenType::Comment);
+                return tokens;
+            }
+            i = endPos + state.blockCommentEnd.size();
+            emit(0, i, TokenType::Comment);
+            state = MultiLineState();
+        }
+
+        while (i < n) {
+            unsigned char c = static_cast<unsigned char>(line[i]);
+
+            // Comentarios de una línea
+            auto lineComment = std::find_if(language.singleLineComments.begin(), language.singleLineComments.end(),
+                [&](const std::string& prefix) {
+                    return !prefix.empty() && line.compare(i, prefix.size(), prefix) == 0;
+                });
+            if (lineComment != language.singleLineComments.end()) {
+                emit(i, n, TokenType::Comment);
+                break;
+            }
+
+            // Comentarios de bloque
+            auto blockComment = std::find_if(language.multiLineComments.begin(), language.multiLineComments.end(),
+                [&](const std::pair<std::string, std::string>& delimiters) {
+                    return !delimiters.first.empty() &&
+                           line.compare(i, delimiters.first.size(), delimiters.first) == 0;
+                });
+            if (blockComment != language.multiLineComments.end()) {
+                size_t endPos = line.find(blockComment->second, i + blockComment->first.size());
+                if (endPos == std::string::npos) {
+                    emit(i, n, TokenType::Comment);
+                    state.inBlockComment = true;
+                    state.blockCommentEnd = blockComment->second;
+                    break;
+                }
+                size_t end = endPos + blockComment->second.size();
+                emit(i, end, TokenType::Comment);
+                i = end;
+                continue;
+            }
+
+            // Strings (con escapes)
+            if (isStringDelimiter(static_cast<char>(c))) {
+                size_t j = i + 1;
+                while (j < n) {
+                    if (line[j] == '\\') {
+                        j += 2;
+                    } else if (line[j] == static_cast<char>(c)) {
+                        ++j;
+                        break;
+                    } else {
+                        ++j;
+                    }
+                }
+                j = std::min(j, n);
+                emit(i, j, TokenType::String);
+                i = j;
+                continue;
+            }
+
+            // Números
+            if (std::isdigit(c)) {
+                size_t j = i + 1;
+                while (j < n && (isIdentifierChar(static_cast<unsigned char>(line[j])) ||
+                                 line[j] == '.' || line[j] == '\'')) {
+                    ++j;
+                }
+                emit(i, j, TokenType::Number);
+                i = j;
+                continue;
+            }
+
+            // Identificadores y palabras reservadas
+            if (isIdentifierStart(c)) {
+                size_t j = i + 1;
+                while (j < n && isIdentifierChar(static_cast<unsigned char>(line[j]))) {
+                    ++j;
+                }
+                tokens.emplace_back(line.substr(i, j - i), TokenType::Identifier, i, j);
+                if (isKeyword(tokens.back().text)) {
+                    tokens.back().type = TokenType::Keyword;
+                }
+                i = j;
+                continue;
+            }
+
+            // Espacios
+            if (c == ' ' || c == '\t' || c == '\r') {
+                size_t j = i + 1;
+                while (j < n && (line[j] == ' ' || line[j] == '\t' || line[j] == '\r')) ++j;
+                emit(i, j, TokenType::Whitespace);
+                i = j;
+                continue;
+            }
+
+            // Operadores y delimitadores: un carácter por token
+            emit(i, i + 1, isOperator(static_cast<char>(c)) ? TokenType::Operator : TokenType::Unknown);
+            ++i;
+        }
+
+        return tokens;
+    }
+
+    TokenType SyntaxHighlighter::classifyToken(const std::string& token) const {
+        if (token.empty()) return TokenType::Unknown;
+
+        unsigned char first = static_cast<unsigned char>(token[0]);
+        if (isKeyword(token)) return TokenType::Keyword;
+        if (isNumber(token)) return TokenType::Number;
+        if (isStringDelimiter(token[0])) return TokenType::String;
+        if (std::isspace(first)) return TokenType::Whitespace;
+        if (isIdentifierStart(first)) return TokenType::Identifier;
+        if (token.size() == 1 && isOperator(token[0])) return TokenType::Operator;
+        return TokenType::Unknown;
+    }
+
+    bool SyntaxHighlighter::isStringDelimiter(char ch) const {
+        const auto& delimiters = currentLanguage_->stringDelimiters;
+        return std::find(delimiters.begin(), delimiters.end(), ch) != delimiters.end();
+    }
+
+    bool SyntaxHighlighter::isOperator(char ch) const {
+        const auto& operators = currentLanguage_->operators;
+        if (operators.empty()) {
+            return std::ispunct(static_cast<unsigned char>(ch)) != 0;
+        }
+        return std::find(operators.begin(), operators.end(), ch) != operators.end();
+    }
+
+    bool SyntaxHighlighter::isNumber(const std::string& token) const {
+        return !token.empty() && std::isdigit(static_cast<unsigned char>(token[0]));
+    }
+
+    // ========================================================================
+    // Inicialización
+    // ========================================================================
+
+    void SyntaxHighlighter::initializeLanguages() {
+        const std::vector<char> cOperators = {
+            '+', '-', '*', '/', '%', '=', '<', '>', '!', '&', '|', '^', '~', '?', ':',
+            ';', ',', '.', '(', ')', '[', ']', '{', '}', '#', '@', '\\'
+        };
+
+        LanguageDefinition plain("Plain Text");
+        plain.extensions = {"txt"};
+        addLanguageDefinition(plain);
+
+        LanguageDefinition cpp("C++");
+        cpp.extensions = {"c", "cc", "cpp", "cxx", "h", "hh", "hpp", "hxx"};
+        cpp.keywords = {
+            "if", "else", "for", "while", "do", "switch", "case", "default", "break", "continue",
+            "return", "class", "struct", "union", "enum", "public", "private", "protected", "virtual",
+            "override", "final", "int", "float", "double", "char", "bool", "void", "long", "short",
+            "unsigned", "signed", "const", "constexpr", "static", "inline", "extern", "volatile",
+            "mutable", "auto", "template", "typename", "namespace", "using", "typedef", "sizeof",
+            "new", "delete", "this", "true", "false", "nullptr", "try", "catch", "throw", "noexcept",
+            "operator", "friend", "explicit", "static_cast", "dynamic_cast", "reinterpret_cast",
+            "const_cast", "decltype", "concept", "requires", "co_await", "co_return", "co_yield"
+        };
+        cpp.singleLineComments = {"//"};
+        cpp.multiLineComments = {{"/*", "*/"}};
+        cpp.stringDelimiters = {'"', '\''};
+        cpp.operators = cOperators;
+        addLanguageDefinition(cpp);
+
+        LanguageDefinition java("Java");
+        java.extensions = {"java"};
+        java.keywords = {
+            "if", "else", "for", "while", "do", "switch", "case", "default", "break", "continue",
+            "return", "class", "interface", "enum", "extends", "implements", "package", "import",
+            "public", "private", "protected", "static", "final", "abstract", "synchronized",
+            "int", "float", "double", "char", "boolean", "void", "long", "short", "byte",
+            "new", "this", "super", "true", "false", "null", "try", "catch", "finally", "throw", "throws"
+        };
+        java.singleLineComments = {"//"};
+        java.multiLineComments = {{"/*", "*/"}};
+        java.stringDelimiters = {'"', '\''};
+        java.operators = cOperators;
+        addLanguageDefinition(java);
+
+        LanguageDefinition csharp("C#");
+        csharp.extensions = {"cs"};
+        csharp.keywords = {
+            "if", "else", "for", "foreach", "while", "do", "switch", "case", "default", "break",
+            "continue", "return", "class", "struct", "interface", "enum", "namespace", "using",
+            "public", "private", "protected", "internal", "static", "readonly", "override", "virtual",
+            "abstract", "sealed", "partial", "int", "float", "double", "char", "bool", "void", "string",
+            "var", "new", "this", "base", "true", "false", "null", "try", "catch", "finally", "throw"
+        };
+        csharp.singleLineComments = {"//"};
+        csharp.multiLineComments = {{"/*", "*/"}};
+        csharp.stringDelimiters = {'"', '\''};
+        csharp.operators = cOperators;
+        addLanguageDefinition(csharp);
+
+        LanguageDefinition javascript("JavaScript");
+        javascript.extensions = {"js", "jsx", "ts", "tsx", "mjs"};
+        javascript.keywords = {
+            "if", "else", "for", "while", "do", "switch", "case", "default", "break", "continue",
+            "return", "function", "class", "extends", "var", "let", "const", "new", "this", "typeof",
+            "instanceof", "import", "export", "from", "async", "await", "yield", "true", "false",
+            "null", "undefined", "try", "catch", "finally", "throw", "interface", "type"
+        };
+        javascript.singleLineComments = {"//"};
+        javascript.multiLineComments = {{"/*", "*/"}};
+        javascript.stringDelimiters = {'"', '\'', '`'};
+        javascript.operators = cOperators;
+        addLanguageDefinition(javascript);
+
+        LanguageDefinition python("Python");
+        python.extensions = {"py", "pyw"};
+        python.keywords = {
+            "if", "elif", "else", "for", "while", "break", "continue", "return", "def", "class",
+            "lambda", "import", "from", "as", "pass", "with", "yield", "try", "except", "finally",
+            "raise", "global", "nonlocal", "in", "is", "not", "and", "or", "self", "None", "True", "False"
+        };
+        python.singleLineComments = {"#"};
+        python.stringDelimiters = {'"', '\''};
+        python.operators = cOperators;
+        addLanguageDefinition(python);
+    }
+
+    void SyntaxHighlighter::initializeColorSchemes() {
+        colorScheme_.clear();
+    }
+
+    void SyntaxHighlighter::loadDefaultTheme() {
+        setTheme("dark");
+    }
+
+    // ========================================================================
+    // Búsqueda de lenguajes
+    // ========================================================================
+
+    const LanguageDefinition* SyntaxHighlighter::findLanguageByName(const std::string& name) const {
+        std::string wanted = toLower(name);
+        for (const auto& language : languages_) {
+            if (toLower(language->name) == wanted) {
+                return language.get();
+            }
+        }
+        // Alias habituales de línea de comandos (--language cpp)
+        if (wanted == "cpp" || wanted == "c") return findLanguageByName("C++");
+        if (wanted == "csharp") return findLanguageByName("C#");
+        if (wanted == "js" || wanted == "typescript") return findLanguageByName("JavaScript");
+        return nullptr;
+    }
+
+    const LanguageDefinition* SyntaxHighlighter::findLanguageByExtension(const std::string& extension) const {
+        std::string wanted = toLower(extension);
+        if (!wanted.empty() && wanted[0] == '.') {
+            wanted.erase(0, 1);
+        }
+        for (const auto& language : languages_) {
+            const auto& extensions = language->extensions;
+            if (std::find(extensions.begin(), extensions.end(), wanted) != extensions.end()) {
+                return language.get();
+            }
+        }
+        return nullptr;
+    }
+
+} // namespace CoralCode
@@ -0,0 +1,198 @@
+/**
+ * @file DistanceFieldAtlas.cpp
+ * @brief Campos de distancia de los glifos y su empaquetado
+ */
+
+#include "DistanceFieldAtlas.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace CoralCode {
+
+    namespace {
+
+        // "Infinito" de la transformada: finito para no operar con inf - inf
+        const float FAR_DISTANCE = 1e10f;
+
+        // Transformada de distancia 1D (Felzenszwalb y Huttenlocher):
+        // d[q] = min_p (q - p)² + f[p], con la envolvente inferior de las
+        // parábolas en v (vértices) y z (fronteras, n + 1 entradas)
+        void transformLine(const float* f, size_t n, float* d, size_t* v, float* z) {
+            auto intersection = [f](size_t q, size_t p) {
+                const float fq = f[q] + static_cast<float>(q * q);
+                const float fp = f[p] + static_cast<float>(p * p);
+                return (fq - fp) / (2.0f * static_cast<float>(q - p));
+            };
+
+            size_t k = 0;
+            v[0] = 0;
+            z[0] = -FAR_DISTANCE;
+            z[1] = FAR_DISTANCE;
+            for (size_t q = 1; q < n; ++q) {
+                float s = intersection(q, v[k]);
+                while (k > 0 && s <= z[k]) {
+                    --k;
+                    s = intersection(q, v[k]);
+                }
+                ++k;
+                v[k] = q;
+                z[k] = s;
+                z[k + 1] = FAR_DISTANCE;
+            }
+
+            k = 0;
+            for (size_t q = 0; q < n; ++q) {
+                while (z[k + 1] < static_cast<float>(q)) ++k;
+                const float delta = static_cast<float>(q) - static_cast<float>(v[k]);
+                d[q] = delta * delta + f[v[k]];
+            }
+        }
+
+    } // namespace
+
+    DistanceFieldAtlas::DistanceFieldAtlas() {
+        latin1_.fill(-1);
+    }
+
+    // ========================================================================
+    // Glifos
+    // ========================================================================
+
+    const DistanceFieldAtlas::Glyph* DistanceFieldAtlas::find(char32_t codepoint) const {
+        if (codepoint < latin1_.size()) {
+            const int32_t index = latin1_[codepoint];
+            return index >= 0 ? &glyphs_[static_cast<size_t>(index)] : nullptr;
+        }
+        auto it = others_.find(codepoint);
+        return it != others_.end() ? &glyphs_[it->second] : nullptr;
+    }
+
+    bool DistanceFieldAtlas::addGlyph(char32_t codepoint, const uint8_t* coverage, unsigned width, unsigned height,
+                                      size_t stride, float left, float top, float advance) {
+        if (find(codepoint)) return true;
+
+        Glyph glyph;
+        glyph.advance = advance;
+        if (coverage && width > 0 && height > 0) {
+            // El campo se extiende SPREAD píxeles alrededor del bitmap
+            const unsigned fieldWidth = width + 2 * SPREAD;
+            const unsigned fieldHeight = height + 2 * SPREAD;
+            if (!reserve(fieldWidth, fieldHeight, glyph.x, glyph.y)) return false;
+
+            // Distancia (al cuadrado) al píxel de dentro y al de fuera más cercanos
+            const size_t cells = size_t(fieldWidth) * fieldHeight;
+            inside_.assign(cells, FAR_DISTANCE);
+            outside_.assign(cells, 0.0f);
+            for (unsigned row = 0; row < height; ++row) {
+                const uint8_t* source = coverage + row * stride;
+                for (unsigned col = 0; col < width; ++col) {
+                    if (source[col] < 128) continue;
+                    const size_t cell = size_t(row + SPREAD) * fieldWidth + col + SPREAD;
+                    inside_[cell] = 0.0f;
+                    outside_[cell] = FAR_DISTANCE;
+                }
+            }
+            transform(inside_, fieldWidth, fieldHeight);
+            transform(outside_, fieldWidth, fieldHeight);
+
+            // El borde queda entre los centros de un píxel de dentro y uno de fuera
+            const float scale = 1.0f / (2.0f * static_cast<float>(SPREAD));
+            for (unsigned row = 0; row < fieldHeight; ++row) {
+                uint8_t* target = pixels_.data() + size_t(glyph.y + row) * WIDTH + glyph.x;
+                for (unsigned col = 0; col < fieldWidth; ++col) {
+                    const size_t cell = size_t(row) * fieldWidth + col;
+                    const float distance = outside_[cell] > 0.0f ? std::sqrt(outside_[cell]) - 0.5f
+                                                                 : 0.5f - std::sqrt(inside_[cell]);
+                    const float value = std::clamp(0.5f + distance * scale, 0.0f, 1.0f);
+                    target[col] = static_cast<uint8_t>(std::lround(value * 255.0f));
+                }
+            }
+
+            glyph.width = fieldWidth;
+            glyph.height = fieldHeight;
+            glyph.left = left - static_cast<float>(SPREAD);
+            glyph.top = top - static_cast<float>(SPREAD);
+            dirtyFirst_ = std::min(dirtyFirst_, glyph.y);
+            dirtyEnd_ = std::max(dirtyEnd_, glyph.y + fieldHeight);
+        }
+
+        const size_t index = glyphs_.size();
+        glyphs_.push_back(glyph);
+        if (codepoint < latin1_.size()) {
+            latin1_[codepoint] = static_cast<int32_t>(index);
+        } else {
+            others_.emplace(codepoint, index);
+        }
+        return true;
+    }
+
+    bool DistanceFieldAtlas::takeDirtyRows(unsigned& firstRow, unsigned& rowCount) {
+        if (dirtyEnd_ <= dirtyFirst_) return false;
+        firstRow = dirtyFirst_;
+        rowCount = dirtyEnd_ - dirtyFirst_;
+        dirtyFirst_ = height_;
+        dirtyEnd_ = 0;
+        return true;
+    }
+
+    size_t DistanceFieldAtlas::getMemoryUsage() const {
+        return pixels_.capacity() + glyphs_.capacity() * sizeof(Glyph) +
+               others_.size() * (sizeof(std::pair<const char32_t, size_t>) + sizeof(void*)) +
+               (inside_.capacity() + outside_.capacity() + line_.capacity() + lineOut_.capacity() +
+                bounds_.capacity()) * sizeof(float) +
+               hull_.capacity() * sizeof(size_t);
+    }
+
+    // ========================================================================
+    // Empaquetado y transformada
+    // ========================================================================
+
+    bool DistanceFieldAtlas::reserve(unsigned width, unsigned height, unsigned& x, unsigned& y) {
+        // Un píxel libre entre campos para que el filtrado no mezcle vecinos
+        if (width + 1 > WIDTH) return false;
+        if (shelfX_ + width + 1 > WIDTH) {
+            shelfY_ += shelfHeight_;
+            shelfX_ = 0;
+            shelfHeight_ = 0;
+        }
+
+        const unsigned bottom = shelfY_ + height + 1;
+        if (bottom > height_) {
+            unsigned grown = std::max(height_, 64u);
+            while (grown < bottom) grown *= 2;
+            if (grown > MAX_HEIGHT) return false;
+            // La imagen cambia de tamaño: hay que volver a subirla entera
+            pixels_.resize(size_t(WIDTH) * grown, 0);
+            height_ = grown;
+            dirtyFirst_ = 0;
+            dirtyEnd_ = height_;
+        }
+
+        x = shelfX_;
+        y = shelfY_;
+        shelfX_ += width + 1;
+        shelfHeight_ = std::max(shelfHeight_, height + 1);
+        return true;
+    }
+
+    void DistanceFieldAtlas::transform(std::vector<float>& grid, unsigned width, unsigned height) {
+        // Separable: primero columnas, después filas
+        const size_t longest = std::max(width, height);
+        line_.resize(longest);
+        lineOut_.resize(longest);
+        hull_.resize(longest);
+        bounds_.resize(longest + 1);
+
+        for (unsigned col = 0; col < width; ++col) {
+            for (unsigned row = 0; row < height; ++row) line_[row] = grid[size_t(row) * width + col];
+            transformLine(line_.data(), height, lineOut_.data(), hull_.data(), bounds_.data());
+            for (unsigned row = 0; row < height; ++row) grid[size_t(row) * width + col] = lineOut_[row];
+        }
+        for (unsigned row = 0; row < height; ++row) {
+            float* cells = grid.data() + size_t(row) * width;
+            std::copy(cells, cells + width, line_.begin());
+            transformLine(line_.data(), width, cells, hull_.data(), bounds_.data());
+        }
+    }
+
+} // namespace CoralCode
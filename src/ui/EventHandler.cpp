@@ -0,0 +1,77 @@
+/**
+ * @file EventHandler.cpp
+ * @brief Gestión de eventos de entrada: grabación de sesiones (EditTrace)
+ */
+
+#include "EventHandler.hpp"
+#include <SFML/Window/Clipboard.hpp>
+
+namespace CoralCode {
+
+    // ========================================================================
+    // Grabación de sesiones
+    // ========================================================================
+
+    void EventHandler::setTraceRecorder(EditTraceRecorder* recorder) {
+        traceRecorder_ = recorder;
+    }
+
+    TraceKey EventHandler::toTraceKey(sf::Keyboard::Key key) {
+        switch (key) {
+            case sf::Keyboard::Key::Left: return TraceKey::Left;
+            case sf::Keyboard::Key::Right: return TraceKey::Right;
+            case sf::Keyboard::Key::Up: return TraceKey::Up;
+            case sf::Keyboard::Key::Down: return TraceKey::Down;
+            case sf::Keyboard::Key::Home: return TraceKey::Home;
+            case sf::Keyboard::Key::End: return TraceKey::End;
+            case sf::Keyboard::Key::PageUp: return TraceKey::PageUp;
+            case sf::Keyboard::Key::PageDown: return TraceKey::PageDown;
+            case sf::Keyboard::Key::Backspace: return TraceKey::Backspace;
+            case sf::Keyboard::Key::Delete: return TraceKey::Delete;
+            case sf::Keyboard::Key::Enter: return TraceKey::Enter;
+            case sf::Keyboard::Key::Tab: return TraceKey::Tab;
+            case sf::Keyboard::Key::Escape: return TraceKey::Escape;
+            case sf::Keyboard::Key::A: return TraceKey::A;
+            case sf::Keyboard::Key::C: return TraceKey::C;
+            case sf::Keyboard::Key::D: return TraceKey::D;
+            case sf::Keyboard::Key::F: return TraceKey::F;
+            case sf::Keyboard::Key::S: return TraceKey::S;
+            case sf::Keyboard::Key::V: return TraceKey::V;
+            case sf::Keyboard::Key::X: return TraceKey::X;
+            case sf::Keyboard::Key::Y: return TraceKey::Y;
+            case sf::Keyboard::Key::Z: return TraceKey::Z;
+            default: return TraceKey::Unknown;
+        }
+    }
+
+    void EventHandler::recordKey(const KeyInfo& keyInfo) {
+        if (!traceRecorder_ || !traceRecorder_->isRecording()) return;
+
+        const TraceKey key = toTraceKey(keyInfo.key);
+        if (key == TraceKey::Unknown) return;   // Modificadores sueltos, F1...
+
+        // Pegar depende del portapapeles del sistema: se graba su contenido
+        if (key == TraceKey::V && (keyInfo.ctrl || keyInfo.system)) {
+            traceRecorder_->recordPaste(sf::Clipboard::getString().toAnsiString());
+            return;
+        }
+
+        uint8_t modifiers = 0;
+        if (keyInfo.ctrl) modifiers |= TRACE_CTRL;
+        if (keyInfo.shift) modifiers |= TRACE_SHIFT;
+        if (keyInfo.alt) modifiers |= TRACE_ALT;
+        if (keyInfo.system) modifiers |= TRACE_SYSTEM;
+        traceRecorder_->recordKey(key, modifiers);
+    }
+
+    void EventHandler::recordText(uint32_t codepoint) {
+        if (traceRecorder_) traceRecorder_->recordText(codepoint);
+    }
+
+    void EventHandler::recordMouse(TraceEventType type, const MouseInfo& mouseInfo) {
+        if (!traceRecorder_) return;
+        const uint8_t button = mouseInfo.button == sf::Mouse::Left ? 0 : 1;
+        traceRecorder_->recordMouse(type, mouseInfo.x, mouseInfo.y, button);
+    }
+
+} // namespace CoralCode
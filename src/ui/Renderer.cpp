@@ -0,0 +1,168 @@
+/**
+ * @file Renderer.cpp
+ * @brief Estadísticas comunes de dibujo y backend nulo
+ */
+
+#include "Renderer.hpp"
+#include <algorithm>
+
+namespace CoralCode {
+
+    namespace {
+
+        // Caracteres que generan un quad: todos menos los blancos y los
+        // bytes de continuación UTF-8
+        size_t countGlyphs(const char* text, size_t length) {
+            size_t glyphs = 0;
+            for (size_t i = 0; i < length; ++i) {
+                const unsigned char c = static_cast<unsigned char>(text[i]);
+                if ((c & 0xC0) == 0x80 || c == ' ' || c == '\t' || c == '\n' || c == '\r') continue;
+                ++glyphs;
+            }
+            return glyphs;
+        }
+
+    } // namespace
+
+    RenderStats& RenderStats::operator+=(const RenderStats& other) {
+        drawCalls += other.drawCalls;
+        quads += other.quads;
+        glyphs += other.glyphs;
+        textRuns += other.textRuns;
+        images += other.images;
+        stateChanges += other.stateChanges;
+        uploadedBytes += other.uploadedBytes;
+        return *this;
+    }
+
+    // ========================================================================
+    // Renderer
+    // ========================================================================
+
+    void Renderer::beginFrame(unsigned width, unsigned height, RenderColor background) {
+        currentStats_ = RenderStats{};
+        binding_ = Binding::None;
+        onBeginFrame(width, height, background);
+    }
+
+    void Renderer::endFrame() {
+        onEndFrame();
+        frameStats_ = currentStats_;
+        totalStats_ += currentStats_;
+        ++frameCount_;
+    }
+
+    void Renderer::bind(Binding binding, uint32_t key) {
+        if (binding == binding_ && key == bindingKey_) return;
+        binding_ = binding;
+        bindingKey_ = key;
+        ++currentStats_.stateChanges;
+    }
+
+    void Renderer::fillRect(const RenderRect& rect, RenderColor color) {
+        if (rect.width <= 0.0f || rect.height <= 0.0f) return;
+        bind(Binding::Solid, 0);
+        ++currentStats_.drawCalls;
+        ++currentStats_.quads;
+        onFillRect(rect, color);
+    }
+
+    void Renderer::drawText(const char* text, size_t length, float x, float y, unsigned size, RenderColor color) {
+        const size_t glyphs = countGlyphs(text, length);
+        if (glyphs == 0) return;
+        bind(Binding::Font, singleFontAtlas_ ? 0 : size);
+        ++currentStats_.drawCalls;
+        ++currentStats_.textRuns;
+        currentStats_.glyphs += glyphs;
+        currentStats_.quads += glyphs;
+        onDrawText(text, length, x, y, size, color);
+    }
+
+    ImageId Renderer::createImage(unsigned width, unsigned height, bool smooth) {
+        imageWidths_.push_back(width);
+        const ImageId image = static_cast<ImageId>(imageWidths_.size());
+        onCreateImage(image, width, height, smooth);
+        return image;
+    }
+
+    void Renderer::updateImage(ImageId image, const uint8_t* pixels, unsigned firstRow, unsigned rowCount) {
+        if (image == 0 || image > imageWidths_.size() || rowCount == 0) return;
+        currentStats_.uploadedBytes += size_t(getImageWidth(image)) * rowCount * 4;
+        onUpdateImage(image, pixels, firstRow, rowCount);
+    }
+
+    void Renderer::drawImage(ImageId image, unsigned rows, const RenderRect& destination) {
+        if (image == 0 || image > imageWidths_.size() || rows == 0) return;
+        bind(Binding::Image, image);
+        ++currentStats_.drawCalls;
+        ++currentStats_.images;
+        ++currentStats_.quads;
+        onDrawImage(image, rows, destination);
+    }
+
+    unsigned Renderer::getImageWidth(ImageId image) const {
+        return image > 0 && image <= imageWidths_.size() ? imageWidths_[image - 1] : 0;
+    }
+
+    // ========================================================================
+    // NullRenderer
+    // ========================================================================
+
+    void NullRenderer::onBeginFrame(unsigned, unsigned, RenderColor) {
+        commands_.clear();
+        text_.clear();
+    }
+
+    void NullRenderer::onFillRect(const RenderRect& rect, RenderColor color) {
+        if (!recording_) return;
+        Command command{CommandType::Rect, rect, color};
+        commands_.push_back(command);
+    }
+
+    void NullRenderer::onDrawText(const char* text, size_t length, float x, float y, unsigned size,
+                                  RenderColor color) {
+        if (!recording_) return;
+        Command command{CommandType::Text, RenderRect{x, y, 0.0f, 0.0f}, color};
+        command.size = size;
+        command.textOffset = text_.size();
+        command.textLength = length;
+        text_.append(text, length);
+        commands_.push_back(command);
+    }
+
+    void NullRenderer::onCreateImage(ImageId, unsigned, unsigned, bool) {}
+
+    void NullRenderer::onUpdateImage(ImageId, const uint8_t*, unsigned, unsigned) {}
+
+    void NullRenderer::onDrawImage(ImageId image, unsigned rows, const RenderRect& destination) {
+        if (!recording_) return;
+        Command command{CommandType::Image, destination, RenderColor{}};
+        command.size = rows;
+        command.image = image;
+        commands_.push_back(command);
+    }
+
+    std::string NullRenderer::getText(const Command& command) const {
+        if (command.type != CommandType::Text) return {};
+        return text_.substr(command.textOffset, command.textLength);
+    }
+
+    RenderRect NullRenderer::measureText(const std::string& text, unsigned size) const {
+        // Columnas de la línea más larga por el avance fijo, filas por el tamaño
+        size_t lines = 1;
+        size_t columns = 0;
+        size_t widest = 0;
+        for (char c : text) {
+            if (c == '\n') {
+                ++lines;
+                columns = 0;
+                continue;
+            }
+            if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) widest = std::max(widest, ++columns);
+        }
+        const float advance = ADVANCE_RATIO * static_cast<float>(size);
+        return RenderRect{0.0f, 0.0f, static_cast<float>(widest) * advance,
+                          static_cast<float>(lines * size)};
+    }
+
+} // namespace CoralCode
@@ -0,0 +1,358 @@
+/**
+ * @file SfmlRenderer.cpp
+ * @brief Backend de dibujo sobre SFML
+ */
+
+#include "SfmlRenderer.hpp"
+#include "AllocationTracker.hpp"
+#include "FrameProfiler.hpp"
+#include "TextLayout.hpp"
+#include <algorithm>
+
+namespace CoralCode {
+
+    namespace {
+
+        sf::Color toSfColor(RenderColor color) {
+            return sf::Color(color.r, color.g, color.b, color.a);
+        }
+
+        // Umbral en 0.5 del campo, suavizado en lo que ocupa un píxel de
+        // pantalla (fwidth sigue al tamaño con que se dibuje el glifo)
+        const char* const DISTANCE_FIELD_SHADER = R"(
+            uniform sampler2D texture;
+            void main() {
+                float distance = texture2D(texture, gl_TexCoord[0].xy).a;
+                float width = max(fwidth(distance) * 0.7, 0.001);
+                float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+                gl_FragColor = vec4(gl_Color.rgb, gl_Color.a * alpha);
+            }
+        )";
+
+        // Anchura de una tabulación dentro de un texto, como sf::Text
+        const float TAB_SPACES = 4.0f;
+
+    } // namespace
+
+    SfmlRenderer::SfmlRenderer(sf::RenderTarget& target, const sf::Font* font, FrameProfiler* profiler,
+                               bool distanceField)
+        : target_(target), font_(font), profiler_(profiler), glyphVertices_(sf::PrimitiveType::Triangles) {
+        if (!font_) return;
+        text_ = std::make_unique<sf::Text>(*font_, "", 16);
+
+        // Sin shaders (o si no compila) quedan los bitmaps de cada tamaño
+        if (!distanceField || !sf::Shader::isAvailable() ||
+            !distanceShader_.loadFromMemory(DISTANCE_FIELD_SHADER, sf::Shader::Type::Fragment)) {
+            return;
+        }
+        distanceShader_.setUniform("texture", sf::Shader::CurrentTexture);
+        atlas_ = std::make_unique<DistanceFieldAtlas>();
+        atlas_->setLineSpacing(font_->getLineSpacing(DistanceFieldAtlas::BASE_SIZE));
+
+        // Latin-1 imprimible de una vez (una sola copia de la página de
+        // SFML); el resto de caracteres, la primera vez que se dibujen
+        for (char32_t codepoint = 32; codepoint < 256; ++codepoint) {
+            if (codepoint < 127 || codepoint >= 160) missingGlyphs_.push_back(codepoint);
+        }
+        distanceField_ = addMissingGlyphs();
+        setSingleFontAtlas(distanceField_);
+        if (!distanceField_) atlas_.reset();
+    }
+
+    SfmlRenderer::~SfmlRenderer() = default;
+
+    // ========================================================================
+    // Frame y primitivas
+    // ========================================================================
+
+    void SfmlRenderer::onBeginFrame(unsigned, unsigned, RenderColor background) {
+        glyphVertices_.clear();
+        target_.clear(toSfColor(background));
+    }
+
+    void SfmlRenderer::onEndFrame() {
+        flushGlyphs();
+    }
+
+    void SfmlRenderer::onFillRect(const RenderRect& rect, RenderColor color) {
+        flushGlyphs();
+        rect_.setSize(sf::Vector2f(rect.width, rect.height));
+        rect_.setPosition(sf::Vector2f(rect.x, rect.y));
+        rect_.setFillColor(toSfColor(color));
+        draw(rect_);
+    }
+
+    void SfmlRenderer::onDrawText(const char* text, size_t length, float x, float y, unsigned size,
+                                  RenderColor color) {
+        if (!text_) return;
+        if (distanceField_) {
+            appendGlyphs(text, length, x, y, size, toSfColor(color));
+            return;
+        }
+
+        // Cada tamaño nuevo rasteriza sus glifos en otra página de la fuente
+        if (std::find(bitmapSizes_.begin(), bitmapSizes_.end(), size) == bitmapSizes_.end()) {
+            bitmapSizes_.push_back(size);
+        }
+        scratch_.assign(text, length);
+        text_->setString(scratch_);
+        text_->setCharacterSize(size);
+        text_->setPosition(sf::Vector2f(x, y));
+        text_->setFillColor(toSfColor(color));
+        draw(*text_);
+    }
+
+    RenderRect SfmlRenderer::measureText(const std::string& text, unsigned size) const {
+        if (!font_) return RenderRect{};
+        if (!distanceField_) {
+            const sf::Text measured(*font_, text, size);
+            const sf::FloatRect bounds = measured.getLocalBounds();
+            return RenderRect{bounds.position.x, bounds.position.y, bounds.size.x, bounds.size.y};
+        }
+
+        // Con los mismos avances que appendGlyphs
+        const float lineSpacing = atlas_->getLineSpacing() * static_cast<float>(size) /
+                                  static_cast<float>(DistanceFieldAtlas::BASE_SIZE);
+        float pen = 0.0f;
+        float widest = 0.0f;
+        size_t lines = 1;
+        size_t i = 0;
+        while (i < text.size()) {
+            char32_t codepoint;
+            i += decodeUtf8(text.data(), text.size(), i, codepoint);
+            if (codepoint == U'\n') {
+                ++lines;
+                pen = 0.0f;
+                continue;
+            }
+            pen += codepoint == U'\t' ? TAB_SPACES * getGlyphAdvance(U' ', size) : getGlyphAdvance(codepoint, size);
+            widest = std::max(widest, pen);
+        }
+        return RenderRect{0.0f, 0.0f, widest, static_cast<float>(lines - 1) * lineSpacing + static_cast<float>(size)};
+    }
+
+    float SfmlRenderer::getGlyphAdvance(char32_t codepoint, unsigned size) const {
+        if (!font_) return 0.0f;
+        if (!distanceField_) return font_->getGlyph(codepoint, size, false).advance;
+
+        // El avance a BASE_SIZE escalado: el mismo para el layout y el dibujo
+        const DistanceFieldAtlas::Glyph* glyph = atlas_->find(codepoint);
+        const float advance = glyph ? glyph->advance
+                                    : font_->getGlyph(codepoint, DistanceFieldAtlas::BASE_SIZE, false).advance;
+        return advance * static_cast<float>(size) / static_cast<float>(DistanceFieldAtlas::BASE_SIZE);
+    }
+
+    // ========================================================================
+    // Campos de distancia
+    // ========================================================================
+
+    const DistanceFieldAtlas::Glyph* SfmlRenderer::findGlyph(char32_t codepoint) {
+        const DistanceFieldAtlas::Glyph* glyph = atlas_->find(codepoint);
+        if (glyph || atlasFull_) return glyph;
+
+        // Primera vez que aparece: se genera su campo una sola vez
+        missingGlyphs_.push_back(codepoint);
+        if (!addMissingGlyphs()) atlasFull_ = true;
+        return atlas_->find(codepoint);
+    }
+
+    bool SfmlRenderer::addMissingGlyphs() {
+        const unsigned size = DistanceFieldAtlas::BASE_SIZE;
+
+        // Rasterizar todos antes de copiar la página: cargar un glifo puede
+        // hacerla crecer y mover a los demás
+        for (char32_t codepoint : missingGlyphs_) {
+            font_->getGlyph(codepoint, size, false);
+        }
+        const sf::Image page = font_->getTexture(size).copyToImage();
+        const sf::Vector2u pageSize = page.getSize();
+        const uint8_t* pixels = page.getPixelsPtr();
+
+        bool added = true;
+        for (char32_t codepoint : missingGlyphs_) {
+            const sf::Glyph& glyph = font_->getGlyph(codepoint, size, false);
+            const sf::IntRect& rect = glyph.textureRect;
+            const bool inPage = rect.position.x >= 0 && rect.position.y >= 0 && rect.size.x > 0 && rect.size.y > 0 &&
+                                static_cast<unsigned>(rect.position.x + rect.size.x) <= pageSize.x &&
+                                static_cast<unsigned>(rect.position.y + rect.size.y) <= pageSize.y;
+            const unsigned width = inPage ? static_cast<unsigned>(rect.size.x) : 0;
+            const unsigned height = inPage ? static_cast<unsigned>(rect.size.y) : 0;
+
+            // SFML guarda la cobertura en el alfa de una página RGBA
+            coverage_.resize(size_t(width) * height);
+            for (unsigned row = 0; row < height; ++row) {
+                const size_t first = (size_t(static_cast<unsigned>(rect.position.y) + row) * pageSize.x +
+                                      static_cast<unsigned>(rect.position.x)) * 4;
+                for (unsigned col = 0; col < width; ++col) {
+                    coverage_[size_t(row) * width + col] = pixels[first + size_t(col) * 4 + 3];
+                }
+            }
+            added = atlas_->addGlyph(codepoint, coverage_.data(), width, height, width, glyph.bounds.position.x,
+                                     glyph.bounds.position.y, glyph.advance) && added;
+        }
+        missingGlyphs_.clear();
+        uploadAtlas();
+        return added;
+    }
+
+    void SfmlRenderer::uploadAtlas() {
+        unsigned firstRow = 0;
+        unsigned rowCount = 0;
+        if (!atlas_->takeDirtyRows(firstRow, rowCount)) return;
+
+        const unsigned width = atlas_->getWidth();
+        if (atlasTexture_.getSize().y != atlas_->getHeight()) {
+            // Creció: textura nueva con el atlas entero
+            static_cast<void>(atlasTexture_.resize(sf::Vector2u(width, atlas_->getHeight())));
+            atlasTexture_.setSmooth(true);
+            firstRow = 0;
+            rowCount = atlas_->getHeight();
+        }
+
+        // Blanco con la distancia en el alfa: el color lo pone cada vértice
+        const uint8_t* field = atlas_->getPixels().data() + size_t(firstRow) * width;
+        std::vector<uint8_t> rgba(size_t(width) * rowCount * 4, 255);
+        for (size_t i = 0; i < size_t(width) * rowCount; ++i) {
+            rgba[i * 4 + 3] = field[i];
+        }
+        atlasTexture_.update(rgba.data(), sf::Vector2u(width, rowCount), sf::Vector2u(0, firstRow));
+    }
+
+    void SfmlRenderer::appendGlyphs(const char* text, size_t length, float x, float y, unsigned size,
+                                    sf::Color color) {
+        // Como sf::Text: la primera línea base queda size píxeles por debajo de y
+        const float scale = static_cast<float>(size) / static_cast<float>(DistanceFieldAtlas::BASE_SIZE);
+        float pen = x;
+        float baseline = y + static_cast<float>(size);
+
+        size_t i = 0;
+        while (i < length) {
+            char32_t codepoint;
+            i += decodeUtf8(text, length, i, codepoint);
+            if (codepoint == U'\n') {
+                pen = x;
+                baseline += atlas_->getLineSpacing() * scale;
+                continue;
+            }
+            if (codepoint == U'\t') {
+                const DistanceFieldAtlas::Glyph* space = findGlyph(U' ');
+                pen += space ? TAB_SPACES * space->advance * scale : 0.0f;
+                continue;
+            }
+
+            const DistanceFieldAtlas::Glyph* glyph = findGlyph(codepoint);
+            if (!glyph) continue;
+            if (glyph->width > 0) {
+                const float left = pen + glyph->left * scale;
+                const float top = baseline + glyph->top * scale;
+                const float right = left + static_cast<float>(glyph->width) * scale;
+                const float bottom = top + static_cast<float>(glyph->height) * scale;
+                const float u0 = static_cast<float>(glyph->x);
+                const float v0 = static_cast<float>(glyph->y);
+                const float u1 = u0 + static_cast<float>(glyph->width);
+                const float v1 = v0 + static_cast<float>(glyph->height);
+
+                glyphVertices_.append(sf::Vertex{sf::Vector2f(left, top), color, sf::Vector2f(u0, v0)});
+                glyphVertices_.append(sf::Vertex{sf::Vector2f(right, top), color, sf::Vector2f(u1, v0)});
+                glyphVertices_.append(sf::Vertex{sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1)});
+                glyphVertices_.append(sf::Vertex{sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1)});
+                glyphVertices_.append(sf::Vertex{sf::Vector2f(right, top), color, sf::Vector2f(u1, v0)});
+                glyphVertices_.append(sf::Vertex{sf::Vector2f(right, bottom), color, sf::Vector2f(u1, v1)});
+            }
+            pen += glyph->advance * scale;
+        }
+    }
+
+    void SfmlRenderer::flushGlyphs() {
+        if (glyphVertices_.getVertexCount() == 0) return;
+        sf::RenderStates states;
+        states.texture = &atlasTexture_;
+        states.shader = &distanceShader_;
+        draw(glyphVertices_, states);
+        glyphVertices_.clear();
+    }
+
+    // ========================================================================
+    // Imágenes
+    // ========================================================================
+
+    void SfmlRenderer::onCreateImage(ImageId image, unsigned width, unsigned height, bool smooth) {
+        auto created = std::make_unique<Image>();
+        // Si no se puede crear queda de tamaño 0: se cuenta pero no se ve
+        static_cast<void>(created->texture.resize(sf::Vector2u(width, height)));
+        created->texture.setSmooth(smooth);
+        created->sprite = std::make_unique<sf::Sprite>(created->texture);
+        if (images_.size() < image) images_.resize(image);
+        images_[image - 1] = std::move(created);
+    }
+
+    void SfmlRenderer::onUpdateImage(ImageId image, const uint8_t* pixels, unsigned firstRow, unsigned rowCount) {
+        Image& target = *images_[image - 1];
+        const sf::Vector2u size = target.texture.getSize();
+        if (firstRow >= size.y) return;
+        rowCount = std::min(rowCount, size.y - firstRow);
+        target.texture.update(pixels, sf::Vector2u(size.x, rowCount), sf::Vector2u(0, firstRow));
+    }
+
+    void SfmlRenderer::onDrawImage(ImageId image, unsigned rows, const RenderRect& destination) {
+        flushGlyphs();
+        Image& source = *images_[image - 1];
+        const sf::Vector2u size = source.texture.getSize();
+        rows = std::min(rows, size.y);
+        if (size.x == 0 || rows == 0) return;
+
+        source.sprite->setTextureRect(sf::IntRect(sf::Vector2i(0, 0),
+                                                  sf::Vector2i(static_cast<int>(size.x), static_cast<int>(rows))));
+        source.sprite->setPosition(sf::Vector2f(destination.x, destination.y));
+        source.sprite->setScale(sf::Vector2f(destination.width / static_cast<float>(size.x),
+                                             destination.height / static_cast<float>(rows)));
+        draw(*source.sprite);
+    }
+
+    size_t SfmlRenderer::getImageMemory() const {
+        size_t bytes = 0;
+        for (const auto& image : images_) {
+            if (!image) continue;
+            const sf::Vector2u size = image->texture.getSize();
+            bytes += size_t(size.x) * size.y * 4;
+        }
+        return bytes;
+    }
+
+    size_t SfmlRenderer::getGlyphAtlasMemory() const {
+        if (!font_) return 0;
+        auto pageBytes = [this](unsigned size) {
+            const sf::Vector2u page = font_->getTexture(size).getSize();
+            return size_t(page.x) * page.y * 4;
+        };
+        if (!distanceField_) {
+            size_t bytes = 0;
+            for (unsigned size : bitmapSizes_) bytes += pageBytes(size);
+            return bytes;
+        }
+        // La página de SFML de la que salen los campos también sigue viva
+        const sf::Vector2u atlas = atlasTexture_.getSize();
+        return size_t(atlas.x) * atlas.y * 4 + atlas_->getMemoryUsage() + coverage_.capacity() +
+               pageBytes(DistanceFieldAtlas::BASE_SIZE);
+    }
+
+    // ========================================================================
+    // Perfilado
+    // ========================================================================
+
+    void SfmlRenderer::draw(const sf::Drawable& drawable, const sf::RenderStates& states) {
+        // Cada draw cuenta como llamada y su tiempo sale de Layout
+        AllocationTracker::Scope allocationSite(AllocationSite::Draw);
+        if (!profiler_ || !profiler_->isEnabled()) {
+            target_.draw(drawable, states);
+            return;
+        }
+        profiler_->endPhase(FramePhase::Layout);
+        profiler_->beginPhase(FramePhase::Draw);
+        target_.draw(drawable, states);
+        profiler_->endPhase(FramePhase::Draw);
+        profiler_->countDrawCall();
+        profiler_->beginPhase(FramePhase::Layout);
+    }
+
+} // namespace CoralCode
@@ -0,0 +1,162 @@
+/**
+ * @file AllocationTracker.cpp
+ * @brief Operator new global con recuento por sitio
+ */
+
+#include "AllocationTracker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace CoralCode {
+
+    namespace {
+
+        // Sin usuarios activos, operator new no cuenta
+        std::atomic<int> g_activeUsers{0};
+        std::array<std::atomic<uint64_t>, AllocationTracker::SITE_COUNT> g_counts{};
+        std::array<std::atomic<uint64_t>, AllocationTracker::SITE_COUNT> g_bytes{};
+
+        thread_local AllocationSite tSite = AllocationSite::Unattributed;
+
+        constexpr const char* SITE_NAMES[AllocationTracker::SITE_COUNT] = {
+            "Sin atribuir", "Entrada", "Ediciones", "Historial undo", "Resaltado",
+            "Barra de estado", "Snapshot", "Layout", "Draw", "display()"
+        };
+
+    } // namespace
+
+    // ========================================================================
+    // AllocationCounts
+    // ========================================================================
+
+    uint64_t AllocationCounts::total() const {
+        uint64_t sum = 0;
+        for (uint64_t value : count) sum += value;
+        return sum;
+    }
+
+    uint64_t AllocationCounts::totalBytes() const {
+        uint64_t sum = 0;
+        for (uint64_t value : bytes) sum += value;
+        return sum;
+    }
+
+    AllocationCounts AllocationCounts::operator-(const AllocationCounts& earlier) const {
+        AllocationCounts difference;
+        for (size_t i = 0; i < SITE_COUNT; ++i) {
+            difference.count[i] = count[i] - earlier.count[i];
+            difference.bytes[i] = bytes[i] - earlier.bytes[i];
+        }
+        return difference;
+    }
+
+    std::string AllocationCounts::formatReport() const {
+        std::array<size_t, SITE_COUNT> order;
+        for (size_t i = 0; i < SITE_COUNT; ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return count[a] > count[b]; });
+
+        std::string report;
+        char row[128];
+        for (size_t index : order) {
+            if (count[index] == 0) break;
+            std::snprintf(row, sizeof(row), "  %-18s %10llu asignaciones %12llu bytes\n", SITE_NAMES[index],
+                          static_cast<unsigned long long>(count[index]),
+                          static_cast<unsigned long long>(bytes[index]));
+            report += row;
+        }
+        std::snprintf(row, sizeof(row), "  %-18s %10llu asignaciones %12llu bytes\n", "total",
+                      static_cast<unsigned long long>(total()), static_cast<unsigned long long>(totalBytes()));
+        report += row;
+        return report;
+    }
+
+    // ========================================================================
+    // AllocationTracker
+    // ========================================================================
+
+    void AllocationTracker::retain() {
+        g_activeUsers.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void AllocationTracker::release() {
+        g_activeUsers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    bool AllocationTracker::isActive() {
+        return g_activeUsers.load(std::memory_order_relaxed) > 0;
+    }
+
+    AllocationCounts AllocationTracker::snapshot() {
+        AllocationCounts counts;
+        for (size_t i = 0; i < SITE_COUNT; ++i) {
+            counts.count[i] = g_counts[i].load(std::memory_order_relaxed);
+            counts.bytes[i] = g_bytes[i].load(std::memory_order_relaxed);
+        }
+        return counts;
+    }
+
+    uint64_t AllocationTracker::totalCount() {
+        uint64_t sum = 0;
+        for (const auto& value : g_counts) sum += value.load(std::memory_order_relaxed);
+        return sum;
+    }
+
+    AllocationSite AllocationTracker::currentSite() {
+        return tSite;
+    }
+
+    void AllocationTracker::setSite(AllocationSite site) {
+        tSite = site;
+    }
+
+    const char* AllocationTracker::siteName(AllocationSite site) {
+        const size_t index = static_cast<size_t>(site);
+        return index < SITE_COUNT ? SITE_NAMES[index] : "?";
+    }
+
+} // namespace CoralCode
+
+// ============================================================================
+// Operator new global
+// ============================================================================
+//
+// Las formas de array y las de borrado estándar delegan en estas. Inactivo
+// solo cuesta una lectura.
+
+void* operator new(std::size_t size) {
+    if (CoralCode::g_activeUsers.load(std::memory_order_relaxed) > 0) {
+        const size_t site = static_cast<size_t>(CoralCode::tSite);
+        CoralCode::g_counts[site].fetch_add(1, std::memory_order_relaxed);
+        CoralCode::g_bytes[site].fetch_add(size, std::memory_order_relaxed);
+    }
+    if (size == 0) size = 1;
+    while (true) {
+        if (void* memory = std::malloc(size)) return memory;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return ::operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
@@ -0,0 +1,759 @@
+/**
+ * @file AsyncFileIO.cpp
+ * @brief E/S de archivos asíncrona: io_uring en Linux, hilos de E/S en el resto
+ */
+
+#include "AsyncFileIO.hpp"
+#include "LatencyTracer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+    #include <filesystem>
+    #include <fstream>
+    #include <process.h>
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#ifdef __linux__
+    #include <linux/io_uring.h>
+    #include <sys/eventfd.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+#endif
+
+namespace CoralCode {
+
+    /**
+     * @brief Una lectura o escritura en curso (máquina de estados)
+     */
+    struct AsyncFileIO::Request {
+        enum class Step { StatTarget, Open, Stat, Read, Write, Sync, Close, Rename };
+
+        bool isWrite = false;
+        Step step = Step::Open;
+        std::string path;
+        std::string temporary;      // Escritura atómica: se renombra al final
+        std::string content;        // Leído o por escribir
+        uint64_t maxSize = 0;
+        size_t done = 0;
+        int fd = -1;
+        unsigned mode = 0666;
+        std::string error;
+        uint64_t submittedAt = 0;   // Solo con la traza de latencia activa
+
+        std::promise<FileReadResult> readPromise;
+        std::promise<FileWriteResult> writePromise;
+
+#ifdef __linux__
+        struct statx info {};
+#endif
+
+        void complete() {
+            if (submittedAt != 0) {
+                LatencyTracer& tracer = LatencyTracer::shared();
+                tracer.asyncSpan("background", isWrite ? "file-write" : "file-read", tracer.newId(), submittedAt,
+                                 LatencyTracer::now());
+            }
+            if (isWrite) {
+                FileWriteResult result;
+                result.success = error.empty();
+                result.error = std::move(error);
+                writePromise.set_value(std::move(result));
+            } else {
+                FileReadResult result;
+                result.success = error.empty();
+                if (result.success) result.content = std::move(content);
+                result.error = std::move(error);
+                readPromise.set_value(std::move(result));
+            }
+        }
+    };
+
+    /**
+     * @brief Ejecutor de peticiones
+     */
+    class AsyncFileIO::Backend {
+    public:
+        virtual ~Backend() = default;
+        virtual void submit(std::unique_ptr<Request> request) = 0;
+        virtual const char* name() const = 0;
+        virtual bool isIoUring() const { return false; }
+    };
+
+    namespace {
+
+        using Request = AsyncFileIO::Request;
+
+        std::string describeError(const char* action, const std::string& path, int code) {
+            return std::string(action) + ": " + path + " (" + std::strerror(code) + ")";
+        }
+
+        // Temporal propio de cada escritura: dos guardados del mismo archivo
+        // (en este proceso o en otro) nunca comparten el archivo temporal
+        std::string temporaryPathFor(const std::string& path) {
+            static std::atomic<uint64_t> nextId{0};
+#ifdef _WIN32
+            const long long processId = _getpid();
+#else
+            const long long processId = ::getpid();
+#endif
+            return path + ".coralcode-tmp." + std::to_string(processId) + "." +
+                   std::to_string(nextId.fetch_add(1, std::memory_order_relaxed));
+        }
+
+        // ====================================================================
+        // Operaciones bloqueantes (respaldo)
+        // ====================================================================
+
+#ifdef _WIN32
+        void readBlocking(Request& request) {
+            std::ifstream file(request.path, std::ios::binary | std::ios::ate);
+            if (!file) {
+                request.error = describeError("No se pudo abrir", request.path, errno);
+                return;
+            }
+            auto size = static_cast<uint64_t>(file.tellg());
+            if (size > request.maxSize) {
+                request.error = "Archivo demasiado grande: " + request.path;
+                return;
+            }
+            request.content.resize(static_cast<size_t>(size));
+            file.seekg(0);
+            if (!file.read(request.content.data(), static_cast<std::streamsize>(size))) {
+                request.error = "Error de lectura: " + request.path;
+            }
+        }
+
+        void writeBlocking(Request& request) {
+            {
+                std::ofstream file(request.temporary, std::ios::binary | std::ios::trunc);
+                if (!file || !file.write(request.content.data(), static_cast<std::streamsize>(request.content.size()))) {
+                    request.error = "No se pudo escribir: " + request.temporary;
+                }
+            }
+            std::error_code error;
+            if (request.error.empty()) {
+                std::filesystem::rename(request.temporary, request.path, error);
+                if (error) request.error = "No se pudo reemplazar: " + request.path + " (" + error.message() + ")";
+            }
+            if (!request.error.empty()) {
+                std::filesystem::remove(request.temporary, error);
+            }
+        }
+#else
+        void readBlocking(Request& request) {
+            int fd = ::open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                request.error = describeError("No se pudo abrir", request.path, errno);
+                return;
+            }
+            struct stat info {};
+            if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+                request.error = "No es un archivo regular: " + request.path;
+            } else if (static_cast<uint64_t>(info.st_size) > request.maxSize) {
+                request.error = "Archivo demasiado grande: " + request.path;
+            } else {
+                request.content.resize(static_cast<size_t>(info.st_size));
+                while (request.done < request.content.size()) {
+                    const size_t length = std::min(request.content.size() - request.done, AsyncFileIO::IO_CHUNK);
+                    ssize_t count = ::read(fd, &request.content[request.done], length);
+                    if (count < 0 && errno == EINTR) continue;
+                    if (count < 0) {
+                        request.error = describeError("Error de lectura", request.path, errno);
+                        break;
+                    }
+                    if (count == 0) break;
+                    request.done += static_cast<size_t>(count);
+                }
+                request.content.resize(request.done);
+            }
+            ::close(fd);
+        }
+
+        void writeBlocking(Request& request) {
+            struct stat info {};
+            const auto mode = ::stat(request.path.c_str(), &info) == 0 ? info.st_mode & 07777 : 0666;
+
+            int fd = ::open(request.temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, mode);
+            if (fd < 0) {
+                request.error = describeError("No se pudo crear", request.temporary, errno);
+                return;
+            }
+            while (request.done < request.content.size()) {
+                const size_t length = std::min(request.content.size() - request.done, AsyncFileIO::IO_CHUNK);
+                ssize_t count = ::write(fd, request.content.data() + request.done, length);
+                if (count < 0 && errno == EINTR) continue;
+                if (count < 0) {
+                    request.error = describeError("Error de escritura", request.temporary, errno);
+                    break;
+                }
+                request.done += static_cast<size_t>(count);
+            }
+            if (request.error.empty() && ::fsync(fd) != 0) {
+                request.error = describeError("Error de escritura", request.temporary, errno);
+            }
+            if (::close(fd) != 0 && request.error.empty()) {
+                request.error = describeError("Error de escritura", request.temporary, errno);
+            }
+            if (request.error.empty() && ::rename(request.temporary.c_str(), request.path.c_str()) != 0) {
+                request.error = describeError("No se pudo reemplazar", request.path, errno);
+            }
+            if (!request.error.empty()) {
+                ::unlink(request.temporary.c_str());
+            }
+        }
+#endif
+
+        /**
+         * @brief Grupo de hilos que ejecuta las operaciones bloqueantes
+         */
+        class ThreadPoolBackend : public AsyncFileIO::Backend {
+        public:
+            explicit ThreadPoolBackend(size_t threadCount) : stopping_(false) {
+                for (size_t i = 0; i < threadCount; ++i) {
+                    threads_.emplace_back(&ThreadPoolBackend::run, this);
+                }
+            }
+
+            ~ThreadPoolBackend() override {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stopping_ = true;
+                }
+                ready_.notify_all();
+                for (std::thread& thread : threads_) {
+                    thread.join();
+                }
+            }
+
+            void submit(std::unique_ptr<Request> request) override {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    queue_.push_back(std::move(request));
+                }
+                ready_.notify_one();
+            }
+
+            const char* name() const override { return "threads"; }
+
+        private:
+            std::vector<std::thread> threads_;
+            std::mutex mutex_;
+            std::condition_variable ready_;
+            std::deque<std::unique_ptr<Request>> queue_;
+            bool stopping_;
+
+            void run() {
+                LatencyTracer::setThreadName("E/S de archivos");
+                while (true) {
+                    std::unique_ptr<Request> request;
+                    {
+                        // Al parar se termina lo encolado: ningún futuro queda sin valor
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                        if (queue_.empty()) return;
+                        request = std::move(queue_.front());
+                        queue_.pop_front();
+                    }
+                    if (request->isWrite) {
+                        writeBlocking(*request);
+                    } else {
+                        readBlocking(*request);
+                    }
+                    request->complete();
+                }
+            }
+        };
+
+#ifdef __linux__
+        // ====================================================================
+        // io_uring
+        // ====================================================================
+
+        int ioUringSetup(unsigned entries, io_uring_params* params) {
+            return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+        }
+
+        int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+            return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+        }
+
+        int ioUringRegister(int fd, unsigned opcode, void* arg, unsigned count) {
+            return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, count));
+        }
+
+        uint64_t addressOf(const void* pointer) {
+            return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer));
+        }
+
+        const char kEmptyPath[] = "";
+
+        /**
+         * @brief Anillo io_uring atendido por un hilo propio
+         *
+         * Cada petición tiene como mucho una operación en vuelo; la siguiente
+         * se encola al llegar la finalización de la anterior. Un read sobre un
+         * eventfd despierta al hilo cuando llegan peticiones nuevas.
+         */
+        class UringBackend : public AsyncFileIO::Backend {
+        public:
+            UringBackend()
+                : ringFd_(-1), eventFd_(-1), sqRing_(MAP_FAILED), cqRing_(MAP_FAILED), sqes_(nullptr),
+                  sqRingSize_(0), cqRingSize_(0), sqesSize_(0), sqHead_(nullptr), sqTail_(nullptr),
+                  sqMask_(nullptr), sqArray_(nullptr), cqHead_(nullptr), cqTail_(nullptr), cqMask_(nullptr),
+                  cqes_(nullptr), maxActive_(0), toSubmit_(0), active_(0), wakeValue_(0), stopping_(false) {}
+
+            ~UringBackend() override {
+                if (thread_.joinable()) {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        stopping_ = true;
+                    }
+                    wake();
+                    thread_.join();
+                }
+                if (sqes_) ::munmap(sqes_, sqesSize_);
+                if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) ::munmap(cqRing_, cqRingSize_);
+                if (sqRing_ != MAP_FAILED) ::munmap(sqRing_, sqRingSize_);
+                if (eventFd_ >= 0) ::close(eventFd_);
+                if (ringFd_ >= 0) ::close(ringFd_);
+            }
+
+            // false si el kernel no ofrece io_uring o le faltan operaciones
+            bool start() {
+                io_uring_params params {};
+                ringFd_ = ioUringSetup(AsyncFileIO::QUEUE_DEPTH, &params);
+                if (ringFd_ < 0 || !supportsRequiredOps()) return false;
+
+                sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (singleMap) {
+                    sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+                }
+                sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                 ringFd_, IORING_OFF_SQ_RING);
+                if (sqRing_ == MAP_FAILED) return false;
+                cqRing_ = singleMap ? sqRing_
+                                    : ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                             ringFd_, IORING_OFF_CQ_RING);
+                if (cqRing_ == MAP_FAILED) return false;
+                sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+                void* sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                    ringFd_, IORING_OFF_SQES);
+                if (sqes == MAP_FAILED) return false;
+                sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+                auto* sq = static_cast<char*>(sqRing_);
+                auto* cq = static_cast<char*>(cqRing_);
+                sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+                sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+                sqMask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+                sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+                cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+                cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+                cqMask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+                cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+                // Una entrada queda para el despertador
+                maxActive_ = params.sq_entries - 1;
+
+                eventFd_ = ::eventfd(0, EFD_CLOEXEC);
+                if (eventFd_ < 0) return false;
+                thread_ = std::thread(&UringBackend::run, this);
+                return true;
+            }
+
+            void submit(std::unique_ptr<Request> request) override {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    incoming_.push_back(std::move(request));
+                }
+                wake();
+            }
+
+            const char* name() const override { return "io_uring"; }
+            bool isIoUring() const override { return true; }
+
+        private:
+            int ringFd_;
+            int eventFd_;
+            void* sqRing_;
+            void* cqRing_;
+            io_uring_sqe* sqes_;
+            size_t sqRingSize_;
+            size_t cqRingSize_;
+            size_t sqesSize_;
+            unsigned* sqHead_;
+            unsigned* sqTail_;
+            unsigned* sqMask_;
+            unsigned* sqArray_;
+            unsigned* cqHead_;
+            unsigned* cqTail_;
+            unsigned* cqMask_;
+            io_uring_cqe* cqes_;
+            size_t maxActive_;
+
+            // Solo los usa el hilo del anillo
+            unsigned toSubmit_;
+            size_t active_;
+            std::deque<std::unique_ptr<Request>> waiting_;
+            uint64_t wakeValue_;
+
+            std::thread thread_;
+            std::mutex mutex_;
+            std::deque<std::unique_ptr<Request>> incoming_;
+            bool stopping_;
+
+            bool supportsRequiredOps() {
+                const unsigned count = IORING_OP_RENAMEAT + 1;
+                std::vector<unsigned char> buffer(sizeof(io_uring_probe) + count * sizeof(io_uring_probe_op));
+                auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+                if (ioUringRegister(ringFd_, IORING_REGISTER_PROBE, probe, count) < 0) return false;
+
+                const unsigned required[] = {IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_WRITE,
+                                             IORING_OP_FSYNC, IORING_OP_CLOSE, IORING_OP_RENAMEAT};
+                for (unsigned op : required) {
+                    if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+                }
+                return true;
+            }
+
+            void wake() {
+                uint64_t one = 1;
+                ssize_t written = ::write(eventFd_, &one, sizeof(one));
+                static_cast<void>(written);
+            }
+
+            // ----------------------------------------------------------------
+            // Cola de envío
+            // ----------------------------------------------------------------
+
+            io_uring_sqe* prepare(uint8_t opcode, int fd, uint64_t address, unsigned length, uint64_t offset,
+                                  uint64_t userData) {
+                const unsigned tail = *sqTail_;
+                const unsigned index = tail & *sqMask_;
+                io_uring_sqe* sqe = &sqes_[index];
+                std::memset(sqe, 0, sizeof(*sqe));
+                sqe->opcode = opcode;
+                sqe->fd = fd;
+                sqe->addr = address;
+                sqe->len = length;
+                sqe->off = offset;
+                sqe->user_data = userData;
+                sqArray_[index] = index;
+                return sqe;
+            }
+
+            void push() {
+                __atomic_store_n(sqTail_, *sqTail_ + 1, __ATOMIC_RELEASE);
+                ++toSubmit_;
+            }
+
+            void armWakeup() {
+                prepare(IORING_OP_READ, eventFd_, addressOf(&wakeValue_), sizeof(wakeValue_), 0, 0);
+                push();
+            }
+
+            void queueOpen(Request* request, const std::string& path, unsigned flags) {
+                io_uring_sqe* sqe = prepare(IORING_OP_OPENAT, AT_FDCWD, addressOf(path.c_str()), request->mode, 0,
+                                            addressOf(request));
+                sqe->open_flags = flags;
+                push();
+            }
+
+            void queueStat(Request* request, int fd, const char* path, unsigned flags, unsigned mask) {
+                io_uring_sqe* sqe = prepare(IORING_OP_STATX, fd, addressOf(path), mask, addressOf(&request->info),
+                                            addressOf(request));
+                sqe->statx_flags = flags;
+                push();
+            }
+
+            void queueTransfer(Request* request, uint8_t opcode) {
+                const size_t length = std::min(request->content.size() - request->done, AsyncFileIO::IO_CHUNK);
+                prepare(opcode, request->fd, addressOf(request->content.data() + request->done),
+                        static_cast<unsigned>(length), request->done, addressOf(request));
+                push();
+            }
+
+            void queueSimple(Request* request, uint8_t opcode) {
+                prepare(opcode, request->fd, 0, 0, 0, addressOf(request));
+                push();
+            }
+
+            void queueRename(Request* request) {
+                io_uring_sqe* sqe = prepare(IORING_OP_RENAMEAT, AT_FDCWD, addressOf(request->temporary.c_str()),
+                                            static_cast<unsigned>(AT_FDCWD), addressOf(request->path.c_str()),
+                                            addressOf(request));
+                sqe->rename_flags = 0;
+                push();
+            }
+
+            // ----------------------------------------------------------------
+            // Máquina de estados
+            // ----------------------------------------------------------------
+
+            void begin(Request* request) {
+                ++active_;
+                if (request->isWrite) {
+                    // Conservar los permisos del archivo que se reemplaza
+                    request->step = Request::Step::StatTarget;
+                    queueStat(request, AT_FDCWD, request->path.c_str(), 0, STATX_MODE);
+                } else {
+                    request->step = Request::Step::Open;
+                    queueOpen(request, request->path, O_RDONLY | O_CLOEXEC);
+                }
+            }
+
+            void finish(Request* request) {
+                std::unique_ptr<Request> owned(request);
+                if (owned->isWrite && !owned->error.empty()) {
+                    ::unlink(owned->temporary.c_str());
+                }
+                --active_;
+                owned->complete();
+            }
+
+            void closeWithError(Request* request, std::string error) {
+                request->error = std::move(error);
+                request->step = Request::Step::Close;
+                queueSimple(request, IORING_OP_CLOSE);
+            }
+
+            void advance(Request* request, int result) {
+                using Step = Request::Step;
+                switch (request->step) {
+                    case Step::StatTarget:
+                        request->mode = result == 0 ? request->info.stx_mode & 07777u : 0666u;
+                        request->step = Step::Open;
+                        queueOpen(request, request->temporary, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC);
+                        break;
+
+                    case Step::Open:
+                        if (result < 0) {
+                            request->error = describeError(request->isWrite ? "No se pudo crear" : "No se pudo abrir",
+                                                           request->isWrite ? request->temporary : request->path, -result);
+                            finish(request);
+                            break;
+                        }
+                        request->fd = result;
+                        if (request->isWrite) {
+                            request->step = request->content.empty() ? Step::Sync : Step::Write;
+                            if (request->content.empty()) {
+                                queueSimple(request, IORING_OP_FSYNC);
+                            } else {
+                                queueTransfer(request, IORING_OP_WRITE);
+                            }
+                        } else {
+                            request->step = Step::Stat;
+                            queueStat(request, request->fd, kEmptyPath, AT_EMPTY_PATH, STATX_TYPE | STATX_SIZE);
+                        }
+                        break;
+
+                    case Step::Stat:
+                        if (result < 0 || !S_ISREG(request->info.stx_mode)) {
+                            closeWithError(request, "No es un archivo regular: " + request->path);
+                        } else if (request->info.stx_size > request->maxSize) {
+                            closeWithError(request, "Archivo demasiado grande: " + request->path);
+                        } else if (request->info.stx_size == 0) {
+                            request->step = Step::Close;
+                            queueSimple(request, IORING_OP_CLOSE);
+                        } else {
+                            request->content.resize(static_cast<size_t>(request->info.stx_size));
+                            request->step = Step::Read;
+                            queueTransfer(request, IORING_OP_READ);
+                        }
+                        break;
+
+                    case Step::Read:
+                        if (result == -EINTR || result == -EAGAIN) {
+                            queueTransfer(request, IORING_OP_READ);
+                        } else if (result < 0) {
+                            closeWithError(request, describeError("Error de lectura", request->path, -result));
+                        } else if (result > 0 && request->done + static_cast<size_t>(result) < request->content.size()) {
+                            request->done += static_cast<size_t>(result);
+                            queueTransfer(request, IORING_OP_READ);
+                        } else {
+                            // Fin del archivo (puede haber encogido desde statx)
+                            request->done += static_cast<size_t>(result);
+                            request->content.resize(request->done);
+                            request->step = Step::Close;
+                            queueSimple(request, IORING_OP_CLOSE);
+                        }
+                        break;
+
+                    case Step::Write:
+                        if (result == -EINTR || result == -EAGAIN) {
+                            queueTransfer(request, IORING_OP_WRITE);
+                        } else if (result < 0) {
+                            closeWithError(request, describeError("Error de escritura", request->temporary, -result));
+                        } else {
+                            request->done += static_cast<size_t>(result);
+                            if (request->done < request->content.size()) {
+                                queueTransfer(request, IORING_OP_WRITE);
+                            } else {
+                                request->step = Step::Sync;
+                                queueSimple(request, IORING_OP_FSYNC);
+                            }
+                        }
+                        break;
+
+                    case Step::Sync:
+                        if (result < 0) {
+                            closeWithError(request, describeError("Error de escritura", request->temporary, -result));
+                        } else {
+                            request->step = Step::Close;
+                            queueSimple(request, IORING_OP_CLOSE);
+                        }
+                        break;
+
+                    case Step::Close:
+                        request->fd = -1;
+                        if (result < 0 && request->isWrite && request->error.empty()) {
+                            request->error = describeError("Error de escritura", request->temporary, -result);
+                        }
+                        if (request->isWrite && request->error.empty()) {
+                            request->step = Step::Rename;
+                            queueRename(request);
+                        } else {
+                            finish(request);
+                        }
+                        break;
+
+                    case Step::Rename:
+                    default:
+                        if (result < 0) {
+                            request->error = describeError("No se pudo reemplazar", request->path, -result);
+                        }
+                        finish(request);
+                        break;
+                }
+            }
+
+            // ----------------------------------------------------------------
+            // Hilo del anillo
+            // ----------------------------------------------------------------
+
+            void run() {
+                LatencyTracer::setThreadName("E/S de archivos (io_uring)");
+                armWakeup();
+                while (true) {
+                    bool stopping;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        while (!incoming_.empty()) {
+                            waiting_.push_back(std::move(incoming_.front()));
+                            incoming_.pop_front();
+                        }
+                        stopping = stopping_;
+                    }
+                    while (!waiting_.empty() && active_ < maxActive_) {
+                        begin(waiting_.front().release());
+                        waiting_.pop_front();
+                    }
+                    // Al parar se termina todo lo pendiente
+                    if (stopping && active_ == 0 && waiting_.empty()) return;
+
+                    // Enviar el lote y esperar al menos una finalización
+                    int submitted = ioUringEnter(ringFd_, toSubmit_, 1, IORING_ENTER_GETEVENTS);
+                    if (submitted > 0) {
+                        toSubmit_ -= std::min(toSubmit_, static_cast<unsigned>(submitted));
+                    }
+                    reap();
+                }
+            }
+
+            void reap() {
+                unsigned head = *cqHead_;
+                const unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+                bool rearm = false;
+                while (head != tail) {
+                    const io_uring_cqe& cqe = cqes_[head & *cqMask_];
+                    const uint64_t userData = cqe.user_data;
+                    const int result = cqe.res;
+                    ++head;
+                    if (userData == 0) {
+                        rearm = true;
+                    } else {
+                        advance(reinterpret_cast<Request*>(static_cast<uintptr_t>(userData)), result);
+                    }
+                }
+                __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+                if (rearm) {
+                    armWakeup();
+                }
+            }
+        };
+#endif
+
+    } // namespace
+
+    // ========================================================================
+    // AsyncFileIO
+    // ========================================================================
+
+    AsyncFileIO::AsyncFileIO(bool allowIoUring, size_t fallbackThreads) {
+#ifdef __linux__
+        if (allowIoUring) {
+            auto uring = std::make_unique<UringBackend>();
+            if (uring->start()) {
+                backend_ = std::move(uring);
+            }
+        }
+#else
+        static_cast<void>(allowIoUring);
+#endif
+        if (!backend_) {
+            backend_ = std::make_unique<ThreadPoolBackend>(fallbackThreads > 0 ? fallbackThreads : FALLBACK_THREADS);
+        }
+    }
+
+    AsyncFileIO::~AsyncFileIO() = default;
+
+    AsyncFileIO& AsyncFileIO::shared() {
+        static AsyncFileIO io;
+        return io;
+    }
+
+    std::future<FileReadResult> AsyncFileIO::read(const std::string& path, uint64_t maxSize) {
+        auto request = std::make_unique<Request>();
+        request->path = path;
+        request->maxSize = maxSize;
+        if (LatencyTracer::shared().isEnabled()) request->submittedAt = LatencyTracer::now();
+        std::future<FileReadResult> future = request->readPromise.get_future();
+        backend_->submit(std::move(request));
+        return future;
+    }
+
+    std::future<FileWriteResult> AsyncFileIO::write(const std::string& path, std::string content) {
+        auto request = std::make_unique<Request>();
+        request->isWrite = true;
+        request->path = path;
+        request->temporary = temporaryPathFor(path);
+        request->content = std::move(content);
+        if (LatencyTracer::shared().isEnabled()) request->submittedAt = LatencyTracer::now();
+        std::future<FileWriteResult> future = request->writePromise.get_future();
+        backend_->submit(std::move(request));
+        return future;
+    }
+
+    bool AsyncFileIO::isUsingIoUring() const {
+        return backend_->isIoUring();
+    }
+
+    const char* AsyncFileIO::getBackendName() const {
+        return backend_->name();
+    }
+
+} // namespace CoralCode
@@ -0,0 +1,23 @@
+/**
+ * @file ClipboardManager.cpp
+ * @brief Portapapeles del sistema e historial interno: memoria del historial
+ */
+
+#include "ClipboardManager.hpp"
+#include "MemoryUsage.hpp"
+
+namespace CoralCode {
+
+    // ========================================================================
+    // Historial
+    // ========================================================================
+
+    size_t ClipboardManager::getMemoryUsage() const {
+        size_t bytes = clipboardHistory_.capacity() * sizeof(std::string);
+        for (const std::string& entry : clipboardHistory_) {
+            bytes += MemoryUsage::stringBytes(entry);
+        }
+        return bytes;
+    }
+
+} // namespace CoralCode
@@ -0,0 +1,598 @@
+/**
+ * @file EditTrace.cpp
+ * @brief Grabación, formato binario e importación de trazas de edición
+ */
+
+#include "EditTrace.hpp"
+#include "FileHandler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace CoralCode {
+
+    namespace {
+
+        // ====================================================================
+        // Codificación binaria
+        // ====================================================================
+
+        void putVarint(std::string& out, uint64_t value) {
+            while (value >= 0x80) {
+                out += static_cast<char>((value & 0x7F) | 0x80);
+                value >>= 7;
+            }
+            out += static_cast<char>(value);
+        }
+
+        void putSigned(std::string& out, int64_t value) {
+            // Zigzag: los negativos pequeños también ocupan un byte
+            putVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+
+        void putString(std::string& out, const std::string& text) {
+            putVarint(out, text.size());
+            out += text;
+        }
+
+        void putByte(std::string& out, uint8_t value) {
+            out += static_cast<char>(value);
+        }
+
+        int64_t toFixed(float value, float scale) {
+            return static_cast<int64_t>(std::lround(value * scale));
+        }
+
+        class Reader {
+        public:
+            explicit Reader(const std::string& data) : data_(data), offset_(0), failed_(false) {}
+
+            bool failed() const { return failed_; }
+            bool atEnd() const { return offset_ >= data_.size(); }
+
+            uint8_t byte() {
+                if (offset_ >= data_.size()) {
+                    failed_ = true;
+                    return 0;
+                }
+                return static_cast<uint8_t>(data_[offset_++]);
+            }
+
+            uint64_t varint() {
+                uint64_t value = 0;
+                for (unsigned shift = 0; shift < 64; shift += 7) {
+                    const uint8_t part = byte();
+                    if (failed_) return 0;
+                    value |= static_cast<uint64_t>(part & 0x7F) << shift;
+                    if ((part & 0x80) == 0) return value;
+                }
+                failed_ = true;
+                return 0;
+            }
+
+            int64_t signedValue() {
+                const uint64_t value = varint();
+                return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+            }
+
+            std::string text() {
+                const uint64_t length = varint();
+                if (failed_ || length > data_.size() - offset_) {
+                    failed_ = true;
+                    return std::string();
+                }
+                std::string result = data_.substr(offset_, static_cast<size_t>(length));
+                offset_ += static_cast<size_t>(length);
+                return result;
+            }
+
+        private:
+            const std::string& data_;
+            size_t offset_;
+            bool failed_;
+        };
+
+        // Escala de Scroll: SFML entrega fracciones con trackpads
+        constexpr float SCROLL_SCALE = 1000.0f;
+
+        // ====================================================================
+        // JSON mínimo para trazas publicadas
+        // ====================================================================
+
+        void appendUtf8(std::string& out, uint32_t codepoint) {
+            if (codepoint < 0x80) {
+                out += static_cast<char>(codepoint);
+            } else if (codepoint < 0x800) {
+                out += static_cast<char>(0xC0 | (codepoint >> 6));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            } else if (codepoint < 0x10000) {
+                out += static_cast<char>(0xE0 | (codepoint >> 12));
+                out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (codepoint >> 18));
+                out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            }
+        }
+
+        /**
+         * @brief Lector JSON en streaming para el formato de trazas publicadas
+         *
+         * No construye un árbol: las trazas grandes tienen cientos de miles
+         * de parches y solo interesan unas pocas claves.
+         */
+        class JsonReader {
+        public:
+            explicit JsonReader(const std::string& text) : text_(text), offset_(0) {}
+
+            const std::string& getError() const { return error_; }
+            bool ok() const { return error_.empty(); }
+
+            void skipSpace() {
+                while (offset_ < text_.size() && (text_[offset_] == ' ' || text_[offset_] == '\n' ||
+                                                  text_[offset_] == '\r' || text_[offset_] == '\t')) {
+                    ++offset_;
+                }
+            }
+
+            bool peek(char ch) {
+                skipSpace();
+                return offset_ < text_.size() && text_[offset_] == ch;
+            }
+
+            bool expect(char ch) {
+                if (peek(ch)) {
+                    ++offset_;
+                    return true;
+                }
+                return fail(std::string("se esperaba '") + ch + "'");
+            }
+
+            // Tras un elemento: ',' para seguir o el cierre para terminar
+            bool next(char close, bool& more) {
+                if (peek(',')) {
+                    ++offset_;
+                    more = true;
+                    return true;
+                }
+                more = false;
+                return expect(close);
+            }
+
+            bool readString(std::string& out) {
+                out.clear();
+                if (!expect('"')) return false;
+                while (offset_ < text_.size()) {
+                    const char ch = text_[offset_++];
+                    if (ch == '"') return true;
+                    if (ch != '\\') {
+                        out += ch;
+                        continue;
+                    }
+                    if (offset_ >= text_.size()) break;
+                    const char escaped = text_[offset_++];
+                    switch (escaped) {
+                        case '"': out += '"'; break;
+                        case '\\': out += '\\'; break;
+                        case '/': out += '/'; break;
+                        case 'b': out += '\b'; break;
+                        case 'f': out += '\f'; break;
+                        case 'n': out += '\n'; break;
+                        case 'r': out += '\r'; break;
+                        case 't': out += '\t'; break;
+                        case 'u': {
+                            uint32_t codepoint = 0;
+                            if (!readHex4(codepoint)) return false;
+                            // Par sustituto UTF-16
+                            if (codepoint >= 0xD800 && codepoint < 0xDC00 && offset_ + 1 < text_.size() &&
+                                text_[offset_] == '\\' && text_[offset_ + 1] == 'u') {
+                                offset_ += 2;
+                                uint32_t low = 0;
+                                if (!readHex4(low)) return false;
+                                codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                            }
+                            appendUtf8(out, codepoint);
+                            break;
+                        }
+                        default:
+                            return fail("escape no válido");
+                    }
+                }
+                return fail("cadena sin cerrar");
+            }
+
+            bool readUnsigned(uint64_t& value) {
+                skipSpace();
+                const size_t start = offset_;
+                value = 0;
+                while (offset_ < text_.size() && text_[offset_] >= '0' && text_[offset_] <= '9') {
+                    value = value * 10 + static_cast<uint64_t>(text_[offset_] - '0');
+                    ++offset_;
+                }
+                return offset_ > start || fail("se esperaba un número");
+            }
+
+            // Salta cualquier valor (objetos y arrays anidados incluidos)
+            bool skipValue() {
+                skipSpace();
+                if (offset_ >= text_.size()) return fail("fin inesperado");
+                const char ch = text_[offset_];
+                if (ch == '"') {
+                    std::string ignored;
+                    return readString(ignored);
+                }
+                if (ch == '{' || ch == '[') {
+                    const char close = ch == '{' ? '}' : ']';
+                    ++offset_;
+                    if (peek(close)) {
+                        ++offset_;
+                        return true;
+                    }
+                    bool more = true;
+                    while (more) {
+                        if (ch == '{') {
+                            std::string key;
+                            if (!readString(key) || !expect(':')) return false;
+                        }
+                        if (!skipValue() || !next(close, more)) return false;
+                    }
+                    return true;
+                }
+                // Número, true, false o null
+                while (offset_ < text_.size() && std::strchr(",]} \n\r\t", text_[offset_]) == nullptr) {
+                    ++offset_;
+                }
+                return true;
+            }
+
+            bool fail(const std::string& message) {
+                if (error_.empty()) {
+                    error_ = "JSON no válido en el byte " + std::to_string(offset_) + ": " + message;
+                }
+                return false;
+            }
+
+        private:
+            const std::string& text_;
+            size_t offset_;
+            std::string error_;
+
+            bool readHex4(uint32_t& value) {
+                if (offset_ + 4 > text_.size()) return fail("escape \\u incompleto");
+                value = 0;
+                for (int i = 0; i < 4; ++i) {
+                    const char ch = text_[offset_++];
+                    value <<= 4;
+                    if (ch >= '0' && ch <= '9') value |= static_cast<uint32_t>(ch - '0');
+                    else if (ch >= 'a' && ch <= 'f') value |= static_cast<uint32_t>(ch - 'a' + 10);
+                    else if (ch >= 'A' && ch <= 'F') value |= static_cast<uint32_t>(ch - 'A' + 10);
+                    else return fail("escape \\u no válido");
+                }
+                return true;
+            }
+        };
+
+        // [posición, borrar, "texto"] (el texto puede faltar)
+        bool readPatch(JsonReader& json, TraceEvent& event) {
+            event.type = TraceEventType::Splice;
+            bool more = false;
+            if (!json.expect('[') || !json.readUnsigned(event.position) || !json.next(']', more)) return false;
+            if (!more) return true;
+            if (!json.readUnsigned(event.deleteCount) || !json.next(']', more)) return false;
+            if (!more) return true;
+            if (!json.readString(event.text)) return false;
+            while (more) {
+                if (!json.next(']', more)) return false;
+                if (more && !json.skipValue()) return false;
+            }
+            return true;
+        }
+
+        bool readTransactions(JsonReader& json, std::vector<TraceEvent>& events) {
+            if (!json.expect('[')) return false;
+            if (json.peek(']')) return json.expect(']');
+
+            bool moreTxns = true;
+            while (moreTxns) {
+                if (!json.expect('{')) return false;
+                bool moreKeys = !json.peek('}');
+                if (!moreKeys && !json.expect('}')) return false;
+                while (moreKeys) {
+                    std::string key;
+                    if (!json.readString(key) || !json.expect(':')) return false;
+                    if (key == "patches") {
+                        if (!json.expect('[')) return false;
+                        bool morePatches = !json.peek(']');
+                        if (!morePatches && !json.expect(']')) return false;
+                        while (morePatches) {
+                            TraceEvent event;
+                            if (!readPatch(json, event)) return false;
+                            events.push_back(std::move(event));
+                            if (!json.next(']', morePatches)) return false;
+                        }
+                    } else if (!json.skipValue()) {
+                        return false;
+                    }
+                    if (!json.next('}', moreKeys)) return false;
+                }
+                if (!json.next(']', moreTxns)) return false;
+            }
+            return true;
+        }
+
+    } // namespace
+
+    // ========================================================================
+    // Formato binario
+    // ========================================================================
+
+    std::string EditTrace::serialize() const {
+        std::string out(MAGIC, sizeof(MAGIC));
+        putVarint(out, windowWidth);
+        putVarint(out, windowHeight);
+        putString(out, initialText);
+        putByte(out, hasExpectedText ? 1 : 0);
+        if (hasExpectedText) putString(out, expectedText);
+        putVarint(out, events.size());
+
+        uint64_t previousTime = 0;
+        for (const TraceEvent& event : events) {
+            putByte(out, static_cast<uint8_t>(event.type));
+            putVarint(out, event.timeUs >= previousTime ? event.timeUs - previousTime : 0);
+            previousTime = std::max(previousTime, event.timeUs);
+
+            switch (event.type) {
+                case TraceEventType::Key:
+                    putByte(out, static_cast<uint8_t>(event.key));
+                    putByte(out, event.modifiers);
+                    break;
+                case TraceEventType::Text:
+                    putVarint(out, event.codepoint);
+                    break;
+                case TraceEventType::MousePress:
+                case TraceEventType::MouseRelease:
+                case TraceEventType::MouseMove:
+                    putSigned(out, toFixed(event.x, 1.0f));
+                    putSigned(out, toFixed(event.y, 1.0f));
+                    putByte(out, event.button);
+                    break;
+                case TraceEventType::Scroll:
+                    putSigned(out, toFixed(event.delta, SCROLL_SCALE));
+                    putByte(out, event.horizontal ? 1 : 0);
+                    break;
+                case TraceEventType::Resize:
+                    putVarint(out, event.width);
+                    putVarint(out, event.height);
+                    break;
+                case TraceEventType::Paste:
+                    putString(out, event.text);
+                    break;
+                case TraceEventType::Splice:
+                default:
+                    putVarint(out, event.position);
+                    putVarint(out, event.deleteCount);
+                    putString(out, event.text);
+                    break;
+            }
+        }
+        return out;
+    }
+
+    bool EditTrace::deserialize(const std::string& data, std::string& error) {
+        if (data.size() < sizeof(MAGIC) || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) {
+            error = "No es una traza de CoralCode";
+            return false;
+        }
+
+        Reader reader(data);
+        for (size_t i = 0; i < sizeof(MAGIC); ++i) reader.byte();
+
+        EditTrace trace;
+        trace.windowWidth = static_cast<uint32_t>(reader.varint());
+        trace.windowHeight = static_cast<uint32_t>(reader.varint());
+        trace.initialText = reader.text();
+        trace.hasExpectedText = reader.byte() != 0;
+        if (trace.hasExpectedText) trace.expectedText = reader.text();
+
+        const uint64_t count = reader.varint();
+        // Cada evento ocupa al menos dos bytes: acotar la reserva
+        trace.events.reserve(static_cast<size_t>(std::min<uint64_t>(count, data.size() / 2)));
+
+        uint64_t time = 0;
+        for (uint64_t i = 0; i < count && !reader.failed(); ++i) {
+            TraceEvent event;
+            const uint8_t type = reader.byte();
+            time += reader.varint();
+            if (reader.failed()) break;
+            event.timeUs = time;
+
+            switch (static_cast<TraceEventType>(type)) {
+                case TraceEventType::Key:
+                    event.key = static_cast<TraceKey>(reader.byte());
+                    event.modifiers = reader.byte();
+                    break;
+                case TraceEventType::Text:
+                    event.codepoint = static_cast<uint32_t>(reader.varint());
+                    break;
+                case TraceEventType::MousePress:
+                case TraceEventType::MouseRelease:
+                case TraceEventType::MouseMove:
+                    event.x = static_cast<float>(reader.signedValue());
+                    event.y = static_cast<float>(reader.signedValue());
+                    event.button = reader.byte();
+                    break;
+                case TraceEventType::Scroll:
+                    event.delta = static_cast<float>(reader.signedValue()) / SCROLL_SCALE;
+                    event.horizontal = reader.byte() != 0;
+                    break;
+                case TraceEventType::Resize:
+                    event.width = static_cast<uint32_t>(reader.varint());
+                    event.height = static_cast<uint32_t>(reader.varint());
+                    break;
+                case TraceEventType::Paste:
+                    event.text = reader.text();
+                    break;
+                case TraceEventType::Splice:
+                    event.position = reader.varint();
+                    event.deleteCount = reader.varint();
+                    event.text = reader.text();
+                    break;
+                default:
+                    error = "Tipo de evento desconocido en la traza: " + std::to_string(static_cast<unsigned>(type));
+                    return false;
+            }
+            event.type = static_cast<TraceEventType>(type);
+            trace.events.push_back(std::move(event));
+        }
+
+        if (reader.failed()) {
+            error = "Traza truncada o dañada";
+            return false;
+        }
+        *this = std::move(trace);
+        return true;
+    }
+
+    bool EditTrace::save(const std::string& path, std::string& error) const {
+        FileHandler files;
+        if (!files.writeFile(path, serialize())) {
+            error = files.getLastError();
+            return false;
+        }
+        return true;
+    }
+
+    bool EditTrace::load(const std::string& path, std::string& error) {
+        FileHandler files;
+        std::string data;
+        if (!files.readFile(path, data)) {
+            error = files.getLastError();
+            return false;
+        }
+        return deserialize(data, error);
+    }
+
+    // ========================================================================
+    // Trazas publicadas
+    // ========================================================================
+
+    bool EditTrace::importEditingTrace(const std::string& path, std::string& error) {
+        FileHandler files;
+        std::string json;
+        if (!files.readFile(path, json)) {
+            error = files.getLastError();
+            return false;
+        }
+        return parseEditingTrace(json, error);
+    }
+
+    bool EditTrace::parseEditingTrace(const std::string& text, std::string& error) {
+        JsonReader json(text);
+        EditTrace trace;
+
+        bool ok = json.expect('{');
+        bool more = ok && !json.peek('}');
+        while (ok && more) {
+            std::string key;
+            ok = json.readString(key) && json.expect(':');
+            if (!ok) break;
+            if (key == "startContent") {
+                ok = json.readString(trace.initialText);
+            } else if (key == "endContent") {
+                ok = json.readString(trace.expectedText);
+                trace.hasExpectedText = ok;
+            } else if (key == "txns") {
+                ok = readTransactions(json, trace.events);
+            } else {
+                ok = json.skipValue();
+            }
+            ok = ok && json.next('}', more);
+        }
+
+        if (!ok || !json.ok()) {
+            error = json.getError().empty() ? "Traza JSON no válida" : json.getError();
+            return false;
+        }
+        if (trace.events.empty()) {
+            error = "La traza no contiene parches (\"txns\")";
+            return false;
+        }
+
+        // Las trazas publicadas no tienen tiempos útiles: orden secuencial
+        for (size_t i = 0; i < trace.events.size(); ++i) {
+            trace.events[i].timeUs = i;
+        }
+        *this = std::move(trace);
+        return true;
+    }
+
+    // ========================================================================
+    // Grabación
+    // ========================================================================
+
+    EditTraceRecorder::EditTraceRecorder() : recording_(false) {}
+
+    void EditTraceRecorder::start(const std::string& initialText, uint32_t windowWidth, uint32_t windowHeight) {
+        trace_ = EditTrace();
+        trace_.initialText = initialText;
+        trace_.windowWidth = windowWidth;
+        trace_.windowHeight = windowHeight;
+        startTime_ = std::chrono::steady_clock::now();
+        recording_ = true;
+    }
+
+    void EditTraceRecorder::stop() {
+        recording_ = false;
+    }
+
+    TraceEvent& EditTraceRecorder::append(TraceEventType type) {
+        TraceEvent event;
+        event.type = type;
+        event.timeUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime_).count());
+        trace_.events.push_back(std::move(event));
+        return trace_.events.back();
+    }
+
+    void EditTraceRecorder::recordKey(TraceKey key, uint8_t modifiers) {
+        if (!recording_) return;
+        TraceEvent& event = append(TraceEventType::Key);
+        event.key = key;
+        event.modifiers = modifiers;
+    }
+
+    void EditTraceRecorder::recordText(uint32_t codepoint) {
+        if (!recording_) return;
+        append(TraceEventType::Text).codepoint = codepoint;
+    }
+
+    void EditTraceRecorder::recordMouse(TraceEventType type, float x, float y, uint8_t button) {
+        if (!recording_) return;
+        TraceEvent& event = append(type);
+        event.x = x;
+        event.y = y;
+        event.button = button;
+    }
+
+    void EditTraceRecorder::recordScroll(float delta, bool horizontal) {
+        if (!recording_) return;
+        TraceEvent& event = append(TraceEventType::Scroll);
+        event.delta = delta;
+        event.horizontal = horizontal;
+    }
+
+    void EditTraceRecorder::recordResize(uint32_t width, uint32_t height) {
+        if (!recording_) return;
+        TraceEvent& event = append(TraceEventType::Resize);
+        event.width = width;
+        event.height = height;
+    }
+
+    void EditTraceRecorder::recordPaste(const std::string& text) {
+        if (!recording_) return;
+        append(TraceEventType::Paste).text = text;
+    }
+
+} // namespace CoralCode
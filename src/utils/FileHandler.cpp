@@ -0,0 +1,63 @@
+/**
+ * @file FileHandler.cpp
+ * @brief Lectura y guardado de archivos sobre la capa de E/S asíncrona
+ */
+
+#include "FileHandler.hpp"
+
+namespace CoralCode {
+
+    FileHandler::FileHandler(AsyncFileIO& io)
+        : io_(io), maxFileSize_(AsyncFileIO::DEFAULT_MAX_FILE_SIZE) {}
+
+    // ========================================================================
+    // Asíncrono
+    // ========================================================================
+
+    std::future<FileReadResult> FileHandler::readAsync(const std::string& path) const {
+        return io_.read(path, maxFileSize_);
+    }
+
+    std::future<FileWriteResult> FileHandler::writeAsync(const std::string& path, std::string content) const {
+        return io_.write(path, std::move(content));
+    }
+
+    std::vector<std::future<FileReadResult>> FileHandler::readAll(const std::vector<std::string>& paths) const {
+        // Se encola todo antes de esperar nada: el disco ve la cola completa
+        std::vector<std::future<FileReadResult>> results;
+        results.reserve(paths.size());
+        for (const std::string& path : paths) {
+            results.push_back(io_.read(path, maxFileSize_));
+        }
+        return results;
+    }
+
+    std::vector<std::future<FileWriteResult>> FileHandler::writeAll(
+        std::vector<std::pair<std::string, std::string>> files) const {
+        std::vector<std::future<FileWriteResult>> results;
+        results.reserve(files.size());
+        for (auto& file : files) {
+            results.push_back(io_.write(file.first, std::move(file.second)));
+        }
+        return results;
+    }
+
+    // ========================================================================
+    // Bloqueante
+    // ========================================================================
+
+    bool FileHandler::readFile(const std::string& path, std::string& content) {
+        FileReadResult result = readAsync(path).get();
+        lastError_ = std::move(result.error);
+        if (!result.success) return false;
+        content = std::move(result.content);
+        return true;
+    }
+
+    bool FileHandler::writeFile(const std::string& path, const std::string& content) {
+        FileWriteResult result = writeAsync(path, content).get();
+        lastError_ = std::move(result.error);
+        return result.success;
+    }
+
+} // namespace CoralCode
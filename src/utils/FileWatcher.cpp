@@ -0,0 +1,165 @@
+/**
+ * @file FileWatcher.cpp
+ * @brief Observación de cambios en el espacio de trabajo
+ */
+
+#include "FileWatcher.hpp"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+
+#ifdef __linux__
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace CoralCode {
+
+    FileWatcher::FileWatcher() : fd_(-1) {}
+
+    FileWatcher::~FileWatcher() {
+        stop();
+    }
+
+    bool FileWatcher::isSupported() {
+#ifdef __linux__
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool FileWatcher::start(const std::string& root, const WalkOptions& options) {
+        stop();
+        lastError_.clear();
+        root_ = root;
+        options_ = options;
+        options_.reportDirectories = true;
+        ignore_ = std::make_unique<IgnoreMatcher>(root, options);
+
+#ifdef __linux__
+        fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd_ < 0) {
+            lastError_ = std::string("inotify: ") + std::strerror(errno);
+            return false;
+        }
+        if (!addWatch("")) {
+            stop();
+            return false;
+        }
+        watchTree("");
+        return true;
+#else
+        lastError_ = "Observación de archivos no disponible en esta plataforma";
+        return false;
+#endif
+    }
+
+    void FileWatcher::stop() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+#endif
+        fd_ = -1;
+        watches_.clear();
+    }
+
+    void FileWatcher::watchTree(const std::string& relativeDirectory) {
+        // Los subdirectorios se recorren con las mismas reglas que el índice
+        WorkspaceWalker walker(options_);
+        std::vector<std::string> directories;
+        std::mutex mutex;
+        walker.walk(root_, relativeDirectory, [&](const WorkspaceFile& file, size_t) {
+            if (!file.isDirectory) return;
+            std::lock_guard<std::mutex> lock(mutex);
+            directories.push_back(file.relativePath);
+        });
+        for (const std::string& directory : directories) {
+            addWatch(directory);
+        }
+    }
+
+    bool FileWatcher::addWatch(const std::string& relativeDirectory) {
+#ifdef __linux__
+        const std::string path = relativeDirectory.empty()
+            ? root_ : (std::filesystem::path(root_) / relativeDirectory).string();
+        const uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE |
+                              IN_DELETE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW;
+        int wd = inotify_add_watch(fd_, path.c_str(), mask);
+        if (wd < 0) {
+            // ENOSPC: límite de fs.inotify.max_user_watches
+            lastError_ = "inotify (" + path + "): " + std::strerror(errno);
+            return false;
+        }
+        watches_[wd] = relativeDirectory;
+        return true;
+#else
+        (void)relativeDirectory;
+        return false;
+#endif
+    }
+
+    std::vector<FileEvent> FileWatcher::poll() {
+        std::vector<FileEvent> events;
+#ifdef __linux__
+        if (fd_ < 0) return events;
+
+        alignas(inotify_event) char buffer[64 * 1024];
+        while (true) {
+            ssize_t length = ::read(fd_, buffer, sizeof(buffer));
+            if (length <= 0) break;
+
+            for (ssize_t offset = 0; offset < length; ) {
+                inotify_event event;
+                std::memcpy(&event, buffer + offset, sizeof(event));
+                const char* name = buffer + offset + static_cast<ssize_t>(sizeof(inotify_event));
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event.len);
+
+                if (event.mask & IN_Q_OVERFLOW) {
+                    events.push_back(FileEvent{FileEventType::Overflow, std::string(), true});
+                    continue;
+                }
+                auto watch = watches_.find(event.wd);
+                if (watch == watches_.end()) continue;
+                if (event.mask & IN_IGNORED) {
+                    watches_.erase(watch);
+                    continue;
+                }
+                if (event.len == 0) continue;
+
+                const std::string& directory = watch->second;
+                std::string relative = directory.empty() ? std::string(name) : directory + "/" + name;
+                const bool isDirectory = (event.mask & IN_ISDIR) != 0;
+
+                if (std::strcmp(name, ".gitignore") == 0 || std::strcmp(name, ".ignore") == 0) {
+                    // Cambian las reglas: el índice debe revisar el árbol
+                    ignore_->invalidate();
+                    events.push_back(FileEvent{FileEventType::Overflow, std::string(), true});
+                    continue;
+                }
+                if (ignore_->isIgnored(relative, isDirectory)) continue;
+
+                FileEventType type;
+                if (event.mask & (IN_CREATE | IN_MOVED_TO)) {
+                    type = FileEventType::Created;
+                    if (isDirectory) {
+                        addWatch(relative);
+                        watchTree(relative);
+                    }
+                } else if (event.mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    type = FileEventType::Deleted;
+                } else if (event.mask & IN_CLOSE_WRITE) {
+                    type = FileEventType::Modified;
+                } else {
+                    continue;
+                }
+                events.push_back(FileEvent{type, std::move(relative), isDirectory});
+            }
+        }
+#endif
+        return events;
+    }
+
+} // namespace CoralCode
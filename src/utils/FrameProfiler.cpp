@@ -0,0 +1,252 @@
+/**
+ * @file FrameProfiler.cpp
+ * @brief Tiempos por fase de cada frame, historial sin bloqueos y percentiles
+ */
+
+#include "FrameProfiler.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace CoralCode {
+
+    namespace {
+
+        constexpr const char* PHASE_NAMES[FrameProfiler::PHASE_COUNT] = {
+            "Eventos", "Ediciones", "Resaltado", "Layout", "Draw", "display()"
+        };
+
+        // Percentiles sobre un búfer fijo (sin asignar memoria)
+        FrameMetric summarize(double* values, size_t count) {
+            FrameMetric metric;
+            if (count == 0) return metric;
+            auto at = [values, count](double fraction) {
+                size_t index = std::min(count - 1, static_cast<size_t>(fraction * static_cast<double>(count)));
+                std::nth_element(values, values + index, values + count);
+                return values[index];
+            };
+            metric.p50 = at(0.50);
+            metric.p99 = at(0.99);
+            metric.max = *std::max_element(values, values + count);
+            return metric;
+        }
+
+        // Tiempos con dos decimales; recuentos (sin unidad) enteros
+        void appendRow(std::string& out, const char* label, const FrameMetric& metric, const char* unit) {
+            char row[96];
+            if (*unit) {
+                std::snprintf(row, sizeof(row), "%-18s p50 %7.2f  p99 %7.2f %s\n", label, metric.p50, metric.p99, unit);
+            } else {
+                std::snprintf(row, sizeof(row), "%-18s p50 %7.0f  p99 %7.0f\n", label, metric.p50, metric.p99);
+            }
+            out += row;
+        }
+
+    } // namespace
+
+    FrameProfiler::FrameProfiler()
+        : enabled_(false), inFrame_(false), frameStart_(0), phaseStart_{}, phaseNs_{}, drawCalls_(0),
+          allocationsAtStart_(), written_(0) {}
+
+    FrameProfiler::~FrameProfiler() {
+        setEnabled(false);
+    }
+
+    void FrameProfiler::setEnabled(bool enabled) {
+        if (enabled == enabled_) return;
+        enabled_ = enabled;
+        inFrame_ = false;
+        if (enabled) {
+            AllocationTracker::retain();
+        } else {
+            AllocationTracker::release();
+        }
+    }
+
+    // ========================================================================
+    // Frame en curso
+    // ========================================================================
+
+    void FrameProfiler::beginFrame() {
+        if (!enabled_) return;
+        inFrame_ = true;
+        phaseNs_.fill(0);
+        phaseStart_.fill(0);
+        drawCalls_ = 0;
+        allocationsAtStart_ = AllocationTracker::snapshot();
+        frameStart_ = now();
+    }
+
+    void FrameProfiler::beginPhase(FramePhase phase) {
+        if (!inFrame_) return;
+        phaseStart_[static_cast<size_t>(phase)] = now();
+    }
+
+    void FrameProfiler::endPhase(FramePhase phase) {
+        if (!inFrame_) return;
+        const size_t index = static_cast<size_t>(phase);
+        if (phaseStart_[index] == 0) return;
+        phaseNs_[index] += now() - phaseStart_[index];
+        phaseStart_[index] = 0;
+    }
+
+    void FrameProfiler::addPhaseTime(FramePhase phase, uint64_t nanoseconds) {
+        if (!inFrame_) return;
+        phaseNs_[static_cast<size_t>(phase)] += nanoseconds;
+    }
+
+    void FrameProfiler::endFrame() {
+        if (!inFrame_) return;
+        inFrame_ = false;
+        const uint64_t end = now();
+        const AllocationCounts allocations = AllocationTracker::snapshot() - allocationsAtStart_;
+
+        const uint64_t index = written_.load(std::memory_order_relaxed);
+        Slot& slot = history_[index & (HISTORY_SIZE - 1)];
+
+        // Secuencia impar: los lectores descartan la entrada mientras tanto
+        const uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.frameNs.store(end - frameStart_, std::memory_order_relaxed);
+        for (size_t i = 0; i < PHASE_COUNT; ++i) {
+            slot.phaseNs[i].store(phaseNs_[i], std::memory_order_relaxed);
+        }
+        slot.drawCalls.store(drawCalls_, std::memory_order_relaxed);
+        slot.allocations.store(static_cast<uint32_t>(std::min<uint64_t>(allocations.total(), UINT32_MAX)),
+                               std::memory_order_relaxed);
+        for (size_t i = 0; i < AllocationTracker::SITE_COUNT; ++i) {
+            slot.siteAllocations[i].store(static_cast<uint32_t>(std::min<uint64_t>(allocations.count[i], UINT32_MAX)),
+                                          std::memory_order_relaxed);
+        }
+        slot.endTime.store(end, std::memory_order_relaxed);
+
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+        written_.store(index + 1, std::memory_order_release);
+    }
+
+    // ========================================================================
+    // Lectura del historial
+    // ========================================================================
+
+    FrameStats FrameProfiler::computeStats() const {
+        // Series en la pila: leer las estadísticas no asigna memoria
+        double frames[HISTORY_SIZE];
+        double phases[PHASE_COUNT][HISTORY_SIZE];
+        double draws[HISTORY_SIZE];
+        double allocations[HISTORY_SIZE];
+        double sites[AllocationTracker::SITE_COUNT][HISTORY_SIZE];
+        uint64_t firstEnd = UINT64_MAX;
+        uint64_t lastEnd = 0;
+        size_t count = 0;
+
+        const uint64_t written = written_.load(std::memory_order_acquire);
+        const uint64_t available = std::min<uint64_t>(written, HISTORY_SIZE);
+        for (uint64_t i = written - available; i < written; ++i) {
+            const Slot& slot = history_[i & (HISTORY_SIZE - 1)];
+            const uint64_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+
+            const double frameMs = static_cast<double>(slot.frameNs.load(std::memory_order_relaxed)) / 1e6;
+            double phaseMs[PHASE_COUNT];
+            for (size_t p = 0; p < PHASE_COUNT; ++p) {
+                phaseMs[p] = static_cast<double>(slot.phaseNs[p].load(std::memory_order_relaxed)) / 1e6;
+            }
+            const uint32_t drawCalls = slot.drawCalls.load(std::memory_order_relaxed);
+            const uint32_t allocated = slot.allocations.load(std::memory_order_relaxed);
+            uint32_t siteAllocated[AllocationTracker::SITE_COUNT];
+            for (size_t s = 0; s < AllocationTracker::SITE_COUNT; ++s) {
+                siteAllocated[s] = slot.siteAllocations[s].load(std::memory_order_relaxed);
+            }
+            const uint64_t endTime = slot.endTime.load(std::memory_order_relaxed);
+
+            // Sobrescrita durante la copia: se descarta
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != before) continue;
+
+            frames[count] = frameMs;
+            for (size_t p = 0; p < PHASE_COUNT; ++p) phases[p][count] = phaseMs[p];
+            draws[count] = drawCalls;
+            allocations[count] = allocated;
+            for (size_t s = 0; s < AllocationTracker::SITE_COUNT; ++s) sites[s][count] = siteAllocated[s];
+            firstEnd = std::min(firstEnd, endTime);
+            lastEnd = std::max(lastEnd, endTime);
+            ++count;
+        }
+
+        FrameStats stats;
+        stats.frames = count;
+        if (count == 0) return stats;
+
+        stats.frameMs = summarize(frames, count);
+        for (size_t p = 0; p < PHASE_COUNT; ++p) {
+            stats.phaseMs[p] = summarize(phases[p], count);
+        }
+        stats.drawCalls = summarize(draws, count);
+        stats.allocations = summarize(allocations, count);
+        for (size_t s = 0; s < AllocationTracker::SITE_COUNT; ++s) {
+            stats.siteAllocations[s] = summarize(sites[s], count);
+        }
+        if (count > 1 && lastEnd > firstEnd) {
+            stats.fps = static_cast<double>(count - 1) * 1e9 / static_cast<double>(lastEnd - firstEnd);
+        }
+        return stats;
+    }
+
+    // ========================================================================
+    // Texto
+    // ========================================================================
+
+    const char* FrameProfiler::phaseName(FramePhase phase) {
+        const size_t index = static_cast<size_t>(phase);
+        return index < PHASE_COUNT ? PHASE_NAMES[index] : "?";
+    }
+
+    std::string FrameProfiler::formatOverlay(const FrameStats& stats) {
+        std::string out;
+        char header[96];
+        std::snprintf(header, sizeof(header), "Frame              p50 %7.2f  p99 %7.2f ms  %5.1f fps\n",
+                      stats.frameMs.p50, stats.frameMs.p99, stats.fps);
+        out += header;
+        for (size_t p = 0; p < PHASE_COUNT; ++p) {
+            appendRow(out, phaseName(static_cast<FramePhase>(p)), stats.phaseMs[p], "ms");
+        }
+        appendRow(out, "Draw calls", stats.drawCalls, "");
+        appendRow(out, "Asignaciones", stats.allocations, "");
+        // Solo los sitios que asignan en algún frame reciente
+        for (size_t s = 0; s < AllocationTracker::SITE_COUNT; ++s) {
+            if (stats.siteAllocations[s].max > 0.0) {
+                char label[32];
+                std::snprintf(label, sizeof(label), "  %s", AllocationTracker::siteName(static_cast<AllocationSite>(s)));
+                appendRow(out, label, stats.siteAllocations[s], "");
+            }
+        }
+        out.pop_back();
+        return out;
+    }
+
+    std::string FrameProfiler::formatSummary(const FrameStats& stats) {
+        std::string out;
+        char text[128];
+        std::snprintf(text, sizeof(text), "%zu frames, frame p50 %.2f ms p99 %.2f ms (máx %.2f)", stats.frames,
+                      stats.frameMs.p50, stats.frameMs.p99, stats.frameMs.max);
+        out += text;
+        for (size_t p = 0; p < PHASE_COUNT; ++p) {
+            std::snprintf(text, sizeof(text), ", %s p99 %.2f", phaseName(static_cast<FramePhase>(p)),
+                          stats.phaseMs[p].p99);
+            out += text;
+        }
+        std::snprintf(text, sizeof(text), ", draw calls p99 %.0f, asignaciones p99 %.0f", stats.drawCalls.p99,
+                      stats.allocations.p99);
+        out += text;
+        for (size_t s = 0; s < AllocationTracker::SITE_COUNT; ++s) {
+            if (stats.siteAllocations[s].p99 > 0.0) {
+                std::snprintf(text, sizeof(text), " (%s %.0f)", AllocationTracker::siteName(static_cast<AllocationSite>(s)),
+                              stats.siteAllocations[s].p99);
+                out += text;
+            }
+        }
+        return out;
+    }
+
+} // namespace CoralCode
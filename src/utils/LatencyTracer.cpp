@@ -0,0 +1,271 @@
+/**
+ * @file LatencyTracer.cpp
+ * @brief Búferes de spans por hilo y exportación a trazas de Chrome/Perfetto
+ */
+
+#include "LatencyTracer.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace CoralCode {
+
+    namespace {
+
+        std::atomic<uint64_t> g_nextInstance{1};
+
+        // Búfer del hilo actual para el último trazador usado
+        struct ThreadCache {
+            uint64_t instance = 0;
+            void* buffer = nullptr;
+            const char* name = nullptr;
+        };
+        thread_local ThreadCache tCache;
+
+        std::string escapeJson(const char* text) {
+            std::string out;
+            for (const char* ch = text ? text : ""; *ch; ++ch) {
+                switch (*ch) {
+                    case '"': out += "\\\""; break;
+                    case '\\': out += "\\\\"; break;
+                    case '\n': out += "\\n"; break;
+                    case '\t': out += "\\t"; break;
+                    default:
+                        if (static_cast<unsigned char>(*ch) < 0x20) {
+                            char escaped[8];
+                            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(*ch));
+                            out += escaped;
+                        } else {
+                            out += *ch;
+                        }
+                }
+            }
+            return out;
+        }
+
+        // Microsegundos desde el origen, con resolución de nanosegundo
+        std::string microseconds(uint64_t timestamp, uint64_t origin) {
+            const uint64_t ns = timestamp > origin ? timestamp - origin : 0;
+            char text[32];
+            std::snprintf(text, sizeof(text), "%llu.%03u", static_cast<unsigned long long>(ns / 1000),
+                          static_cast<unsigned>(ns % 1000));
+            return text;
+        }
+
+    } // namespace
+
+    LatencyTracer::LatencyTracer()
+        : enabled_(false), nextId_(1), origin_(now()),
+          instance_(g_nextInstance.fetch_add(1, std::memory_order_relaxed)) {}
+
+    LatencyTracer::~LatencyTracer() = default;
+
+    LatencyTracer& LatencyTracer::shared() {
+        // Nunca se destruye: los hilos pueden seguir trazando al salir
+        static LatencyTracer* tracer = new LatencyTracer();
+        return *tracer;
+    }
+
+    void LatencyTracer::setEnabled(bool enabled) {
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    void LatencyTracer::setThreadName(const char* name) {
+        tCache.name = name;
+    }
+
+    const char* LatencyTracer::intern(const std::string& name) {
+        std::lock_guard<std::mutex> lock(internMutex_);
+        return interned_.insert(name).first->c_str();
+    }
+
+    // ========================================================================
+    // Registro
+    // ========================================================================
+
+    LatencyTracer::ThreadBuffer& LatencyTracer::currentBuffer() {
+        if (tCache.instance == instance_) {
+            return *static_cast<ThreadBuffer*>(tCache.buffer);
+        }
+
+        // Primera vez en este hilo: único momento con bloqueo
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->name = tCache.name;
+        ThreadBuffer* raw = buffer.get();
+        {
+            std::lock_guard<std::mutex> lock(buffersMutex_);
+            buffer->track = static_cast<uint32_t>(buffers_.size() + 1);
+            buffers_.push_back(std::move(buffer));
+        }
+        tCache.instance = instance_;
+        tCache.buffer = raw;
+        return *raw;
+    }
+
+    void LatencyTracer::record(RecordKind kind, const char* category, const char* name, uint64_t start,
+                               uint64_t end, uint64_t id) {
+        ThreadBuffer& buffer = currentBuffer();
+        const uint64_t index = buffer.written.load(std::memory_order_relaxed);
+        Record& entry = buffer.records[index & (RECORDS_PER_THREAD - 1)];
+
+        entry.kind.store(static_cast<uint8_t>(kind), std::memory_order_relaxed);
+        entry.category.store(category, std::memory_order_relaxed);
+        entry.name.store(name, std::memory_order_relaxed);
+        entry.start.store(start, std::memory_order_relaxed);
+        entry.end.store(end, std::memory_order_relaxed);
+        entry.id.store(id, std::memory_order_relaxed);
+
+        // Publica la entrada: el exportador no lee más allá de written
+        buffer.written.store(index + 1, std::memory_order_release);
+    }
+
+    void LatencyTracer::span(const char* category, const char* name, uint64_t start, uint64_t end, uint64_t id) {
+        if (!isEnabled()) return;
+        record(RecordKind::Span, category, name, start, end, id);
+    }
+
+    void LatencyTracer::asyncSpan(const char* category, const char* name, uint64_t id, uint64_t start,
+                                  uint64_t end) {
+        if (!isEnabled()) return;
+        record(RecordKind::Async, category, name, start, end, id);
+    }
+
+    void LatencyTracer::flow(TraceFlow phase, uint64_t id, uint64_t timestamp) {
+        if (!isEnabled()) return;
+        RecordKind kind = RecordKind::FlowStep;
+        if (phase == TraceFlow::Start) kind = RecordKind::FlowStart;
+        else if (phase == TraceFlow::End) kind = RecordKind::FlowEnd;
+        record(kind, "input", "input", timestamp, timestamp, id);
+    }
+
+    // ========================================================================
+    // Exportación
+    // ========================================================================
+
+    std::vector<LatencyTracer::RecordCopy> LatencyTracer::snapshot(
+        std::vector<std::pair<uint32_t, const char*>>& tracks) const {
+        std::vector<RecordCopy> copies;
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+
+        for (const auto& buffer : buffers_) {
+            tracks.emplace_back(buffer->track, buffer->name);
+
+            const uint64_t written = buffer->written.load(std::memory_order_acquire);
+            const uint64_t cleared = buffer->cleared.load(std::memory_order_relaxed);
+            uint64_t first = written > RECORDS_PER_THREAD ? written - RECORDS_PER_THREAD : 0;
+            first = std::max(first, cleared);
+            const size_t base = copies.size();
+
+            for (uint64_t i = first; i < written; ++i) {
+                const Record& entry = buffer->records[i & (RECORDS_PER_THREAD - 1)];
+                copies.push_back(RecordCopy{static_cast<RecordKind>(entry.kind.load(std::memory_order_relaxed)),
+                                            entry.category.load(std::memory_order_relaxed),
+                                            entry.name.load(std::memory_order_relaxed),
+                                            entry.start.load(std::memory_order_relaxed),
+                                            entry.end.load(std::memory_order_relaxed),
+                                            entry.id.load(std::memory_order_relaxed), buffer->track});
+            }
+
+            // Lo que el hilo alcanzó a sobrescribir mientras se copiaba se descarta
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t after = buffer->written.load(std::memory_order_relaxed);
+            const uint64_t valid = after > RECORDS_PER_THREAD ? after - RECORDS_PER_THREAD : 0;
+            if (valid > first) {
+                const size_t stale = static_cast<size_t>(std::min(valid, written) - first);
+                copies.erase(copies.begin() + static_cast<std::ptrdiff_t>(base),
+                             copies.begin() + static_cast<std::ptrdiff_t>(base + stale));
+            }
+        }
+        return copies;
+    }
+
+    void LatencyTracer::writeChromeTrace(std::ostream& out) const {
+        std::vector<std::pair<uint32_t, const char*>> tracks;
+        std::vector<RecordCopy> records = snapshot(tracks);
+        std::sort(records.begin(), records.end(),
+                  [](const RecordCopy& a, const RecordCopy& b) { return a.start < b.start; });
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        out << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"args\":{\"name\":\"CoralCode\"}}";
+        for (const auto& track : tracks) {
+            const std::string name = track.second ? escapeJson(track.second) : "Hilo " + std::to_string(track.first);
+            out << ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << track.first
+                << ",\"args\":{\"name\":\"" << name << "\"}}";
+        }
+
+        for (const RecordCopy& record : records) {
+            const std::string ts = microseconds(record.start, origin_);
+            const std::string common = "\"pid\":1,\"tid\":" + std::to_string(record.track) + ",\"ts\":" + ts;
+            switch (record.kind) {
+                case RecordKind::Span:
+                    out << ",\n{\"ph\":\"X\",\"cat\":\"" << escapeJson(record.category) << "\",\"name\":\""
+                        << escapeJson(record.name) << "\"," << common << ",\"dur\":"
+                        << microseconds(record.end, record.start);
+                    if (record.id != 0) out << ",\"args\":{\"input\":" << record.id << "}";
+                    out << "}";
+                    break;
+
+                case RecordKind::Async: {
+                    // Pareja b/e: Perfetto la dibuja en una pista por nombre
+                    const std::string head = ",\n{\"cat\":\"" + escapeJson(record.category) + "\",\"name\":\"" +
+                                             escapeJson(record.name) + "\",\"id\":" + std::to_string(record.id) +
+                                             ",\"pid\":1,\"tid\":" + std::to_string(record.track);
+                    out << head << ",\"ph\":\"b\",\"ts\":" << ts << "}";
+                    out << head << ",\"ph\":\"e\",\"ts\":" << microseconds(record.end, origin_) << "}";
+                    break;
+                }
+
+                case RecordKind::FlowStart:
+                case RecordKind::FlowStep:
+                case RecordKind::FlowEnd: {
+                    const char* phase = record.kind == RecordKind::FlowStart ? "s"
+                                      : record.kind == RecordKind::FlowStep ? "t" : "f";
+                    out << ",\n{\"ph\":\"" << phase << "\",\"cat\":\"input\",\"name\":\"input\",\"id\":"
+                        << record.id << "," << common;
+                    // El final se engancha al span que lo contiene
+                    if (record.kind == RecordKind::FlowEnd) out << ",\"bp\":\"e\"";
+                    out << "}";
+                    break;
+                }
+
+                default:
+                    break;
+            }
+        }
+        out << "\n]}\n";
+    }
+
+    bool LatencyTracer::exportChromeTrace(const std::string& path, std::string& error) const {
+        std::ofstream out(path, std::ios::binary);
+        if (!out) {
+            error = "No se pudo abrir " + path;
+            return false;
+        }
+        writeChromeTrace(out);
+        out.flush();
+        if (!out) {
+            error = "Error escribiendo " + path;
+            return false;
+        }
+        return true;
+    }
+
+    size_t LatencyTracer::getRecordCount() const {
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        size_t count = 0;
+        for (const auto& buffer : buffers_) {
+            const uint64_t written = buffer->written.load(std::memory_order_acquire);
+            const uint64_t cleared = buffer->cleared.load(std::memory_order_relaxed);
+            count += static_cast<size_t>(std::min<uint64_t>(written - std::min(written, cleared), RECORDS_PER_THREAD));
+        }
+        return count;
+    }
+
+    void LatencyTracer::clear() {
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        for (const auto& buffer : buffers_) {
+            buffer->cleared.store(buffer->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+    }
+
+} // namespace CoralCode
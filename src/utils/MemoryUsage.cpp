@@ -0,0 +1,76 @@
+/**
+ * @file MemoryUsage.cpp
+ * @brief Formato del desglose de memoria por subsistema
+ */
+
+#include "MemoryUsage.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace CoralCode {
+
+    namespace {
+
+        constexpr const char* SUBSYSTEM_NAMES[MemoryUsage::SUBSYSTEM_COUNT] = {
+            "buffer", "índice de líneas", "historial de undo", "caché de tokens", "atlas de glifos",
+            "minimapa", "índice de búsqueda", "historial del portapapeles", "autocompletado", "índice de archivos"
+        };
+
+    } // namespace
+
+    size_t MemoryUsage::total() const {
+        size_t sum = 0;
+        for (size_t value : bytes) sum += value;
+        return sum;
+    }
+
+    MemorySubsystem MemoryUsage::largest() const {
+        auto it = std::max_element(bytes.begin(), bytes.end());
+        return static_cast<MemorySubsystem>(it - bytes.begin());
+    }
+
+    const char* MemoryUsage::subsystemName(MemorySubsystem subsystem) {
+        const size_t index = static_cast<size_t>(subsystem);
+        return index < SUBSYSTEM_COUNT ? SUBSYSTEM_NAMES[index] : "?";
+    }
+
+    std::string MemoryUsage::formatBytes(size_t value) {
+        char text[32];
+        const double amount = static_cast<double>(value);
+        if (value < 1024) {
+            std::snprintf(text, sizeof(text), "%zu B", value);
+        } else if (value < 1024 * 1024) {
+            std::snprintf(text, sizeof(text), "%.1f KB", amount / 1024.0);
+        } else if (value < size_t(1024) * 1024 * 1024) {
+            std::snprintf(text, sizeof(text), "%.1f MB", amount / (1024.0 * 1024.0));
+        } else {
+            std::snprintf(text, sizeof(text), "%.2f GB", amount / (1024.0 * 1024.0 * 1024.0));
+        }
+        return text;
+    }
+
+    std::string MemoryUsage::formatStatus() const {
+        const MemorySubsystem top = largest();
+        return "Memoria: " + formatBytes(total()) + " (" + subsystemName(top) + " " + formatBytes((*this)[top]) + ")";
+    }
+
+    std::string MemoryUsage::formatReport() const {
+        std::array<size_t, SUBSYSTEM_COUNT> order;
+        for (size_t i = 0; i < SUBSYSTEM_COUNT; ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return bytes[a] > bytes[b]; });
+
+        const size_t sum = total();
+        std::string report = "Memoria por subsistema:\n";
+        char row[128];
+        for (size_t index : order) {
+            const double share = sum > 0 ? 100.0 * static_cast<double>(bytes[index]) / static_cast<double>(sum) : 0.0;
+            std::snprintf(row, sizeof(row), "  %-28s %12s  %5.1f%%\n", SUBSYSTEM_NAMES[index],
+                          formatBytes(bytes[index]).c_str(), share);
+            report += row;
+        }
+        std::snprintf(row, sizeof(row), "  %-28s %12s\n", "total", formatBytes(sum).c_str());
+        report += row;
+        return report;
+    }
+
+} // namespace CoralCode
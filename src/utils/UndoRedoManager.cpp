@@ -0,0 +1,312 @@
+/**
+ * @file UndoRedoManager.cpp
+ * @brief Historial de undo/redo con copias completas y registros compactos
+ */
+
+#include "UndoRedoManager.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace CoralCode {
+
+    namespace {
+
+        bool editsAreEqual(const TextEdit& a, const TextEdit& b) {
+            return a.line == b.line && a.column == b.column && a.endLine == b.endLine &&
+                   a.endColumn == b.endColumn && a.text == b.text;
+        }
+
+    } // namespace
+
+    UndoRedoManager::UndoRedoManager(size_t maxHistorySize)
+        : maxHistorySize_(std::max<size_t>(maxHistorySize, 1)), inCompoundOperation_(false),
+          currentGroupSize_(0) {}
+
+    // ========================================================================
+    // Gestión del historial
+    // ========================================================================
+
+    void UndoRedoManager::saveState(const TextBuffer& buffer, const CursorPosition& cursor,
+                                    OperationType operation, const std::string& description) {
+        EditorState state(buffer.getLines(0, buffer.getLineCount()), cursor, operation, description);
+
+        if (inCompoundOperation_) {
+            // Solo el estado previo a la primera edición del grupo
+            if (!compoundStartState_) {
+                state.operation = OperationType::Compound;
+                state.description = compoundDescription_;
+                compoundStartState_ = std::make_unique<EditorState>(std::move(state));
+            } else if (compoundStartState_->isDelta) {
+                // El grupo empezó con ediciones compactas: se deshacen sobre
+                // esta copia para obtener la copia previa al grupo
+                TextBuffer before(state.lines);
+                CursorPosition startCursor;
+                restoreState(std::move(*compoundStartState_), before, startCursor);
+                *compoundStartState_ = EditorState(before.getLines(0, before.getLineCount()), startCursor,
+                                                   OperationType::Compound, compoundDescription_);
+            }
+            return;
+        }
+
+        if (shouldGroupWithPrevious(state)) {
+            // La copia anterior ya representa el estado previo al grupo
+            undoHistory_.back().timestamp = state.timestamp;
+            ++currentGroupSize_;
+            return;
+        }
+        addToHistory(std::move(state));
+    }
+
+    void UndoRedoManager::recordEdits(std::vector<TextEdit> inverseEdits, const CursorPosition& cursor,
+                                      OperationType operation, const std::string& description) {
+        if (inverseEdits.empty()) return;
+
+        if (inCompoundOperation_) {
+            if (!compoundStartState_) {
+                compoundStartState_ = std::make_unique<EditorState>(std::move(inverseEdits), cursor,
+                                                                    OperationType::Compound, compoundDescription_);
+            } else if (compoundStartState_->isDelta) {
+                // Otro lote del mismo grupo: se deshará antes que los anteriores
+                EditorState& group = *compoundStartState_;
+                if (group.batchEnds.empty()) group.batchEnds.push_back(group.edits.size());
+                group.edits.insert(group.edits.end(), std::make_move_iterator(inverseEdits.begin()),
+                                   std::make_move_iterator(inverseEdits.end()));
+                group.batchEnds.push_back(group.edits.size());
+            }
+            // Con copia inicial, la copia ya cubre esta edición
+            return;
+        }
+
+        addToHistory(EditorState(std::move(inverseEdits), cursor, operation, description));
+    }
+
+    bool UndoRedoManager::undo(TextBuffer& buffer, CursorPosition& cursor) {
+        if (undoHistory_.empty()) return false;
+
+        EditorState state = std::move(undoHistory_.back());
+        undoHistory_.pop_back();
+        redoHistory_.push_back(restoreState(std::move(state), buffer, cursor));
+        currentGroupSize_ = 0;
+        return true;
+    }
+
+    bool UndoRedoManager::redo(TextBuffer& buffer, CursorPosition& cursor) {
+        if (redoHistory_.empty()) return false;
+
+        EditorState state = std::move(redoHistory_.back());
+        redoHistory_.pop_back();
+        undoHistory_.push_back(restoreState(std::move(state), buffer, cursor));
+        currentGroupSize_ = 0;
+        trimHistoryIfNeeded();
+        return true;
+    }
+
+    EditorState UndoRedoManager::restoreState(EditorState state, TextBuffer& buffer, CursorPosition& cursor) {
+        // Devuelve el estado opuesto, del mismo tipo, para la otra pila
+        EditorState opposite;
+        if (state.isDelta && state.batchEnds.empty()) {
+            opposite = EditorState(buffer.applyEdits(state.edits), cursor, state.operation, state.description);
+        } else if (state.isDelta) {
+            // Lotes en orden inverso; sus inversas quedan a su vez en orden inverso
+            opposite = EditorState(std::vector<TextEdit>(), cursor, state.operation, state.description);
+            for (size_t batch = state.batchEnds.size(); batch-- > 0;) {
+                const size_t begin = batch > 0 ? state.batchEnds[batch - 1] : 0;
+                auto first = state.edits.begin() + static_cast<std::ptrdiff_t>(begin);
+                auto last = state.edits.begin() + static_cast<std::ptrdiff_t>(state.batchEnds[batch]);
+                std::vector<TextEdit> edits(std::make_move_iterator(first), std::make_move_iterator(last));
+                std::vector<TextEdit> inverse = buffer.applyEdits(edits);
+                opposite.edits.insert(opposite.edits.end(), std::make_move_iterator(inverse.begin()),
+                                      std::make_move_iterator(inverse.end()));
+                opposite.batchEnds.push_back(opposite.edits.size());
+            }
+        } else {
+            opposite = EditorState(buffer.getLines(0, buffer.getLineCount()), cursor,
+                                   state.operation, state.description);
+            buffer.setLines(std::move(state.lines));
+        }
+        cursor = state.cursor;
+        return opposite;
+    }
+
+    // ========================================================================
+    // Estado del historial
+    // ========================================================================
+
+    bool UndoRedoManager::canUndo() const {
+        return !undoHistory_.empty();
+    }
+
+    bool UndoRedoManager::canRedo() const {
+        return !redoHistory_.empty();
+    }
+
+    size_t UndoRedoManager::getUndoCount() const {
+        return undoHistory_.size();
+    }
+
+    size_t UndoRedoManager::getRedoCount() const {
+        return redoHistory_.size();
+    }
+
+    // ========================================================================
+    // Configuración
+    // ========================================================================
+
+    void UndoRedoManager::setMaxHistorySize(size_t size) {
+        maxHistorySize_ = std::max<size_t>(size, 1);
+        trimHistoryIfNeeded();
+    }
+
+    size_t UndoRedoManager::getMaxHistorySize() const {
+        return maxHistorySize_;
+    }
+
+    void UndoRedoManager::clear() {
+        undoHistory_.clear();
+        redoHistory_.clear();
+        compoundStartState_.reset();
+        inCompoundOperation_ = false;
+        compoundDescription_.clear();
+        currentGroupSize_ = 0;
+    }
+
+    // ========================================================================
+    // Agrupación de operaciones
+    // ========================================================================
+
+    void UndoRedoManager::beginCompoundOperation(const std::string& description) {
+        if (inCompoundOperation_) return;
+        inCompoundOperation_ = true;
+        compoundDescription_ = description;
+        compoundStartState_.reset();
+    }
+
+    void UndoRedoManager::endCompoundOperation() {
+        if (!inCompoundOperation_) return;
+        inCompoundOperation_ = false;
+        if (compoundStartState_) {
+            addToHistory(std::move(*compoundStartState_));
+            compoundStartState_.reset();
+        }
+        compoundDescription_.clear();
+    }
+
+    bool UndoRedoManager::isInCompoundOperation() const {
+        return inCompoundOperation_;
+    }
+
+    // ========================================================================
+    // Información del historial
+    // ========================================================================
+
+    std::string UndoRedoManager::getUndoDescription() const {
+        return undoHistory_.empty() ? std::string() : undoHistory_.back().description;
+    }
+
+    std::string UndoRedoManager::getRedoDescription() const {
+        return redoHistory_.empty() ? std::string() : redoHistory_.back().description;
+    }
+
+    std::vector<std::string> UndoRedoManager::getHistoryDescriptions() const {
+        std::vector<std::string> descriptions;
+        descriptions.reserve(undoHistory_.size());
+        for (const EditorState& state : undoHistory_) {
+            descriptions.push_back(state.description);
+        }
+        return descriptions;
+    }
+
+    // ========================================================================
+    // Optimización de memoria
+    // ========================================================================
+
+    void UndoRedoManager::compactHistory() {
+        // Copias consecutivas iguales: la operación entre ambas no cambió nada.
+        // Los registros compactos nunca se fusionan (cada uno deshace algo).
+        auto duplicate = std::unique(undoHistory_.begin(), undoHistory_.end(),
+                                     [this](const EditorState& a, const EditorState& b) {
+                                         return !a.isDelta && statesAreEqual(a, b);
+                                     });
+        undoHistory_.erase(duplicate, undoHistory_.end());
+
+        for (EditorState& state : undoHistory_) {
+            state.lines.shrink_to_fit();
+            state.edits.shrink_to_fit();
+            state.batchEnds.shrink_to_fit();
+        }
+        undoHistory_.shrink_to_fit();
+        redoHistory_.shrink_to_fit();
+    }
+
+    size_t UndoRedoManager::getMemoryUsage() const {
+        size_t total = 0;
+        for (const EditorState& state : undoHistory_) {
+            total += calculateStateSize(state);
+        }
+        for (const EditorState& state : redoHistory_) {
+            total += calculateStateSize(state);
+        }
+        return total;
+    }
+
+    // ========================================================================
+    // Métodos internos
+    // ========================================================================
+
+    void UndoRedoManager::addToHistory(EditorState state) {
+        clearRedoHistory();
+        undoHistory_.push_back(std::move(state));
+        currentGroupSize_ = 1;
+        trimHistoryIfNeeded();
+    }
+
+    void UndoRedoManager::clearRedoHistory() {
+        redoHistory_.clear();
+    }
+
+    bool UndoRedoManager::shouldGroupWithPrevious(const EditorState& newState) const {
+        if (undoHistory_.empty() || !redoHistory_.empty()) return false;
+
+        const EditorState& previous = undoHistory_.back();
+        if (previous.isDelta || previous.operation != newState.operation) return false;
+        if (newState.operation != OperationType::Insert && newState.operation != OperationType::Delete) {
+            return false;
+        }
+        return newState.timestamp - previous.timestamp <= MAX_GROUP_TIME &&
+               currentGroupSize_ < MAX_GROUP_SIZE;
+    }
+
+    void UndoRedoManager::trimHistoryIfNeeded() {
+        while (undoHistory_.size() > maxHistorySize_) {
+            undoHistory_.pop_front();
+        }
+        while (redoHistory_.size() > maxHistorySize_) {
+            redoHistory_.pop_front();
+        }
+    }
+
+    // ========================================================================
+    // Utilidades
+    // ========================================================================
+
+    size_t UndoRedoManager::calculateStateSize(const EditorState& state) const {
+        size_t size = sizeof(EditorState) + state.description.capacity();
+        size += state.lines.capacity() * sizeof(std::string);
+        for (const std::string& line : state.lines) {
+            size += line.capacity();
+        }
+        size += state.edits.capacity() * sizeof(TextEdit) + state.batchEnds.capacity() * sizeof(size_t);
+        for (const TextEdit& edit : state.edits) {
+            size += edit.text.capacity();
+        }
+        return size;
+    }
+
+    bool UndoRedoManager::statesAreEqual(const EditorState& a, const EditorState& b) const {
+        if (a.isDelta != b.isDelta || a.cursor != b.cursor) return false;
+        if (!a.isDelta) return a.lines == b.lines;
+        if (a.batchEnds != b.batchEnds) return false;
+        return std::equal(a.edits.begin(), a.edits.end(), b.edits.begin(), b.edits.end(), editsAreEqual);
+    }
+
+} // namespace CoralCode
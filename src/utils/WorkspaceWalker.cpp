@@ -0,0 +1,366 @@
+/**
+ * @file WorkspaceWalker.cpp
+ * @brief Recorrido paralelo del espacio de trabajo con reglas de ignore
+ */
+
+#include "WorkspaceWalker.hpp"
+#include "TaskScheduler.hpp"
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CoralCode {
+
+    namespace fs = std::filesystem;
+
+    // ========================================================================
+    // Reglas de ignore
+    // ========================================================================
+
+    /**
+     * @brief Reglas de los archivos de ignore de un directorio
+     *
+     * Cada conjunto apunta al de su directorio padre; el más profundo tiene
+     * prioridad y, dentro de un conjunto, gana la última regla que coincide.
+     */
+    class IgnoreRules {
+    public:
+        static std::shared_ptr<const IgnoreRules> load(const std::string& directory, const std::string& base,
+                                                       std::shared_ptr<const IgnoreRules> parent) {
+            auto rules = std::make_shared<IgnoreRules>();
+            for (const char* name : {".gitignore", ".ignore"}) {
+                std::ifstream file(fs::path(directory) / name);
+                if (file) rules->parse(file);
+            }
+            if (rules->rules_.empty()) return parent;
+
+            rules->base_ = base;
+            rules->parent_ = std::move(parent);
+            return rules;
+        }
+
+        bool isIgnored(const std::string& relativePath, bool isDirectory) const {
+            for (const IgnoreRules* set = this; set; set = set->parent_.get()) {
+                const char* local = relativePath.c_str() + set->base_.length();
+                const char* name = std::strrchr(local, '/');
+                name = name ? name + 1 : local;
+
+                for (auto rule = set->rules_.rbegin(); rule != set->rules_.rend(); ++rule) {
+                    if (rule->directoryOnly && !isDirectory) continue;
+                    if (WorkspaceWalker::globMatch(rule->pattern.c_str(), rule->anchored ? local : name)) {
+                        return !rule->negated;
+                    }
+                }
+            }
+            return false;
+        }
+
+    private:
+        struct Rule {
+            std::string pattern;
+            bool negated;
+            bool directoryOnly;
+            bool anchored;
+        };
+
+        // Directorio de las reglas relativo a la raíz ("" o "a/b/")
+        std::string base_;
+        std::vector<Rule> rules_;
+        std::shared_ptr<const IgnoreRules> parent_;
+
+        void parse(std::istream& input) {
+            std::string line;
+            while (std::getline(input, line)) {
+                while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+                    line.pop_back();
+                }
+                if (line.empty() || line[0] == '#') continue;
+
+                Rule rule{line, false, false, false};
+                if (rule.pattern[0] == '!') {
+                    rule.negated = true;
+                    rule.pattern.erase(0, 1);
+                } else if (rule.pattern[0] == '\\') {
+                    rule.pattern.erase(0, 1);
+                }
+                if (!rule.pattern.empty() && rule.pattern.back() == '/') {
+                    rule.directoryOnly = true;
+                    rule.pattern.pop_back();
+                }
+                // Con una barra interna el patrón se ancla al directorio de las reglas
+                rule.anchored = rule.pattern.find('/') != std::string::npos;
+                if (!rule.pattern.empty() && rule.pattern[0] == '/') {
+                    rule.pattern.erase(0, 1);
+                }
+                if (!rule.pattern.empty()) {
+                    rules_.push_back(std::move(rule));
+                }
+            }
+        }
+    };
+
+    IgnoreMatcher::IgnoreMatcher(const std::string& root, const WalkOptions& options)
+        : root_(root), options_(options) {}
+
+    bool IgnoreMatcher::isIgnored(const std::string& relativePath, bool isDirectory) {
+        // Cada componente debe pasar las reglas de su directorio padre
+        size_t start = 0;
+        while (true) {
+            size_t slash = relativePath.find('/', start);
+            bool last = slash == std::string::npos;
+            std::string name = relativePath.substr(start, last ? std::string::npos : slash - start);
+            if (name == ".git" || (!options_.includeHidden && !name.empty() && name[0] == '.')) return true;
+
+            std::string parent = start == 0 ? std::string() : relativePath.substr(0, start - 1);
+            std::string path = last ? relativePath : relativePath.substr(0, slash);
+            auto rules = rulesFor(parent);
+            if (rules && rules->isIgnored(path, last ? isDirectory : true)) return true;
+
+            if (last) return false;
+            start = slash + 1;
+        }
+    }
+
+    void IgnoreMatcher::invalidate() {
+        cache_.clear();
+    }
+
+    std::shared_ptr<const IgnoreRules> IgnoreMatcher::rulesFor(const std::string& directory) {
+        if (!options_.respectIgnoreFiles) return nullptr;
+
+        auto cached = cache_.find(directory);
+        if (cached != cache_.end()) return cached->second;
+
+        std::shared_ptr<const IgnoreRules> parent;
+        if (!directory.empty()) {
+            size_t slash = directory.rfind('/');
+            parent = rulesFor(slash == std::string::npos ? std::string() : directory.substr(0, slash));
+        }
+        std::string path = directory.empty() ? root_ : (fs::path(root_) / directory).string();
+        auto rules = IgnoreRules::load(path, directory.empty() ? std::string() : directory + "/", parent);
+        cache_.emplace(directory, rules);
+        return rules;
+    }
+
+    bool WorkspaceWalker::globMatch(const char* pattern, const char* text) {
+        while (*pattern) {
+            switch (*pattern) {
+                case '*': {
+                    if (pattern[1] == '*') {
+                        // "**/" abarca cero o más directorios; "**" al final, todo
+                        pattern += 2;
+                        bool slash = *pattern == '/';
+                        if (slash) ++pattern;
+                        if (!*pattern) return true;
+                        for (const char* start = text; ; ++start) {
+                            if ((!slash || start == text || start[-1] == '/') && globMatch(pattern, start)) {
+                                return true;
+                            }
+                            if (!*start) return false;
+                        }
+                    }
+                    ++pattern;
+                    for (const char* start = text; ; ++start) {
+                        if (globMatch(pattern, start)) return true;
+                        if (!*start || *start == '/') return false;
+                    }
+                }
+                case '?':
+                    if (!*text || *text == '/') return false;
+                    ++pattern;
+                    ++text;
+                    break;
+                case '[': {
+                    const char* close = pattern + 1;
+                    if (*close == '!' || *close == '^') ++close;
+                    if (*close == ']') ++close;
+                    while (*close && *close != ']') ++close;
+                    if (!*close) {
+                        // Clase sin cerrar: '[' literal
+                        if (*text != '[') return false;
+                        ++pattern;
+                        ++text;
+                        break;
+                    }
+                    if (!*text || *text == '/') return false;
+
+                    const char* cursor = pattern + 1;
+                    bool negated = *cursor == '!' || *cursor == '^';
+                    if (negated) ++cursor;
+                    bool matched = false;
+                    for (bool first = true; first || cursor < close; first = false) {
+                        if (cursor + 2 < close && cursor[1] == '-') {
+                            matched = matched || (*text >= cursor[0] && *text <= cursor[2]);
+                            cursor += 3;
+                        } else {
+                            matched = matched || *text == *cursor;
+                            ++cursor;
+                        }
+                    }
+                    if (matched == negated) return false;
+                    pattern = close + 1;
+                    ++text;
+                    break;
+                }
+                case '\\':
+                    if (pattern[1]) ++pattern;
+                    [[fallthrough]];
+                default:
+                    if (*pattern != *text) return false;
+                    ++pattern;
+                    ++text;
+                    break;
+            }
+        }
+        return !*text;
+    }
+
+    // ========================================================================
+    // Recorrido
+    // ========================================================================
+
+    struct WorkspaceWalker::Task {
+        std::string path;
+        std::string relativePath;
+        std::shared_ptr<const IgnoreRules> rules;
+        bool isDirectory;
+    };
+
+    struct WorkspaceWalker::Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    WorkspaceWalker::WorkspaceWalker(const WalkOptions& options)
+        : options_(options), threadCount_(options.threadCount), directoryCount_(0) {
+        if (threadCount_ == 0) {
+            threadCount_ = TaskScheduler::shared().getWorkerCount() + 1;
+        }
+    }
+
+    bool WorkspaceWalker::walk(const std::string& root, const FileCallback& onFile,
+                               const std::atomic<bool>* cancel) {
+        return walk(root, std::string(), onFile, cancel);
+    }
+
+    bool WorkspaceWalker::walk(const std::string& root, const std::string& subdirectory,
+                               const FileCallback& onFile, const std::atomic<bool>* cancel) {
+        lastError_.clear();
+        directoryCount_ = 0;
+
+        const std::string start = subdirectory.empty() ? root : (fs::path(root) / subdirectory).string();
+        std::error_code error;
+        if (!fs::is_directory(start, error)) {
+            lastError_ = "No es un directorio: " + start;
+            return false;
+        }
+
+        // Un subdirectorio hereda las reglas de sus directorios padre
+        std::shared_ptr<const IgnoreRules> inherited;
+        if (!subdirectory.empty()) {
+            IgnoreMatcher matcher(root, options_);
+            if (matcher.isIgnored(subdirectory, true)) return true;
+            size_t slash = subdirectory.rfind('/');
+            inherited = matcher.rulesFor(slash == std::string::npos ? std::string() : subdirectory.substr(0, slash));
+        }
+
+        std::vector<Worker> workers(threadCount_);
+        std::atomic<size_t> pending{1};
+        std::atomic<size_t> directories{0};
+        workers[0].tasks.push_back(Task{start, subdirectory, inherited, true});
+
+        auto cancelled = [cancel] {
+            return cancel && cancel->load(std::memory_order_relaxed);
+        };
+
+        // Propia: LIFO por el final (localidad); robo: FIFO por el principio
+        // (tareas más antiguas, normalmente directorios grandes)
+        auto takeTask = [&workers](size_t self, Task& task) {
+            for (size_t i = 0; i < workers.size(); ++i) {
+                Worker& worker = workers[(self + i) % workers.size()];
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                if (worker.tasks.empty()) continue;
+                if (i == 0) {
+                    task = std::move(worker.tasks.back());
+                    worker.tasks.pop_back();
+                } else {
+                    task = std::move(worker.tasks.front());
+                    worker.tasks.pop_front();
+                }
+                return true;
+            }
+            return false;
+        };
+
+        auto expand = [&](size_t self, const Task& task) {
+            directories.fetch_add(1, std::memory_order_relaxed);
+            const std::string base = task.relativePath.empty() ? std::string() : task.relativePath + "/";
+            auto rules = options_.respectIgnoreFiles ? IgnoreRules::load(task.path, base, task.rules) : nullptr;
+
+            std::vector<Task> children;
+            std::error_code listError;
+            for (fs::directory_iterator it(task.path, fs::directory_options::skip_permission_denied, listError), end;
+                 !listError && it != end; it.increment(listError)) {
+                std::string name = it->path().filename().string();
+                if (name == ".git" || (!options_.includeHidden && name[0] == '.')) continue;
+
+                std::error_code statusError;
+                fs::file_status status = it->symlink_status(statusError);
+                if (statusError || fs::is_symlink(status)) continue;
+                bool isDirectory = fs::is_directory(status);
+                if (!isDirectory && !fs::is_regular_file(status)) continue;
+
+                std::string relative = base + name;
+                if (rules && rules->isIgnored(relative, isDirectory)) continue;
+                if (isDirectory && options_.reportDirectories) {
+                    onFile(WorkspaceFile{it->path().string(), relative, true}, self);
+                }
+                children.push_back(Task{it->path().string(), std::move(relative), rules, isDirectory});
+            }
+            if (children.empty()) return;
+
+            pending.fetch_add(children.size(), std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(workers[self].mutex);
+            for (Task& child : children) {
+                workers[self].tasks.push_back(std::move(child));
+            }
+        };
+
+        auto run = [&](size_t self) {
+            size_t idle = 0;
+            Task task;
+            while (pending.load(std::memory_order_acquire) > 0 && !cancelled()) {
+                if (!takeTask(self, task)) {
+                    // Otro hilo está expandiendo un directorio: esperar sin girar en vacío
+                    if (++idle < 64) {
+                        std::this_thread::yield();
+                    } else {
+                        std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    }
+                    continue;
+                }
+                idle = 0;
+                if (task.isDirectory) {
+                    expand(self, task);
+                } else {
+                    onFile(WorkspaceFile{std::move(task.path), std::move(task.relativePath), false}, self);
+                }
+                pending.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        };
+
+        // Una porción por cola; el hilo que llama también recorre
+        TaskScheduler::shared().parallelFor("workspace-walk", TaskPriority::Background, threadCount_, threadCount_,
+                                            [&run](size_t part, size_t, size_t) { run(part); });
+
+        directoryCount_ = directories.load();
+        return !cancelled();
+    }
+
+} // namespace CoralCode